@@ -4,6 +4,7 @@
 
 #include "graph.h"
 #include "cachedGraph.h"
+#include "listComponents.h"
 #include "intMath.h"
 
 
@@ -59,6 +60,7 @@ void returnCachedGraph(struct CachedGraph* cache) {
 		dumpVertexListRecursively(lp, w->neighborhood);
 		wipeVertexButKeepNumber(w);
 	}
+	invalidateBlockDecomposition(cache->g);
 	cache->inUse = 0;
 }
 
@@ -1,62 +1,184 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <pthread.h>
 
 #include "listComponents.h"
 #include "listCycles.h"
 #include "cs_Tree.h"
 #include "cs_Cycle.h"
+#include "cs_Compare.h"
 #include "loading.h"
+#include "patternDictionary.h"
+#include "sparseFeatureWriter.h"
 #include "cpk.h"
 
 
+/* limits for the enumeration of simple cycles in a single graph, nonpositive values mean no limit */
+static long int maxCyclesPerGraph = 0;
+static double cycleTimeLimit = 0;
+
+
 /**
- * This is the actual main function that computes a feature vector from the graph g
- *  does not dump g */
-int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
-		char outputOptions, struct Vertex* globalPatternSet, struct compInfo** results, int* resSize) {
-	struct Graph* tmp;
-	struct Graph* idx;
-	int numCycles;
-	int pos = 0;
+ * Limit the number of cycles (maxCycles) and the time in seconds (timeLimit) spent to enumerate the
+ * simple cycles of a single graph. Nonpositive values disable the respective limit.
+ */
+void setCycleEnumerationLimits(long int maxCycles, double timeLimit) {
+	maxCyclesPerGraph = maxCycles;
+	cycleTimeLimit = timeLimit;
+}
 
-	/* find biconnected Components */
-	struct ShallowGraph* h = listBiconnectedComponents(g, sgp);
-	struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
-	/* TODO refactor */
-	struct Graph* biconnectedComponents = forest->next;
 
-	/* list tree patterns */
-	struct ShallowGraph* treePatterns = getTreePatterns(forest, sgp);
+/* if set, feature ids are taken from this persistent dictionary instead of the global pattern set */
+static struct PatternDictionary* patternDictionary = NULL;
 
-	/* create search tree structure */
-	struct Vertex* treePatternSearchTree = buildSearchTree(treePatterns, gp, sgp);
-	int numTrees = treePatternSearchTree->number;
 
-	/* list all cycles */
-	struct ShallowGraph* simpleCycles = NULL;
-	struct ShallowGraph* cyclePatterns = NULL;
-	struct Vertex* cyclePatternSearchTree = NULL;
+/**
+ * Use the ids stored in d for all features. Patterns that are not contained in d are appended to it.
+ * If d is NULL, ids are assigned by the global pattern set given to the kernel functions.
+ */
+void setPatternDictionary(struct PatternDictionary* d) {
+	patternDictionary = d;
+}
 
-	for (idx=biconnectedComponents; idx; idx=idx->next) {
-		simpleCycles = addComponent(simpleCycles, listCycles(idx, sgp));
+
+/* if set, feature vectors are written with this writer instead of printf */
+static struct SparseFeatureWriter* featureWriter = NULL;
+
+
+/**
+ * Write the feature vectors of the output options 'a', 'x', and 'y' with w. If w is NULL, they are
+ * printed to stdout as text.
+ */
+void setFeatureWriter(struct SparseFeatureWriter* w) {
+	featureWriter = w;
+}
+
+
+/**
+ * List each simple cycle of g once, respecting the limits set by setCycleEnumerationLimits().
+ * Prints a warning to stderr if the enumeration was stopped early.
+ */
+static struct ShallowGraph* listSimpleCycles(struct Graph* g, struct ShallowGraphPool* sgp) {
+	char truncated = 0;
+	struct ShallowGraph* simpleCycles = listCyclesOnce(g, maxCyclesPerGraph, cycleTimeLimit, &truncated, sgp);
+	if (truncated) {
+		fprintf(stderr, "Warning: cycle enumeration of graph %i stopped early, the cycle patterns are incomplete\n", g->number);
 	}
+	return simpleCycles;
+}
 
-	/* if cycles were found, compute canonical strings */
-	if (simpleCycles) {
-		/* transform cycle of shallow graphs to a list */
-		simpleCycles->prev->next = NULL;
-		simpleCycles->prev = NULL;
 
-		cyclePatterns = getCyclePatterns(simpleCycles, sgp);
-		cyclePatternSearchTree = buildSearchTree(cyclePatterns, gp, sgp);
+/**
+ * Sort a list of canonical strings lexicographically. The cycle patterns of a graph are inserted into its
+ * search tree in this order, so new patterns get their ids in an order that does not depend on the order
+ * in which the cycle enumeration finds the cycles.
+ */
+static struct ShallowGraph* sortCanonicalStrings(struct ShallowGraph* strings) {
+	int n = 0;
+	for (struct ShallowGraph* idx=strings; idx; idx=idx->next) {
+		++n;
+	}
+	if (n < 2) {
+		return strings;
+	}
 
-		numCycles = cyclePatternSearchTree->number;
-	} else {
-		numCycles = 0;
+	struct ShallowGraph** array = malloc(n * sizeof(struct ShallowGraph*));
+	int i = 0;
+	for (struct ShallowGraph* idx=strings; idx; idx=idx->next, ++i) {
+		array[i] = idx;
+	}
+	qsort(array, n, sizeof(struct ShallowGraph*), &lexCompCS);
+	for (i=0; i<n-1; ++i) {
+		array[i]->next = array[i+1];
+	}
+	array[n-1]->next = NULL;
+	strings = array[0];
+	free(array);
+	return strings;
+}
+
+
+/**
+ * Tree and cycle patterns of a single graph. The search trees belong to the pools that were used to
+ * compute them. The search trees and cycleLengths are NULL if they were not computed.
+ */
+struct CyclicPatterns {
+	struct Vertex* treePatterns;
+	struct Vertex* cyclePatterns;
+	long int* cycleLengths;
+};
+
+
+/**
+ * Compute the search trees of the tree patterns and the cycle patterns of g. Output option 'x' skips the
+ * tree patterns and 'y' skips the cycle patterns. Output option 'l' only counts the simple cycles of each
+ * length, without listing them.
+ *
+ * Only uses g, the given pools, and the read-only cycle enumeration limits. Hence, different graphs can be
+ * processed in parallel if each thread has its own pools.
+ */
+static void computeCyclicPatterns(struct Graph* g, char outputOptions, struct CyclicPatterns* patterns, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
+	patterns->treePatterns = NULL;
+	patterns->cyclePatterns = NULL;
+	patterns->cycleLengths = NULL;
+
+	if (outputOptions == 'l') {
+		char truncated = 0;
+		patterns->cycleLengths = calloc(g->n + 1, sizeof(long int));
+		countCycles(g, patterns->cycleLengths, maxCyclesPerGraph, cycleTimeLimit, &truncated);
+		if (truncated) {
+			fprintf(stderr, "Warning: cycle enumeration of graph %i stopped early, the cycle counts are incomplete\n", g->number);
+		}
+		return;
+	}
+
+	if (outputOptions != 'x') {
+		struct Graph* idx;
+		struct Graph* tmp;
+
+		/* find biconnected Components */
+		struct ShallowGraph* h = getBlocksAsShallowGraphs(getBlockDecomposition(g), sgp);
+		struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
+
+		/* list tree patterns and create search tree structure */
+		struct ShallowGraph* treePatterns = getTreePatterns(forest, sgp);
+		patterns->treePatterns = buildSearchTree(treePatterns, gp, sgp);
+
+		/* dump biconnected components list */
+		for (idx=forest->next; idx; idx=tmp) {
+			tmp = idx->next;
+			dumpGraph(gp, idx);
+		}
+		dumpGraph(gp, forest);
+	}
+
+	if (outputOptions != 'y') {
+		/* each cycle is listed once */
+		struct ShallowGraph* simpleCycles = listSimpleCycles(g, sgp);
+
+		/* if cycles were found, compute canonical strings */
+		if (simpleCycles) {
+			struct ShallowGraph* cyclePatterns = sortCanonicalStrings(getCyclePatterns(simpleCycles, sgp));
+			patterns->cyclePatterns = buildSearchTree(cyclePatterns, gp, sgp);
+		}
 	}
+}
 
 
+/**
+ * Merge the patterns of g into globalPatternSet to obtain their ids and print the output for g. New patterns
+ * get the next free ids in globalPatternSet. Hence, ids depend only on the order in which graphs are output.
+ * If a pattern dictionary is set, the ids are taken from it instead.
+ * Returns -1 if the pattern dictionary cannot be accessed.
+ */
+static int outputCyclicPatterns(struct Graph* g, char outputOptions, struct CyclicPatterns* patterns,
+		struct Vertex* globalPatternSet, struct compInfo** results, int* resSize, struct GraphPool* gp) {
+	int numTrees = patterns->treePatterns ? patterns->treePatterns->number : 0;
+	int numCycles = patterns->cyclePatterns ? patterns->cyclePatterns->number : 0;
+	int pos = 0;
+	int status = 0;
+	int i;
 
 	if (numTrees + numCycles > *resSize) {
 		if (*results) {
@@ -67,13 +189,24 @@ int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct Gr
 		*resSize = numTrees + numCycles;
 	}
 
-
-	
-
 	/* add elements to global search trees to obtain mapping from strings to integers */
-	mergeSearchTrees(globalPatternSet, treePatternSearchTree, 1, *results, &pos, globalPatternSet, 0, gp);
-	if (cyclePatternSearchTree) {
-		mergeSearchTrees(globalPatternSet, cyclePatternSearchTree, 2, *results, &pos, globalPatternSet, 0, gp);
+	if (patternDictionary) {
+		if (patterns->treePatterns) {
+			status = getPatternIds(patternDictionary, patterns->treePatterns, *results, &pos);
+		}
+		if (patterns->cyclePatterns && (status == 0)) {
+			status = getPatternIds(patternDictionary, patterns->cyclePatterns, *results, &pos);
+		}
+		if (status != 0) {
+			return status;
+		}
+	} else {
+		if (patterns->treePatterns) {
+			mergeSearchTrees(globalPatternSet, patterns->treePatterns, 1, *results, &pos, globalPatternSet, 0, gp);
+		}
+		if (patterns->cyclePatterns) {
+			mergeSearchTrees(globalPatternSet, patterns->cyclePatterns, 1, *results, &pos, globalPatternSet, 0, gp);
+		}
 	}
 
 	/* sort the output elements by increasing id */
@@ -81,14 +214,23 @@ int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct Gr
 
 	/* output options */
 	switch (outputOptions) {
-	int i;
-
 	case 'a':
+	case 'x':
+	case 'y':
 		/* "all" output the feature vector for the current graph in the format specified
 		 * by SVMlight g->activity is assumed to be either 0, 1 or -1 to be compliant with
 		 * the specs of SVMlight.
 		 */
 
+		if (featureWriter) {
+			beginSparseRow(featureWriter, g->activity);
+			for (i=0; i<pos; ++i) {
+				addSparseEntry(featureWriter, (*results)[i].id, (*results)[i].count);
+			}
+			endSparseRow(featureWriter);
+			break;
+		}
+
 		/* print the id and label of the graph */
 		printf("%i", g->activity);
 
@@ -98,16 +240,23 @@ int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct Gr
 		}
 		printf("\n");
 		break;
+	case 'l':
+		/* returns the number of simple cycles of each length */
+		printf("%i", g->number);
+		for (i=3; i<=g->n; ++i) {
+			if (patterns->cycleLengths[i]) {
+				printf(" %i:%li", i, patterns->cycleLengths[i]);
+			}
+		}
+		printf("\n");
+		break;
 	case 'c':
 		/* returns the number of cycles found in the graph */
-		if (cyclePatternSearchTree)
-			printf("%i %i\n", g->number, cyclePatternSearchTree->number / 2);
-		else
-			printf("%i 0\n", g->number);
+		printf("%i %i\n", g->number, numCycles);
 		break;
 	case 't':
 		/* returns the number of trees found in the graph */
-		printf("%i %i\n", g->number, treePatternSearchTree->number);
+		printf("%i %i\n", g->number, numTrees);
 		break;
 	case 'v':
 		/* returns the number of vertices in the graph */
@@ -118,187 +267,192 @@ int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct Gr
 		printf("%i %i\n", g->number, g->m);
 		break;
 	}
+	return 0;
+}
 
 
-	/* garbage collection */
-
-	/* dump cycles, if any
-	 * TODO may be moved upwards directly after finding simple cycles */
-	if (cyclePatternSearchTree) {
-			dumpSearchTree(gp, cyclePatternSearchTree);
+/**
+ * Return the search trees of patterns to gp, which has to be the pool they were computed with.
+ */
+static void dumpCyclicPatterns(struct CyclicPatterns* patterns, struct GraphPool* gp) {
+	if (patterns->treePatterns) {
+		dumpSearchTree(gp, patterns->treePatterns);
 	}
-
-	/* dump biconnected components list */
-	for (idx=biconnectedComponents; idx; idx=tmp) {
-		tmp = idx->next;
-		dumpGraph(gp, idx);
+	if (patterns->cyclePatterns) {
+		dumpSearchTree(gp, patterns->cyclePatterns);
 	}
+	free(patterns->cycleLengths);
+}
 
-	dumpSearchTree(gp, treePatternSearchTree);
-	dumpGraph(gp, forest);
 
-	return 0;
+/**
+ * This is the actual main function that computes a feature vector from the graph g
+ *  does not dump g */
+int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
+		char outputOptions, struct Vertex* globalPatternSet, struct compInfo** results, int* resSize) {
+	struct CyclicPatterns patterns;
+	int status;
+	computeCyclicPatterns(g, outputOptions, &patterns, sgp, gp);
+	status = outputCyclicPatterns(g, outputOptions, &patterns, globalPatternSet, results, resSize, gp);
+	dumpCyclicPatterns(&patterns, gp);
+	return status;
 }
 
+
 /**
  * This is the actual main function that computes a feature vector from the graph g
  *  does not dump g */
 int CyclicPatternKernel_onlyCycles(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp, struct Vertex* globalPatternSet, struct compInfo** results, int* resSize) {
-	struct Graph* tmp;
-	struct Graph* idx;
-	int numCycles;
-	int pos = 0;
-	int i;
-
-	/* find biconnected Components */
-	struct ShallowGraph* h = listBiconnectedComponents(g, sgp);
-	struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
-	/* TODO refactor */
-	struct Graph* biconnectedComponents = forest->next;
+	return CyclicPatternKernel(g, sgp, gp, 'x', globalPatternSet, results, resSize);
+}
 
-	/* list all cycles */
-	struct ShallowGraph* simpleCycles = NULL;
-	struct ShallowGraph* cyclePatterns = NULL;
-	struct Vertex* cyclePatternSearchTree = NULL;
 
-	for (idx=biconnectedComponents; idx; idx=idx->next) {
-		simpleCycles = addComponent(simpleCycles, listCycles(idx, sgp));
-	}
+/**
+ * This is the actual main function that computes a feature vector from the graph g
+ *  does not dump g */
+int CyclicPatternKernel_onlyTrees(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
+		struct Vertex* globalPatternSet, struct compInfo** results, int* resSize) {
+	return CyclicPatternKernel(g, sgp, gp, 'y', globalPatternSet, results, resSize);
+}
 
-	/* if cycles were found, compute canonical strings */
-	if (simpleCycles) {
-		/* transform cycle of shallow graphs to a list */
-		simpleCycles->prev->next = NULL;
-		simpleCycles->prev = NULL;
 
-		cyclePatterns = getCyclePatterns(simpleCycles, sgp);
-		cyclePatternSearchTree = buildSearchTree(cyclePatterns, gp, sgp);
+/******* Parallel cyclic pattern kernel ************************************************/
 
-		numCycles = cyclePatternSearchTree->number;
-	} else {
-		numCycles = 0;
-	}
+/**
+ * Pools of one thread and the shared state of a batch. Graphs are assigned to threads one by one
+ * by incrementing *next, as the time to list the cycles of a graph varies a lot.
+ */
+struct CPKWorker {
+	struct ListPool* lp;
+	struct VertexPool* vp;
+	struct ShallowGraphPool* sgp;
+	struct GraphPool* gp;
+
+	struct Graph** graphs;
+	struct CyclicPatterns* patterns;
+	struct GraphPool** owners;
+	int nGraphs;
+	int* next;
+	pthread_mutex_t* lock;
+	char outputOptions;
+};
+
+struct CPKWorkers {
+	struct CPKWorker* workers;
+	int nThreads;
+	pthread_mutex_t lock;
+};
 
-	if (numCycles > *resSize) {
-		if (*results) {
-			free(*results);
-		}
 
-		*results = getResultVector(numCycles);
-		*resSize = numCycles;
+/**
+ * Create nThreads workers, each with its own object pools.
+ */
+struct CPKWorkers* createCPKWorkers(int nThreads) {
+	struct CPKWorkers* w = malloc(sizeof(struct CPKWorkers));
+	if (nThreads < 1) {
+		nThreads = 1;
 	}
-
-
-	
-
-	/* add elements to global search trees to obtain mapping from strings to integers */
-	if (cyclePatternSearchTree) {
-		mergeSearchTrees(globalPatternSet, cyclePatternSearchTree, 2, *results, &pos, globalPatternSet, 0, gp);
-		
-		/* sort the output elements by increasing id */
-		qsort(*results, pos, sizeof(struct compInfo), &compInfoComparison);
-		
-		/* "all" output the feature vector for the current graph in the format specified
-		 * by SVMlight g->activity is assumed to be either 0, 1 or -1 to be compliant with
-		 * the specs of SVMlight.
-		 */
-
-		/* print the id and label of the graph */
-		printf("%i", g->activity);
-
-		/* print key:value pairs */
-		for (i=0; i<pos; ++i) {
-			printf(" %i:%i", (*results)[i].id, (*results)[i].count);
-		}
-		printf("\n");
-	} else {
-		/* print only label */
-		printf("%i", g->activity);
-		printf("\n");
+	w->nThreads = nThreads;
+	w->workers = malloc(nThreads * sizeof(struct CPKWorker));
+	pthread_mutex_init(&w->lock, NULL);
+	for (int t=0; t<nThreads; ++t) {
+		w->workers[t].lp = createListPool(10000);
+		w->workers[t].vp = createVertexPool(10000);
+		w->workers[t].sgp = createShallowGraphPool(1000, w->workers[t].lp);
+		w->workers[t].gp = createGraphPool(100, w->workers[t].vp, w->workers[t].lp);
+		w->workers[t].lock = &w->lock;
 	}
+	return w;
+}
 
-	/* garbage collection */
-
-	/* dump cycles, if any
-	 * TODO may be moved upwards directly after finding simple cycles */
-	if (cyclePatternSearchTree) {
-		dumpSearchTree(gp, cyclePatternSearchTree);
-	}
 
-	/* dump biconnected components list */
-	for (idx=biconnectedComponents; idx; idx=tmp) {
-		tmp = idx->next;
-		dumpGraph(gp, idx);
+void freeCPKWorkers(struct CPKWorkers* w) {
+	for (int t=0; t<w->nThreads; ++t) {
+		freeGraphPool(w->workers[t].gp);
+		freeShallowGraphPool(w->workers[t].sgp);
+		freeListPool(w->workers[t].lp);
+		freeVertexPool(w->workers[t].vp);
 	}
-
-	dumpGraph(gp, forest);
-
-	return 0;
+	pthread_mutex_destroy(&w->lock);
+	free(w->workers);
+	free(w);
 }
 
 
 /**
- * This is the actual main function that computes a feature vector from the graph g
- *  does not dump g */
-int CyclicPatternKernel_onlyTrees(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
-		struct Vertex* globalPatternSet, struct compInfo** results, int* resSize) {
-	struct Graph* tmp;
-	struct Graph* idx;
-	int pos = 0;
-	int i;
-
-	/* find biconnected Components */
-	struct ShallowGraph* h = listBiconnectedComponents(g, sgp);
-	struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
-	/* TODO refactor */
-	struct Graph* biconnectedComponents = forest->next;
-
-	/* list tree patterns */
-	struct ShallowGraph* treePatterns = getTreePatterns(forest, sgp);
-
-	/* create search tree structure */
-	struct Vertex* treePatternSearchTree = buildSearchTree(treePatterns, gp, sgp);
-	int numTrees = treePatternSearchTree->number;
-
-	if (numTrees > *resSize) {
-		if (*results) {
-			free(*results);
+ * Compute the patterns of the next unprocessed graph of the batch until all graphs are processed.
+ */
+static void* cpkWorkerRun(void* arg) {
+	struct CPKWorker* w = arg;
+	while (1) {
+		pthread_mutex_lock(w->lock);
+		int i = *w->next;
+		++*w->next;
+		pthread_mutex_unlock(w->lock);
+
+		if (i >= w->nGraphs) {
+			break;
 		}
-
-		*results = getResultVector(numTrees);
-		*resSize = numTrees;
+		computeCyclicPatterns(w->graphs[i], w->outputOptions, &w->patterns[i], w->sgp, w->gp);
+		w->owners[i] = w->gp;
 	}
+	return NULL;
+}
 
-	/* add elements to global search trees to obtain mapping from strings to integers */
-	mergeSearchTrees(globalPatternSet, treePatternSearchTree, 1, *results, &pos, globalPatternSet, 0, gp);
-
-	/* sort the output elements by increasing id */
-	qsort(*results, pos, sizeof(struct compInfo), &compInfoComparison);
-
-	/* "all" output the feature vector for the current graph in the format specified
-	 * by SVMlight g->activity is assumed to be either 0, 1 or -1 to be compliant with
-	 * the specs of SVMlight.
-	 */
-
-	/* print the id and label of the graph */
-	printf("%i", g->activity);
 
-	/* print key:value pairs */
-	for (i=0; i<pos; ++i) {
-		printf(" %i:%i", (*results)[i].id, (*results)[i].count);
+/**
+ * Compute the cyclic pattern kernel features of a batch of graphs with the threads of workers and output
+ * them as CyclicPatternKernel() would, if it was called for the graphs in this order.
+ *
+ * The patterns of each graph are computed in thread local search trees. Afterwards, they are merged into
+ * globalPatternSet and printed in the order of the batch. Hence, ids and output do not depend on the number
+ * of threads. Does not dump the graphs. Returns -1 if the pattern dictionary cannot be accessed.
+ */
+int CyclicPatternKernelBatch(struct Graph** graphs, int nGraphs, struct CPKWorkers* workers,
+		char outputOptions, struct Vertex* globalPatternSet, struct compInfo** results, int* resSize, struct GraphPool* gp) {
+	struct CyclicPatterns* patterns = malloc(nGraphs * sizeof(struct CyclicPatterns));
+	struct GraphPool** owners = malloc(nGraphs * sizeof(struct GraphPool*));
+	pthread_t* threads = malloc(workers->nThreads * sizeof(pthread_t));
+	char* started = malloc(workers->nThreads * sizeof(char));
+	int next = 0;
+	int status = 0;
+	int t, i;
+
+	for (t=0; t<workers->nThreads; ++t) {
+		workers->workers[t].graphs = graphs;
+		workers->workers[t].patterns = patterns;
+		workers->workers[t].owners = owners;
+		workers->workers[t].nGraphs = nGraphs;
+		workers->workers[t].next = &next;
+		workers->workers[t].outputOptions = outputOptions;
 	}
-	printf("\n");
-
-	/* garbage collection */
 
-	/* dump biconnected components list */
-	for (idx=biconnectedComponents; idx; idx=tmp) {
-		tmp = idx->next;
-		dumpGraph(gp, idx);
+	if (workers->nThreads == 1) {
+		cpkWorkerRun(&workers->workers[0]);
+	} else {
+		for (t=0; t<workers->nThreads; ++t) {
+			started[t] = pthread_create(&threads[t], NULL, &cpkWorkerRun, &workers->workers[t]) == 0;
+		}
+		for (t=0; t<workers->nThreads; ++t) {
+			if (started[t]) {
+				pthread_join(threads[t], NULL);
+			}
+		}
+		/* if no thread could be started, process the remaining graphs in the current thread */
+		cpkWorkerRun(&workers->workers[0]);
 	}
 
-	dumpSearchTree(gp, treePatternSearchTree);
-	dumpGraph(gp, forest);
+	/* merge step in the order of the batch */
+	for (i=0; i<nGraphs; ++i) {
+		if (status == 0) {
+			status = outputCyclicPatterns(graphs[i], outputOptions, &patterns[i], globalPatternSet, results, resSize, gp);
+		}
+		dumpCyclicPatterns(&patterns[i], owners[i]);
+	}
 
-	return 0;
+	free(started);
+	free(threads);
+	free(owners);
+	free(patterns);
+	return status;
 }
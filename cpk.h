@@ -10,7 +10,14 @@
 
 #include "graph.h"
 #include "searchTree.h"
- 
+
+struct CPKWorkers;
+struct PatternDictionary;
+struct SparseFeatureWriter;
+
+void setCycleEnumerationLimits(long int maxCycles, double timeLimit);
+void setPatternDictionary(struct PatternDictionary* d);
+void setFeatureWriter(struct SparseFeatureWriter* w);
 int CyclicPatternKernel(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
 		char outputOptions, struct Vertex* globalPatternSet, struct compInfo** results, int* resSize);
 int CyclicPatternKernel_onlyTrees(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
@@ -18,4 +25,9 @@ int CyclicPatternKernel_onlyTrees(struct Graph *g, struct ShallowGraphPool *sgp,
 int CyclicPatternKernel_onlyCycles(struct Graph *g, struct ShallowGraphPool *sgp, struct GraphPool *gp,
 		struct Vertex* globalPatternSet, struct compInfo** results, int* resSize);
 
+struct CPKWorkers* createCPKWorkers(int nThreads);
+void freeCPKWorkers(struct CPKWorkers* w);
+int CyclicPatternKernelBatch(struct Graph** graphs, int nGraphs, struct CPKWorkers* workers,
+		char outputOptions, struct Vertex* globalPatternSet, struct compInfo** results, int* resSize, struct GraphPool* gp);
+
 #endif /* CPK_H_ */
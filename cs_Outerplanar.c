@@ -100,12 +100,12 @@ struct VertexList* __compareBlockRepresentations(struct VertexList* c1, struct V
 		/* count number of diagonals that go from the current vertex to a vertex with a higher
 		 * index wrt the current permutation */
 		for (e=idx1->endPoint->neighborhood; e; e=e->next) {
-			if (mod(e->startPoint->d - o1, m + 1) < mod(e->endPoint->d - o1, m + 1)) {
+			if (mod(e->startPoint->d - o1, m) < mod(e->endPoint->d - o1, m)) {
 				++neighbors1;
 			}
 		}
 		for (e=idx2->endPoint->neighborhood; e; e=e->next) {
-			if (mod(e->startPoint->d - o2, m + 1) < mod(e->endPoint->d - o2, m + 1)) {
+			if (mod(e->startPoint->d - o2, m) < mod(e->endPoint->d - o2, m)) {
 				++neighbors2;
 			}
 		}
@@ -125,11 +125,25 @@ struct VertexList* __compareBlockRepresentations(struct VertexList* c1, struct V
 			continue;
 		}
 		if (neighbors1 == 1) {
-			if (mod(idx1->endPoint->neighborhood->endPoint->d - o1, m + 1) > mod(idx2->endPoint->neighborhood->endPoint->d - o2, m + 1)) {
+			int end1 = 0;
+			int end2 = 0;
+			for (e=idx1->endPoint->neighborhood; e; e=e->next) {
+				if (mod(e->startPoint->d - o1, m) < mod(e->endPoint->d - o1, m)) {
+					end1 = mod(e->endPoint->d - o1, m);
+				}
+			}
+			for (e=idx2->endPoint->neighborhood; e; e=e->next) {
+				if (mod(e->startPoint->d - o2, m) < mod(e->endPoint->d - o2, m)) {
+					end2 = mod(e->endPoint->d - o2, m);
+				}
+			}
+			if (end1 > end2) {
 				return c2;
-			} else {
+			}
+			if (end1 < end2) {
 				return c1;
 			}
+			continue;
 		}
 
 		/* otherwise we have to sort the edges wrt their endpoints modulo the permutation */
@@ -138,16 +152,16 @@ struct VertexList* __compareBlockRepresentations(struct VertexList* c1, struct V
 		narray1 = malloc(neighbors1 * sizeof(struct VertexList*));
 		narray2 = malloc(neighbors2 * sizeof(struct VertexList*));
 		for (i=0, e=idx1->endPoint->neighborhood; i<neighbors1; e=e->next) {
-			e->flag = mod(e->startPoint->d - o1, m + 1);
-			e->used = mod(e->endPoint->d - o1, m + 1);
+			e->flag = mod(e->startPoint->d - o1, m);
+			e->used = mod(e->endPoint->d - o1, m);
 			if (e->flag < e->used) {
 				narray1[i] = e;
 				++i;
 			}
 		}
 		for (i=0, e=idx2->endPoint->neighborhood; i<neighbors2; e=e->next) {
-			e->flag = mod(e->startPoint->d - o2, m + 1);
-			e->used = mod(e->endPoint->d - o2, m + 1);
+			e->flag = mod(e->startPoint->d - o2, m);
+			e->used = mod(e->endPoint->d - o2, m);
 			if (e->flag < e->used) {
 				narray2[i] = e;
 				++i;
@@ -230,14 +244,15 @@ struct ShallowGraph* __permutateBlock(struct ShallowGraph* cycle, struct Shallow
 	end->next = start;
 
 	/* give each vertex a number according to its position in cycle */
-	for (idx=start->next, i=1; idx!=start; idx=idx->next, ++i) {
+	for (idx=start, i=0; i<cycle->m; idx=idx->next, ++i) {
 		idx->startPoint->d = i;
 	}
-	start->endPoint->d = 0;
 
-	/* offset=3 as in the first step the permutation starting at edge after the second vertex
+	/* the offset is the number of the first vertex of the string, i.e. the endpoint of the edge after best.
+	 * offset=3 as in the first step the permutation starting at edge after the second vertex
 	 * in cycle is compared to the permutation starting after the first */
-	for (idx = start->next, i=3; idx != start; idx=idx->next, i=(i+1)%(cycle->m + 1)) {
+	bestOffset = mod(bestOffset, cycle->m);
+	for (idx = start->next, i=mod(3, cycle->m); idx != start; idx=idx->next, i=(i+1)%(cycle->m)) {
 		best = __compareBlockRepresentations(best, idx, cycle->m, bestOffset, i);
 		if (best == idx) {
 			bestOffset = i;
@@ -260,7 +275,7 @@ struct ShallowGraph* __permutateBlock(struct ShallowGraph* cycle, struct Shallow
 		/* count number of diagonals that go from the current vertex to a vertex with a higher
 		 * index wrt the current permutation */
 		for (e=idx->endPoint->neighborhood; e; e=e->next) {
-			if (mod(e->startPoint->d - bestOffset, cycle->m + 1) < mod(e->endPoint->d - bestOffset, cycle->m + 1)) {
+			if (mod(e->startPoint->d - bestOffset, cycle->m) < mod(e->endPoint->d - bestOffset, cycle->m)) {
 				++neighbors;
 			}
 		}
@@ -274,10 +289,10 @@ struct ShallowGraph* __permutateBlock(struct ShallowGraph* cycle, struct Shallow
 			/* add edge representation to secondPart. There may be more than one incident diagonals, but just one that
 			 * satisfies startpoint < endpoint. This is the edge we are searching. */
 			for (e=idx->endPoint->neighborhood; e; e=e->next) {
-				if (mod(e->startPoint->d - bestOffset, cycle->m + 1) < mod(e->endPoint->d - bestOffset, cycle->m + 1)) {
+				if (mod(e->startPoint->d - bestOffset, cycle->m) < mod(e->endPoint->d - bestOffset, cycle->m)) {
 					__appendDiagonal(secondPart,
-							mod(e->startPoint->d - bestOffset, cycle->m + 1),
-							mod(e->endPoint->d - bestOffset, cycle->m + 1),
+							mod(e->startPoint->d - bestOffset, cycle->m),
+							mod(e->endPoint->d - bestOffset, cycle->m),
 							e->label,
 							sgp->listPool);
 
@@ -291,8 +306,8 @@ struct ShallowGraph* __permutateBlock(struct ShallowGraph* cycle, struct Shallow
 		narray1 = malloc(neighbors * sizeof(struct VertexList*));
 
 		for (i=0, e=idx->endPoint->neighborhood; i<neighbors; e=e->next) {
-			e->flag = mod(e->startPoint->d - bestOffset, cycle->m + 1);
-			e->used = mod(e->endPoint->d - bestOffset, cycle->m + 1);
+			e->flag = mod(e->startPoint->d - bestOffset, cycle->m);
+			e->used = mod(e->endPoint->d - bestOffset, cycle->m);
 			if (e->flag < e->used) {
 				narray1[i] = e;
 				++i;
@@ -313,20 +328,12 @@ struct ShallowGraph* __permutateBlock(struct ShallowGraph* cycle, struct Shallow
 
 	cString = canonicalStringOfCycle(cycle, sgp);
 
-	//debug
-	printCanonicalString(cString, stdout);
-	printCanonicalString(secondPart, stdout);
-
 	cString->lastEdge->next = secondPart->edges;
 	cString->lastEdge = secondPart->lastEdge;
 	cString->m = cString->m + secondPart->m;
 	pushEdge(cString, getInitialisatorEdge(sgp->listPool));
 	appendEdge(cString, getTerminatorEdge(sgp->listPool));
 
-	//debug
-	fprintf(stdout, "something\n");
-	printCanonicalString(cString, stdout);
-
 	/* garbage collection */
 	secondPart->edges = NULL;
 	dumpShallowGraph(sgp, secondPart);
@@ -336,14 +343,16 @@ struct ShallowGraph* __permutateBlock(struct ShallowGraph* cycle, struct Shallow
 
 
 /**
- * Compute the canonical string of an outerplanar block given as hamiltonian cycle and list of diagonals.
+ * Compute the canonical string of an outerplanar block given as hamiltonian cycle and list of diagonals
+ * by comparing all rotations of both orientations of the hamiltonian cycle. This takes quadratic time in
+ * the size of the block and is kept as reference for canonicalStringOfOuterplanarBlock().
  * This method assumes that graph, the start- and endpoints of the edges point to, contains no edges.
  *
  * If you want to use this method in a context, where the underlying graph is not empty, you either
  * have to delete all edges from it or you have to grate an empty new graph and change the start-
  * and endpoints of edges in hamiltonianCycle and diagonals accordingly.
  */
-struct ShallowGraph* canonicalStringOfOuterplanarBlock(struct ShallowGraph* hamiltonianCycle, struct ShallowGraph* diagonals, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* canonicalStringOfOuterplanarBlockQuadratic(struct ShallowGraph* hamiltonianCycle, struct ShallowGraph* diagonals, struct ShallowGraphPool* sgp) {
 	struct VertexList* idx;
 	struct ShallowGraph* result1;
 	struct ShallowGraph* result2;
@@ -371,15 +380,8 @@ struct ShallowGraph* canonicalStringOfOuterplanarBlock(struct ShallowGraph* hami
 	 * smallest string */
 
 	result1 = __permutateBlock(hamiltonianCycle, sgp);
-
-	//debug
-	printCanonicalString(result1, stdout);
-
 	result2 = __permutateBlock(inverse, sgp);
 
-	//debug
-	printCanonicalString(result2, stderr);
-
 	/* garbage collection */
 	dumpShallowGraph(sgp, inverse);
 	dumpShallowGraph(sgp, hamiltonianCycle);
@@ -397,6 +399,382 @@ struct ShallowGraph* canonicalStringOfOuterplanarBlock(struct ShallowGraph* hami
 }
 
 
+/**
+ * One orientation of the hamiltonian cycle of an outerplanar block. Vertex i is the startpoint of edges[i],
+ * token[i] encodes the labels of edges[i] and of its endpoint. The diagonals at vertex i are given by their
+ * lengths, i.e. the number of steps along the orientation to their other endpoint, in increasing order:
+ * diagonalLength[diagonalStart[i]], ..., diagonalLength[diagonalStart[i+1] - 1].
+ */
+struct BlockOrientation {
+	int n;
+	struct VertexList** edges;
+	long int* token;
+	int* diagonalStart;
+	int* diagonalLength;
+	char** diagonalLabel;
+};
+
+
+struct RankedLabel {
+	char* label;
+	int index;
+};
+
+
+static int compareRankedLabels(const void* a, const void* b) {
+	return strcmp(((struct RankedLabel*)a)->label, ((struct RankedLabel*)b)->label);
+}
+
+
+/**
+ * Booth's algorithm. Returns the start of the lexicographically smallest rotation of s.
+ * f must have space for 2n ints.
+ */
+static int leastRotation(long int* s, int n, int* f) {
+	int k = 0;
+	int j;
+
+	f[0] = -1;
+	for (j=1; j<2*n; ++j) {
+		long int sj = s[j % n];
+		int i = f[j - k - 1];
+		while ((i != -1) && (sj != s[(k + i + 1) % n])) {
+			if (sj < s[(k + i + 1) % n]) {
+				k = j - i - 1;
+			}
+			i = f[i];
+		}
+		if (sj != s[(k + i + 1) % n]) {
+			/* here i == -1 */
+			if (sj < s[k % n]) {
+				k = j;
+			}
+			f[j - k] = -1;
+		} else {
+			f[j - k] = i + 1;
+		}
+	}
+
+	return k % n;
+}
+
+
+/**
+ * Return the smallest p such that rotating s by p results in s. prefix must have space for n ints.
+ */
+static int rotationPeriod(long int* s, int n, int* prefix) {
+	int p;
+	int k = 0;
+
+	prefix[0] = 0;
+	for (int i=1; i<n; ++i) {
+		while ((k > 0) && (s[i] != s[k])) {
+			k = prefix[k-1];
+		}
+		if (s[i] == s[k]) {
+			++k;
+		}
+		prefix[i] = k;
+	}
+	p = n - prefix[n-1];
+	return (n % p == 0) ? p : n;
+}
+
+
+/**
+ * Compare the diagonals of the representations of o that start with edges[s1] and edges[s2], assuming their
+ * hamiltonian cycles are equal. Uses the order of __compareBlockRepresentations(): vertex by vertex, more
+ * diagonals to vertices with a higher position come first, then smaller positions of their endpoints.
+ * Returns a negative value, if the representation starting at s1 is smaller.
+ */
+static int compareDiagonalsOfRotations(struct BlockOrientation* o, int s1, int s2) {
+	int n = o->n;
+
+	for (int k=0; k<n-1; ++k) {
+		int v1 = (s1 + 1 + k) % n;
+		int v2 = (s2 + 1 + k) % n;
+		int count1 = 0;
+		int count2 = 0;
+
+		while ((o->diagonalStart[v1] + count1 < o->diagonalStart[v1+1]) && (o->diagonalLength[o->diagonalStart[v1] + count1] <= n - 1 - k)) {
+			++count1;
+		}
+		while ((o->diagonalStart[v2] + count2 < o->diagonalStart[v2+1]) && (o->diagonalLength[o->diagonalStart[v2] + count2] <= n - 1 - k)) {
+			++count2;
+		}
+
+		/* more diagonals result in a smaller representation */
+		if (count1 != count2) {
+			return count2 - count1;
+		}
+		for (int i=0; i<count1; ++i) {
+			int length1 = o->diagonalLength[o->diagonalStart[v1] + i];
+			int length2 = o->diagonalLength[o->diagonalStart[v2] + i];
+			if (length1 != length2) {
+				return length1 - length2;
+			}
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * Return the canonical string of the representation of o that starts with edges[s]. Its first vertex,
+ * the endpoint of edges[s], has position 0.
+ */
+static struct ShallowGraph* blockStringOfRotation(struct BlockOrientation* o, int s, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph* cString = getShallowGraph(sgp);
+	struct ShallowGraph* secondPart = getShallowGraph(sgp);
+	int n = o->n;
+	int k;
+
+	/* hamiltonian cycle, as canonicalStringOfCycle() */
+	appendEdge(cString, getInitialisatorEdge(sgp->listPool));
+	for (k=0; k<n; ++k) {
+		struct VertexList* e = o->edges[(s + k) % n];
+		struct VertexList* endPoint = getVertexList(sgp->listPool);
+		endPoint->label = e->endPoint->label;
+		appendEdge(cString, shallowCopyEdge(e, sgp->listPool));
+		appendEdge(cString, endPoint);
+	}
+	appendEdge(cString, getTerminatorEdge(sgp->listPool));
+
+	/* diagonals sorted by the positions of their endpoints */
+	for (k=0; k<n-1; ++k) {
+		int v = (s + 1 + k) % n;
+		for (int i=o->diagonalStart[v]; (i<o->diagonalStart[v+1]) && (o->diagonalLength[i] <= n - 1 - k); ++i) {
+			__appendDiagonal(secondPart, k, k + o->diagonalLength[i], o->diagonalLabel[i], sgp->listPool);
+		}
+	}
+
+	cString->lastEdge->next = secondPart->edges;
+	cString->lastEdge = secondPart->lastEdge;
+	cString->m = cString->m + secondPart->m;
+	pushEdge(cString, getInitialisatorEdge(sgp->listPool));
+	appendEdge(cString, getTerminatorEdge(sgp->listPool));
+
+	secondPart->edges = NULL;
+	dumpShallowGraph(sgp, secondPart);
+	return cString;
+}
+
+
+/**
+ * Find the smallest representation of o. The hamiltonian cycle has priority, hence only the rotations
+ * that minimize the token sequence are candidates. These are found by Booth's algorithm and are equal up to
+ * multiples of the period of the token sequence. Returns the index of the first edge of the smallest
+ * representation.
+ */
+static int smallestRotation(struct BlockOrientation* o, int* scratch) {
+	int first = leastRotation(o->token, o->n, scratch);
+	int period = rotationPeriod(o->token, o->n, scratch);
+	int best = first;
+
+	for (int s=first+period; s<first+o->n; s+=period) {
+		if (compareDiagonalsOfRotations(o, s % o->n, best) < 0) {
+			best = s % o->n;
+		}
+	}
+	return best;
+}
+
+
+/**
+ * Fill the diagonal arrays of o. position[i] is the index of vertex i of the hamiltonian cycle in o.
+ * The lengths are sorted by counting sort. scratch must have space for n + 1 + 2 * nDiagonals ints.
+ */
+static void setOrientationDiagonals(struct BlockOrientation* o, int* from, int* to, char** labels, int nDiagonals, int* position, int* scratch) {
+	int n = o->n;
+	int* count = scratch;
+	int* byLength = scratch + n + 1;
+	int i;
+
+	for (i=0; i<=n; ++i) {
+		count[i] = 0;
+	}
+	/* entry 2i is diagonal i at from[i], entry 2i+1 is diagonal i at to[i] */
+	for (i=0; i<2*nDiagonals; ++i) {
+		int v = position[(i % 2) ? to[i/2] : from[i/2]];
+		int w = position[(i % 2) ? from[i/2] : to[i/2]];
+		++count[mod(w - v, n)];
+	}
+	for (i=1; i<=n; ++i) {
+		count[i] += count[i-1];
+	}
+	for (i=2*nDiagonals-1; i>=0; --i) {
+		int v = position[(i % 2) ? to[i/2] : from[i/2]];
+		int w = position[(i % 2) ? from[i/2] : to[i/2]];
+		byLength[--count[mod(w - v, n)]] = i;
+	}
+
+	for (i=0; i<=n; ++i) {
+		o->diagonalStart[i] = 0;
+	}
+	for (i=0; i<2*nDiagonals; ++i) {
+		++o->diagonalStart[position[(i % 2) ? to[i/2] : from[i/2]] + 1];
+	}
+	for (i=0; i<n; ++i) {
+		o->diagonalStart[i+1] += o->diagonalStart[i];
+		count[i] = o->diagonalStart[i];
+	}
+	for (int j=0; j<2*nDiagonals; ++j) {
+		i = byLength[j];
+		int v = position[(i % 2) ? to[i/2] : from[i/2]];
+		int w = position[(i % 2) ? from[i/2] : to[i/2]];
+		o->diagonalLength[count[v]] = mod(w - v, n);
+		o->diagonalLabel[count[v]] = labels[i/2];
+		++count[v];
+	}
+}
+
+
+/**
+ * Compute the canonical string of an outerplanar block given as hamiltonian cycle and list of diagonals.
+ * The result is the same as the one of canonicalStringOfOuterplanarBlockQuadratic(), but the labels are
+ * replaced by integer ranks and the candidate rotations of each orientation of the hamiltonian cycle are
+ * found by Booth's minimal rotation algorithm. Only rotations with equal hamiltonian cycles are compared
+ * with respect to their diagonals.
+ *
+ * hamiltonianCycle and diagonals are consumed. The ->d values of the vertices are changed.
+ */
+struct ShallowGraph* canonicalStringOfOuterplanarBlock(struct ShallowGraph* hamiltonianCycle, struct ShallowGraph* diagonals, struct ShallowGraphPool* sgp) {
+	struct BlockOrientation forward;
+	struct BlockOrientation backward;
+	struct ShallowGraph* result;
+	struct ShallowGraph* inverse;
+	struct RankedLabel* labels;
+	struct VertexList* idx;
+	int n = hamiltonianCycle->m;
+	int nDiagonals = diagonals->m;
+	int* edgeRank;
+	int* vertexRank;
+	int* from;
+	int* to;
+	char** diagonalLabels;
+	int* position;
+	int* scratch;
+	int* intBuffer;
+	char** labelBuffer;
+	int bestForward;
+	int bestBackward;
+	int i, cmp;
+
+	/* special case. if block is a cycle, return the canonical string of that cycle */
+	if (nDiagonals == 0) {
+		dumpShallowGraph(sgp, diagonals);
+		return getCyclePatterns(hamiltonianCycle, sgp);
+	}
+
+	inverse = inverseCycle(hamiltonianCycle, sgp);
+
+	/* get all arrays at once */
+	labels = malloc(2 * n * sizeof(struct RankedLabel));
+	intBuffer = malloc((8 * n + 9 * nDiagonals + 3) * sizeof(int));
+	labelBuffer = malloc(5 * nDiagonals * sizeof(char*));
+	forward.edges = malloc(2 * n * sizeof(struct VertexList*));
+	forward.token = malloc(2 * n * sizeof(long int));
+	backward.edges = forward.edges + n;
+	backward.token = forward.token + n;
+	edgeRank = intBuffer;
+	vertexRank = edgeRank + n;
+	position = vertexRank + n;
+	from = position + n;
+	to = from + nDiagonals;
+	forward.diagonalStart = to + nDiagonals;
+	backward.diagonalStart = forward.diagonalStart + n + 1;
+	forward.diagonalLength = backward.diagonalStart + n + 1;
+	backward.diagonalLength = forward.diagonalLength + 2 * nDiagonals;
+	scratch = backward.diagonalLength + 2 * nDiagonals;
+	diagonalLabels = labelBuffer;
+	forward.diagonalLabel = diagonalLabels + nDiagonals;
+	backward.diagonalLabel = forward.diagonalLabel + 2 * nDiagonals;
+
+	/* number the vertices along the cycle and rank all labels */
+	for (idx=hamiltonianCycle->edges, i=0; idx; idx=idx->next, ++i) {
+		idx->startPoint->d = i;
+		labels[2*i].label = idx->label;
+		labels[2*i].index = 2*i;
+		labels[2*i+1].label = idx->startPoint->label;
+		labels[2*i+1].index = 2*i+1;
+	}
+	qsort(labels, 2 * n, sizeof(struct RankedLabel), &compareRankedLabels);
+	for (i=0; i<2*n; ++i) {
+		int rank = ((i > 0) && (strcmp(labels[i].label, labels[i-1].label) == 0)) ? labels[i-1].index : i;
+		if (labels[i].index % 2) {
+			vertexRank[labels[i].index / 2] = rank;
+		} else {
+			edgeRank[labels[i].index / 2] = rank;
+		}
+		/* from here on, index stores the rank */
+		labels[i].index = rank;
+	}
+
+	for (idx=diagonals->edges, i=0; idx; idx=idx->next, ++i) {
+		from[i] = idx->startPoint->d;
+		to[i] = idx->endPoint->d;
+		diagonalLabels[i] = idx->label;
+	}
+
+	/* the orientation given by hamiltonianCycle and the inverse one */
+	forward.n = backward.n = n;
+	for (idx=hamiltonianCycle->edges, i=0; idx; idx=idx->next, ++i) {
+		forward.edges[i] = idx;
+		forward.token[i] = (long int)edgeRank[i] * 2 * n + vertexRank[(i + 1) % n];
+	}
+	for (idx=inverse->edges, i=0; idx; idx=idx->next, ++i) {
+		backward.edges[i] = idx;
+		backward.token[i] = (long int)edgeRank[n - 1 - i] * 2 * n + vertexRank[n - 1 - i];
+	}
+
+	for (int o=0; o<2; ++o) {
+		struct BlockOrientation* orientation = o ? &backward : &forward;
+		for (i=0; i<n; ++i) {
+			position[i] = o ? mod(n - i, n) : i;
+		}
+		setOrientationDiagonals(orientation, from, to, diagonalLabels, nDiagonals, position, scratch);
+	}
+
+	/* if the hamiltonian cycles of the smallest representations of both orientations differ, only the
+	 * smaller one needs to be written. Otherwise, the complete strings decide as in
+	 * canonicalStringOfOuterplanarBlockQuadratic() */
+	bestForward = smallestRotation(&forward, scratch);
+	bestBackward = smallestRotation(&backward, scratch);
+	for (i=0, cmp=0; (i<n) && (cmp==0); ++i) {
+		long int tf = forward.token[(bestForward + i) % n];
+		long int tb = backward.token[(bestBackward + i) % n];
+		cmp = (tf < tb) ? -1 : ((tf > tb) ? 1 : 0);
+	}
+	if (cmp < 0) {
+		result = blockStringOfRotation(&forward, bestForward, sgp);
+	} else if (cmp > 0) {
+		result = blockStringOfRotation(&backward, bestBackward, sgp);
+	} else {
+		struct ShallowGraph* result1 = blockStringOfRotation(&forward, bestForward, sgp);
+		struct ShallowGraph* result2 = blockStringOfRotation(&backward, bestBackward, sgp);
+		if (compareVertexLists(result1->edges, result2->edges) < 0) {
+			dumpShallowGraph(sgp, result2);
+			result = result1;
+		} else {
+			dumpShallowGraph(sgp, result1);
+			result = result2;
+		}
+	}
+
+	/* garbage collection */
+	free(labels);
+	free(intBuffer);
+	free(labelBuffer);
+	free(forward.edges);
+	free(forward.token);
+	dumpShallowGraph(sgp, inverse);
+	dumpShallowGraph(sgp, hamiltonianCycle);
+	dumpShallowGraph(sgp, diagonals);
+
+	return result;
+}
+
+
 
 
 /**
@@ -813,17 +1191,41 @@ struct ShallowGraph* __getCycleAndDiagonals(struct Graph* g, struct ShallowGraph
 
 
 struct ShallowGraph* canonicalStringOfOuterplanarGraph(struct ShallowGraph* original, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
-	struct Graph* g = shallowGraphToGraph(original, gp);
-	struct ShallowGraph* hamiltonianCycle = __getCycleAndDiagonals(g, sgp);
-	if (hamiltonianCycle != NULL) {
-		struct ShallowGraph* diagonals = hamiltonianCycle->next;	
-		struct ShallowGraph* cString;
-		hamiltonianCycle->next = NULL;
+	struct OuterplanarBlockTest* t = createOuterplanarBlockTest();
+	struct ShallowGraph* cString = NULL;
+
+	if (getOuterplanarBlockStructureShallow(t, original)) {
+		/* canonicalStringOfOuterplanarBlock needs the cycle and diagonals on vertices without edges */
+		struct Graph* g = createGraph(t->n, gp);
+		struct ShallowGraph* hamiltonianCycle = getShallowGraph(sgp);
+		struct ShallowGraph* diagonals = getShallowGraph(sgp);
+		int i;
+
+		/* __permutateBlock() reads ->d of the first vertex of the cycle before setting it. Keep the
+		 * value Mitchells test leaves there (1 for vertices that had degree two) to obtain the same strings. */
+		for (i=0; i<t->n; ++i) {
+			g->vertices[i]->label = t->vertices[i]->label;
+			g->vertices[i]->d = t->queued[i];
+		}
+		for (i=0; i<t->n; ++i) {
+			struct VertexList* e = getVertexList(sgp->listPool);
+			e->startPoint = g->vertices[t->cycle[i]];
+			e->endPoint = g->vertices[t->cycle[(i + 1) % t->n]];
+			e->label = t->cycleEdges[i]->label;
+			appendEdge(hamiltonianCycle, e);
+		}
+		for (i=0; i<t->nDiagonals; ++i) {
+			struct VertexList* e = getVertexList(sgp->listPool);
+			e->startPoint = g->vertices[t->diagonals[2 * i]];
+			e->endPoint = g->vertices[t->diagonals[2 * i + 1]];
+			e->label = t->diagonalEdges[i]->label;
+			appendEdge(diagonals, e);
+		}
+
 		cString = canonicalStringOfOuterplanarBlock(hamiltonianCycle, diagonals, sgp);
 		dumpGraph(gp, g);
-		return cString;
-	} else {
-		dumpGraph(gp, g);
-		return NULL;
 	}
+
+	freeOuterplanarBlockTest(t);
+	return cString;
 }
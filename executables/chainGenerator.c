@@ -7,6 +7,7 @@
 #include "../graph.h"
 #include "../graphPrinting.h"
 #include "../randomGraphGenerators.h"
+#include "../randomNumberGenerator.h"
 #include "chainGenerator.h"
 
 
@@ -54,11 +55,12 @@ int main(int argc, char** argv) {
 	int nVertexLabels = -1;
 	int nEdgeLabels = 1;
 	int randomSeed = time(NULL);
+	char legacyRandom = 0;
 	double diagonalProbability = 0.0;
 
 	/* parse command line arguments */
 	int arg;
-	const char* validArgs = "hs:a:b:c:d:N:m:p:";
+	const char* validArgs = "hs:Ra:b:c:d:N:m:p:";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		case 'h':
@@ -70,6 +72,9 @@ int main(int argc, char** argv) {
 				return EXIT_FAILURE;
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
 		case 'a':
 			if (sscanf(optarg, "%i", &lowerBoundBlocks) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
@@ -119,7 +124,8 @@ int main(int argc, char** argv) {
 	}
 
 	/* set initial random seed */
-	srand(randomSeed);
+	seedRandomNumberGenerators(randomSeed, legacyRandom);
+	struct RandomNumberGenerator* rng = threadRandomNumberGenerator();
 
 
 	/* init object pools */
@@ -131,9 +137,9 @@ int main(int argc, char** argv) {
 	/* iterate over all graphs in the database */
 	for (i=0; i<numberOfGeneratedGraphs; ++i) {
 		struct Graph* g;
-		int nBlocks = rand() % (upperBoundBlocks - lowerBoundBlocks) + lowerBoundBlocks;
+		int nBlocks = randomIntBelow(rng, upperBoundBlocks - lowerBoundBlocks) + lowerBoundBlocks;
 		/* calculate p, if m option was given */
-		g = blockChainGenerator(nBlocks, blockSize, nVertexLabels, nEdgeLabels, diagonalProbability, gp);
+		g = blockChainGenerator(nBlocks, blockSize, nVertexLabels, nEdgeLabels, diagonalProbability, rng, gp);
 		g->number = i+1;
 		printGraphAidsFormat(g, out);
 	}
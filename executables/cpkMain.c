@@ -6,6 +6,8 @@
 #include "../graph.h"
 #include "../loading.h"
 #include "../cpk.h"
+#include "../patternDictionary.h"
+#include "../sparseFeatureWriter.h"
 #include "../connectedComponents.h"
 #include "cpkMain.h"
 
@@ -28,10 +30,15 @@ void printHelp() {
 	printf("    -output O: write output to stdout\n");
 	printf("        a \"all\" (default) output the feature vector for each graph in the\n"
 		   "            format specified by SVMlight the label of each graph has to be\n"
-		   "            either 0, 1 or -1 to be compliant with the specs of SVMlight.\n");
+		   "            either 0, 1 or -1 to be compliant with the specs of SVMlight.\n"
+		   "            Feature ids are assigned in the order in which patterns first\n"
+		   "            occur; the new cycle patterns of a graph are numbered in\n"
+		   "            lexicographic order of their canonical strings. Cycle pattern\n"
+		   "            ids differ from those of versions that listed each cycle twice.\n");
 	printf("        x output a feature vector that only contains cyclic patterns\n");
 	printf("        y output a feature vector that only contains tree patterns\n");
 	printf("        c returns the number of cycles found in the graph\n");
+	printf("        l returns the number of simple cycles of each length in each graph\n");
 	printf("        t returns the number of trees found in each graph\n");
 	printf("        v returns the number of vertices in each graph\n");
 	printf("        e returns the number of edges in each graph\n\n");
@@ -39,6 +46,19 @@ void printHelp() {
 		   "        t process only connected graphs\n"
 		   "        f (default) process all graphs in the database\n");
 	printf("    -limit N: process the first N graphs in F\n\n");
+	printf("    -maxCycles N: stop listing the simple cycles of a graph after N cycles\n"
+		   "        and print a warning to stderr (default: no limit)\n\n");
+	printf("    -timeout S: stop listing the simple cycles of a graph after S seconds\n"
+		   "        and print a warning to stderr (default: no limit)\n\n");
+	printf("    -dictionary D: take the feature ids from the pattern dictionary file D\n"
+		   "        and append new patterns to it. Ids stay the same across runs on\n"
+		   "        different data. D is created if it does not exist and can be shared\n"
+		   "        by several concurrent runs of cpk, tpk, and ts\n\n");
+	printf("    -featureFormat F: format of the feature vectors of the output options a, x, y\n"
+		   "        text (default) SVMlight format\n"
+		   "        binary CSR matrix, see python/svmlight_loader.py for a reader\n\n");
+	printf("    -threads N: compute the patterns of the graphs with N threads. Graphs are\n"
+		   "        processed in batches, the output is identical for any N (default: 1)\n\n");
 	printf("    -h | --help: display this help\n\n");
 	printf("    ");
 }
@@ -80,6 +100,19 @@ void labelProcessing(struct Graph* g, char p) {
 }
 
 
+/**
+ * Compute and output the features of the graphs in batch in parallel and dump them.
+ */
+static int processBatch(struct Graph** batch, int nBatch, struct CPKWorkers* workers, char outputOption,
+		struct Vertex* globalPatternSet, struct compInfo** results, int* resSize, struct GraphPool* gp) {
+	int status = CyclicPatternKernelBatch(batch, nBatch, workers, outputOption, globalPatternSet, results, resSize, gp);
+	for (int i=0; i<nBatch; ++i) {
+		dumpGraph(gp, batch[i]);
+	}
+	return status;
+}
+
+
 /**
  * Input handling, parsing of database and call of cpk feature extraction method.
  */
@@ -122,6 +155,25 @@ int main(int argc, char** argv) {
 
 		char processOnlyConnected = 0;
 
+		/* limits for cycle enumeration */
+		long int maxCycles = 0;
+		double timeout = 0;
+
+		/* graphs are collected in batches that are processed in parallel */
+		int nThreads = 1;
+		struct CPKWorkers* workers = NULL;
+		struct Graph** batch = NULL;
+		int batchSize = 0;
+		int nBatch = 0;
+
+		/* persistent feature ids */
+		char* dictionaryFile = NULL;
+		struct PatternDictionary* dictionary = NULL;
+		int status = 0;
+
+		/* feature vector output */
+		SparseFeatureFormat featureFormat = sparseText;
+		struct SparseFeatureWriter* featureWriter = NULL;
 
 		/* user input handling */
 		for (param=2; param<argc; param+=2) {
@@ -141,6 +193,27 @@ int main(int argc, char** argv) {
 			if (strcmp(argv[param], "-label") == 0) {
 				labelOption = argv[param+1][0];
 			}
+			if (strcmp(argv[param], "-maxCycles") == 0) {
+				sscanf(argv[param+1], "%li", &maxCycles);
+			}
+			if (strcmp(argv[param], "-timeout") == 0) {
+				sscanf(argv[param+1], "%lf", &timeout);
+			}
+			if (strcmp(argv[param], "-dictionary") == 0) {
+				dictionaryFile = argv[param+1];
+			}
+			if (strcmp(argv[param], "-featureFormat") == 0) {
+				if (!parseSparseFeatureFormat(argv[param+1], &featureFormat)) {
+					fprintf(stderr, "Unknown feature format: %s\n", argv[param+1]);
+					return EXIT_FAILURE;
+				}
+			}
+			if (strcmp(argv[param], "-threads") == 0) {
+				if ((sscanf(argv[param+1], "%i", &nThreads) != 1) || (nThreads < 1)) {
+					fprintf(stderr, "Number of threads must be a positive integer, is: %s\n", argv[param+1]);
+					return EXIT_FAILURE;
+				}
+			}
 			if (strcmp(argv[param], "-connected") == 0) {
 				processOnlyConnected = argv[param+1][0];
 				if (processOnlyConnected == 't') {
@@ -155,12 +228,35 @@ int main(int argc, char** argv) {
 			outputOption = 'a';
 		}
 
+		setCycleEnumerationLimits(maxCycles, timeout);
+
+		if ((outputOption == 'a') || (outputOption == 'x') || (outputOption == 'y')) {
+			featureWriter = createSparseFeatureWriter(stdout, featureFormat, 1);
+			setFeatureWriter(featureWriter);
+		} else if (featureFormat == sparseBinary) {
+			fprintf(stderr, "Binary feature format is only supported by the output options a, x, and y\n");
+			return EXIT_FAILURE;
+		}
+
+		if (dictionaryFile) {
+			if (!(dictionary = openPatternDictionary(dictionaryFile))) {
+				return EXIT_FAILURE;
+			}
+			setPatternDictionary(dictionary);
+		}
+
+		if (nThreads > 1) {
+			workers = createCPKWorkers(nThreads);
+			batchSize = 256 * nThreads;
+			batch = malloc(batchSize * sizeof(struct Graph*));
+		}
+
 		/* try to load a file */
 		createFileIterator(argv[1], gp);
 
 
 		/* iterate over all graphs in the database */
-		while (((i < maxGraphs) || (maxGraphs == -1)) && (g = iterateFile())) {
+		while (((i < maxGraphs) || (maxGraphs == -1)) && (status == 0) && (g = iterateFile())) {
 
 			/* if there was an error reading some graph the returned n will be -1 */
 			if (g->n != -1) {
@@ -186,15 +282,27 @@ int main(int argc, char** argv) {
 					}
 				}
 
+				if (workers) {
+					/* the graph is processed and dumped together with the other graphs in the batch */
+					batch[nBatch] = g;
+					++nBatch;
+					++i;
+					if (nBatch == batchSize) {
+						status = processBatch(batch, nBatch, workers, outputOption, globalPatternSet, &intermediateResults, &imrSize, gp);
+						nBatch = 0;
+					}
+					continue;
+				}
+
 				switch (outputOption) {
 					case 'x':
-						CyclicPatternKernel_onlyCycles(g, sgp, gp, globalPatternSet, &intermediateResults, &imrSize);
+						status = CyclicPatternKernel_onlyCycles(g, sgp, gp, globalPatternSet, &intermediateResults, &imrSize);
 						break;
 					case 'y':
-						CyclicPatternKernel_onlyTrees(g, sgp, gp, globalPatternSet, &intermediateResults, &imrSize);
+						status = CyclicPatternKernel_onlyTrees(g, sgp, gp, globalPatternSet, &intermediateResults, &imrSize);
 						break;
 					default:
-						CyclicPatternKernel(g, sgp, gp, outputOption, globalPatternSet, &intermediateResults, &imrSize);
+						status = CyclicPatternKernel(g, sgp, gp, outputOption, globalPatternSet, &intermediateResults, &imrSize);
 						break;
 				}
 
@@ -209,10 +317,29 @@ int main(int argc, char** argv) {
 			}
 		}
 
+		if (workers) {
+			if (status == 0) {
+				status = processBatch(batch, nBatch, workers, outputOption, globalPatternSet, &intermediateResults, &imrSize, gp);
+			} else {
+				for (int j=0; j<nBatch; ++j) {
+					dumpGraph(gp, batch[j]);
+				}
+			}
+			freeCPKWorkers(workers);
+			free(batch);
+		}
+
+		if (featureWriter) {
+			closeSparseFeatureWriter(featureWriter);
+		}
+
 		/* global garbage collection */
 		free(intermediateResults);
 
 		dumpSearchTree(gp, globalPatternSet);
+		if (dictionary) {
+			closePatternDictionary(dictionary);
+		}
 
 		destroyFileIterator();
 		freeGraphPool(gp);
@@ -225,7 +352,7 @@ int main(int argc, char** argv) {
 			printf("It took %li milliseconds to process the %i graphs\n", (toc - tic) / 1000, i);
 		}
 
-		return EXIT_SUCCESS;
+		return (status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
 }
 
@@ -19,6 +19,7 @@
 #include "../localEasiness.h"
 #include "../sampleSubtrees.h"
 #include "../localEasySubtreeIsomorphism.h"
+#include "../randomNumberGenerator.h"
 #include "filter.h"
 
 
@@ -42,6 +43,215 @@ int printHelp() {
 }
 
 
+/**
+ * Set *filter to the filter with the given name. Return 0 if there is no such filter.
+ */
+char parseFilter(const char* name, Filter* filter) {
+	/* labels */
+	if (strcmp(name, "label") == 0) {
+		*filter = label;
+		return 1;
+	}
+	/* counting */
+	if (strcmp(name, "graphName") == 0) {
+		*filter = graphName;
+		return 1;
+	}
+	if (strcmp(name, "count") == 0) {
+		*filter = count;
+		return 1;
+	}
+	if (strcmp(name, "connected") == 0) {
+		*filter = connected;
+		return 1;
+	}
+	if (strcmp(name, "outerplanar") == 0) {
+		*filter = outerplanar;
+		return 1;
+	}
+	if (strcmp(name, "tree") == 0) {
+		*filter = tree;
+		return 1;
+	}
+	if (strcmp(name, "cactus") == 0) {
+		*filter = cactus;
+		return 1;
+	}
+	if (strcmp(name, "path") == 0) {
+		*filter = path;
+		return 1;
+	}
+	if (strcmp(name, "traceableCactus") == 0) {
+		*filter = traceableCactus;
+		return 1;
+	}
+	if (strcmp(name, "weaklyTraceable") == 0) {
+		*filter = weaklyTraceable;
+		return 1;
+	}
+	if (strcmp(name, "spanningTreeEstimate") == 0) {
+		*filter = spanningTreeEstimate;
+		return 1;
+	}
+	if (strcmp(name, "spanningTreeListing") == 0) {
+		*filter = spanningTreeListing;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicSpanningTrees") == 0) {
+		*filter = nonisomorphicSpanningTrees;
+		return 1;
+	}
+	if (strcmp(name, "sampledSpanningTreesFiltered") == 0) {
+		*filter = sampledSpanningTreesFiltered;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicSampledSpanningTrees") == 0) {
+		*filter = nonisomorphicSampledSpanningTrees;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicLocallySampledSpanningTrees") == 0) {
+		*filter = nonisomorphicLocallySampledSpanningTrees;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicLocallySampledSpanningTreesFiltered") == 0) {
+		*filter = nonisomorphicLocallySampledSpanningTreesFiltered;
+		return 1;
+	}
+	if (strcmp(name, "locallySampledSpanningTrees") == 0) {
+		*filter = locallySampledSpanningTrees;
+		return 1;
+	}
+	if (strcmp(name, "locallySampledSpanningTreesFiltered") == 0) {
+		*filter = locallySampledSpanningTreesFiltered;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicSampledSpanningTreesNormalized") == 0) {
+		*filter = nonisomorphicSampledSpanningTreesNormalized;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicLocallySampledSpanningTreesNormalized") == 0) {
+		*filter = nonisomorphicLocallySampledSpanningTreesNormalized;
+		return 1;
+	}
+	if (strcmp(name, "nonisomorphicLocallySampledSpanningTreesFilteredNormalized") == 0) {
+		*filter = nonisomorphicLocallySampledSpanningTreesFilteredNormalized;
+		return 1;
+	}
+	if (strcmp(name, "locallySampledSpanningTreesNormalized") == 0) {
+		*filter = locallySampledSpanningTreesNormalized;
+		return 1;
+	}
+	if (strcmp(name, "locallySampledSpanningTreesFilteredNormalized") == 0) {
+		*filter = locallySampledSpanningTreesFilteredNormalized;
+		return 1;
+	}
+	if (strcmp(name, "maxBlocksPerComponent") == 0) {
+		*filter = maxBlocksPerComponent;
+		return 1;
+	}
+	if (strcmp(name, "numberOfBlocks") == 0) {
+		*filter = numberOfBlocks;
+		return 1;
+	}
+	if (strcmp(name, "numberOfBridges") == 0) {
+		*filter = numberOfBridges;
+		return 1;
+	}
+	if (strcmp(name, "numberOfBridgeTrees") == 0) {
+		*filter = numberOfBridgeTrees;
+		return 1;
+	}
+	if (strcmp(name, "numberOfSimpleCycles") == 0) {
+		*filter = numberOfSimpleCycles;
+		return 1;
+	}
+	if (strcmp(name, "numberOfNonIsoCycles") == 0) {
+		*filter = numberOfNonIsoCycles;
+		return 1;
+	}
+	if (strcmp(name, "numberOfVertices") == 0) {
+		*filter = numberOfVertices;
+		return 1;
+	}
+	if (strcmp(name, "numberOfBiconnectedComponents") == 0) {
+		*filter = numberOfBiconnectedComponents;
+		return 1;
+	}
+	if (strcmp(name, "numberOfConnectedComponents") == 0) {
+		*filter = numberOfConnectedComponents;
+		return 1;
+	}
+	if (strcmp(name, "numberOfEdges") == 0) {
+		*filter = numberOfEdges;
+		return 1;
+	}
+	if ((strcmp(name, "maxCycleDegree") == 0) ||
+		(strcmp(name, "maxBlockDegree") == 0)) {
+		*filter = maxBlockDegree;
+		return 1;
+	}
+	if ((strcmp(name, "minCycleDegree") == 0) ||
+		(strcmp(name, "minBlockDegree") == 0)) {
+		*filter = minBlockDegree;
+		return 1;
+	}
+	if (strcmp(name, "minLocalEasiness") == 0) {
+		*filter = minLocalEasiness;
+		return 1;
+	}
+	if (strcmp(name, "maxLocalEasiness") == 0) {
+		*filter = maxLocalEasiness;
+		return 1;
+	}
+	if (strcmp(name, "maxDegree") == 0) {
+		*filter = maxDegree;
+		return 1;
+	}
+	if (strcmp(name, "minDegree") == 0) {
+		*filter = minDegree;
+		return 1;
+	}
+	if (strcmp(name, "randomSample") == 0) {
+		*filter = randomSample;
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * Parse a comma separated list of filter names to a newly allocated array.
+ * Return the number of filters or 0 if some filter name is unknown.
+ */
+int parseFilters(const char* names, Filter** filters) {
+	char* copy = malloc((strlen(names) + 1) * sizeof(char));
+	int nFilters = 1;
+	strcpy(copy, names);
+	for (const char* c=names; *c!='\0'; ++c) {
+		if (*c == ',') {
+			++nFilters;
+		}
+	}
+	*filters = malloc(nFilters * sizeof(Filter));
+
+	int i = 0;
+	for (char* name=strtok(copy, ","); name!=NULL; name=strtok(NULL, ",")) {
+		if (!parseFilter(name, &((*filters)[i]))) {
+			fprintf(stderr, "Unknown filter: %s\n", name);
+			free(copy);
+			return 0;
+		}
+		++i;
+	}
+	free(copy);
+	if (i != nFilters) {
+		fprintf(stderr, "Empty filter name in: %s\n", names);
+		return 0;
+	}
+	return nFilters;
+}
+
+
 /**
  * Input handling, parsing of database and call of opk feature extraction method.
  */
@@ -61,193 +271,30 @@ int main(int argc, char** argv) {
 	FILE* out = stdout;
 
 	/* user set variables to specify what needs to be done */
-	Filter filter = count;
+	Filter* filters = NULL;
+	int nFilters = 0;
 	Comparator comparator = pass;
 	OutputOption oOption = graph;
 	int value = -1;
 	/* can be set via -a. Used e.g. by spanningTreeListing filter, and randomSample*/
 	int additionalParameter = 100;
 	int randomSeed = time(NULL);
+	char legacyRandom = 0;
 
 	/* parse command line arguments */
 	int arg;
-	const char* validArgs = "hf:c:v:o:a:r:";
+	const char* validArgs = "hf:c:v:o:a:r:R";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		case 'h':
 			printHelp();
 			return EXIT_SUCCESS;
 		case 'f':
-			/* labels */
-			if (strcmp(optarg, "label") == 0) {
-				filter = label;
-				break;
-			}
-			/* counting */
-			if (strcmp(optarg, "graphName") == 0) {
-				filter = graphName;
-				break;
-			}
-			if (strcmp(optarg, "count") == 0) {
-				filter = count;
-				break;
-			}
-			if (strcmp(optarg, "connected") == 0) {
-				filter = connected;
-				break;
-			}
-			if (strcmp(optarg, "outerplanar") == 0) {
-				filter = outerplanar;
-				break;
-			}
-			if (strcmp(optarg, "tree") == 0) {
-				filter = tree;
-				break;
-			}
-			if (strcmp(optarg, "cactus") == 0) {
-				filter = cactus;
-				break;
-			}
-			if (strcmp(optarg, "path") == 0) {
-				filter = path;
-				break;
-			}
-			if (strcmp(optarg, "traceableCactus") == 0) {
-				filter = traceableCactus;
-				break;
-			}
-			if (strcmp(optarg, "weaklyTraceable") == 0) {
-				filter = weaklyTraceable;
-				break;
-			}
-			if (strcmp(optarg, "spanningTreeEstimate") == 0) {
-				filter = spanningTreeEstimate;
-				break;
-			}
-			if (strcmp(optarg, "spanningTreeListing") == 0) {
-				filter = spanningTreeListing;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicSpanningTrees") == 0) {
-				filter = nonisomorphicSpanningTrees;
-				break;
-			}
-			if (strcmp(optarg, "sampledSpanningTreesFiltered") == 0) {
-				filter = sampledSpanningTreesFiltered;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicSampledSpanningTrees") == 0) {
-				filter = nonisomorphicSampledSpanningTrees;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicLocallySampledSpanningTrees") == 0) {
-				filter = nonisomorphicLocallySampledSpanningTrees;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicLocallySampledSpanningTreesFiltered") == 0) {
-				filter = nonisomorphicLocallySampledSpanningTreesFiltered;
-				break;
-			}
-			if (strcmp(optarg, "locallySampledSpanningTrees") == 0) {
-				filter = locallySampledSpanningTrees;
-				break;
-			}
-			if (strcmp(optarg, "locallySampledSpanningTreesFiltered") == 0) {
-				filter = locallySampledSpanningTreesFiltered;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicSampledSpanningTreesNormalized") == 0) {
-				filter = nonisomorphicSampledSpanningTreesNormalized;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicLocallySampledSpanningTreesNormalized") == 0) {
-				filter = nonisomorphicLocallySampledSpanningTreesNormalized;
-				break;
-			}
-			if (strcmp(optarg, "nonisomorphicLocallySampledSpanningTreesFilteredNormalized") == 0) {
-				filter = nonisomorphicLocallySampledSpanningTreesFilteredNormalized;
-				break;
-			}
-			if (strcmp(optarg, "locallySampledSpanningTreesNormalized") == 0) {
-				filter = locallySampledSpanningTreesNormalized;
-				break;
-			}
-			if (strcmp(optarg, "locallySampledSpanningTreesFilteredNormalized") == 0) {
-				filter = locallySampledSpanningTreesFilteredNormalized;
-				break;
-			}
-			if (strcmp(optarg, "maxBlocksPerComponent") == 0) {
-				filter = maxBlocksPerComponent;
-				break;
-			}
-			if (strcmp(optarg, "numberOfBlocks") == 0) {
-				filter = numberOfBlocks;
-				break;
-			}
-			if (strcmp(optarg, "numberOfBridges") == 0) {
-				filter = numberOfBridges;
-				break;
-			}
-			if (strcmp(optarg, "numberOfBridgeTrees") == 0) {
-				filter = numberOfBridgeTrees;
-				break;
-			}
-			if (strcmp(optarg, "numberOfSimpleCycles") == 0) {
-				filter = numberOfSimpleCycles;
-				break;
-			}
-			if (strcmp(optarg, "numberOfNonIsoCycles") == 0) {
-				filter = numberOfNonIsoCycles;
-				break;
-			}
-			if (strcmp(optarg, "numberOfVertices") == 0) {
-				filter = numberOfVertices;
-				break;
-			}
-			if (strcmp(optarg, "numberOfBiconnectedComponents") == 0) {
-				filter = numberOfBiconnectedComponents;
-				break;
-			}
-			if (strcmp(optarg, "numberOfConnectedComponents") == 0) {
-				filter = numberOfConnectedComponents;
-				break;
-			}
-			if (strcmp(optarg, "numberOfEdges") == 0) {
-				filter = numberOfEdges;
-				break;
-			}
-			if ((strcmp(optarg, "maxCycleDegree") == 0) ||
-				(strcmp(optarg, "maxBlockDegree") == 0)) {
-				filter = maxBlockDegree;
-				break;
-			}
-			if ((strcmp(optarg, "minCycleDegree") == 0) ||
-				(strcmp(optarg, "minBlockDegree") == 0)) {
-				filter = minBlockDegree;
-				break;
-			}
-			if (strcmp(optarg, "minLocalEasiness") == 0) {
-				filter = minLocalEasiness;
-				break;
-			}
-			if (strcmp(optarg, "maxLocalEasiness") == 0) {
-				filter = maxLocalEasiness;
-				break;
-			}
-			if (strcmp(optarg, "maxDegree") == 0) {
-				filter = maxDegree;
-				break;
-			}
-			if (strcmp(optarg, "minDegree") == 0) {
-				filter = minDegree;
-				break;
-			}
-			if (strcmp(optarg, "randomSample") == 0) {
-				filter = randomSample;
-				break;
+			free(filters);
+			nFilters = parseFilters(optarg, &filters);
+			if (nFilters == 0) {
+				return EXIT_FAILURE;
 			}
-			fprintf(stderr, "Unknown filter: %s\n", optarg);
-			return EXIT_FAILURE;
 			break;
 		case 'c':
 			if (strcmp(optarg, "==") == 0) {
@@ -295,6 +342,9 @@ int main(int argc, char** argv) {
 				return EXIT_FAILURE;
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
 		case 'o':
 			if ((strcmp(optarg, "graph") == 0) || (strcmp(optarg, "g") == 0)) {
 				oOption = graph;
@@ -325,8 +375,15 @@ int main(int argc, char** argv) {
 		}
 	}
 
+	/* default filter */
+	if (filters == NULL) {
+		filters = malloc(sizeof(Filter));
+		filters[0] = count;
+		nFilters = 1;
+	}
+
 	/* set initial random seed */
-	srand(randomSeed);
+	seedRandomNumberGenerators(randomSeed, legacyRandom);
 
 	/* init object pools */
 	lp = createListPool(10000);
@@ -354,7 +411,7 @@ int main(int argc, char** argv) {
 		/* if there was an error reading some graph the returned n will be -1 */
 		if (g->n != -1) {
 			
-			processGraph(i, g, filter, comparator, value, additionalParameter, out, oOption, sgp, gp);
+			processGraph(i, g, filters, nFilters, comparator, value, additionalParameter, out, oOption, sgp, gp);
 
 			/***** do not alter ****/
 
@@ -375,6 +432,7 @@ int main(int argc, char** argv) {
 
 	/* global garbage collection */
 	destroyFileIterator();
+	free(filters);
 	freeGraphPool(gp);
 	freeShallowGraphPool(sgp);
 	freeListPool(lp);
@@ -383,8 +441,26 @@ int main(int argc, char** argv) {
 	return EXIT_SUCCESS;
 }	
 
-void processGraph(int i, struct Graph* g, Filter filter, Comparator comparator, int value, int additionalParameter, FILE* out, OutputOption oOption, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
+/**
+Evaluate all filters on g. The comparison is done for the first filter only, and all measures are output.
+Measures that need the biconnected components of g share the decomposition cached with g (see getBlockDecomposition()),
+hence g is decomposed only once.
+*/
+void processGraph(int i, struct Graph* g, Filter* filters, int nFilters, Comparator comparator, int value, int additionalParameter, FILE* out, OutputOption oOption, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
+	int measures[nFilters];
+	for (int f=0; f<nFilters; ++f) {
+		measures[f] = computeMeasure(i, g, filters[f], additionalParameter, sgp, gp);
+	}
+
+	if (conditionHolds(measures[0], value, comparator)) {
+		output(g, measures, nFilters, oOption, out);
+	}
+}
+
+
+int computeMeasure(int i, struct Graph* g, Filter filter, int additionalParameter, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
 	int measure = -1;
+	struct RandomNumberGenerator* rng = threadRandomNumberGenerator();
 	switch (filter) {
 
 	/* counts */ 
@@ -396,7 +472,7 @@ void processGraph(int i, struct Graph* g, Filter filter, Comparator comparator,
 		measure = g->number;
 		break;
 	case randomSample:
-		measure = rand() % 1000;
+		measure = randomIntBelow(rng, 1000);
 		break;
 	/* labels */
 	case label:
@@ -444,16 +520,16 @@ void processGraph(int i, struct Graph* g, Filter filter, Comparator comparator,
 		measure = getNumberOfDifferentSpanningForestComponentsForKSamples(g, additionalParameter, gp, sgp);
 		break;
 	case nonisomorphicLocallySampledSpanningTrees:
-		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, gp, sgp);
+		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, rng, gp, sgp);
 		break;
 	case nonisomorphicLocallySampledSpanningTreesFiltered:
-		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, gp, sgp);
+		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, rng, gp, sgp);
 		break;
 	case locallySampledSpanningTrees:
-		measure = getNumberOfSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, gp, sgp);
+		measure = getNumberOfSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, rng, gp, sgp);
 		break;
 	case locallySampledSpanningTreesFiltered:
-		measure = getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, gp, sgp);
+		measure = getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, rng, gp, sgp);
 		break;
 
 	case nonisomorphicSampledSpanningTreesNormalized:
@@ -461,19 +537,19 @@ void processGraph(int i, struct Graph* g, Filter filter, Comparator comparator,
 		measure /= getAndMarkConnectedComponents(g);
 		break;
 	case nonisomorphicLocallySampledSpanningTreesNormalized:
-		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, gp, sgp);
+		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, rng, gp, sgp);
 		measure /= getAndMarkConnectedComponents(g);
 		break;
 	case nonisomorphicLocallySampledSpanningTreesFilteredNormalized:
-		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, gp, sgp);
+		measure = getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, rng, gp, sgp);
 		measure /= getAndMarkConnectedComponents(g);
 		break;
 	case locallySampledSpanningTreesNormalized:
-		measure = getNumberOfSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, gp, sgp);
+		measure = getNumberOfSpanningTreesObtainedByLocalEasySampling(g, additionalParameter, rng, gp, sgp);
 		measure /= getAndMarkConnectedComponents(g);
 		break;
 	case locallySampledSpanningTreesFilteredNormalized:
-		measure = getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, gp, sgp);
+		measure = getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(g, additionalParameter, rng, gp, sgp);
 		measure /= getAndMarkConnectedComponents(g);
 		break;
 
@@ -526,10 +602,7 @@ void processGraph(int i, struct Graph* g, Filter filter, Comparator comparator,
 		measure = getMinLocalEasiness(g, additionalParameter, gp, sgp);
 		break;
 	}
-
-	if (conditionHolds(measure, value, comparator)) {
-		output(g, measure, oOption, out);
-	}
+	return measure;
 }
 
 
@@ -566,16 +639,23 @@ char conditionHolds(int measure, int threshold, Comparator comparator) {
 }
 
 
-void output(struct Graph* g, int measure, OutputOption option, FILE* out) {
+void output(struct Graph* g, int* measures, int nMeasures, OutputOption option, FILE* out) {
 	switch (option) {
 	case graph:
 		writeCurrentGraph(out);
 		break;
 	case onlyValue:
-		fprintf(out, "%i\n", measure);
+		for (int f=0; f<nMeasures; ++f) {
+			fprintf(out, f == 0 ? "%i" : " %i", measures[f]);
+		}
+		fputc('\n', out);
 		break;
 	case idAndValue:
-		fprintf(out, "%i %i\n", g->number, measure);
+		fprintf(out, "%i", g->number);
+		for (int f=0; f<nMeasures; ++f) {
+			fprintf(out, " %i", measures[f]);
+		}
+		fputc('\n', out);
 		break;
 	case id:
 		fprintf(out, "%i\n", g->number);
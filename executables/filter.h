@@ -73,7 +73,10 @@ typedef enum {
 
 } Filter;
 
-void processGraph(int i, struct Graph* g, Filter filter, Comparator comparator, int value, int additionalParameter, FILE* out, OutputOption oOption, struct ShallowGraphPool* sgp, struct GraphPool* gp);
-void output(struct Graph* g, int measure, OutputOption option, FILE* out);
+char parseFilter(const char* name, Filter* filter);
+int parseFilters(const char* names, Filter** filters);
+void processGraph(int i, struct Graph* g, Filter* filters, int nFilters, Comparator comparator, int value, int additionalParameter, FILE* out, OutputOption oOption, struct ShallowGraphPool* sgp, struct GraphPool* gp);
+int computeMeasure(int i, struct Graph* g, Filter filter, int additionalParameter, struct ShallowGraphPool* sgp, struct GraphPool* gp);
+void output(struct Graph* g, int* measures, int nMeasures, OutputOption option, FILE* out);
 
 #endif
@@ -7,6 +7,7 @@
 #include "../loading.h"
 #include "../graphPrinting.h"
 #include "../randomGraphGenerators.h"
+#include "../randomNumberGenerator.h"
 
 
 /**
@@ -59,12 +60,13 @@ int main(int argc, char** argv) {
 	double mParameter = -1;
 	double qParameter = 0.1;
 	int randomSeed = time(NULL);
+	char legacyRandom = 0;
 	Generator generator = erdosrenyi;
 	char outputDot = 0;
 
 	/* parse command line arguments */
 	int arg;
-	const char* validArgs = "ohs:a:b:c:d:N:x:m:p:q:";
+	const char* validArgs = "ohs:Ra:b:c:d:N:x:m:p:q:";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		// common / global variables
@@ -77,6 +79,9 @@ int main(int argc, char** argv) {
 				return EXIT_FAILURE;
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
 		case 'a':
 			if (sscanf(optarg, "%i", &lowerBoundVertices) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
@@ -174,7 +179,8 @@ int main(int argc, char** argv) {
 	}
 
 	/* set initial random seed */
-	srand(randomSeed);
+	seedRandomNumberGenerators(randomSeed, legacyRandom);
+	struct RandomNumberGenerator* rng = threadRandomNumberGenerator();
 
 
 	/* init object pools */
@@ -187,7 +193,7 @@ int main(int argc, char** argv) {
 
 	/* iterate over all graphs in the database */
 	for (i=0; i<numberOfGeneratedGraphs; ++i) {
-		int n = rand() % (upperBoundVertices - lowerBoundVertices) + lowerBoundVertices;
+		int n = randomIntBelow(rng, upperBoundVertices - lowerBoundVertices) + lowerBoundVertices;
 
 		/* calculate p, if m option was given */
 		switch (generator) {
@@ -196,40 +202,40 @@ int main(int argc, char** argv) {
 			if ((mParameter > 0) && (n > 1)) {
 				pParameter = ( 2.0 * mParameter ) / (n - 1.0);
 			}
-			g = erdosRenyiWithLabels(n, pParameter, nVertexLabels, nEdgeLabels, gp);
+			g = erdosRenyiWithLabels(n, pParameter, nVertexLabels, nEdgeLabels, rng, gp);
 			break;
 		case overlap:
-			g = randomOverlapGraphWithLabels(n, pParameter, nVertexLabels, gp);
+			g = randomOverlapGraphWithLabels(n, pParameter, nVertexLabels, rng, gp);
 			break;
 		case iterativeoverlap:
 			if (i == 0) {
-				g = randomOverlapGraphWithLabels(n, pParameter, nVertexLabels, gp);
+				g = randomOverlapGraphWithLabels(n, pParameter, nVertexLabels, rng, gp);
 			} else {
-				moveOverlapGraph(g, mParameter, pParameter, gp);
+				moveOverlapGraph(g, mParameter, pParameter, rng, gp);
 			}
 			break;
 		case clusteredOverlap:
-			g = randomClusteredOverlapGraphWithLabels(n, pParameter, nVertexLabels, qParameter, gp);
+			g = randomClusteredOverlapGraphWithLabels(n, pParameter, nVertexLabels, qParameter, rng, gp);
 			break;
 		case iterativeClusteredOverlap:
 			if (i == 0) {
-				g = randomClusteredOverlapGraphWithLabels(n, pParameter, nVertexLabels, qParameter, gp);
+				g = randomClusteredOverlapGraphWithLabels(n, pParameter, nVertexLabels, qParameter, rng, gp);
 			} else {
-				moveOverlapGraph(g, mParameter, pParameter, gp);
+				moveOverlapGraph(g, mParameter, pParameter, rng, gp);
 			}
 			break;
 		case barabasialbert:
-			core = erdosRenyiWithLabels((int)pParameter, 0, 1, 1, gp);
+			core = erdosRenyiWithLabels((int)pParameter, 0, 1, 1, rng, gp);
 //			core = blockChainGenerator(1, (int)edgeProbability, 1, 1, 0, gp);
 			makeMinDegree1(core, gp);
-			g = barabasiAlbert(n, (int)pParameter, core, gp);
+			g = barabasiAlbert(n, (int)pParameter, core, rng, gp);
 			dumpGraph(gp, core);
 			break;
 		case barabasialbertalpha:
-			core = erdosRenyiWithLabels((int)pParameter, 0, 1, 1, gp);
+			core = erdosRenyiWithLabels((int)pParameter, 0, 1, 1, rng, gp);
 //			core = blockChainGenerator(1, (int)edgeProbability, 1, 1, 0, gp);
 			makeMinDegree1(core, gp);
-			g = barabasiAlpha(n, (int)pParameter, 0.95, core, gp);
+			g = barabasiAlpha(n, (int)pParameter, 0.95, core, rng, gp);
 			dumpGraph(gp, core);
 			break;
 		case chains:
@@ -4,9 +4,11 @@
 #include <string.h>
 #include <time.h>
 
+#include "../loading.h"
 #include "../lwm_embeddingOperators.h"
 #include "../lwm_initAndCollect.h"
 #include "../lwm_miningAndExtension.h"
+#include "../randomNumberGenerator.h"
 
 #include "levelwiseGraphMiningMain.h"
 
@@ -48,14 +50,18 @@ int main(int argc, char** argv) {
 	int threshold = 1000;
 	unsigned int maxPatternSize = 20;
 
-	// init random generator according to current time
-	srand(time(NULL));
+	// random seed, defaults to the current time
+	int seed = time(NULL);
+	char legacyRandom = 0;
+
+	// threads that parse the input database
+	int loadingThreads = 1;
 
 	// initializator for the mining
-	size_t (*initMining)(size_t, double, struct Vertex**, struct SupportSet**, struct ShallowGraph**, void**, FILE*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &initFrequentTreeMiningForForestDB;
+	size_t (*initMining)(size_t, double, struct Vertex**, struct SupportSet**, struct ShallowGraph**, void**, struct SparseFeatureWriter*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &initFrequentTreeMiningForForestDB;
 
 	// mining strategy
-	void (*miningStrategy)(size_t, size_t, size_t, struct Vertex*, struct SupportSet*, struct ShallowGraph*, struct SubtreeIsoDataStore (*)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*), double, FILE*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &BFSStrategy;
+	void (*miningStrategy)(size_t, size_t, size_t, struct Vertex*, struct SupportSet*, struct ShallowGraph*, struct SubtreeIsoDataStore (*)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*), double, struct SparseFeatureWriter*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &BFSStrategy;
 
 	// garbage collector after mining
 	void (*garbageCollector)(void** y, struct GraphPool* gp, struct ShallowGraphPool* sgp) = &garbageCollectFrequentTreeMiningForForestDB;
@@ -65,14 +71,14 @@ int main(int argc, char** argv) {
 
 	// other
 	double importance = 0.5;
-	double ingraphThreshold = 1.0;
+	double additionalParameter = 1.0;
 	char* patternFile = NULL;
 	char* featureFile = NULL;
+	SparseFeatureFormat featureFormat = sparseText;
 
 	/* parse command line arguments */
 	int arg;
-	int seed;
-	const char* validArgs = "ht:p:m:o:f:e:i:r:l:";
+	const char* validArgs = "ht:p:m:o:f:e:i:r:l:j:bRs";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		case 'h':
@@ -89,10 +95,21 @@ int main(int argc, char** argv) {
 			if (sscanf(optarg, "%i", &seed) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
 				return EXIT_FAILURE;
-			} else {
-				srand(seed);
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
+		case 's':
+			setShareSampledSpanningTrees(1);
+			break;
+		case 'j':
+			if ((sscanf(optarg, "%i", &loadingThreads) != 1) || (loadingThreads < 0)) {
+				fprintf(stderr, "value must be a nonnegative integer, is: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			setLoadingThreads(loadingThreads);
+			break;
 		case 'p':
 			if (sscanf(optarg, "%u", &maxPatternSize) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
@@ -120,14 +137,15 @@ int main(int argc, char** argv) {
 			}
 			break;
 		case 'l':
-			if (sscanf(optarg, "%lf", &ingraphThreshold) != 1) {
+			if (sscanf(optarg, "%lf", &additionalParameter) != 1) {
 				fprintf(stderr, "value must be float, is: %s\n", optarg);
 				return EXIT_FAILURE;
 			}
-			if (ingraphThreshold <= 0) {
+			if (additionalParameter <= 0) {
 				fprintf(stderr, "value must be larger than zero but is %lf\n", importance);
 			}
-			setInGraphThreshold(ingraphThreshold);
+			setInGraphThreshold(additionalParameter);
+			setLocalEasyCubesLimit((size_t)(additionalParameter * 1024));
 			break;
 		case 'e':
 			// operators for forest transaction databases
@@ -243,6 +261,21 @@ int main(int argc, char** argv) {
 				garbageCollector = &garbageCollectLocalEasyForGraphDB;
 				break;
 			}
+			if (strcmp(optarg, "localEasy_iterative") == 0) {
+				initMining = &initExactLocalEasyForGraphDB;
+				embeddingOperator = &iterativeLocalEasyOperator;
+				garbageCollector = &garbageCollectLocalEasyForGraphDB;
+				break;
+			}
+			if (strcmp(optarg, "bps_iterative") == 0) {
+				initMining = &initSampledLocalEasyForGraphDB;
+				embeddingOperator = &iterativeLocalEasyOperator;
+				if ((int)importance <= 0) {
+					importance = 1;
+				}
+				garbageCollector = &garbageCollectLocalEasyForGraphDB;
+				break;
+			}
 			if ((strcmp(optarg, "localEasyResampling") == 0) ||
 				(strcmp(optarg, "bps_resampling") == 0)) {
 				initMining = &initSampledLocalEasyForGraphDB;
@@ -253,6 +286,14 @@ int main(int argc, char** argv) {
 				garbageCollector = &garbageCollectLocalEasyForGraphDB;
 				break;
 			}
+			// operator for paths in arbitrary graph transaction databases
+			if (strcmp(optarg, "paths") == 0) {
+				initMining = &initPathMining;
+				embeddingOperator = &pathOperator;
+				setMinePathsOnly(1);
+				garbageCollector = &garbageCollectPatternEnumeration;
+				break;
+			}
 			if (strcmp(optarg, "treeEnumeration") == 0) {
 				initMining = &initPatternEnumeration;
 				embeddingOperator = &alwaysReturnTrue;
@@ -267,12 +308,17 @@ int main(int argc, char** argv) {
 		case 'f':
 			featureFile = copyString(optarg);
 			break;
+		case 'b':
+			featureFormat = sparseBinary;
+			break;
 		case '?':
 			return EXIT_FAILURE;
 			break;
 		}
 	}
 
+	seedRandomNumberGenerators(seed, legacyRandom);
+
 	/* init object pools */
 	lp = createListPool(10000);
 	vp = createVertexPool(10000);
@@ -296,7 +342,7 @@ int main(int argc, char** argv) {
 
 	// start frequent subgraph mining
 
-	FILE* featureStream = stdout;
+	FILE* featureFileStream = stdout;
 	FILE* patternStream = stdout;
 	FILE* logStream = stderr;
 
@@ -311,8 +357,8 @@ int main(int argc, char** argv) {
 	}
 
 	if (featureFile != NULL) {
-		featureStream = fopen(featureFile, "w");
-		if (featureStream) {
+		featureFileStream = fopen(featureFile, "w");
+		if (featureFileStream) {
 			fprintf(logStream, "Write patterns to file: %s\n", featureFile);
 		} else {
 			fprintf(logStream, "Could not open feature file for writing: %s\nTerminating\n", featureFile);
@@ -320,6 +366,8 @@ int main(int argc, char** argv) {
 		}
 	}
 
+	struct SparseFeatureWriter* featureStream = createSparseFeatureWriter(featureFileStream, featureFormat, 0);
+
 	struct Vertex* initialFrequentPatterns = NULL;
 	struct SupportSet* supportSets = NULL;
 	struct ShallowGraph* extensionEdgeList = NULL;
@@ -354,6 +402,12 @@ int main(int argc, char** argv) {
 		free(patternFile);
 	}
 
+	closeSparseFeatureWriter(featureStream);
+	if (featureFile != NULL) {
+		fclose(featureFileStream);
+		free(featureFile);
+	}
+
 	/* global garbage collection */
 	freeGraphPool(gp);
 	freeShallowGraphPool(sgp);
@@ -4,12 +4,14 @@
 #include <string.h>
 #include <time.h>
 
+#include "../loading.h"
 #include "../lwm_initAndCollect.h"
 #include "../lwm_embeddingOperators.h"
 
 #include "../lwmr_embeddingOperators.h"
 #include "../lwmr_initAndCollect.h"
 #include "../lwmr_miningAndExtension.h"
+#include "../randomNumberGenerator.h"
 
 #include "levelwiseGraphMiningMain.h"
 
@@ -51,30 +53,32 @@ int main(int argc, char** argv) {
 	int threshold = 1000;
 	unsigned int maxPatternSize = 20;
 
-	// init random generator according to current time
-	srand(time(NULL));
+	// random seed, defaults to the current time
+	int seed = time(NULL);
+	char legacyRandom = 0;
 
 	// initializator for the mining
-	size_t (*initMining)(size_t, double, struct Vertex**, struct SupportSet**, struct ShallowGraph**, void**, FILE*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &initFrequentTreeMiningForForestDB;
+	size_t (*initMining)(size_t, double, struct Vertex**, struct SupportSet**, struct ShallowGraph**, void**, struct SparseFeatureWriter*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &initFrequentTreeMiningForForestDB;
 
 	// mining strategy
-	void (*miningStrategy)(size_t, size_t, size_t, struct Vertex*, struct SupportSet*, struct ShallowGraph*, struct SubtreeIsoDataStore (*)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*), double, FILE*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &BFSStrategyRooted;
+	void (*miningStrategy)(size_t, size_t, size_t, struct Vertex*, struct SupportSet*, struct ShallowGraph*, struct SubtreeIsoDataStore (*)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*), double, struct SparseFeatureWriter*, FILE*, FILE*, struct GraphPool*, struct ShallowGraphPool*) = &BFSStrategyRooted;
 
 	// garbage collector after mining
 	void (*garbageCollector)(void** y, struct GraphPool* gp, struct ShallowGraphPool* sgp) = &garbageCollectFrequentTreeMiningForForestDB;
 
 	// embedding operator
-	struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*) = &rootedSubtreeComputationOperator;
+	struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*) = &rootedSubtreeIterativeOperator;
 
 	// other
 	double importance = 0.5;
+	int nThreads = 1;
 	char* patternFile = NULL;
 	char* featureFile = NULL;
+	SparseFeatureFormat featureFormat = sparseText;
 
 	/* parse command line arguments */
 	int arg;
-	int seed;
-	const char* validArgs = "ht:p:m:o:f:e:i:r:";
+	const char* validArgs = "ht:p:m:o:f:e:i:r:j:bR";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		case 'h':
@@ -91,10 +95,11 @@ int main(int argc, char** argv) {
 			if (sscanf(optarg, "%i", &seed) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
 				return EXIT_FAILURE;
-			} else {
-				srand(seed);
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
 		case 'p':
 			if (sscanf(optarg, "%u", &maxPatternSize) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
@@ -115,6 +120,12 @@ int main(int argc, char** argv) {
 		case 'e':
 			// operators for forest transaction databases
 			if (strcmp(optarg, "rootedTrees") == 0) {
+				initMining = &initFrequentTreeMiningForForestDB;
+				embeddingOperator = &rootedSubtreeIterativeOperator;
+				garbageCollector = &garbageCollectFrequentTreeMiningForForestDB;
+				break;
+			}
+			if (strcmp(optarg, "rootedTrees_noniterative") == 0) {
 				initMining = &initFrequentTreeMiningForForestDB;
 				embeddingOperator = &rootedSubtreeComputationOperator;
 				garbageCollector = &garbageCollectFrequentTreeMiningForForestDB;
@@ -151,18 +162,37 @@ int main(int argc, char** argv) {
 				fprintf(stderr, "value must be larger than zero but is %lf\n", importance);
 			}
 			break;
+		case 'j':
+			if ((sscanf(optarg, "%i", &nThreads) != 1) || (nThreads < 1)) {
+				fprintf(stderr, "value must be a positive integer, is: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
 		case 'o':
 			patternFile = copyString(optarg);
 			break;
 		case 'f':
 			featureFile = copyString(optarg);
 			break;
+		case 'b':
+			featureFormat = sparseBinary;
+			break;
 		case '?':
 			return EXIT_FAILURE;
 			break;
 		}
 	}
 
+	seedRandomNumberGenerators(seed, legacyRandom);
+
+	// hops changes the ->visited values of the transaction graphs, hence threads may not share them
+	if ((nThreads > 1) && (embeddingOperator == &rootedHopsOperator)) {
+		fprintf(stderr, "rootedHops does not support -j, using a single thread\n");
+		nThreads = 1;
+	}
+	setRootedMiningThreads(nThreads);
+	setLoadingThreads(nThreads);
+
 	/* init object pools */
 	lp = createListPool(10000);
 	vp = createVertexPool(10000);
@@ -186,7 +216,7 @@ int main(int argc, char** argv) {
 
 	// start frequent subgraph mining
 
-	FILE* featureStream = stdout;
+	FILE* featureFileStream = stdout;
 	FILE* patternStream = stdout;
 	FILE* logStream = stderr;
 
@@ -201,8 +231,8 @@ int main(int argc, char** argv) {
 	}
 
 	if (featureFile != NULL) {
-		featureStream = fopen(featureFile, "w");
-		if (featureStream) {
+		featureFileStream = fopen(featureFile, "w");
+		if (featureFileStream) {
 			fprintf(logStream, "Write features to file: %s\n", featureFile);
 		} else {
 			fprintf(logStream, "Could not open feature file for writing features : %s\nTerminating\n", featureFile);
@@ -210,6 +240,8 @@ int main(int argc, char** argv) {
 		}
 	}
 
+	struct SparseFeatureWriter* featureStream = createSparseFeatureWriter(featureFileStream, featureFormat, 0);
+
 	struct Vertex* initialFrequentPatterns = NULL;
 	struct SupportSet* supportSets = NULL;
 	struct ShallowGraph* extensionEdgeList = NULL;
@@ -246,6 +278,12 @@ int main(int argc, char** argv) {
 		free(patternFile);
 	}
 
+	closeSparseFeatureWriter(featureStream);
+	if (featureFile != NULL) {
+		fclose(featureFileStream);
+		free(featureFile);
+	}
+
 	/* global garbage collection */
 	freeGraphPool(gp);
 	freeShallowGraphPool(sgp);
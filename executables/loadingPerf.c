@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "../graph.h"
+#include "../loading.h"
+#include "loadingPerf.h"
+
+/**
+ * Measure the throughput of the graph database parser.
+ *
+ * A large synthetic database can be generated with ggen, e.g.
+ *     ggen -N 5000000 -a 20 -b 60 -c 40 -d 4 -m 1.2 -s 1 > big.txt
+ * results in about 2.4GB of graphs.
+ */
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("use as lperf <graph database> [repetitions]\n");
+		printf("\tparses all graphs in the database and prints the throughput in MB/s\n");
+		return EXIT_FAILURE;
+	}
+	int repetitions = (argc > 2) ? atoi(argv[2]) : 1;
+
+	struct stat info;
+	if (stat(argv[1], &info) != 0) {
+		fprintf(stderr, "File %s not found\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	double megabytes = info.st_size / (1024.0 * 1024.0);
+
+	struct ListPool* lp = createListPool(10000);
+	struct VertexPool* vp = createVertexPool(10000);
+	struct GraphPool* gp = createGraphPool(100, vp, lp);
+
+	for (int r=0; r<repetitions; ++r) {
+		struct timespec start;
+		struct timespec end;
+		long nGraphs = 0;
+		long nVertices = 0;
+		long nEdges = 0;
+		struct Graph* g;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		createFileIterator(argv[1], gp);
+		while ((g = iterateFile())) {
+			++nGraphs;
+			nVertices += g->n;
+			nEdges += g->m;
+			dumpGraph(gp, g);
+		}
+		destroyFileIterator();
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+		printf("%.1f MB in %.3f s: %.1f MB/s, %.0f graphs/s (%li graphs, %li vertices, %li edges)\n",
+				megabytes, seconds, megabytes / seconds, nGraphs / seconds, nGraphs, nVertices, nEdges);
+	}
+
+	freeGraphPool(gp);
+	freeListPool(lp);
+	freeVertexPool(vp);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,8 @@
+#ifndef EXECUTABLES_LOADINGPERF_H_
+#define EXECUTABLES_LOADINGPERF_H_
+
+
+int main(int argc, char** argv);
+
+
+#endif /* EXECUTABLES_LOADINGPERF_H_ */
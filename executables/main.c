@@ -13,6 +13,7 @@
 #include "../treeCenter.h"
 #include "../connectedComponents.h"
 #include "../cs_Tree.h"
+#include "../patternDictionary.h"
 #include "main.h" 
 
 char DEBUG_INFO = 1;
@@ -40,7 +41,17 @@ void printHelp() {
 		   "            there are more than depth\n"
 		   "        c return if graph is connected\n"
 		   "        p print the spanning tree patterns of all graphs with\n"
-		   "            less than filter spanning trees\n");
+		   "            less than filter spanning trees\n"
+		   "        f print the spanning tree patterns as in p as feature vectors\n"
+		   "            in SVMlight format. There is one row per graph; graphs that\n"
+		   "            are disconnected or have more than filter spanning trees\n"
+		   "            get a row without features\n");
+	printf("    -dictionary D: take the feature ids of -output f from the pattern\n"
+		   "        dictionary file D and append new patterns to it. D is created if it\n"
+		   "        does not exist (default: ids are only valid for this run)\n");
+	printf("    -featureFormat F: format of the feature vectors of -output f\n"
+		   "        text (default) SVMlight format\n"
+		   "        binary CSR matrix, see python/svmlight_loader.py for a reader\n");
 	printf("    -limit N: process the first N graphs in F (default: process all)\n");
 	printf("    -min M process graphs starting from Mth instance (default 0)\n\n");
 	printf("    -h | --help: display this help\n\n");
@@ -114,6 +125,13 @@ int main(int argc, char** argv) {
 		int maxGraphs = -1;
 		int minGraph = 0;
 
+		/* persistent feature ids */
+		char* dictionaryFile = NULL;
+		struct PatternDictionary* dictionary = NULL;
+		SparseFeatureFormat featureFormat = sparseText;
+		struct SparseFeatureWriter* featureWriter = NULL;
+		int status = 0;
+
 
 		/* user input handling */
 		for (param=2; param<argc; param+=2) {
@@ -139,17 +157,36 @@ int main(int argc, char** argv) {
 			if (strcmp(argv[param], "-min") == 0) {
 				sscanf(argv[param+1], "%i", &minGraph);
 			}
+			if (strcmp(argv[param], "-dictionary") == 0) {
+				dictionaryFile = argv[param+1];
+			}
+			if (strcmp(argv[param], "-featureFormat") == 0) {
+				if (!parseSparseFeatureFormat(argv[param+1], &featureFormat)) {
+					fprintf(stderr, "Unknown feature format: %s\n", argv[param+1]);
+					return EXIT_FAILURE;
+				}
+			}
 		}
 
 		if (outputOption == 0) {
 			outputOption = 'p';
 		}
 
+		if (outputOption == 'f') {
+			if (!(dictionary = openPatternDictionary(dictionaryFile))) {
+				return EXIT_FAILURE;
+			}
+			featureWriter = createSparseFeatureWriter(stdout, featureFormat, 1);
+		} else if (featureFormat == sparseBinary) {
+			fprintf(stderr, "Binary feature format is only supported by -output f\n");
+			return EXIT_FAILURE;
+		}
+
 		/* try to load a file */
 		createFileIterator(argv[1], gp);
 
 		/* iterate over all graphs in the database */
-		while (((i < maxGraphs) || (maxGraphs == -1)) && (g = iterateFile())) {
+		while (((i < maxGraphs) || (maxGraphs == -1)) && (status == 0) && (g = iterateFile())) {
 		
 			/* if there was an error reading some graph the returned n will be -1 */
 			if (g->n != -1) {
@@ -185,36 +222,43 @@ int main(int argc, char** argv) {
 						break;
 
 						case 'p':
-						if (isConnected(g)) {
-							/* getGoodEstimate returns an upper bound on the number of spanning
-							trees in g, or -1 if there was an overflow of long ints while computing */
-							long upperBound = getGoodEstimate(g, sgp, gp);
-							if ((upperBound < depth) && (upperBound != -1)) {
-
-								struct Vertex* searchTree = getVertex(gp->vertexPool);
-
-								struct ShallowGraph* trees = listSpanningTrees(g, sgp, gp);
-
-								struct ShallowGraph* idx;
-								int st = 0;
-								for (idx=trees; idx; idx=idx->next) {	
-									struct Graph* tree = shallowGraphToGraph(idx, gp);
-
-									/* assumes that tree is a tree */
-									struct ShallowGraph* cString = canonicalStringOfTree(tree, sgp);
-									addToSearchTree(searchTree, cString, gp, sgp);
-									++st;
-
-									/* garbage collection */
-									dumpGraph(gp, tree);
+						case 'f':
+						{
+							/* graphs that are not enumerated keep their row of -output f, without features */
+							struct Vertex* searchTree = getVertex(gp->vertexPool);
+							char enumerated = 0;
+							if (isConnected(g)) {
+								/* getGoodEstimate returns an upper bound on the number of spanning
+								trees in g, or -1 if there was an overflow of long ints while computing */
+								long upperBound = getGoodEstimate(g, sgp, gp);
+								if ((upperBound < depth) && (upperBound != -1)) {
+
+									struct ShallowGraph* trees = listSpanningTrees(g, sgp, gp);
+
+									struct ShallowGraph* idx;
+									for (idx=trees; idx; idx=idx->next) {	
+										struct Graph* tree = shallowGraphToGraph(idx, gp);
+
+										/* assumes that tree is a tree */
+										struct ShallowGraph* cString = canonicalStringOfTree(tree, sgp);
+										addToSearchTree(searchTree, cString, gp, sgp);
+
+										/* garbage collection */
+										dumpGraph(gp, tree);
+									}
+									dumpShallowGraphCycle(sgp, trees);
+									enumerated = 1;
 								}
-								dumpShallowGraphCycle(sgp, trees);
+							}
 
+							if (outputOption == 'f') {
+								status = writePatternFeatures(dictionary, searchTree, g->activity, featureWriter);
+							} else if (enumerated) {
 								printf("# %i %i\n", g->number, searchTree->d);
 								printStringsInSearchTree(searchTree, stdout, sgp);
 								fflush(stdout);
-								dumpSearchTree(gp, searchTree);
 							}
+							dumpSearchTree(gp, searchTree);
 						}
 						break;
 					}
@@ -238,6 +282,12 @@ int main(int argc, char** argv) {
 		}
 
 		/* global garbage collection */
+		if (featureWriter) {
+			closeSparseFeatureWriter(featureWriter);
+		}
+		if (dictionary) {
+			closePatternDictionary(dictionary);
+		}
 		destroyFileIterator();
 		freeGraphPool(gp);
 		freeShallowGraphPool(sgp);
@@ -249,6 +299,6 @@ int main(int argc, char** argv) {
 			printf("It took %li milliseconds to process the %i graphs\n", (toc - tic) / 1000, i);
 		}
 
-		return EXIT_SUCCESS;
+		return (status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
 }
@@ -108,37 +108,30 @@ char listHamiltonianCycles(struct ShallowGraph* biconnectedComponents, char exte
     char isFirstCycle = 1; // for pretty printing
     int nonOuterplanarHamiltonianCycles = 0;
     int componentNumber;
+    struct OuterplanarBlockTest* t = createOuterplanarBlockTest();
 
     printf("\"hamiltonianCycles\": {");
 
     for (comp = biconnectedComponents, componentNumber=-1; comp!=NULL; comp=comp->next) {
         if (comp->m > 1) {
-            struct Graph* block = shallowGraphToGraphWithIDs(comp, gp);
-            // returns null if block is not outerplanar
-            struct ShallowGraph* hamiltonianCycle = __getCycleAndDiagonals(block, sgp);
-
-            if (hamiltonianCycle != NULL) {
+            // returns 0 if block is not outerplanar
+            if (getOuterplanarBlockStructureShallow(t, comp)) {
                 if (isFirstCycle) {
                     isFirstCycle = 0;
                 } else {
                     printf(", ");
                 }
-                printf("\"%i\": [%i", componentNumber, originalIDs[hamiltonianCycle->edges->startPoint->lowPoint]);
+                printf("\"%i\": [%i", componentNumber, originalIDs[t->vertices[t->cycle[0]]->number]);
 
-                struct VertexList* e;
-                for (e = hamiltonianCycle->edges->next; e!=NULL; e=e->next) {
-                    printf(", %i", originalIDs[e->startPoint->lowPoint]);
+                for (int i=1; i<t->n; ++i) {
+                    printf(", %i", originalIDs[t->vertices[t->cycle[i]]->number]);
                 }
                 printf("]");
 
-                
-                
-                // cleanup
-                dumpShallowGraphCycle(sgp, hamiltonianCycle);
-
             } else {
                 isOuterplanar = 0;
                 if (extendToHamiltonianBlocks) {
+                    struct Graph* block = shallowGraphToGraphWithIDs(comp, gp);
                     struct Graph* newBlock = shallowGraphToGraphWithIDs(comp, gp);
                     struct Graph* blockCopy = cloneGraph(newBlock, gp);
                     struct ShallowGraph* hamiltonianCycles = listCyclesOfLength(blockCopy, blockCopy->n, sgp);
@@ -165,12 +158,13 @@ char listHamiltonianCycles(struct ShallowGraph* biconnectedComponents, char exte
                         dumpShallowGraphCycle(sgp, hamiltonianCycles);
                     }  
                     dumpGraph(gp, blockCopy);
+                    dumpGraph(gp, block);
                 }
             }
             --componentNumber;
-            dumpGraph(gp, block);
         } 	
     }
+    freeOuterplanarBlockTest(t);
 
     if (isOuterplanar) {
         printf("}, \"isOuterplanar\": true");
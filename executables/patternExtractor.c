@@ -12,7 +12,9 @@
 #include "../localEasySubtreeIsomorphism.h"
 #include "../sampleSubtrees.h"
 #include "../poset_pathCover.h"
+#include "../poset_persistence.h"
 #include "../cs_Parsing.h"
+#include "../randomNumberGenerator.h"
 #include "patternExtractor.h"
 
 
@@ -217,12 +219,12 @@ struct IntSet* computeSubtreeIsomorphisms(struct Graph* g, struct Graph** patter
 	return features;
 }
 
-struct IntSet* computeHOPSTrials(struct Graph* g, int nIterationsPerPattern, struct Graph** patterns, int nPatterns, struct GraphPool* gp) {
+struct IntSet* computeHOPSTrials(struct Graph* g, int nIterationsPerPattern, struct Graph** patterns, int nPatterns, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	struct IntSet* features = getIntSet();
 
 	for (int i=0; i<nPatterns; ++i) {
 		for (int k=0; k<nIterationsPerPattern; ++k) {
-			if (subtreeIsomorphismSamplerWithSampledMaximumMatching(g, patterns[i], gp, 0)) {
+			if (subtreeIsomorphismSamplerWithSampledMaximumMatching(g, patterns[i], rng, gp, 0)) {
 					addIntSortedNoDuplicates(features, i);
 					break;
 				}
@@ -244,11 +246,11 @@ struct IntSet* computeResampledLocalEasyFullEmbedding(struct Graph* g, int nLoca
 }
 
 
-struct IntSet* computeResampledTreeFullEmbedding(struct Graph* g, int nSpanningTrees, struct Graph** patterns, int nPatterns, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+struct IntSet* computeResampledTreeFullEmbedding(struct Graph* g, int nSpanningTrees, struct Graph** patterns, int nPatterns, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	struct IntSet* features = getIntSet();
 
 	for (int i=0; i<nPatterns; ++i) {
-		struct ShallowGraph* spanningTrees = sampleSpanningTreesUsingKruskal(g, nSpanningTrees, gp, sgp);
+		struct ShallowGraph* spanningTrees = sampleSpanningTreesUsingKruskal(g, nSpanningTrees, rng, gp, sgp);
 		for (struct ShallowGraph* spt=spanningTrees; spt!=NULL; spt=spt->next) {
 			struct Graph* sptg = shallowGraphToGraph(spt, gp);
 			if (isSubtree(sptg, patterns[i], gp)) {
@@ -293,6 +295,304 @@ struct IntSet* getTripletFingerprintsTriangulation(struct Graph* g, struct Shall
 	return fingerprints;
 }
 
+/** FNV-1a hash of a label string. NULL labels (i.e. missing edges) hash to 0. */
+static uint32_t labelHash(const char* label) {
+	if (label == NULL) {
+		return 0;
+	}
+	uint32_t hash = 2166136261u;
+	for (; *label!='\0'; ++label) {
+		hash ^= (unsigned char)*label;
+		hash *= 16777619u;
+	}
+	return hash | 1u;
+}
+
+/** splitmix64 finalizer */
+static uint64_t mix64(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ull;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBull;
+	x ^= x >> 31;
+	return x;
+}
+
+static uint32_t hashSequence(uint64_t tag, const uint32_t* sequence, int length) {
+	uint64_t hash = mix64(tag);
+	for (int i=0; i<length; ++i) {
+		hash = mix64(hash ^ sequence[i]);
+	}
+	return (uint32_t)(hash ^ (hash >> 32));
+}
+
+static int compareUint32(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+static int compareNeighbors(const void* a, const void* b) {
+	const int* x = a;
+	const int* y = b;
+	return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+static struct FingerprintGraph getFingerprintGraph(struct Graph* g) {
+	struct FingerprintGraph f;
+	f.n = g->n;
+	f.offsets = malloc((g->n + 1) * sizeof(int));
+	f.vertexLabels = malloc(g->n * sizeof(uint32_t));
+	f.offsets[0] = 0;
+	for (int v=0; v<g->n; ++v) {
+		f.offsets[v+1] = f.offsets[v] + degree(g->vertices[v]);
+		f.vertexLabels[v] = labelHash(g->vertices[v]->label);
+	}
+
+	// collect (neighbor, edge label) pairs and sort them by neighbor
+	int* pairs = malloc(2 * f.offsets[g->n] * sizeof(int));
+	for (int v=0; v<g->n; ++v) {
+		int pos = f.offsets[v];
+		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next, ++pos) {
+			pairs[2 * pos] = e->endPoint->number;
+			pairs[2 * pos + 1] = (int)labelHash(e->label);
+		}
+		qsort(pairs + 2 * f.offsets[v], f.offsets[v+1] - f.offsets[v], 2 * sizeof(int), &compareNeighbors);
+	}
+	f.neighbors = malloc(f.offsets[g->n] * sizeof(int));
+	f.edgeLabels = malloc(f.offsets[g->n] * sizeof(uint32_t));
+	for (int i=0; i<f.offsets[g->n]; ++i) {
+		f.neighbors[i] = pairs[2 * i];
+		f.edgeLabels[i] = (uint32_t)pairs[2 * i + 1];
+	}
+	free(pairs);
+	return f;
+}
+
+static void dumpFingerprintGraph(struct FingerprintGraph f) {
+	free(f.offsets);
+	free(f.neighbors);
+	free(f.edgeLabels);
+	free(f.vertexLabels);
+}
+
+/**
+ * Canonical fingerprint of a path v - u - w of length two whose endpoints are not adjacent.
+ */
+static uint32_t fingerprintWedge(uint32_t uLabel, uint32_t uvLabel, uint32_t vLabel, uint32_t uwLabel, uint32_t wLabel) {
+	uint64_t a = ((uint64_t)uvLabel << 32) | vLabel;
+	uint64_t b = ((uint64_t)uwLabel << 32) | wLabel;
+	uint32_t sequence[5] = {uLabel, 0, 0, 0, 0};
+	if (a > b) {
+		uint64_t tmp = a;
+		a = b;
+		b = tmp;
+	}
+	sequence[1] = (uint32_t)(a >> 32);
+	sequence[2] = (uint32_t)a;
+	sequence[3] = (uint32_t)(b >> 32);
+	sequence[4] = (uint32_t)b;
+	return hashSequence(2, sequence, 5);
+}
+
+/** overwrite best with candidate, if candidate is lexicographically smaller */
+static void keepSmallerSequence(uint32_t* best, const uint32_t* candidate, int length) {
+	for (int i=0; i<length; ++i) {
+		if (candidate[i] != best[i]) {
+			if (candidate[i] < best[i]) {
+				memcpy(best, candidate, length * sizeof(uint32_t));
+			}
+			return;
+		}
+	}
+}
+
+/**
+ * Canonical fingerprint of a triangle with vertex labels l[0], l[1], l[2] and edge labels
+ * e[0] = {0,1}, e[1] = {1,2}, e[2] = {2,0}. The label sequence along the cycle is the lexicographically
+ * smallest of the six sequences obtained by choosing a start vertex and a direction.
+ */
+static uint32_t fingerprintTriangle(const uint32_t* l, const uint32_t* e) {
+	uint32_t best[6] = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+	for (int start=0; start<3; ++start) {
+		int i1 = (start + 1) % 3;
+		int i2 = (start + 2) % 3;
+		uint32_t forward[6] = {l[start], e[start], l[i1], e[i1], l[i2], e[i2]};
+		uint32_t backward[6] = {l[start], e[i2], l[i2], e[i1], l[i1], e[start]};
+		keepSmallerSequence(best, forward, 6);
+		keepSmallerSequence(best, backward, 6);
+	}
+	return hashSequence(3, best, 6);
+}
+
+
+/**
+ * Fast version of getTripletFingerprintsTriangulation() that yields the same feature classes with different
+ * fingerprint values: Each path of length two in g is fingerprinted as triangle, if its endpoints are adjacent,
+ * and as open path, otherwise.
+ *
+ * Triangles are enumerated exactly once by orienting each edge towards its endpoint of higher (degree, id) rank
+ * and intersecting the out-neighborhoods using a marker array. Open paths are enumerated around their center
+ * vertex. Adjacency of their endpoints is tested in constant time by stamping the neighbors of one endpoint.
+ */
+struct IntSet* getTripletFingerprintsTriangulationFast(struct Graph* g) {
+	struct FingerprintGraph f = getFingerprintGraph(g);
+	struct FingerprintBuffer buffer = {0};
+	int n = f.n;
+
+	// rank vertices by degree, breaking ties by id
+	int* order = malloc(2 * n * sizeof(int));
+	int* rank = malloc(n * sizeof(int));
+	for (int v=0; v<n; ++v) {
+		order[2 * v] = f.offsets[v+1] - f.offsets[v];
+		order[2 * v + 1] = v;
+	}
+	// qsort may order vertices of equal degree arbitrarily, but any total order finds each triangle exactly once
+	qsort(order, n, 2 * sizeof(int), &compareNeighbors);
+	for (int i=0; i<n; ++i) {
+		rank[order[2 * i + 1]] = i;
+	}
+
+	int* marker = malloc(n * sizeof(int));
+	int* markedEdge = malloc(n * sizeof(int));
+	for (int v=0; v<n; ++v) {
+		marker[v] = -1;
+	}
+
+	// closed triangles
+	for (int v=0; v<n; ++v) {
+		for (int p=f.offsets[v]; p<f.offsets[v+1]; ++p) {
+			if (rank[f.neighbors[p]] > rank[v]) {
+				marker[f.neighbors[p]] = v;
+				markedEdge[f.neighbors[p]] = p;
+			}
+		}
+		for (int p=f.offsets[v]; p<f.offsets[v+1]; ++p) {
+			int w = f.neighbors[p];
+			if (rank[w] < rank[v]) {
+				continue;
+			}
+			for (int q=f.offsets[w]; q<f.offsets[w+1]; ++q) {
+				int x = f.neighbors[q];
+				if ((rank[x] > rank[w]) && (marker[x] == v)) {
+					uint32_t l[3] = {f.vertexLabels[v], f.vertexLabels[w], f.vertexLabels[x]};
+					uint32_t e[3] = {f.edgeLabels[p], f.edgeLabels[q], f.edgeLabels[markedEdge[x]]};
+					addFingerprint(&buffer, fingerprintTriangle(l, e));
+				}
+			}
+		}
+	}
+
+	// open paths of length two. stamps start at n to be distinguishable from the vertex ids used above
+	int stamp = n;
+	for (int u=0; u<n; ++u) {
+		for (int i=f.offsets[u]; i<f.offsets[u+1]; ++i) {
+			int v = f.neighbors[i];
+			++stamp;
+			for (int q=f.offsets[v]; q<f.offsets[v+1]; ++q) {
+				marker[f.neighbors[q]] = stamp;
+			}
+			for (int j=i+1; j<f.offsets[u+1]; ++j) {
+				int w = f.neighbors[j];
+				if (marker[w] != stamp) {
+					addFingerprint(&buffer, fingerprintWedge(f.vertexLabels[u], f.edgeLabels[i], f.vertexLabels[v], f.edgeLabels[j], f.vertexLabels[w]));
+				}
+			}
+		}
+	}
+
+	free(order);
+	free(rank);
+	free(marker);
+	free(markedEdge);
+	dumpFingerprintGraph(f);
+	return fingerprintBufferToIntSet(&buffer);
+}
+
+
+/**
+ * Fingerprint of the subgraph induced by vertices i, j, k of f. The edges ij, jk, ki are given by
+ * their position in f.neighbors plus one, or zero, if the edge does not exist.
+ * Triples with two or three edges get the same fingerprints as in getTripletFingerprintsTriangulationFast().
+ */
+static uint32_t fingerprintInducedTriple(struct FingerprintGraph* f, int i, int j, int k, int ij, int jk, int ki) {
+	uint32_t l[3] = {f->vertexLabels[i], f->vertexLabels[j], f->vertexLabels[k]};
+	int nEdges = (ij != 0) + (jk != 0) + (ki != 0);
+	uint32_t sequence[3];
+
+	switch (nEdges) {
+	case 3: {
+		uint32_t e[3] = {f->edgeLabels[ij - 1], f->edgeLabels[jk - 1], f->edgeLabels[ki - 1]};
+		return fingerprintTriangle(l, e);
+	}
+	case 2:
+		if (ij == 0) {
+			return fingerprintWedge(l[2], f->edgeLabels[jk - 1], l[1], f->edgeLabels[ki - 1], l[0]);
+		}
+		if (jk == 0) {
+			return fingerprintWedge(l[0], f->edgeLabels[ij - 1], l[1], f->edgeLabels[ki - 1], l[2]);
+		}
+		return fingerprintWedge(l[1], f->edgeLabels[ij - 1], l[0], f->edgeLabels[jk - 1], l[2]);
+	case 1: {
+		// the edge with its sorted endpoint labels and the label of the isolated vertex
+		uint32_t a, b, edge, isolated;
+		if (ij != 0) {
+			a = l[0]; b = l[1]; edge = f->edgeLabels[ij - 1]; isolated = l[2];
+		} else if (jk != 0) {
+			a = l[1]; b = l[2]; edge = f->edgeLabels[jk - 1]; isolated = l[0];
+		} else {
+			a = l[2]; b = l[0]; edge = f->edgeLabels[ki - 1]; isolated = l[1];
+		}
+		uint32_t edgeSequence[4] = {a < b ? a : b, a < b ? b : a, edge, isolated};
+		return hashSequence(4, edgeSequence, 4);
+	}
+	default:
+		memcpy(sequence, l, sizeof(sequence));
+		qsort(sequence, 3, sizeof(uint32_t), &compareUint32);
+		return hashSequence(5, sequence, 3);
+	}
+}
+
+
+/**
+ * Fast version of getTripletFingerprintsBruteForce() that yields the same feature classes with different
+ * fingerprint values. It still enumerates all triples of vertices, but tests adjacency in constant time using
+ * two arrays that store the incident edges of the first two vertices of the current triple.
+ */
+struct IntSet* getTripletFingerprintsBruteForceFast(struct Graph* g) {
+	struct FingerprintGraph f = getFingerprintGraph(g);
+	struct FingerprintBuffer buffer = {0};
+	int n = f.n;
+	int* edgesOfI = calloc(n, sizeof(int));
+	int* edgesOfJ = calloc(n, sizeof(int));
+
+	for (int i=0; i<n-2; ++i) {
+		for (int p=f.offsets[i]; p<f.offsets[i+1]; ++p) {
+			edgesOfI[f.neighbors[p]] = p + 1;
+		}
+		for (int j=i+1; j<n-1; ++j) {
+			for (int p=f.offsets[j]; p<f.offsets[j+1]; ++p) {
+				edgesOfJ[f.neighbors[p]] = p + 1;
+			}
+			for (int k=j+1; k<n; ++k) {
+				addFingerprint(&buffer, fingerprintInducedTriple(&f, i, j, k, edgesOfI[j], edgesOfJ[k], edgesOfI[k]));
+			}
+			for (int p=f.offsets[j]; p<f.offsets[j+1]; ++p) {
+				edgesOfJ[f.neighbors[p]] = 0;
+			}
+		}
+		for (int p=f.offsets[i]; p<f.offsets[i+1]; ++p) {
+			edgesOfI[f.neighbors[p]] = 0;
+		}
+	}
+
+	free(edgesOfI);
+	free(edgesOfJ);
+	dumpFingerprintGraph(f);
+	return fingerprintBufferToIntSet(&buffer);
+}
+
+
 void printIntArrayNoId(int* a, int n) {
 	for (int i=0; i<n; ++i) {
 		printf("%i ", a[i]);
@@ -308,7 +608,7 @@ void printIntArray(int* a, int n, int id) {
 /**
 Return a subset of k numbers from the set 1..n
 see shuffle() */
-int* randomSubset(int n, int k) {
+int* randomSubset(int n, int k, struct RandomNumberGenerator* rng) {
 
 	// create array with number 1..n
 	int* array = malloc(n * sizeof(int));
@@ -319,7 +619,7 @@ int* randomSubset(int n, int k) {
 	// shuffle the array
     if (n > 1) {
         for (int i = n - 1; i > 0; i--) {
-            size_t j = (unsigned int) (rand() % i);
+            size_t j = (unsigned int) randomIntBelow(rng, i);
             int t = array[j];
             array[j] = array[i];
             array[i] = t;
@@ -358,9 +658,35 @@ int* randomSubset(int n, int k) {
 //}
 
 
+static int compareDoubles(const void* a, const void* b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Print the number of answered requests and percentiles of their latencies (in milliseconds).
+ * Sorts the latencies array.
+ */
+static void printLatencyPercentiles(double* latencies, size_t nRequests, FILE* out) {
+	fprintf(out, "requests: %zu\n", nRequests);
+	if (nRequests == 0) {
+		return;
+	}
+	qsort(latencies, nRequests, sizeof(double), &compareDoubles);
+	double percentiles[] = {0.5, 0.9, 0.99, 1.0};
+	char* names[] = {"p50", "p90", "p99", "max"};
+	for (int i=0; i<4; ++i) {
+		// nearest rank
+		size_t rank = (size_t)(percentiles[i] * nRequests + 0.999999);
+		fprintf(out, "%s latency: %.3lfms\n", names[i], latencies[rank > 0 ? rank - 1 : 0]);
+	}
+}
+
+
 int main(int argc, char** argv) {
 
-	typedef enum {triangles, bruteForceTriples,
+	typedef enum {triangles, bruteForceTriples, trianglesLegacy, bruteForceTriplesLegacy,
 		localEasyPatternsFast, localEasyPatternsResampling,
 		treePatternsResampling,
 		hopsPatterns,
@@ -391,27 +717,33 @@ int main(int argc, char** argv) {
 	InputMethod inputMethod = AIDS99_INPUT;
 	size_t absImportance = 5;
 	double relImportance = 0.5;
+	char* planInFile = NULL;
+	char* planOutFile = NULL;
+	char serverMode = 0;
+	SparseFeatureFormat featureFormat = sparseText;
+	struct PlanFile planFile = {0};
 
 	// init random with system time
-	srand(time(NULL));
+	int seed = time(NULL);
+	char legacyRandom = 0;
 
 	/* parse command line arguments */
 	int arg;
-	const char* validArgs = "hm:f:c:k:i:r:";
+	const char* validArgs = "hm:f:c:k:i:r:Rp:w:sb";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
-		int tmpRndSeed;
 		switch (arg) {
 		case 'h':
 			printHelp();
 			return EXIT_SUCCESS;
 		case 'r':
-			if (sscanf(optarg, "%i", &tmpRndSeed) != 1) {
+			if (sscanf(optarg, "%i", &seed) != 1) {
 				fprintf(stderr, "Random seed must be integer, is: %s\n", optarg);
 				return EXIT_FAILURE;
-			} else {
-				srand(tmpRndSeed);
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
 		case 'f':
 			patternFile = optarg;
 			inputMethod = AIDS99_INPUT;
@@ -420,6 +752,18 @@ int main(int argc, char** argv) {
 			patternFile = optarg;
 			inputMethod = CANONICALSTRING_INPUT;
 			break;
+		case 'p':
+			planInFile = optarg;
+			break;
+		case 'w':
+			planOutFile = optarg;
+			break;
+		case 's':
+			serverMode = 1;
+			break;
+		case 'b':
+			featureFormat = sparseBinary;
+			break;
 		case 'k':
 			if (sscanf(optarg, "%zu", &sketchSize) != 1) {
 				fprintf(stderr, "Hash size argument must be unsigned integer, is: %s\n", optarg);
@@ -443,6 +787,14 @@ int main(int argc, char** argv) {
 				method = bruteForceTriples;
 				break;
 			}
+			if (strcmp(optarg, "trianglesLegacy") == 0) {
+				method = trianglesLegacy;
+				break;
+			}
+			if (strcmp(optarg, "triplesLegacy") == 0) {
+				method = bruteForceTriplesLegacy;
+				break;
+			}
 			if (strcmp(optarg, "treePatterns") == 0) {
 				method = treePatterns;
 				break;
@@ -542,6 +894,15 @@ int main(int argc, char** argv) {
 	}
 
 	// sanity check of input arguments
+	if ((featureFormat == sparseBinary) && serverMode) {
+		fprintf(stderr, "Binary feature output is not supported in server mode\n");
+		return EXIT_FAILURE;
+	}
+	if ((featureFormat == sparseBinary) && ((method == minHashTree) || (method == minHashAbsImportant) || (method == minHashRelImportant) || (method == dotApproxForTrees) || (method == dotApproxLocalEasy))) {
+		fprintf(stderr, "Binary feature output is only supported for sparse feature vectors\n");
+		return EXIT_FAILURE;
+	}
+
 	switch (method) {
 	case minHashAbsImportant:
 	case treePatternsFastAbsImp:
@@ -571,80 +932,22 @@ int main(int argc, char** argv) {
 		break; // do nothing for other methods
 	}
 
-	/* init object pools */
-	lp = createListPool(10000);
-	vp = createVertexPool(10000);
-	sgp = createShallowGraphPool(1000, lp);
-	gp = createGraphPool(100, vp, lp);
-
-	// load pattern database for those methods that require one
+	// methods that evaluate a pattern poset can store and load their evaluation plan
+	int usesPoset = 1;
+	PlanType planType = POSET_PLAN;
 	switch (method) {
-	case treePatterns:
-	case localEasyPatternsResampling:
-	case treePatternsResampling:
-	case treePatternsFast:
-	case hopsPatterns:
-	case localEasyPatternsFast:
-	case treePatternsFastAbsImp:
-	case treePatternsFastRelImp:
 	case minHashTree:
 	case minHashAbsImportant:
 	case minHashRelImportant:
-	case dotApproxForTrees:
-	case dotApproxLocalEasy:
-	case dfsForTrees:
-	case latticePathForTrees:
-	case latticeLongestPathForTrees:
+		planType = MINHASH_PLAN;
+		break;
 	case dilworthsCoverForTrees:
-	case dfsForLocalEasy:
-	case latticePathForLocalEasy:
-	case latticeLongestPathForLocalEasy:
 	case dilworthsCoverForLocalEasy:
-	case weightedLongestPathForTrees:
-		if (patternFile == NULL) {
-			fprintf(stderr, "No pattern file specified! Please do so using -a or -c\n");
-			return EXIT_FAILURE;
-		} else {
-			FILE* patternStream = NULL;
-			switch (inputMethod) {
-			case AIDS99_INPUT:
-				createFileIterator(patternFile, gp);
-				nPatterns = getDB(&patterns);
-				destroyFileIterator();
-				break;
-			case CANONICALSTRING_INPUT:
-				patternStream = fopen(patternFile, "r");
-				nPatterns = getDBfromCanonicalStrings(&patterns, patternStream, CS_STRING_CACHE_SIZE, gp, sgp);
-				fclose(patternStream);
-				break;
-			}
-		}
+		planType = PATHCOVER_PLAN;
 		break;
-	default:
-		break; // do nothing for other methods
-	}
-
-	// preprocessing for those methods that require some
-	struct EvaluationPlan evaluationPlan = {0};
-	int* randomProjection = NULL;
-	switch (method) {
-	// local variables
-	struct Graph* patternPoset;
-	int** permutations;
-	// cases
-	case minHashTree:
-	case minHashAbsImportant:
-	case minHashRelImportant:
-		patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
-		free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
-		permutations = malloc(sketchSize * sizeof(int*));
-		size_t* permutationSizes = malloc(sketchSize * sizeof(size_t));
-		for (size_t i=0; i<sketchSize; ++i) {
-			permutations[i] = getRandomPermutation(nPatterns);
-			permutationSizes[i] = posetPermutationMark(permutations[i], nPatterns, patternPoset);
-			permutations[i] = posetPermutationShrink(permutations[i], nPatterns, permutationSizes[i]);
-		}
-		evaluationPlan = buildMinHashEvaluationPlan(permutations, permutationSizes, sketchSize, patternPoset, gp);
+	case dotApproxForTrees:
+	case dotApproxLocalEasy:
+		planType = PROJECTION_PLAN;
 		break;
 	case treePatternsFast:
 	case localEasyPatternsFast:
@@ -657,32 +960,156 @@ int main(int argc, char** argv) {
 	case latticePathForLocalEasy:
 	case latticeLongestPathForLocalEasy:
 	case weightedLongestPathForTrees:
-		// these methods only need the pattern poset and its reverse
-		patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
-		free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
-		evaluationPlan.poset = patternPoset;
-		evaluationPlan.reversePoset = reverseGraph(patternPoset, gp);
-		break;
-	case dilworthsCoverForTrees:
-	case dilworthsCoverForLocalEasy:
-		// these methods need the pattern poset, its reverse, and the static set of paths for evaluation
-		patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
-		free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
-		evaluationPlan.poset = patternPoset;
-		evaluationPlan.reversePoset = reverseGraph(patternPoset, gp);
-		evaluationPlan.shrunkPermutations = getPathCoverOfPoset(evaluationPlan.poset, &(evaluationPlan.sketchSize), gp, sgp);
-		break;
-	case dotApproxForTrees:
-	case dotApproxLocalEasy:
-		// these methods need pattern poset, its reverse, and a set of random patterns of given size
-		patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
-		free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
-		evaluationPlan.poset = patternPoset;
-		evaluationPlan.reversePoset = reverseGraph(patternPoset, gp);
-		randomProjection = randomSubset(patternPoset->n, sketchSize);
+		planType = POSET_PLAN;
 		break;
 	default:
-		break; // do nothing for other methods
+		usesPoset = 0;
+		break;
+	}
+	if (!usesPoset && ((planInFile != NULL) || (planOutFile != NULL))) {
+		fprintf(stderr, "Evaluation plans (-p, -w) are only supported by methods that use the pattern poset\n");
+		return EXIT_FAILURE;
+	}
+
+	seedRandomNumberGenerators(seed, legacyRandom);
+	struct RandomNumberGenerator* rng = threadRandomNumberGenerator();
+
+	/* init object pools */
+	lp = createListPool(10000);
+	vp = createVertexPool(10000);
+	sgp = createShallowGraphPool(1000, lp);
+	gp = createGraphPool(100, vp, lp);
+
+	// load a stored evaluation plan instead of the pattern database, if given
+	struct EvaluationPlan evaluationPlan = {0};
+	int* randomProjection = NULL;
+	if (planInFile != NULL) {
+		size_t projectionSize = 0;
+		planFile = loadEvaluationPlan(planInFile, &evaluationPlan, &randomProjection, &projectionSize, gp);
+		if (planFile.data == NULL) {
+			return EXIT_FAILURE;
+		}
+		if ((planType != POSET_PLAN) && (planFile.type != planType)) {
+			fprintf(stderr, "Evaluation plan in %s was not built for this method\n", planInFile);
+			return EXIT_FAILURE;
+		}
+		nPatterns = evaluationPlan.poset->n - 1;
+		if (planType == PROJECTION_PLAN) {
+			sketchSize = projectionSize;
+		}
+	} else {
+		// without a stored plan, load patterns and build the plan
+		// load pattern database for those methods that require one
+		switch (method) {
+		case treePatterns:
+		case localEasyPatternsResampling:
+		case treePatternsResampling:
+		case treePatternsFast:
+		case hopsPatterns:
+		case localEasyPatternsFast:
+		case treePatternsFastAbsImp:
+		case treePatternsFastRelImp:
+		case minHashTree:
+		case minHashAbsImportant:
+		case minHashRelImportant:
+		case dotApproxForTrees:
+		case dotApproxLocalEasy:
+		case dfsForTrees:
+		case latticePathForTrees:
+		case latticeLongestPathForTrees:
+		case dilworthsCoverForTrees:
+		case dfsForLocalEasy:
+		case latticePathForLocalEasy:
+		case latticeLongestPathForLocalEasy:
+		case dilworthsCoverForLocalEasy:
+		case weightedLongestPathForTrees:
+			if (patternFile == NULL) {
+				fprintf(stderr, "No pattern file specified! Please do so using -a or -c\n");
+				return EXIT_FAILURE;
+			} else {
+				FILE* patternStream = NULL;
+				switch (inputMethod) {
+				case AIDS99_INPUT:
+					createFileIterator(patternFile, gp);
+					nPatterns = getDB(&patterns);
+					destroyFileIterator();
+					break;
+				case CANONICALSTRING_INPUT:
+					patternStream = fopen(patternFile, "r");
+					nPatterns = getDBfromCanonicalStrings(&patterns, patternStream, CS_STRING_CACHE_SIZE, gp, sgp);
+					fclose(patternStream);
+					break;
+				}
+			}
+			break;
+		default:
+			break; // do nothing for other methods
+		}
+
+		// preprocessing for those methods that require some
+		switch (method) {
+		// local variables
+		struct Graph* patternPoset;
+		int** permutations;
+		// cases
+		case minHashTree:
+		case minHashAbsImportant:
+		case minHashRelImportant:
+			patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
+			free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
+			permutations = malloc(sketchSize * sizeof(int*));
+			size_t* permutationSizes = malloc(sketchSize * sizeof(size_t));
+			for (size_t i=0; i<sketchSize; ++i) {
+				permutations[i] = getRandomPermutation(nPatterns, rng);
+				permutationSizes[i] = posetPermutationMark(permutations[i], nPatterns, patternPoset);
+				permutations[i] = posetPermutationShrink(permutations[i], nPatterns, permutationSizes[i]);
+			}
+			evaluationPlan = buildMinHashEvaluationPlan(permutations, permutationSizes, sketchSize, patternPoset, gp);
+			break;
+		case treePatternsFast:
+		case localEasyPatternsFast:
+		case treePatternsFastAbsImp:
+		case treePatternsFastRelImp:
+		case dfsForTrees:
+		case latticePathForTrees:
+		case latticeLongestPathForTrees:
+		case dfsForLocalEasy:
+		case latticePathForLocalEasy:
+		case latticeLongestPathForLocalEasy:
+		case weightedLongestPathForTrees:
+			// these methods only need the pattern poset and its reverse
+			patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
+			free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
+			evaluationPlan.poset = patternPoset;
+			evaluationPlan.reversePoset = reverseGraph(patternPoset, gp);
+			break;
+		case dilworthsCoverForTrees:
+		case dilworthsCoverForLocalEasy:
+			// these methods need the pattern poset, its reverse, and the static set of paths for evaluation
+			patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
+			free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
+			evaluationPlan.poset = patternPoset;
+			evaluationPlan.reversePoset = reverseGraph(patternPoset, gp);
+			evaluationPlan.shrunkPermutations = getPathCoverOfPoset(evaluationPlan.poset, &(evaluationPlan.sketchSize), gp, sgp);
+			break;
+		case dotApproxForTrees:
+		case dotApproxLocalEasy:
+			// these methods need pattern poset, its reverse, and a set of random patterns of given size
+			patternPoset = buildTreePosetFromGraphDB(patterns, nPatterns, gp, sgp);
+			free(patterns); // we do not need this array any more. the graphs are accessible from patternPoset
+			evaluationPlan.poset = patternPoset;
+			evaluationPlan.reversePoset = reverseGraph(patternPoset, gp);
+			randomProjection = randomSubset(patternPoset->n - 1, sketchSize, rng);
+			break;
+		default:
+			break; // do nothing for other methods
+		}
+	}
+
+	if (planOutFile != NULL) {
+		if (!writeEvaluationPlan(planOutFile, planType, evaluationPlan, randomProjection, sketchSize)) {
+			return EXIT_FAILURE;
+		}
 	}
 
 	/* initialize the stream to read graphs from.
@@ -700,16 +1127,31 @@ int main(int argc, char** argv) {
 		createStdinIterator(gp);
 	}
 
-	/* iterate over all graphs in the database */
-	while ((g = iterateFile())) {
-		/* if there was an error reading some graph the returned n will be -1 */
-		if (g->n != -1) {
+	/* iterate over all graphs in the database.
+	in server mode, each batch of graphs terminated by a line starting with '$' is a request.
+	it is answered by the output for its graphs, followed by a line containing '$' */
+	double* latencies = NULL;
+	size_t nRequests = 0;
+	size_t latencyCapacity = 0;
+	struct SparseFeatureWriter* featureWriter = createSparseFeatureWriter(stdout, featureFormat, 1);
+	char moreRequests = serverMode ? !fileIteratorAtEnd() : 1;
+	while (moreRequests) {
+		struct timespec requestStart;
+		clock_gettime(CLOCK_MONOTONIC, &requestStart);
+
+		while ((g = iterateFile())) {
 			struct IntSet* fingerprints = NULL;
 			switch (method) {
 			case triangles:
-				fingerprints = getTripletFingerprintsTriangulation(g, sgp);
+				fingerprints = getTripletFingerprintsTriangulationFast(g);
 				break;
 			case bruteForceTriples:
+				fingerprints = getTripletFingerprintsBruteForceFast(g);
+				break;
+			case trianglesLegacy:
+				fingerprints = getTripletFingerprintsTriangulation(g, sgp);
+				break;
+			case bruteForceTriplesLegacy:
 				fingerprints = getTripletFingerprintsBruteForce(g, sgp);
 				break;
 			case treePatterns:
@@ -719,13 +1161,13 @@ int main(int argc, char** argv) {
 				fingerprints = computeResampledLocalEasyFullEmbedding(g, absImportance, patterns, nPatterns, gp, sgp);
 				break;
 			case treePatternsResampling:
-				fingerprints = computeResampledTreeFullEmbedding(g, absImportance, patterns, nPatterns, gp, sgp);
+				fingerprints = computeResampledTreeFullEmbedding(g, absImportance, patterns, nPatterns, rng, gp, sgp);
 				break;
 			case treePatternsFast:
 				fingerprints = bfsEmbeddingForTrees(g, evaluationPlan, gp, sgp);
 				break;
 			case hopsPatterns:
-				fingerprints = computeHOPSTrials(g, absImportance, patterns, nPatterns, gp);
+				fingerprints = computeHOPSTrials(g, absImportance, patterns, nPatterns, rng, gp);
 				break;
 			case localEasyPatternsFast:
 				fingerprints = bfsEmbeddingForLocalEasy(g, evaluationPlan, absImportance, gp, sgp);
@@ -792,15 +1234,45 @@ int main(int argc, char** argv) {
 				free(fingerprints);
 				break;
 			default:
-				printIntSetAsLibSvm(fingerprints, g->activity, stdout);
+				writeIntSetAsLibSvm(fingerprints, g->activity, featureWriter);
 				dumpIntSet(fingerprints);
 				break;
 			}
+
+
+			/* garbage collection */
+			dumpGraph(gp, g);
 		}
 
+		if (serverMode) {
+			flushSparseFeatureWriter(featureWriter);
+			/* a malformed graph invalidates the rest of its request, which is answered by one error line */
+			if (fileIteratorFailed()) {
+				skipToRequestEnd();
+				fputs("error: malformed graph in request\n", stdout);
+			}
+			fputs("$\n", stdout);
+			fflush(stdout);
+
+			struct timespec requestEnd;
+			clock_gettime(CLOCK_MONOTONIC, &requestEnd);
+			if (nRequests == latencyCapacity) {
+				latencyCapacity = latencyCapacity == 0 ? 128 : 2 * latencyCapacity;
+				latencies = realloc(latencies, latencyCapacity * sizeof(double));
+			}
+			latencies[nRequests] = (requestEnd.tv_sec - requestStart.tv_sec) * 1000.0 + (requestEnd.tv_nsec - requestStart.tv_nsec) / 1000000.0;
+			++nRequests;
+			moreRequests = !fileIteratorAtEnd();
+		} else {
+			moreRequests = 0;
+		}
+	}
+
+	closeSparseFeatureWriter(featureWriter);
 
-		/* garbage collection */
-		dumpGraph(gp, g);
+	if (serverMode) {
+		printLatencyPercentiles(latencies, nRequests, stderr);
+		free(latencies);
 	}
 
 	/* global garbage collection */
@@ -845,6 +1317,7 @@ int main(int argc, char** argv) {
 	}
 
 	destroyFileIterator();
+	releasePlanFile(planFile);
 	freeGraphPool(gp);
 	freeShallowGraphPool(sgp);
 	freeListPool(lp);
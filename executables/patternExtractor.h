@@ -6,6 +6,18 @@
 #include <stdint.h>
 #include "../graph.h"
 
+/**
+ * Compact representation of a graph for fingerprinting: adjacency lists in CSR format, sorted by neighbor id,
+ * and 32 bit hashes of all vertex and edge labels.
+ */
+struct FingerprintGraph {
+	int n;
+	int* offsets; // the neighbors of v are stored at positions offsets[v], ..., offsets[v+1]-1
+	int* neighbors;
+	uint32_t* edgeLabels;
+	uint32_t* vertexLabels;
+};
+
 int printHelp();
 
 static uint32_t jenkinsOneAtATimeHash_step(char *key, uint32_t hash);
@@ -15,6 +27,21 @@ static struct VertexList* hasEdge(struct Vertex* v, struct Vertex* w);
 uint32_t fingerprintTriple(struct Vertex* u, struct Vertex* v, struct Vertex* w, struct VertexList* uv, struct VertexList* vw, struct VertexList* wu, struct ShallowGraphPool* sgp);
 struct IntSet* getTripletFingerprintsBruteForce(struct Graph* g, struct ShallowGraphPool* sgp);
 struct IntSet* getTripletFingerprintsTriangulation(struct Graph* g, struct ShallowGraphPool* sgp);
+static uint32_t labelHash(const char* label);
+static uint64_t mix64(uint64_t x);
+static uint32_t hashSequence(uint64_t tag, const uint32_t* sequence, int length);
+static int compareUint32(const void* a, const void* b);
+static int compareNeighbors(const void* a, const void* b);
+static struct FingerprintGraph getFingerprintGraph(struct Graph* g);
+static void dumpFingerprintGraph(struct FingerprintGraph f);
+static uint32_t fingerprintWedge(uint32_t uLabel, uint32_t uvLabel, uint32_t vLabel, uint32_t uwLabel, uint32_t wLabel);
+static void keepSmallerSequence(uint32_t* best, const uint32_t* candidate, int length);
+static uint32_t fingerprintTriangle(const uint32_t* l, const uint32_t* e);
+struct IntSet* getTripletFingerprintsTriangulationFast(struct Graph* g);
+static uint32_t fingerprintInducedTriple(struct FingerprintGraph* f, int i, int j, int k, int ij, int jk, int ki);
+struct IntSet* getTripletFingerprintsBruteForceFast(struct Graph* g);
+static int compareDoubles(const void* a, const void* b);
+static void printLatencyPercentiles(double* latencies, size_t nRequests, FILE* out);
 int main(int argc, char** argv);
 
 #endif // PATTERN_EXTRACTOR_H_
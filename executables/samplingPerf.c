@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../graph.h"
+#include "../loading.h"
+#include "../connectedComponents.h"
+#include "../wilsonsAlgorithm.h"
+#include "../kruskalsAlgorithm.h"
+#include "../sampleSubtrees.h"
+#include "../searchTree.h"
+#include "../cs_Tree.h"
+#include "../randomNumberGenerator.h"
+#include "samplingPerf.h"
+
+
+typedef enum {
+	wilsonSingle, wilsonBatch, wilsonCanonicalStrings, wilsonNonisomorphic, kruskalPooled, kruskalArrays, nSamplers
+} Sampler;
+
+static const char* SAMPLER_NAMES[] = {"wilson (one tree per call)", "wilson (batch)", "wilson (batch, canonical strings)", "wilson (batch, nonisomorphic)",
+		"kruskal (pooled union-find)", "kruskal (array union-find)"};
+
+
+/**
+ * Remove isomorphic duplicates from trees by their canonical strings, as the sampling based miners did
+ * before sampleNonisomorphicSpanningTreesUsingWilson().
+ */
+static struct ShallowGraph* filterByCanonicalStrings(struct ShallowGraph* trees, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	struct Vertex* searchTree = getVertex(gp->vertexPool);
+	for (struct ShallowGraph* tree=trees; tree!=NULL; tree=tree->next) {
+		struct Graph* tmp = shallowGraphToGraph(tree, gp);
+		addToSearchTree(searchTree, canonicalStringOfTree(tmp, sgp), gp, sgp);
+		dumpGraph(gp, tmp);
+	}
+	dumpShallowGraphCycle(sgp, trees);
+	struct ShallowGraph* strings = listStringsInSearchTree(searchTree, sgp);
+	dumpSearchTree(gp, searchTree);
+	return strings;
+}
+
+
+/**
+ * Kruskal sampling as done before struct KruskalSampler: the union-find forest is a pooled graph
+ * without path compression and the edge list is created anew for each tree.
+ */
+static struct ShallowGraph* kruskalWithPooledUnionFind(struct Graph* g, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph* edges = getGraphEdges(g, sgp);
+	struct VertexList** edgeArray = malloc(g->m * sizeof(struct VertexList*));
+	int i = 0;
+	for (struct VertexList* e=edges->edges; e!=NULL; e=e->next) {
+		edgeArray[i++] = e;
+	}
+	shuffle(edgeArray, g->m, rng);
+	struct ShallowGraph* spanningTree = kruskalMST(g, edgeArray, gp, sgp);
+	dumpShallowGraphCycle(sgp, edges);
+	free(edgeArray);
+	return spanningTree;
+}
+
+
+static struct ShallowGraph* sample(Sampler sampler, struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph* trees = NULL;
+	switch (sampler) {
+	case wilsonSingle:
+		for (int j=0; j<k; ++j) {
+			struct ShallowGraph* tree = randomSpanningTreeAsShallowGraph(g, rng, sgp);
+			tree->next = trees;
+			trees = tree;
+		}
+		break;
+	case wilsonBatch:
+		trees = sampleSpanningTreesUsingWilson(g, k, rng, sgp);
+		break;
+	case wilsonCanonicalStrings:
+		trees = filterByCanonicalStrings(sampleSpanningTreesUsingWilson(g, k, rng, sgp), gp, sgp);
+		break;
+	case wilsonNonisomorphic:
+		trees = sampleNonisomorphicSpanningTreesUsingWilson(g, k, rng, sgp);
+		break;
+	case kruskalPooled:
+		for (int j=0; j<k; ++j) {
+			struct ShallowGraph* tree = kruskalWithPooledUnionFind(g, rng, gp, sgp);
+			tree->next = trees;
+			trees = tree;
+		}
+		break;
+	case kruskalArrays:
+		trees = sampleSpanningTreesUsingKruskal(g, k, rng, gp, sgp);
+		break;
+	default:
+		break;
+	}
+	return trees;
+}
+
+
+/**
+ * Measure the throughput of the spanning tree samplers.
+ *
+ * Each sampler draws k spanning trees of each connected graph in the database, which is held in memory.
+ * The canonical strings and the nonisomorphic sampler draw as many trees, but return only one of each
+ * isomorphism class.
+ */
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("use as sperf <graph database> [k] [repetitions]\n");
+		printf("\tsamples k (default 100) spanning trees of each connected graph and prints trees/s for each sampler\n");
+		return EXIT_FAILURE;
+	}
+	int k = (argc > 2) ? atoi(argv[2]) : 100;
+	int repetitions = (argc > 3) ? atoi(argv[3]) : 1;
+
+	struct ListPool* lp = createListPool(10000);
+	struct VertexPool* vp = createVertexPool(10000);
+	struct ShallowGraphPool* sgp = createShallowGraphPool(1000, lp);
+	struct GraphPool* gp = createGraphPool(100, vp, lp);
+	struct RandomNumberGenerator rng;
+	seedRandomNumberGenerator(&rng, 1);
+
+	struct Graph* db = NULL;
+	int nGraphs = 0;
+	long nVertices = 0;
+	struct Graph* g;
+	createFileIterator(argv[1], gp);
+	while ((g = iterateFile())) {
+		if ((g->m > 0) && isConnected(g)) {
+			g->next = db;
+			db = g;
+			++nGraphs;
+			nVertices += g->n;
+		} else {
+			dumpGraph(gp, g);
+		}
+	}
+	destroyFileIterator();
+	printf("%i connected graphs with %li vertices, k=%i\n", nGraphs, nVertices, k);
+
+	for (int r=0; r<repetitions; ++r) {
+		for (Sampler s=0; s<nSamplers; ++s) {
+			struct timespec start;
+			struct timespec end;
+			long nTrees = 0;
+
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			for (g=db; g!=NULL; g=g->next) {
+				struct ShallowGraph* trees = sample(s, g, k, &rng, gp, sgp);
+				for (struct ShallowGraph* tree=trees; tree!=NULL; tree=tree->next) {
+					++nTrees;
+				}
+				dumpShallowGraphCycle(sgp, trees);
+			}
+			clock_gettime(CLOCK_MONOTONIC, &end);
+
+			double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+			printf("%-34s %.3f s: %.0f trees/s (%li trees returned)\n",
+					SAMPLER_NAMES[s], seconds, (double)nGraphs * k / seconds, nTrees);
+		}
+	}
+
+	dumpGraphList(gp, db);
+	freeGraphPool(gp);
+	freeShallowGraphPool(sgp);
+	freeListPool(lp);
+	freeVertexPool(vp);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,8 @@
+#ifndef EXECUTABLES_SAMPLINGPERF_H_
+#define EXECUTABLES_SAMPLINGPERF_H_
+
+
+int main(int argc, char** argv);
+
+
+#endif /* EXECUTABLES_SAMPLINGPERF_H_ */
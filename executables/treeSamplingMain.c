@@ -13,6 +13,8 @@
 #include "../connectedComponents.h"
 #include "../sampleSubtrees.h"
 #include "../weisfeilerLehman.h"
+#include "../patternDictionary.h"
+#include "../randomNumberGenerator.h"
 #include "treeSamplingMain.h"
 
 /**
@@ -58,22 +60,27 @@ int main(int argc, char** argv) {
 	char processDisconnectedGraphs = 0;
 	char weisfeilerLehmanLabeling = 0;
 	OutputMethod outputMethod = cs;
+	char* dictionaryFile = NULL;
+	struct PatternDictionary* dictionary = NULL;
+	SparseFeatureFormat featureFormat = sparseText;
+	struct SparseFeatureWriter* featureWriter = NULL;
+	int status = 0;
 
 	/* i counts the number of graphs read */
 	int i = 0;
 	/* processedGraphs is the number of graphs that are considered (might be less, if some graphs are not connected) */
 	int processedGraphs = 0;
 	long int avgTrees = 0;
-	/* set random seed */
-	srand(time(NULL));
+	/* random seed, defaults to the current time */
+	int seed = time(NULL);
+	char legacyRandom = 0;
 
 	/* TODO refactor Weisfeiler Lehman Label store */
 	struct Vertex* wlLabels = NULL;
 
 	/* parse command line arguments */
 	int arg;
-	int seed;
-	const char* validArgs = "hs:k:t:o:ur:vdwm";
+	const char* validArgs = "hs:k:t:o:ur:RvdwmD:b";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		case 'h':
@@ -147,10 +154,11 @@ int main(int argc, char** argv) {
 			if (sscanf(optarg, "%i", &seed) != 1) {
 				fprintf(stderr, "value must be integer, is: %s\n", optarg);
 				return EXIT_FAILURE;
-			} else {
-				srand(seed);
 			}
 			break;
+		case 'R':
+			legacyRandom = 1;
+			break;
 		case 'o':
 			if (strcmp(optarg, "canonicalString") == 0) {
 				outputMethod = cs;
@@ -168,18 +176,31 @@ int main(int argc, char** argv) {
 				outputMethod = mi;
 				break;
 			}
+			if (strcmp(optarg, "features") == 0) {
+				outputMethod = fe;
+				break;
+			}
 			fprintf(stderr, "Unknown output method: %s\n", optarg);
 			return EXIT_FAILURE;
 			break;
 		case 'v': 
 			verbosity = 1;
 			break;
+		case 'D':
+			dictionaryFile = optarg;
+			break;
+		case 'b':
+			featureFormat = sparseBinary;
+			break;
 		case '?':
 			return EXIT_FAILURE;
 			break;
 		}
 	}
 
+	seedRandomNumberGenerators(seed, legacyRandom);
+	struct RandomNumberGenerator* rng = threadRandomNumberGenerator();
+
 	/* init object pools */
 	lp = createListPool(10000);
 	vp = createVertexPool(10000);
@@ -190,6 +211,17 @@ int main(int argc, char** argv) {
 		wlLabels = getVertex(vp);
 	}
 
+	if (outputMethod == fe) {
+		// without -D, ids are only valid for this run
+		if (!(dictionary = openPatternDictionary(dictionaryFile))) {
+			return EXIT_FAILURE;
+		}
+		featureWriter = createSparseFeatureWriter(stdout, featureFormat, 1);
+	} else if (featureFormat == sparseBinary) {
+		fprintf(stderr, "Binary feature format is only supported by -o features\n");
+		return EXIT_FAILURE;
+	}
+
 	/* initialize the stream to read graphs from 
    check if there is a filename present in the command line arguments 
    if so, open the file, if not, read from stdin */
@@ -206,7 +238,7 @@ int main(int argc, char** argv) {
 	}
 
 	/* iterate over all graphs in the database */
-	while ((g = iterateFile())) {
+	while ((status == 0) && (g = iterateFile())) {
 	
 		/* if there was an error reading some graph the returned n will be -1 */
 		if (g->n != -1) {
@@ -224,28 +256,28 @@ int main(int argc, char** argv) {
 				if (!processDisconnectedGraphs) {
 					switch (samplingMethod) {
 					case wilson:
-						sample = sampleSpanningTreesUsingWilson(g, k, sgp);
+						sample = sampleSpanningTreesUsingWilson(g, k, rng, sgp);
 						break;
 					case kruskal:
-						sample = sampleSpanningTreesUsingKruskal(g, k, gp, sgp);
+						sample = sampleSpanningTreesUsingKruskal(g, k, rng, gp, sgp);
 						break;
 					case listing:
-						sample = sampleSpanningTreesUsingListing(g, k, gp, sgp);
+						sample = sampleSpanningTreesUsingListing(g, k, rng, gp, sgp);
 						break;
 					case mix:
-						sample = sampleSpanningTreesUsingMix(g, k, threshold, gp, sgp);
+						sample = sampleSpanningTreesUsingMix(g, k, threshold, rng, gp, sgp);
 						break;
 					case partialListing:
-						sample = sampleSpanningTreesUsingPartialListingMix(g, k, threshold, gp, sgp);
+						sample = sampleSpanningTreesUsingPartialListingMix(g, k, threshold, rng, gp, sgp);
 						break;
 					case cactusSampling:
-						sample = sampleSpanningTreesUsingCactusMix(g, k, threshold, gp, sgp);
+						sample = sampleSpanningTreesUsingCactusMix(g, k, threshold, rng, gp, sgp);
 						break;
 					case bridgeForest:
 						sample = listBridgeForest(g, gp, sgp);
 						break;
 					case listOrSample:
-						sample = listOrSampleSpanningTrees(g, k, threshold, gp, sgp);
+						sample = listOrSampleSpanningTrees(g, k, threshold, rng, gp, sgp);
 						break;
 					}
 				} else {
@@ -396,6 +428,10 @@ int main(int argc, char** argv) {
 					dumpGraph(gp, forest);
 					dumpShallowGraphCycle(sgp, strings);
 					break;
+				case fe:
+					/* output tree patterns as feature vector with ids from the pattern dictionary */
+					status = writePatternFeatures(dictionary, searchTree, g->activity, featureWriter);
+					break;
 				}
 
 				avgTrees += searchTree->number;
@@ -437,11 +473,17 @@ int main(int argc, char** argv) {
 	if (weisfeilerLehmanLabeling) {
 		dumpSearchTree(gp, wlLabels);
 	}
+	if (featureWriter) {
+		closeSparseFeatureWriter(featureWriter);
+	}
+	if (dictionary) {
+		closePatternDictionary(dictionary);
+	}
 	destroyFileIterator();
 	freeGraphPool(gp);
 	freeShallowGraphPool(sgp);
 	freeListPool(lp);
 	freeVertexPool(vp);
 
-	return EXIT_SUCCESS;
+	return (status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
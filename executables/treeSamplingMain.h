@@ -18,7 +18,8 @@ typedef enum {
 		cs,
 		fo,
 		tr,
-		mi
+		mi,
+		fe
 } OutputMethod;
 
 int main(int argc, char** argv);
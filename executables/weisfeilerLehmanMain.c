@@ -10,6 +10,7 @@
 #include "../graphPrinting.h"
 #include "../searchTree.h"
 #include "../weisfeilerLehman.h"
+#include "../lwm_initAndCollect.h"
 #include "weisfeilerLehmanMain.h"
 
 
@@ -34,10 +35,12 @@ int printHelp() {
 
 
 /**
- * Input handling, parsing of database and call of opk feature extraction method.
+ * Input handling, parsing of database and call of the Weisfeiler-Lehman relabeling method.
  */
 int main(int argc, char** argv) {
 
+	typedef enum {relabeledGraph, subtreeFeatures, trieRelabeledGraph} OutputMethod;
+
 	/* object pools */
 	struct ListPool *lp;
 	struct VertexPool *vp;
@@ -47,41 +50,75 @@ int main(int argc, char** argv) {
 	/* pointer to the current graph which is returned by the input iterator */
 	struct Graph* g = NULL;
 	int i = 0;
-	struct Vertex* wlLabels;
+	struct Vertex* wlLabels = NULL;
+	struct WLCompressionTable* compressionTable = NULL;
 
 	/* output */
 	FILE* out = stdout;
 
 	/* user set variables to specify what needs to be done */
-	// Filter filter = count;
-	// Comparator comparator = pass;
-	// OutputOption oOption = graph;
-	// int value = -1;
-	// // can be set via -a. Used e.g. by spanningTreeListing filter, and randomSample
-	// int additionalParameter = 100;
+	OutputMethod method = trieRelabeledGraph;
+	int nIterations = 1;
+	int nThreads = 0;
 
 	/* parse command line arguments */
 	int arg;
-	const char* validArgs = "h";
+	const char* validArgs = "hi:m:t:";
 	for (arg=getopt(argc, argv, validArgs); arg!=-1; arg=getopt(argc, argv, validArgs)) {
 		switch (arg) {
 		case 'h':
 			printHelp();
 			return EXIT_SUCCESS;
+		case 'i':
+			if ((sscanf(optarg, "%i", &nIterations) != 1) || (nIterations < 0)) {
+				fprintf(stderr, "Number of iterations must be a nonnegative integer, is: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 't':
+			if ((sscanf(optarg, "%i", &nThreads) != 1) || (nThreads < 1)) {
+				fprintf(stderr, "Number of threads must be a positive integer, is: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'm':
+			if (strcmp(optarg, "graph") == 0) {
+				method = relabeledGraph;
+				break;
+			}
+			if (strcmp(optarg, "features") == 0) {
+				method = subtreeFeatures;
+				break;
+			}
+			if (strcmp(optarg, "trie") == 0) {
+				method = trieRelabeledGraph;
+				break;
+			}
+			fprintf(stderr, "Unknown output method: %s\n", optarg);
+			return EXIT_FAILURE;
 		case '?':
 			return EXIT_FAILURE;
 			break;
 		}
 	}
 
+	if ((nThreads > 0) && (method == trieRelabeledGraph)) {
+		fprintf(stderr, "Method trie does not support -t, use -m graph or -m features\n");
+		return EXIT_FAILURE;
+	}
+
 	/* init object pools */
 	lp = createListPool(10000);
 	vp = createVertexPool(10000);
 	sgp = createShallowGraphPool(1000, lp);
 	gp = createGraphPool(100, vp, lp);
 
-	/* init wl label compression search tree */
-	wlLabels = getVertex(vp);
+	/* init wl label compression */
+	if (method == trieRelabeledGraph) {
+		wlLabels = getVertex(vp);
+	} else {
+		compressionTable = createWLCompressionTable(1 << 16);
+	}
 
 	/* initialize the stream to read graphs from 
 	   check if there is a filename present in the command line arguments 
@@ -98,14 +135,85 @@ int main(int argc, char** argv) {
 		createStdinIterator(gp);
 	}
 
+	/* parallel mode: load the whole database and relabel it with canonical label ids */
+	if (nThreads > 0) {
+		struct Graph** db = NULL;
+		setLoadingThreads(nThreads);
+		int nGraphs = getDB(&db);
+		int nLabels = 0;
+		int** labels = weisfeilerLehmanParallelLabels(db, nGraphs, nIterations, nThreads, &nLabels);
+		int* ids = NULL;
+		int* counts = NULL;
+
+		for (i=0; i<nGraphs; ++i) {
+			g = db[i];
+			int nFeatures = 0;
+			switch (method) {
+			case relabeledGraph:
+				for (int v=0; v<g->n; ++v) {
+					if (g->vertices[v]->isStringMaster) {
+						free(g->vertices[v]->label);
+					}
+					g->vertices[v]->label = intLabel(labels[i][nIterations * g->n + v]);
+					g->vertices[v]->isStringMaster = 1;
+				}
+				printGraphAidsFormat(g, out);
+				break;
+			case subtreeFeatures:
+				ids = realloc(ids, (nIterations + 1) * g->n * sizeof(int));
+				counts = realloc(counts, (nIterations + 1) * g->n * sizeof(int));
+				nFeatures = weisfeilerLehmanSubtreeFeatures(labels[i], (nIterations + 1) * g->n, ids, counts);
+				printWLSubtreeFeatures(ids, counts, nFeatures, g->activity, out);
+				break;
+			case trieRelabeledGraph:
+				break;
+			}
+			free(labels[i]);
+			dumpGraph(gp, g);
+		}
+		free(ids);
+		free(counts);
+		free(labels);
+		free(db);
+	}
+
 	/* iterate over all graphs in the database */
-	while ((g = iterateFile())) {
+	while ((nThreads == 0) && (g = iterateFile())) {
 		/* if there was an error reading some graph the returned n will be -1 */
 		if (g->n != -1) {
-			
-			struct Graph* h = weisfeilerLehmanRelabel(g, wlLabels, gp, sgp);
-			printGraphAidsFormat(h, out);
-			dumpGraph(gp, h);
+			struct Graph* h = NULL;
+			int* labels = NULL;
+			int* ids = NULL;
+			int* counts = NULL;
+			int nFeatures = 0;
+
+			switch (method) {
+			case relabeledGraph:
+				h = weisfeilerLehmanIntegerRelabel(g, nIterations, compressionTable, gp);
+				printGraphAidsFormat(h, out);
+				dumpGraph(gp, h);
+				break;
+			case subtreeFeatures:
+				labels = weisfeilerLehmanIntegerLabels(g, nIterations, compressionTable);
+				ids = malloc((nIterations + 1) * g->n * sizeof(int));
+				counts = malloc((nIterations + 1) * g->n * sizeof(int));
+				nFeatures = weisfeilerLehmanSubtreeFeatures(labels, (nIterations + 1) * g->n, ids, counts);
+				printWLSubtreeFeatures(ids, counts, nFeatures, g->activity, out);
+				free(labels);
+				free(ids);
+				free(counts);
+				break;
+			case trieRelabeledGraph:
+				h = cloneGraph(g, gp);
+				for (int iteration=0; iteration<nIterations; ++iteration) {
+					struct Graph* next = weisfeilerLehmanRelabel(h, wlLabels, gp, sgp);
+					dumpGraph(gp, h);
+					h = next;
+				}
+				printGraphAidsFormat(h, out);
+				dumpGraph(gp, h);
+				break;
+			}
 
 			/***** do not alter ****/
 
@@ -120,11 +228,17 @@ int main(int argc, char** argv) {
 	}
 
 	/* terminate output stream */
-	fprintf(out, "$\n");
-	
+	if (method != subtreeFeatures) {
+		fprintf(out, "$\n");
+	}
 
 	/* global garbage collection */
-	dumpSearchTree(gp, wlLabels);
+	if (wlLabels != NULL) {
+		dumpSearchTree(gp, wlLabels);
+	}
+	if (compressionTable != NULL) {
+		freeWLCompressionTable(compressionTable);
+	}
 	destroyFileIterator();
 	freeGraphPool(gp);
 	freeShallowGraphPool(sgp);
@@ -132,4 +246,4 @@ int main(int argc, char** argv) {
 	freeVertexPool(vp);
 
 	return EXIT_SUCCESS;
-}	
+}
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "graph.h"
+#include "listComponents.h"
 
 
 /********************************************************************************************************
@@ -260,6 +261,7 @@ struct Graph* mergeGraphs(struct Graph* g, struct GraphPool* gp) {
 
 /** Delete the directed edge between vertices v and w in g and return it */
 struct VertexList* deleteEdge(struct Graph* g, int v, int w) {
+	invalidateBlockDecomposition(g);
 	struct VertexList* e = g->vertices[v]->neighborhood;
 	struct VertexList* f = e->next;
 
@@ -510,6 +512,7 @@ struct Vertex** setVertexNumber(struct Graph* g, int n) {
 		return NULL;
 	}
 	
+	invalidateBlockDecomposition(g);
 	g->n = n;
 	g->vertices = malloc(n * sizeof(struct Vertex*));
 
@@ -549,6 +552,7 @@ struct ShallowGraph* getGraphEdges(struct Graph *g, struct ShallowGraphPool* sgp
 Add an undirected edge between vertex v and vertex w in g with label label
 */
 void addEdgeBetweenVertices(int v, int w, char* label, struct Graph* g, struct GraphPool* gp) {
+	invalidateBlockDecomposition(g);
 	struct VertexList* e = getVertexList(gp->listPool);
 	e->startPoint = g->vertices[v];
 	e->endPoint = g->vertices[w];
@@ -32,6 +32,8 @@ struct VertexList{
 	int isStringMaster;
 };
 
+struct BiconnectedDecomposition;
+
 /**
 A graph has n vertices and m edges and a !constant! number of vertices.
 */
@@ -42,6 +44,8 @@ struct Graph{
 	int activity;
 	struct Vertex** vertices;
 	struct Graph* next;
+	/* cached biconnected decomposition, see getBlockDecomposition() */
+	struct BiconnectedDecomposition* blocks;
 };
 
 /**
@@ -21,63 +21,59 @@ Check if a given connected cactus graph is traceable.
 Assumes the input graph to be a connected cactus graph
 */
 char isThisCactusTraceable(struct Graph* g, struct ShallowGraphPool* sgp) {
-	struct ShallowGraph* biconnectedComponents;
+	(void)sgp; // unused
+	struct BiconnectedDecomposition* blocks;
 	int* criticality;
 	int v; 
-	struct ShallowGraph* c;
 
 	/* the empty graph and singleton vertices are traceable cactus graphs */
 	if (g->n <= 1) {
 		return 1;
 	}
 
-	biconnectedComponents = listBiconnectedComponents(g, sgp);
-	criticality = computeCriticality(biconnectedComponents, g->n);
+	blocks = getBlockDecomposition(g);
+	criticality = getCachedCriticality(g);
 
 	// test if every vertex has criticality at most 2
 	for (v=0; v<g->n; ++v) {
 		if (criticality[v] > 2) {
-			free(criticality);
-			dumpShallowGraphCycle(sgp, biconnectedComponents);
 			return 0;
 		}
 	}
 
 	// test if every biconnected component contains at most two critical vertices.
-	for (c=biconnectedComponents; c!=NULL; c=c->next) {
-		struct VertexList* e;
+	for (int c=0; c<blocks->nBlocks; ++c) {
+		struct VertexList** first = blocks->edges + blocks->blockStart[c];
+		struct VertexList** end = blocks->edges + blocks->blockStart[c+1];
+		struct VertexList** e;
 		int criticalVertexCount = 0;
 
 		// TODO measure if the alg is faster with or without this line
-		if (c->m == 1) continue;
+		if (end - first == 1) continue;
 
 		// init ->visited = 0
-		for (e=c->edges; e!=NULL; e=e->next) {
-			e->startPoint->visited = 0;
-			e->endPoint->visited = 0;
+		for (e=first; e!=end; ++e) {
+			(*e)->startPoint->visited = 0;
+			(*e)->endPoint->visited = 0;
 		}
 		// count critical vertices
-		for (e=c->edges; e!=NULL; e=e->next) {
-			criticalVertexCount += visit(e->startPoint, criticality);
-			criticalVertexCount += visit(e->endPoint, criticality);
+		for (e=first; e!=end; ++e) {
+			criticalVertexCount += visit((*e)->startPoint, criticality);
+			criticalVertexCount += visit((*e)->endPoint, criticality);
 		}
 		if (criticalVertexCount > 2) {
-			free(criticality);
-			dumpShallowGraphCycle(sgp, biconnectedComponents);
 			return 0;
 		 } else {
 			if (criticalVertexCount == 2) {
 				char notFound = 1;
 				// search for the edge that contains both critical vertices
-				for (e=c->edges; e!=NULL; e=e->next) {
-					if ((criticality[e->startPoint->number] > 1) && (criticality[e->endPoint->number] > 1)) {
+				for (e=first; e!=end; ++e) {
+					if ((criticality[(*e)->startPoint->number] > 1) && (criticality[(*e)->endPoint->number] > 1)) {
 						notFound = 0;
 						break;
 					} 
 				}
 				if (notFound) {
-					free(criticality);
-					dumpShallowGraphCycle(sgp, biconnectedComponents);
 					return 0;
 				}
 			}
@@ -124,41 +120,39 @@ If this method returns 0, then the graph is not traceable.
 If it returns 1, it might still not be traceable.
 */
 char isWeaklyTraceableUnsafe(struct Graph* g, struct ShallowGraphPool* sgp) {
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	int* criticality = computeCriticality(biconnectedComponents, g->n);
+	(void)sgp; // unused
+	struct BiconnectedDecomposition* blocks = getBlockDecomposition(g);
+	int* criticality = getCachedCriticality(g);
 	int v; 
-	struct ShallowGraph* c;
 
 	// test if every vertex has criticality at most 2
 	for (v=0; v<g->n; ++v) {
 		if (criticality[v] > 2) {
-			free(criticality);
-			dumpShallowGraphCycle(sgp, biconnectedComponents);
 			return 0;
 		}
 	}
 
 	// test if every biconnected component contains at most two critical vertices.
-	for (c=biconnectedComponents; c!=NULL; c=c->next) {
-		struct VertexList* e;
+	for (int c=0; c<blocks->nBlocks; ++c) {
+		struct VertexList** first = blocks->edges + blocks->blockStart[c];
+		struct VertexList** end = blocks->edges + blocks->blockStart[c+1];
+		struct VertexList** e;
 		int criticalVertexCount = 0;
 
 		// TODO measure if the alg is faster with or without this line
-		if (c->m == 1) continue;
+		if (end - first == 1) continue;
 
 		// init ->visited = 0
-		for (e=c->edges; e!=NULL; e=e->next) {
-			e->startPoint->visited = 0;
-			e->endPoint->visited = 0;
+		for (e=first; e!=end; ++e) {
+			(*e)->startPoint->visited = 0;
+			(*e)->endPoint->visited = 0;
 		}
 		// count critical vertices
-		for (e=c->edges; e!=NULL; e=e->next) {
-			criticalVertexCount += visit(e->startPoint, criticality);
-			criticalVertexCount += visit(e->endPoint, criticality);
+		for (e=first; e!=end; ++e) {
+			criticalVertexCount += visit((*e)->startPoint, criticality);
+			criticalVertexCount += visit((*e)->endPoint, criticality);
 		}
 		if (criticalVertexCount > 2) {
-			free(criticality);
-			dumpShallowGraphCycle(sgp, biconnectedComponents);
 			return 0;
 		 } else {
 			/* this is where misclassification might occur.
@@ -46,6 +46,14 @@ void printIntSetAsLibSvm(struct IntSet* s, int label, FILE* out) {
 	fprintf(out, "\n");
 }
 
+void writeIntSetAsLibSvm(struct IntSet* s, int label, struct SparseFeatureWriter* out) {
+	beginSparseRow(out, label);
+	for (struct IntElement* i=s->first; i!=NULL; i=i->next) {
+		addSparseEntry(out, i->value, 1);
+	}
+	endSparseRow(out);
+}
+
 void printIntSetSparse(struct IntSet* s, int id, FILE* out) {
 	fprintf(out, "%i:", id);
 	printIntSetSparseNoId(s, out);
@@ -236,6 +244,40 @@ char isSortedUniqueIntSet(struct IntSet* s) {
 	return 1;
 }
 
+/**
+ * Add a 32 bit hash value to the buffer. Only its lower 31 bits are kept, such that fingerprints
+ * are nonnegative ints and their order as int matches their order as uint32_t.
+ */
+void addFingerprint(struct FingerprintBuffer* b, uint32_t fingerprint) {
+	if (b->size == b->capacity) {
+		b->capacity = b->capacity == 0 ? 1024 : 2 * b->capacity;
+		b->data = realloc(b->data, b->capacity * sizeof(uint32_t));
+	}
+	b->data[b->size] = fingerprint & 0x7fffffffu;
+	++b->size;
+}
+
+static int compareFingerprints(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Sort and deduplicate the buffer and return its content as IntSet. Frees the buffer.
+ */
+struct IntSet* fingerprintBufferToIntSet(struct FingerprintBuffer* b) {
+	struct IntSet* fingerprints = getIntSet();
+	qsort(b->data, b->size, sizeof(uint32_t), &compareFingerprints);
+	for (size_t i=0; i<b->size; ++i) {
+		if ((i == 0) || (b->data[i] != b->data[i-1])) {
+			appendInt(fingerprints, (int)b->data[i]);
+		}
+	}
+	free(b->data);
+	return fingerprints;
+}
+
 //int main(int argc, char* argv) {
 //	struct IntSet* s = getIntSet();
 //
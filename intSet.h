@@ -2,6 +2,9 @@
 #define _INTSET_H_
 
 #include <stdio.h>
+#include <stdint.h>
+
+#include "sparseFeatureWriter.h"
 
 struct IntElement{
 	int value;
@@ -15,6 +18,15 @@ struct IntSet{
 	size_t size;
 };
 
+/**
+ * A growing buffer of fingerprints that is sorted and made unique once all fingerprints of a graph are added.
+ */
+struct FingerprintBuffer {
+	uint32_t* data;
+	size_t size;
+	size_t capacity;
+};
+
 struct IntElement* getIntElement();
 struct IntSet* getIntSet();
 void dumpIntElements(struct IntElement* e);
@@ -22,6 +34,7 @@ void printIntSet(struct IntSet* s, FILE*out);
 void printIntSetSparse(struct IntSet* s, int id, FILE* out);
 void printIntSetSparseNoId(struct IntSet* s, FILE* out);
 void printIntSetAsLibSvm(struct IntSet* s, int label, FILE* out);
+void writeIntSetAsLibSvm(struct IntSet* s, int label, struct SparseFeatureWriter* out);
 void dumpIntSet(struct IntSet* s);
 void appendInt(struct IntSet* s, int i);
 void addIntSortedNoDuplicates(struct IntSet* s, int i);
@@ -33,4 +46,7 @@ struct IntSet* intersectIntSet(const struct IntSet* setA, const struct IntSet* s
 char isSortedUniqueIntSet(struct IntSet* s);
 char isSortedIntSet(struct IntSet* s);
 
+void addFingerprint(struct FingerprintBuffer* b, uint32_t fingerprint);
+struct IntSet* fingerprintBufferToIntSet(struct FingerprintBuffer* b);
+
 #endif
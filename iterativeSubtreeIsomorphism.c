@@ -591,6 +591,10 @@ static struct Vertex* noniterativeRootedSubtreeCheck_intern(struct SubtreeIsoDat
 			// is there a subgraph iso here?
 			if (sizeofMatching == nNeighbors) {
 				addCharacteristic(current, u, u, v);
+				// a matching that covers all neighbors of u also covers all neighbors but one
+				for (struct VertexList* e=u->neighborhood; e!=NULL; e=e->next) {
+					addCharacteristic(current, e->endPoint, u, v);
+				}
 
 				if (u == hRoot) {
 					current->foundIso = 1;
@@ -667,3 +671,167 @@ struct SubtreeIsoDataStore noniterativeRootedSubtreeCheck(struct SubtreeIsoDataS
 	info.S = NULL;
 	return info;
 }
+
+
+/* the rooted characteristics of a pattern h with respect to a graph g are stored row by row, one row of
+g->n bits for each vertex of h. Rows start at byte boundaries, hence the rows of the first k vertices
+of h do not depend on h->n. */
+static inline size_t rootedCharacteristicPosition(const size_t u, const size_t v, const size_t gn) {
+	return u * ((gn + 7) / 8) * 8 + v;
+}
+
+
+/* vertices of g have their ->visited values set to the postorder. Thus,
+children of v are vertices w that are neighbors of v and have w->visited < v->visited.
+Check whether the children of u in h (rooted at vertex 0) can be mapped injectively to children of v
+along edges with the same labels, such that each child has a rooted characteristic at its image. */
+static char computeRootedCharacteristic(struct SubtreeIsoDataStore* current, struct CachedGraph* cachedB, struct Vertex* u, int uParent, struct Vertex* v, struct GraphPool* gp) {
+	int sizeofX = (uParent == -1) ? degree(u) : degree(u) - 1;
+	if (sizeofX == 0) {
+		return 1;
+	}
+
+	int sizeofY = 0;
+	for (struct VertexList* e=v->neighborhood; e!=NULL; e=e->next) {
+		if (e->endPoint->visited < v->visited) {
+			++sizeofY;
+		}
+	}
+	if (sizeofY < sizeofX) {
+		return 0;
+	}
+
+	struct Graph* B = getCachedGraph(sizeofX + sizeofY, cachedB);
+	B->number = sizeofX;
+
+	/* add vertex numbers of original vertices to ->lowPoint of each vertex in B
+	and add edge labels to vertex labels to compare edges easily */
+	int i = 0;
+	for (struct VertexList* e=u->neighborhood; e!=NULL; e=e->next) {
+		if (e->endPoint->number != uParent) {
+			B->vertices[i]->lowPoint = e->endPoint->number;
+			B->vertices[i]->label = e->label;
+			++i;
+		}
+	}
+	for (struct VertexList* e=v->neighborhood; e!=NULL; e=e->next) {
+		if (e->endPoint->visited < v->visited) {
+			B->vertices[i]->lowPoint = e->endPoint->number;
+			B->vertices[i]->label = e->label;
+			++i;
+		}
+	}
+
+	/* add edge (x,w) if x has a rooted characteristic at w */
+	for (i=0; i<sizeofX; ++i) {
+		int x = B->vertices[i]->lowPoint;
+		for (int j=sizeofX; j<B->n; ++j) {
+			int w = B->vertices[j]->lowPoint;
+			if (labelCmp(B->vertices[i]->label, B->vertices[j]->label) == 0) {
+				if (getBit(current->S, rootedCharacteristicPosition(x, w, current->g->n))) {
+					addResidualEdges(B->vertices[i], B->vertices[j], gp->listPool);
+					++B->m;
+				}
+			}
+		}
+	}
+
+	char hasMatchingCoveringAll = bipartiteMatchingTerminateEarly(B);
+	returnCachedGraph(cachedB);
+	return hasMatchingCoveringAll;
+}
+
+
+/**
+Iterative Labeled Rooted Subtree Isomorphism Check.
+
+Input:
+	a text    forest g, rooted according to base.postorder
+	a pattern tree h, rooted at vertex 0
+	the data that was computed for h without its last vertex, or any data of g that has no
+	characteristics for this h (object pool data structures)
+
+Output:
+	yes, if h is rooted subgraph isomorphic to g, no otherwise
+	the rooted characteristics of h and g
+
+The rooted characteristic (u,v) states that the subtree of h below u has a rooted embedding
+into the subtree of g below v that maps u to v. Hence, h matches g iff there is a characteristic (0,v).
+
+If h is a refinementGraph() of base.h, that is, its last vertex b is a new leaf, only the subtrees
+of b and its ancestors change. The rows of all other vertices are copied from base. The new
+characteristics of an ancestor u can only be at vertices v where u had a characteristic for base.h,
+as the subtree of u in base.h is contained in its subtree in h. Thus, the embeddings of the
+parent pattern are extended, instead of computed from scratch.
+*/
+struct SubtreeIsoDataStore iterativeRootedSubtreeCheck(struct SubtreeIsoDataStore base, struct Graph* h, struct GraphPool* gp) {
+	struct SubtreeIsoDataStore info = {0};
+	info.g = base.g;
+	info.h = h;
+	info.postorder = base.postorder;
+
+	struct Graph* g = info.g;
+	if (g->n == 0) {
+		// if g is empty, then h only matches if it is empty as well.
+		info.foundIso = h->n == 0 ? 1 : 0;
+		return info;
+	}
+
+	info.S = createBitset(rootedCharacteristicPosition(h->n, 0, g->n));
+
+	int* parents = getParents(h, 0);
+	// the vertices of h whose rooted characteristics need to be computed, bottom up
+	int* changed = malloc(h->n * sizeof(int));
+	int nChanged = 0;
+	char hasBase = (base.S != NULL) && (base.h != NULL) && (base.h->n == h->n - 1);
+
+	if (hasBase) {
+		const size_t bytesOfBase = rootedCharacteristicPosition(base.h->n, 0, g->n) / 8;
+		memcpy(info.S, base.S, bytesOfBase);
+
+		int b = h->n - 1;
+		for (int vi=0; vi<g->n; ++vi) {
+			if (labelCmp(g->vertices[vi]->label, h->vertices[b]->label) == 0) {
+				setBitTrue(info.S, rootedCharacteristicPosition(b, vi, g->n));
+			}
+		}
+		for (int u=parents[b]; u!=-1; u=parents[u]) {
+			changed[nChanged] = u;
+			++nChanged;
+		}
+	} else {
+		int* postorder = getPostorder(h, 0);
+		memcpy(changed, postorder, h->n * sizeof(int));
+		nChanged = h->n;
+		free(postorder);
+	}
+
+	struct CachedGraph* cachedB = initCachedGraph(gp, h->n);
+
+	for (int i=0; i<nChanged; ++i) {
+		struct Vertex* u = h->vertices[changed[i]];
+		for (int vi=0; vi<g->n; ++vi) {
+			struct Vertex* v = g->vertices[info.postorder[vi]];
+			size_t position = rootedCharacteristicPosition(u->number, v->number, g->n);
+
+			if (hasBase) {
+				if (!getBit(base.S, position)) { continue; }
+				setBitFalse(info.S, position);
+			} else {
+				if (labelCmp(u->label, v->label) != 0) { continue; }
+			}
+
+			if (computeRootedCharacteristic(&info, cachedB, u, parents[u->number], v, gp)) {
+				setBitTrue(info.S, position);
+				if (u->number == 0) {
+					info.foundIso = 1;
+				}
+			}
+		}
+	}
+
+	dumpCachedGraph(cachedB);
+	free(changed);
+	free(parents);
+	return info;
+}
@@ -43,6 +43,7 @@ char isSubtree(struct Graph* g, struct Graph* h, struct GraphPool* gp);
 
 struct Vertex* computeRootedSubtreeEmbedding(struct Graph* g, struct Vertex* gRoot, struct Graph* h, struct Vertex* hRoot, struct GraphPool* gp);
 struct SubtreeIsoDataStore noniterativeRootedSubtreeCheck(struct SubtreeIsoDataStore base, struct Graph* h, struct Vertex** rootEmbedding, struct GraphPool* gp);
+struct SubtreeIsoDataStore iterativeRootedSubtreeCheck(struct SubtreeIsoDataStore base, struct Graph* h, struct GraphPool* gp);
 
 // INITIALIZATORS
 
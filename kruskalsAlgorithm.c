@@ -1,6 +1,7 @@
 #include <stdlib.h>
 
 #include "graph.h"
+#include "kruskalsAlgorithm.h"
 
 static struct Vertex* getRoot(struct Vertex* v) {
 	struct Vertex* r = v;
@@ -56,3 +57,118 @@ struct ShallowGraph* kruskalMST(struct Graph* g, struct VertexList** sortedEdges
 	dumpGraph(gp, branching);
 	return spanningTree;
 }
+
+
+/**
+ * Create a sampler for random spanning trees of g. g must not be changed or freed while the sampler is used.
+ */
+struct KruskalSampler* createKruskalSampler(struct Graph* g) {
+	struct KruskalSampler* ks = malloc(sizeof(struct KruskalSampler));
+	ks->g = g;
+	ks->n = g->n;
+	ks->m = 0;
+	for (int v=0; v<g->n; ++v) {
+		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+			if (e->endPoint->number > v) {
+				++ks->m;
+			}
+		}
+	}
+
+	ks->edges = malloc(ks->m * sizeof(struct VertexList*));
+	ks->from = malloc(ks->m * sizeof(int));
+	ks->to = malloc(ks->m * sizeof(int));
+	// getGraphEdges() pushes the edges, hence they are stored backwards
+	int i = ks->m;
+	for (int v=0; v<g->n; ++v) {
+		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+			if (e->endPoint->number > v) {
+				--i;
+				ks->edges[i] = e;
+				ks->from[i] = v;
+				ks->to[i] = e->endPoint->number;
+			}
+		}
+	}
+
+	ks->order = malloc(ks->m * sizeof(int));
+	ks->parent = malloc(ks->n * sizeof(int));
+	ks->rank = malloc(ks->n * sizeof(char));
+	ks->tree = malloc(ks->n * sizeof(int));
+	ks->nTreeEdges = 0;
+	return ks;
+}
+
+
+void freeKruskalSampler(struct KruskalSampler* ks) {
+	free(ks->edges);
+	free(ks->from);
+	free(ks->to);
+	free(ks->order);
+	free(ks->parent);
+	free(ks->rank);
+	free(ks->tree);
+	free(ks);
+}
+
+
+static int findRoot(int* parent, int v) {
+	while (parent[v] != v) {
+		parent[v] = parent[parent[v]];
+		v = parent[v];
+	}
+	return v;
+}
+
+
+/**
+ * Draw a random spanning tree of ks->g and store it in ks->tree.
+ *
+ * The edges are permuted by the same shuffle as sampleSpanningTreesUsingKruskalOnce() used before, starting
+ * from the order of getGraphEdges() for each tree. Hence, the same seed results in the same trees.
+ */
+void kruskalSampleTree(struct KruskalSampler* ks, struct RandomNumberGenerator* rng) {
+	for (int i=0; i<ks->m; ++i) {
+		ks->order[i] = i;
+	}
+	for (int i=ks->m-1; i>0; --i) {
+		int j = randomIntBelow(rng, i);
+		int t = ks->order[j];
+		ks->order[j] = ks->order[i];
+		ks->order[i] = t;
+	}
+
+	for (int v=0; v<ks->n; ++v) {
+		ks->parent[v] = v;
+		ks->rank[v] = 0;
+	}
+	ks->nTreeEdges = 0;
+	for (int i=0; (i<ks->m) && (ks->nTreeEdges < ks->n - 1); ++i) {
+		int e = ks->order[i];
+		int rv = findRoot(ks->parent, ks->from[e]);
+		int rw = findRoot(ks->parent, ks->to[e]);
+		if (rv != rw) {
+			if (ks->rank[rv] < ks->rank[rw]) {
+				ks->parent[rv] = rw;
+			} else {
+				ks->parent[rw] = rv;
+				if (ks->rank[rv] == ks->rank[rw]) {
+					++ks->rank[rv];
+				}
+			}
+			ks->tree[ks->nTreeEdges++] = e;
+		}
+	}
+}
+
+
+/**
+ * Return the last drawn tree as list of edges of ks->g.
+ */
+struct ShallowGraph* kruskalTreeAsShallowGraph(struct KruskalSampler* ks, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph* tree = getShallowGraph(sgp);
+	for (int i=0; i<ks->nTreeEdges; ++i) {
+		appendEdge(tree, shallowCopyEdge(ks->edges[ks->tree[i]], sgp->listPool));
+	}
+	return tree;
+}
@@ -1,6 +1,41 @@
 #ifndef KRUSKALS_ALGORITHM_H_
 #define KRUSKALS_ALGORITHM_H_
 
+#include "graph.h"
+#include "randomNumberGenerator.h"
+
+/**
+ * Draws many random spanning trees of the same graph g by running Kruskals algorithm on random
+ * permutations of its edges.
+ *
+ * edges[i] is the i-th edge of g in the order of getGraphEdges(), and from[i], to[i] are the numbers
+ * of its endpoints. The connected components are stored in a union-find forest of integer arrays
+ * (union by rank, path halving). tree holds the indices of the nTreeEdges edges of the last drawn
+ * spanning tree (or spanning forest, if g is not connected).
+ */
+struct KruskalSampler {
+	struct Graph* g;
+	int n;
+	int m;
+	struct VertexList** edges;
+	int* from;
+	int* to;
+
+	// scratch space
+	int* order;
+	int* parent;
+	char* rank;
+
+	// the last drawn tree
+	int* tree;
+	int nTreeEdges;
+};
+
 struct ShallowGraph* kruskalMST(struct Graph* g, struct VertexList** sortedEdges, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 
+struct KruskalSampler* createKruskalSampler(struct Graph* g);
+void freeKruskalSampler(struct KruskalSampler* ks);
+void kruskalSampleTree(struct KruskalSampler* ks, struct RandomNumberGenerator* rng);
+struct ShallowGraph* kruskalTreeAsShallowGraph(struct KruskalSampler* ks, struct ShallowGraphPool* sgp);
+
 #endif
@@ -87,9 +87,9 @@ int* computeBlockDegrees(struct ShallowGraph* biconnectedComponents, int n) {
 
 
 int getMaxBlockDegree(struct Graph* g, struct ShallowGraphPool* sgp) {
+	(void)sgp; // unused
 	int maxDegree = -1;
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	int* cycleDegrees = computeBlockDegrees(biconnectedComponents, g->n);
+	int* cycleDegrees = getCachedBlockDegrees(g);
 
 	int v;
 	for (v=0; v<g->n; ++v) {
@@ -97,17 +97,14 @@ int getMaxBlockDegree(struct Graph* g, struct ShallowGraphPool* sgp) {
 			maxDegree = cycleDegrees[v];
 		}
 	}
-
-	free(cycleDegrees);
-	dumpShallowGraphCycle(sgp, biconnectedComponents);
 	return maxDegree;
 }
 
 
 int getMinBlockDegree(struct Graph* g, struct ShallowGraphPool* sgp) {
+	(void)sgp; // unused
 	int minDegree = INT_MAX;
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	int* cycleDegrees = computeBlockDegrees(biconnectedComponents, g->n);
+	int* cycleDegrees = getCachedBlockDegrees(g);
 
 	int v;
 	for (v=0; v<g->n; ++v) {
@@ -115,25 +112,17 @@ int getMinBlockDegree(struct Graph* g, struct ShallowGraphPool* sgp) {
 			minDegree = cycleDegrees[v];
 		}
 	}
-
-	free(cycleDegrees);
-	dumpShallowGraphCycle(sgp, biconnectedComponents);
 	return minDegree;
 }
 
 
 /**
-Count the number of biconnected components that are not a bridge.
+Count the number of biconnected components of g, including the bridges. Isolated vertices do not form a
+biconnected component. The count is taken from the cached decomposition, see getBlockDecomposition().
 */
 int getNumberOfBiconnectedComponents(struct Graph* g, struct ShallowGraphPool* sgp) {
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	int compNumber = 0;
-	for (struct ShallowGraph* comp = biconnectedComponents; comp!=NULL; comp=comp->next) {
-			++compNumber;
-	}
-	/* cleanup */
-	dumpShallowGraphCycle(sgp, biconnectedComponents);
-	return compNumber;
+	(void)sgp; // unused
+	return getBlockDecomposition(g)->nBlocks;
 }
 
 
@@ -144,17 +133,9 @@ int getNumberOfBlocks(struct Graph* g, struct ShallowGraphPool* sgp) {
 	if (g->m == 0) {
 		return 0;
 	}
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	struct ShallowGraph* comp;
-	int compNumber = 0;
-	for (comp = biconnectedComponents; comp!=NULL; comp=comp->next) {
-		if (comp->m > 1) {
-			++compNumber;
-		}			
-	}
-	/* cleanup */
-	dumpShallowGraphCycle(sgp, biconnectedComponents);
-	return compNumber;
+	(void)sgp; // unused
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	return d->nBlocks - d->nBridges;
 }
 
 
@@ -177,17 +158,8 @@ Count the number of edges in the graph that are bridges.
 I.e. count the number of biconnected components with only one edge.
 */
 int getNumberOfBridges(struct Graph* g, struct ShallowGraphPool* sgp) {
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	struct ShallowGraph* comp;
-	int bridgeNumber = 0;
-	for (comp = biconnectedComponents; comp!=NULL; comp=comp->next) {
-		if (comp->m == 1) {
-			++bridgeNumber;
-		}			
-	}
-	/* cleanup */
-	dumpShallowGraphCycle(sgp, biconnectedComponents);
-	return bridgeNumber;
+	(void)sgp; // unused
+	return getBlockDecomposition(g)->nBridges;
 }
 
 
@@ -196,7 +168,7 @@ Count the number of connected components in the graph obtained from g by removin
 all block edges (i.e. all edges that are not bridges)
 */
 int getNumberOfBridgeTrees(struct Graph* g, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
-	struct ShallowGraph* h = listBiconnectedComponents(g, sgp);
+	struct ShallowGraph* h = getBlocksAsShallowGraphs(getBlockDecomposition(g), sgp);
 	struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
 	int nConnectedComponents = getAndMarkConnectedComponents(forest);
 	dumpGraphList(gp, forest);
@@ -324,77 +296,271 @@ int getAndMarkConnectedComponents(struct Graph* g) {
 
 
 /**
-Finds the biconnected components of a graph. 
-The stack argument has to contain an artificial vertex which will be interpreted as the head
-of a list that is used as a stack. This is necessary to not change the pointer to the first element of the list.
+Moves the edges on top of edgeStack that belong to the block entered by the dfs via the tree edge from u to child
+to a new block of d. These are all edges above and including the tree edge, which are exactly the edges whose
+start points have a dfs depth at least as large as the one of child, plus the tree edge itself.
 
-The output of this function will be a doubly connected cycle of ShallowGraph structs which each contain a
-list of cloned edges of the graph edges and each represent a biconnected component of the graph.
-
-The ShallowGraphs contain a field m which specifies the number of contained edges. Iff this number is larger
-than 1, the component is 2-connected and each edge is contained in a cycle.
+Returns the new size of the edge stack.
  */
-struct ShallowGraph* __tarjanFBC(struct Vertex *v, struct Vertex* w, int i, struct VertexList* stack, struct ListPool* lp, struct ShallowGraphPool* gp) {
-	struct VertexList *index, *stackEdge;
+static int popBlock(struct BiconnectedDecomposition* d, struct VertexList** edgeStack, int stackSize, struct Vertex* u, struct Vertex* child) {
+	int top = stackSize;
+	int block = d->nBlocks;
 
-	struct ShallowGraph* graphList = NULL;
-	struct ShallowGraph* tmp;
+	while (edgeStack[top - 1]->startPoint->visited >= child->visited) {
+		--top;
+	}
+	/* the tree edge (u, child) */
+	--top;
+
+	d->blockTop[block] = u->number;
+	for (int i=top; i<stackSize; ++i) {
+		struct VertexList* e = edgeStack[i];
+		d->edges[d->blockStart[block] + i - top] = e;
+		if (e->startPoint != u) {
+			d->parentBlock[e->startPoint->number] = block;
+		}
+		if (e->endPoint != u) {
+			d->parentBlock[e->endPoint->number] = block;
+		}
+	}
+	d->blockStart[block + 1] = d->blockStart[block] + stackSize - top;
+	if (stackSize - top == 1) {
+		++d->nBridges;
+	}
+	++d->nBlocks;
+	return top;
+}
 
-	/* set the lowest occurrence of a vertex in the current cycle to the current vertex */
-	v->lowPoint = i + 1;
-	/* assign dfs-numbers */
-	v->visited = i + 1;
 
-	for (index = v->neighborhood; index; index = index->next) {
-		if (!(index->endPoint->visited)) {
-			/* add copy of the current edge to stack of edges, head of the stack remains the head! */
-			stack->next = push(stack->next, shallowCopyEdge(index, lp));
+static void markArticulationPoint(struct BiconnectedDecomposition* d, int v) {
+	if (!d->isArticulationPoint[v]) {
+		d->isArticulationPoint[v] = 1;
+		++d->nArticulationPoints;
+	}
+}
 
-			/* recursive call */
-			tmp = __tarjanFBC(index->endPoint, v, i + 1, stack, lp, gp);
 
-			/* add output to component list */
-			graphList = addComponent(graphList, tmp);
+/**
+Hopcroft and Tarjans algorithm for finding the biconnected components of an undirected graph, using an explicit
+dfs stack instead of recursion. Hence, it can handle graphs with long paths or chains of blocks that would
+overflow the call stack of a recursive implementation.
 
-			/* TODO comment */
-			v->lowPoint = min(v->lowPoint, index->endPoint->lowPoint);
+The edges of each block are stored in a contiguous range of the returned struct. They are pointers to the edges
+in the adjacency lists of g, not copies, and are only valid as long as g is not changed or dumped.
+The order of the blocks and of the edges in each block is the same as in the output of listBiconnectedComponents().
+In addition, the algorithm marks the articulation points of g and stores the information necessary to construct
+the block-cut tree (see getBlockCutTree()).
 
-			if (index->endPoint->lowPoint >= v->visited) {
+As a side effect, v->visited is set to the dfs depth of v plus one and v->lowPoint is set to the lowpoint
+of v in the same numbering for each vertex v of g.
 
-				/* start new biconnected component */
-				struct ShallowGraph* newBiconnectedComponent = getShallowGraph(gp);
-				for (stackEdge = stack->next; stackEdge->startPoint->visited >= index->endPoint->visited; stackEdge = stack->next) {
-					/* pop stackEdge and add it to the newBiconnectedComponent */
-					stack->next = stackEdge->next;
-					pushEdge(newBiconnectedComponent, stackEdge);
-//					newBiconnectedComponent->edges = push(newBiconnectedComponent->edges, stackEdge);
-//					++(newBiconnectedComponent->m);
-				}
+runtime: O(n+m). Returns NULL if memory allocation fails.
+ */
+struct BiconnectedDecomposition* computeBiconnectedDecomposition(struct Graph* g) {
+	struct BiconnectedDecomposition* d = malloc(sizeof(struct BiconnectedDecomposition));
+	int nEntries = 0;
+	int stackSize = 0;
+
+	for (int v=0; v<g->n; ++v) {
+		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+			++nEntries;
+		}
+	}
+
+	/* each edge is pushed at most once, either as tree edge or as back edge from the deeper vertex */
+	struct VertexList** edgeStack = malloc((nEntries + 1) * sizeof(struct VertexList*));
+	struct Vertex** path = malloc((g->n + 1) * sizeof(struct Vertex*));
+	struct VertexList** iterator = malloc((g->n + 1) * sizeof(struct VertexList*));
+
+	if (d) {
+		d->n = g->n;
+		d->nBlocks = 0;
+		d->nArticulationPoints = 0;
+		d->nBridges = 0;
+		d->blockDegrees = NULL;
+		d->criticality = NULL;
+		d->edges = malloc((nEntries + 1) * sizeof(struct VertexList*));
+		d->blockStart = malloc((nEntries + 1) * sizeof(int));
+		d->blockTop = malloc((nEntries + 1) * sizeof(int));
+		d->parentBlock = malloc((g->n + 1) * sizeof(int));
+		d->isArticulationPoint = calloc(g->n + 1, sizeof(char));
+		d->visited = malloc((g->n + 1) * sizeof(int));
+		d->lowPoint = malloc((g->n + 1) * sizeof(int));
+	}
+	if (!d || !edgeStack || !path || !iterator || !d->edges || !d->blockStart || !d->blockTop || !d->parentBlock
+			|| !d->isArticulationPoint || !d->visited || !d->lowPoint) {
+		fprintf(stderr, "Error allocating memory for biconnected components of graph %i\n", g->number);
+		free(edgeStack);
+		free(path);
+		free(iterator);
+		freeBiconnectedDecomposition(d);
+		return NULL;
+	}
+
+	d->blockStart[0] = 0;
+	for (int v=0; v<g->n; ++v) {
+		g->vertices[v]->visited = 0;
+		d->parentBlock[v] = -1;
+	}
+
+	for (int r=0; r<g->n; ++r) {
+		struct Vertex* root = g->vertices[r];
+		int depth = 0;
+		int rootChildren = 0;
 
-				/* pop index edge */
-				stack->next = stackEdge->next;
-				pushEdge(newBiconnectedComponent, stackEdge);
-//				newBiconnectedComponent->edges = push(newBiconnectedComponent->edges, stackEdge);
-//				++(newBiconnectedComponent->m);
+		if (root->visited) {
+			continue;
+		}
 
-				/* set the prev and next pointers s.t. newBiconnectedComponent is "a cycle of length 1" */
-				newBiconnectedComponent->next = newBiconnectedComponent;
-				newBiconnectedComponent->prev = newBiconnectedComponent;
+		root->visited = 1;
+		root->lowPoint = 1;
+		path[0] = root;
+		iterator[0] = root->neighborhood;
+
+		while (depth >= 0) {
+			struct Vertex* v = path[depth];
+			struct VertexList* e = iterator[depth];
+
+			if (e == NULL) {
+				/* v is finished, return to its parent u. iterator[depth] still points to the tree edge (u, v) */
+				--depth;
+				if (depth >= 0) {
+					struct Vertex* u = path[depth];
+					u->lowPoint = min(u->lowPoint, v->lowPoint);
+					if (v->lowPoint >= u->visited) {
+						stackSize = popBlock(d, edgeStack, stackSize, u, v);
+						if (depth > 0) {
+							markArticulationPoint(d, u->number);
+						} else {
+							++rootChildren;
+						}
+					}
+					iterator[depth] = iterator[depth]->next;
+				}
+				continue;
+			}
 
-				/* add new biconnected component to the list of components */
-				graphList = addComponent(graphList, newBiconnectedComponent);
+			if (!(e->endPoint->visited)) {
+				/* tree edge: descend, iterator[depth] is advanced when we return */
+				struct Vertex* w = e->endPoint;
+				edgeStack[stackSize++] = e;
+				w->visited = depth + 2;
+				w->lowPoint = depth + 2;
+				++depth;
+				path[depth] = w;
+				iterator[depth] = w->neighborhood;
+			} else {
+				/* if the edge leads to a vertex that was already visited and is not the edge on which we
+				entered the vertex, we have found a cycle and add the edge to the stack. */
+				struct Vertex* parent = (depth > 0) ? path[depth - 1] : v;
+				if ((e->endPoint->visited < v->visited) && (e->endPoint->number != parent->number)) {
+					edgeStack[stackSize++] = e;
+					v->lowPoint = min(v->lowPoint, e->endPoint->visited);
+				}
+				iterator[depth] = e->next;
 			}
+		}
+
+		if (rootChildren > 1) {
+			markArticulationPoint(d, root->number);
+		}
+	}
+
+	for (int v=0; v<g->n; ++v) {
+		d->visited[v] = g->vertices[v]->visited;
+		d->lowPoint[v] = g->vertices[v]->lowPoint;
+	}
+
+	free(edgeStack);
+	free(path);
+	free(iterator);
+	return d;
+}
+
+
+void freeBiconnectedDecomposition(struct BiconnectedDecomposition* d) {
+	if (d) {
+		free(d->edges);
+		free(d->blockStart);
+		free(d->blockTop);
+		free(d->parentBlock);
+		free(d->isArticulationPoint);
+		free(d->visited);
+		free(d->lowPoint);
+		free(d->blockDegrees);
+		free(d->criticality);
+		free(d);
+	}
+}
+
+
+/**
+Return block b of d as a ShallowGraph containing copies of the edges of the block.
+ */
+struct ShallowGraph* getBlockAsShallowGraph(struct BiconnectedDecomposition* d, int b, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph* block = getShallowGraph(sgp);
+	for (int i=d->blockStart[b+1]-1; i>=d->blockStart[b]; --i) {
+		pushEdge(block, shallowCopyEdge(d->edges[i], sgp->listPool));
+	}
+	return block;
+}
+
+
+/**
+Return all blocks of d as a list of ShallowGraphs in the order of listBiconnectedComponents().
+The edges in the ShallowGraphs are copies, hence the list may be altered and consumed by the caller.
+ */
+struct ShallowGraph* getBlocksAsShallowGraphs(struct BiconnectedDecomposition* d, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph *allComponents = NULL;
+	struct ShallowGraph *last = NULL;
+
+	for (int b=0; b<d->nBlocks; ++b) {
+		struct ShallowGraph* block = getBlockAsShallowGraph(d, b, sgp);
+		block->prev = last;
+		if (last) {
+			last->next = block;
 		} else {
-			/* if the edge leads to a vertex that was already visited and is not the edge on which we 
-			entered the vertex, we have found a cycle and add the edge to the stack. */
-			if ((index->endPoint->visited < v->visited) && (index->endPoint->number != w->number)) {
-				/* add index to the edge stack */
-				stack->next = push(stack->next, shallowCopyEdge(index, lp));
-				v->lowPoint = min(v->lowPoint, index->endPoint->visited);
-			} 
+			allComponents = block;
+		}
+		last = block;
+	}
+	return allComponents;
+}
+
+
+/**
+Construct the block-cut tree (or forest, if g is not connected) of a graph from its biconnected decomposition.
+Vertices 0, ..., d->nBlocks - 1 of the result correspond to the blocks of g, the remaining vertices correspond to
+the articulation points of g in increasing order of their number. The ->lowPoint of each articulation point vertex
+stores the number of the corresponding vertex in g.
+
+A block and an articulation point are adjacent, if the articulation point is contained in the block. Each
+articulation point v is contained in the block through which the dfs entered v (if v is not a dfs root) and in
+all blocks that were entered from v.
+ */
+struct Graph* getBlockCutTree(struct BiconnectedDecomposition* d, struct GraphPool* gp) {
+	int* cutVertex = malloc(d->n * sizeof(int));
+	int nCutVertices = d->nBlocks;
+	for (int v=0; v<d->n; ++v) {
+		cutVertex[v] = d->isArticulationPoint[v] ? nCutVertices++ : -1;
+	}
+
+	struct Graph* tree = createGraph(nCutVertices, gp);
+	for (int v=0; v<d->n; ++v) {
+		if (cutVertex[v] != -1) {
+			tree->vertices[cutVertex[v]]->lowPoint = v;
+			if (d->parentBlock[v] != -1) {
+				addEdgeBetweenVertices(d->parentBlock[v], cutVertex[v], NULL, tree, gp);
+			}
+		}
+	}
+	for (int b=0; b<d->nBlocks; ++b) {
+		if (cutVertex[d->blockTop[b]] != -1) {
+			addEdgeBetweenVertices(b, cutVertex[d->blockTop[b]], NULL, tree, gp);
 		}
 	}
-	return graphList;
+	free(cutVertex);
+	return tree;
 }
 
 
@@ -402,52 +568,130 @@ struct ShallowGraph* __tarjanFBC(struct Vertex *v, struct Vertex* w, int i, stru
 Convenience method to call Tarjans algorithm for finding all biconnected components of an undirected graph.
 Input:
 - A graph
-- A ListPool struct to manage VertexList structs
 - A GraphPool struct to manage Shallowgraph structs
 
+The output of this function is a list of ShallowGraph structs which each contain a list of cloned edges of the
+graph edges and each represent a biconnected component of the graph.
+
+The ShallowGraphs contain a field m which specifies the number of contained edges. Iff this number is larger
+than 1, the component is 2-connected and each edge is contained in a cycle.
+
 tarjans algorithm to find biconnected components is applied to each connected component of the graph once,
-yielding a runtime of O(m+n).
+yielding a runtime of O(m+n). See computeBiconnectedDecomposition() for a version that does not copy edges.
 
 This algorithm requires g to contain at least one edge.
  */
 struct ShallowGraph* listBiconnectedComponents(struct Graph* g, struct ShallowGraphPool *gp) {
-	int i;
+	struct BiconnectedDecomposition* d = computeBiconnectedDecomposition(g);
+	struct ShallowGraph *allComponents = NULL;
+
+	if (d == NULL) {
+		return NULL;
+	}
+
+	allComponents = getBlocksAsShallowGraphs(d, gp);
+	if (allComponents == NULL) {
+		/* this case should not occur */
+		fprintf(stderr, "Error: No biconnected components found in graph %i\n", g->number);
+	}
 
-	/* __tarjanFBC needs a static (artificial) head of stack */
-	struct VertexList *headOfStack = getVertexList(gp->listPool);
+	freeBiconnectedDecomposition(d);
+	return allComponents;
+}
 
-	/* this is where the magic happens. For all vertices: if the vertex is not visited yet,
-	 * start find biconnected components for its connected component. This yields a list of
-	 * all biconnected components in the graph. */
-	struct ShallowGraph *allComponents = NULL;
 
-	/* init ->visited to zero */
-	for (i=0; i<g->n; ++i) {
-		g->vertices[i]->visited = 0;
+/************************* Cached Block Decomposition **************************/
+
+
+/**
+Return the biconnected decomposition of g. It is computed on the first call and stored with g until g is changed
+by one of the graph level functions in graph.c (e.g. addEdgeBetweenVertices(), deleteEdge()) or dumped.
+Code that alters the adjacency lists of g directly has to call invalidateBlockDecomposition().
+
+The result belongs to g and must not be freed by the caller. It is never NULL: as the callers cannot report
+errors, the program is aborted if the decomposition cannot be allocated.
+->visited and ->lowPoint of the vertices of g are set to the same values as by computeBiconnectedDecomposition(),
+even if the decomposition is taken from the cache.
+ */
+struct BiconnectedDecomposition* getBlockDecomposition(struct Graph* g) {
+	if (g->blocks == NULL) {
+		g->blocks = computeBiconnectedDecomposition(g);
+		if (g->blocks == NULL) {
+			abort();
+		}
+	} else {
+		for (int v=0; v<g->n; ++v) {
+			g->vertices[v]->visited = g->blocks->visited[v];
+			g->vertices[v]->lowPoint = g->blocks->lowPoint[v];
+		}
+	}
+	return g->blocks;
+}
+
+
+void invalidateBlockDecomposition(struct Graph* g) {
+	if (g->blocks != NULL) {
+		freeBiconnectedDecomposition(g->blocks);
+		g->blocks = NULL;
 	}
+}
+
+
+/**
+For each vertex of d, count the number of blocks with at least minEdges edges that contain it.
+ */
+static int* countBlocksPerVertex(struct BiconnectedDecomposition* d, int minEdges) {
+	/* store for each vertex if the current block was already counted */
+	int* occurrences = malloc(d->n * sizeof(int));
+	int* degrees = malloc(d->n * sizeof(int));
 
-	for (i=0; i<g->n; ++i) {
-		if (g->vertices[i]->visited == 0) {
-			struct ShallowGraph* currentComponents = __tarjanFBC(g->vertices[i], g->vertices[i], 0, headOfStack, gp->listPool, gp);
-			allComponents = addComponent(allComponents, currentComponents);
+	for (int v=0; v<d->n; ++v) {
+		occurrences[v] = -1;
+		degrees[v] = 0;
+	}
+	for (int b=0; b<d->nBlocks; ++b) {
+		if (d->blockStart[b+1] - d->blockStart[b] < minEdges) {
+			continue;
+		}
+		for (int i=d->blockStart[b]; i<d->blockStart[b+1]; ++i) {
+			int v = d->edges[i]->startPoint->number;
+			int w = d->edges[i]->endPoint->number;
+			if (occurrences[v] < b) {
+				occurrences[v] = b;
+				++degrees[v];
+			}
+			if (occurrences[w] < b) {
+				occurrences[w] = b;
+				++degrees[w];
+			}
 		}
 	}
+	free(occurrences);
+	return degrees;
+}
 
 
-	/* __tarjanFBC returns a cycle of ShallowGraphs. Convert it to a list */
-	if (allComponents) {
-		allComponents->prev->next = NULL;
-		allComponents->prev = NULL;
-	} else {
-		/* this case should not occur */
-		fprintf(stderr, "Error: No cycle of shallow graphs after __tarjanFBC\n");
+/**
+Cached version of computeBlockDegrees(). The result belongs to g and must not be freed by the caller.
+ */
+int* getCachedBlockDegrees(struct Graph* g) {
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	if (d->blockDegrees == NULL) {
+		d->blockDegrees = countBlocksPerVertex(d, 2);
 	}
+	return d->blockDegrees;
+}
 
-	/* garbage collection */
-	dumpVertexList(gp->listPool, headOfStack);
 
-	/*return results */
-	return allComponents;
+/**
+Cached version of computeCriticality(). The result belongs to g and must not be freed by the caller.
+ */
+int* getCachedCriticality(struct Graph* g) {
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	if (d->criticality == NULL) {
+		d->criticality = countBlocksPerVertex(d, 1);
+	}
+	return d->criticality;
 }
 
 
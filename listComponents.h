@@ -3,6 +3,30 @@
 
 #include "graph.h"
 
+/**
+ * The biconnected components (blocks) of a graph, computed by computeBiconnectedDecomposition().
+ * The edges of block b are edges[blockStart[b]], ..., edges[blockStart[b+1] - 1].
+ */
+struct BiconnectedDecomposition {
+	int n;
+	int nBlocks;
+	struct VertexList** edges;
+	int* blockStart;
+	/* the vertex from which the dfs entered block b */
+	int* blockTop;
+	/* the block containing the dfs tree edge to v, or -1 if v is a dfs root */
+	int* parentBlock;
+	char* isArticulationPoint;
+	int nArticulationPoints;
+	/* number of blocks that consist of a single edge */
+	int nBridges;
+	/* ->visited and ->lowPoint of each vertex after the dfs */
+	int* visited;
+	int* lowPoint;
+	/* computed on demand by getCachedBlockDegrees() and getCachedCriticality() */
+	int* blockDegrees;
+	int* criticality;
+};
 
 void markConnectedComponent(struct Vertex *v, int component);
 int getAndMarkConnectedComponents(struct Graph* g);
@@ -23,5 +47,16 @@ int getMinBlockDegree(struct Graph* g, struct ShallowGraphPool* sgp);
 struct Graph* partitionIntoForestAndCycles(struct ShallowGraph* list, struct Graph* original, struct GraphPool* p, struct ShallowGraphPool* gp);
 struct ShallowGraph* listBiconnectedComponents(struct Graph* g, struct ShallowGraphPool* gp);
 
+struct BiconnectedDecomposition* computeBiconnectedDecomposition(struct Graph* g);
+void freeBiconnectedDecomposition(struct BiconnectedDecomposition* d);
+struct ShallowGraph* getBlockAsShallowGraph(struct BiconnectedDecomposition* d, int b, struct ShallowGraphPool* sgp);
+struct ShallowGraph* getBlocksAsShallowGraphs(struct BiconnectedDecomposition* d, struct ShallowGraphPool* sgp);
+struct Graph* getBlockCutTree(struct BiconnectedDecomposition* d, struct GraphPool* gp);
+
+struct BiconnectedDecomposition* getBlockDecomposition(struct Graph* g);
+void invalidateBlockDecomposition(struct Graph* g);
+int* getCachedBlockDegrees(struct Graph* g);
+int* getCachedCriticality(struct Graph* g);
+
 
 #endif /* LIST_COMPONENTS_H_ */
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
+#include <limits.h>
 
 #include "listComponents.h"
 #include "listCycles.h"
@@ -7,105 +9,31 @@
 #include "searchTree.h"
 
 
+/* Get the number of simple cycles the graph contains or -1 if there are more than INT_MAX. */
 int getNumberOfSimpleCycles(struct Graph* g, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
-	struct Graph* tmp;
-	struct Graph* idx;
-	int numCycles = 0;
-
-	/* find biconnected Components */
-	struct ShallowGraph* h = listBiconnectedComponents(g, sgp);
-	struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
-	/* TODO refactor */
-	struct Graph* biconnectedComponents = forest->next;
-
-	/* list all cycles */
-	struct ShallowGraph* simpleCycles = NULL;
-
-
-	for (idx=biconnectedComponents; idx; idx=idx->next) {
-		simpleCycles = addComponent(simpleCycles, listCycles(idx, sgp));
-	}
-
-	/* if cycles were found, compute canonical strings */
-	if (simpleCycles) {
-		struct ShallowGraph* cycle = NULL;
-
-		/* transform cycle of shallow graphs to a list */
-		simpleCycles->prev->next = NULL;
-		simpleCycles->prev = NULL;
-
-		for (cycle=simpleCycles; cycle!=NULL; cycle=cycle->next) {
-			++numCycles;
-		}
-
-		dumpShallowGraphCycle(sgp, simpleCycles);
-	} 
-
-	/* garbage collection */
-	for (idx=biconnectedComponents; idx; idx=tmp) {
-		tmp = idx->next;
-		dumpGraph(gp, idx);
-	}
-	dumpGraph(gp, forest);
-
-	/* each cycle is found twice */
-	return numCycles / 2;
+	(void)sgp;
+	(void)gp;
+	char truncated = 0;
+	// count one cycle more than INT_MAX to tell "exactly INT_MAX" from "more"
+	long int numCycles = countCycles(g, NULL, (long int)INT_MAX + 1, 0, &truncated);
+	return truncated ? -1 : (int)numCycles;
 }
 
 
 /* Get the number of nonisomorphic simple cycles the graph contains. */
 int getNumberOfNonIsoCycles(struct Graph* g, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
-	struct Graph* tmp;
-	struct Graph* idx;
-	int numCycles;
-
-	/* find biconnected Components */
-	struct ShallowGraph* h = listBiconnectedComponents(g, sgp);
-	struct Graph* forest = partitionIntoForestAndCycles(h, g, gp, sgp);
-	/* TODO refactor */
-	struct Graph* biconnectedComponents = forest->next;
-
-	/* list all cycles */
-	struct ShallowGraph* simpleCycles = NULL;
-	struct ShallowGraph* cyclePatterns = NULL;
-	struct Vertex* cyclePatternSearchTree = NULL;
-
-	for (idx=biconnectedComponents; idx; idx=idx->next) {
-		simpleCycles = addComponent(simpleCycles, listCycles(idx, sgp));
-	}
+	int numCycles = 0;
+	struct ShallowGraph* simpleCycles = listCyclesOnce(g, 0, 0, NULL, sgp);
 
 	/* if cycles were found, compute canonical strings */
 	if (simpleCycles) {
-		/* transform cycle of shallow graphs to a list */
-		simpleCycles->prev->next = NULL;
-		simpleCycles->prev = NULL;
-
-		cyclePatterns = getCyclePatterns(simpleCycles, sgp);
-		cyclePatternSearchTree = buildSearchTree(cyclePatterns, gp, sgp);
-
+		struct ShallowGraph* cyclePatterns = getCyclePatterns(simpleCycles, sgp);
+		struct Vertex* cyclePatternSearchTree = buildSearchTree(cyclePatterns, gp, sgp);
 		numCycles = cyclePatternSearchTree->number;
-	} else {
-		numCycles = 0;
+		dumpSearchTree(gp, cyclePatternSearchTree);
 	}
 
-	/* garbage collection */
-
-	/* dump cycles, if any
-	 * TODO may be moved upwards directly after finding simple cycles */
-	if (cyclePatternSearchTree) {
-			dumpSearchTree(gp, cyclePatternSearchTree);
-	}
-
-	/* dump biconnected components list */
-	for (idx=biconnectedComponents; idx; idx=tmp) {
-		tmp = idx->next;
-		dumpGraph(gp, idx);
-	}
-
-	dumpGraph(gp, forest);
-
-	/* each cycle is found twice */
-	return numCycles / 2;
+	return numCycles;
 }
 
 
@@ -456,4 +384,339 @@ struct ShallowGraph* listCyclesOfLength(struct Graph *g, int cycleLength, struct
 	}
 
 	return result;
-}
\ No newline at end of file
+}
+
+/******************************* Johnsons algorithm *********************************************/
+
+
+/**
+ * A single biconnected block of some graph as symmetric directed graph on local vertex ids 0, ..., n-1,
+ * together with the state of Johnsons algorithm.
+ * Each undirected edge e of the block results in two arcs. Arc a corresponds to edges[a], if reversed[a] == 0
+ * and to its inverse, otherwise.
+ */
+struct JohnsonBlock {
+	int n;
+	int* offsets;
+	int* targets;
+	int* sources;
+	struct VertexList** edges;
+	char* reversed;
+
+	/* Johnsons blocked set. The list B(v) is stored as a linked list of arcs (w, v) starting at bHead[v] */
+	char* blocked;
+	int* bHead;
+	int* bNext;
+	char* inB;
+
+	/* explicit dfs stack */
+	int* vertexAt;
+	int* stackArc;
+	int* position;
+	char* found;
+	int* unblockStack;
+};
+
+
+/**
+ * Limits and results of a single cycle enumeration run.
+ */
+struct JohnsonRun {
+	long int maxCycles;
+	double timeLimit;
+	struct timespec start;
+	long int steps;
+
+	long int nCycles;
+	long int* lengthHistogram;
+	struct ShallowGraph* cycles;
+	struct ShallowGraphPool* sgp;
+	char truncated;
+};
+
+
+static double secondsSince(struct timespec* start) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+
+static struct VertexList* copyArc(struct JohnsonBlock* b, int a, struct ListPool* lp) {
+	return b->reversed[a] ? inverseEdge(b->edges[a], lp) : shallowCopyEdge(b->edges[a], lp);
+}
+
+
+/**
+ * Report the cycle consisting of the arcs on the stack (levels 1, ..., depth) and the closing arc.
+ * Returns 0 if the enumeration has to stop due to the cycle limit.
+ */
+static char reportCycle(struct JohnsonBlock* b, int depth, int closingArc, struct JohnsonRun* run) {
+	int length = depth + 1;
+
+	++run->nCycles;
+	if (run->lengthHistogram) {
+		++run->lengthHistogram[length];
+	}
+	if (run->sgp) {
+		struct ShallowGraph* cycle = getShallowGraph(run->sgp);
+		for (int i=1; i<=depth; ++i) {
+			appendEdge(cycle, copyArc(b, b->stackArc[i], run->sgp->listPool));
+		}
+		appendEdge(cycle, copyArc(b, closingArc, run->sgp->listPool));
+		cycle->next = run->cycles;
+		run->cycles = cycle;
+	}
+	return (run->maxCycles <= 0) || (run->nCycles < run->maxCycles);
+}
+
+
+/**
+ * Iterative version of the UNBLOCK procedure of Johnsons algorithm.
+ */
+static void unblock(struct JohnsonBlock* b, int u) {
+	int top = 0;
+	b->unblockStack[top++] = u;
+	b->blocked[u] = 0;
+	while (top > 0) {
+		int v = b->unblockStack[--top];
+		for (int a=b->bHead[v]; a!=-1; a=b->bNext[a]) {
+			int w = b->sources[a];
+			b->inB[a] = 0;
+			if (b->blocked[w]) {
+				b->blocked[w] = 0;
+				b->unblockStack[top++] = w;
+			}
+		}
+		b->bHead[v] = -1;
+	}
+}
+
+
+/**
+ * Johnsons algorithm on the symmetric directed version of a block. For each start vertex s, the cycles
+ * through s in the subgraph induced by the vertices >= s are enumerated. Each undirected cycle of length at
+ * least three is found twice (once per direction) and reported only if the second vertex is smaller than the
+ * last one. Cycles s, v, s of length two are found, but not reported; they are still needed to keep the
+ * blocked sets of Johnsons algorithm correct.
+ *
+ * Returns 0 if the enumeration was stopped by the cycle or time limit.
+ */
+static char johnsonForBlock(struct JohnsonBlock* b, struct JohnsonRun* run) {
+	for (int s=0; s<b->n-2; ++s) {
+		for (int v=s; v<b->n; ++v) {
+			b->blocked[v] = 0;
+			b->bHead[v] = -1;
+		}
+		for (int a=b->offsets[s]; a<b->offsets[b->n]; ++a) {
+			b->inB[a] = 0;
+		}
+
+		int depth = 0;
+		int* vertexAt = b->vertexAt;
+		vertexAt[0] = s;
+		b->blocked[s] = 1;
+		b->found[0] = 0;
+		b->position[0] = b->offsets[s];
+
+		while (depth >= 0) {
+			int v = vertexAt[depth];
+
+			if ((run->timeLimit > 0) && ((++run->steps & 0xfff) == 0) && (secondsSince(&run->start) > run->timeLimit)) {
+				return 0;
+			}
+
+			if (b->position[depth] < b->offsets[v+1]) {
+				int a = b->position[depth]++;
+				int w = b->targets[a];
+				if (w < s) {
+					continue;
+				}
+				if (w == s) {
+					b->found[depth] = 1;
+					if ((depth >= 2) && (b->targets[b->stackArc[1]] < v)) {
+						if (!reportCycle(b, depth, a, run)) {
+							return 0;
+						}
+					}
+				} else if (!b->blocked[w]) {
+					++depth;
+					vertexAt[depth] = w;
+					b->stackArc[depth] = a;
+					b->blocked[w] = 1;
+					b->found[depth] = 0;
+					b->position[depth] = b->offsets[w];
+				}
+			} else {
+				/* v is finished */
+				if (b->found[depth]) {
+					unblock(b, v);
+				} else {
+					for (int a=b->offsets[v]; a<b->offsets[v+1]; ++a) {
+						int w = b->targets[a];
+						/* the arc (v, w) represents v in B(w) */
+						if ((w >= s) && !b->inB[a]) {
+							b->inB[a] = 1;
+							b->bNext[a] = b->bHead[w];
+							b->bHead[w] = a;
+						}
+					}
+				}
+				if (depth > 0) {
+					b->found[depth-1] |= b->found[depth];
+				}
+				--depth;
+			}
+		}
+	}
+	return 1;
+}
+
+
+/**
+ * Run Johnsons algorithm on each block of g that is not a bridge.
+ */
+static void enumerateCycles(struct Graph* g, struct JohnsonRun* run) {
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	struct JohnsonBlock b;
+	int nArcs = 2 * d->blockStart[d->nBlocks];
+	int* local = malloc(g->n * sizeof(int));
+
+	clock_gettime(CLOCK_MONOTONIC, &run->start);
+	run->steps = 0;
+	run->nCycles = 0;
+	run->cycles = NULL;
+	run->truncated = 0;
+
+	b.offsets = malloc((g->n + 1) * sizeof(int));
+	b.targets = malloc(nArcs * sizeof(int));
+	b.sources = malloc(nArcs * sizeof(int));
+	b.edges = malloc(nArcs * sizeof(struct VertexList*));
+	b.reversed = malloc(nArcs * sizeof(char));
+	b.blocked = malloc(g->n * sizeof(char));
+	b.bHead = malloc(g->n * sizeof(int));
+	b.bNext = malloc(nArcs * sizeof(int));
+	b.inB = malloc(nArcs * sizeof(char));
+	b.vertexAt = malloc(g->n * sizeof(int));
+	b.stackArc = malloc(g->n * sizeof(int));
+	b.position = malloc(g->n * sizeof(int));
+	b.found = malloc(g->n * sizeof(char));
+	b.unblockStack = malloc(g->n * sizeof(int));
+
+	for (int v=0; v<g->n; ++v) {
+		local[v] = -1;
+	}
+
+	for (int block=0; block<d->nBlocks; ++block) {
+		int first = d->blockStart[block];
+		int end = d->blockStart[block+1];
+		if (end - first < 3) {
+			continue;
+		}
+
+		/* number the vertices of the block and count their degrees */
+		b.n = 0;
+		for (int i=first; i<end; ++i) {
+			int v = d->edges[i]->startPoint->number;
+			int w = d->edges[i]->endPoint->number;
+			if (local[v] == -1) {
+				local[v] = b.n++;
+				b.offsets[local[v] + 1] = 0;
+			}
+			if (local[w] == -1) {
+				local[w] = b.n++;
+				b.offsets[local[w] + 1] = 0;
+			}
+			++b.offsets[local[v] + 1];
+			++b.offsets[local[w] + 1];
+		}
+		b.offsets[0] = 0;
+		for (int v=0; v<b.n; ++v) {
+			b.offsets[v+1] += b.offsets[v];
+			b.position[v] = b.offsets[v];
+		}
+
+		/* add both arcs of each edge */
+		for (int i=first; i<end; ++i) {
+			int v = local[d->edges[i]->startPoint->number];
+			int w = local[d->edges[i]->endPoint->number];
+			int a = b.position[v]++;
+			b.sources[a] = v;
+			b.targets[a] = w;
+			b.edges[a] = d->edges[i];
+			b.reversed[a] = 0;
+			a = b.position[w]++;
+			b.sources[a] = w;
+			b.targets[a] = v;
+			b.edges[a] = d->edges[i];
+			b.reversed[a] = 1;
+		}
+
+		char complete = johnsonForBlock(&b, run);
+
+		for (int i=first; i<end; ++i) {
+			local[d->edges[i]->startPoint->number] = -1;
+			local[d->edges[i]->endPoint->number] = -1;
+		}
+		if (!complete) {
+			run->truncated = 1;
+			break;
+		}
+	}
+
+	free(local);
+	free(b.offsets);
+	free(b.targets);
+	free(b.sources);
+	free(b.edges);
+	free(b.reversed);
+	free(b.blocked);
+	free(b.bHead);
+	free(b.bNext);
+	free(b.inB);
+	free(b.vertexAt);
+	free(b.stackArc);
+	free(b.position);
+	free(b.found);
+	free(b.unblockStack);
+}
+
+
+/**
+ * List all simple cycles of g, each undirected cycle exactly once, using Johnsons algorithm on each biconnected
+ * block of g. In contrast to listCycles(), g may be an arbitrary graph.
+ *
+ * The enumeration stops after maxCycles cycles or timeLimit seconds (if these are positive). In this case,
+ * *truncated is set to 1 and the cycles found so far are returned.
+ *
+ * Output: A NULL terminated list of ShallowGraphs, each containing the edges of one cycle in order.
+ */
+struct ShallowGraph* listCyclesOnce(struct Graph* g, long int maxCycles, double timeLimit, char* truncated, struct ShallowGraphPool* sgp) {
+	struct JohnsonRun run = {0};
+	run.maxCycles = maxCycles;
+	run.timeLimit = timeLimit;
+	run.sgp = sgp;
+	enumerateCycles(g, &run);
+	if (truncated) {
+		*truncated = run.truncated;
+	}
+	return run.cycles;
+}
+
+
+/**
+ * Count the simple cycles of g as listCyclesOnce() does, but without allocating anything per cycle.
+ * If lengthHistogram is not NULL, it must have size at least g->n + 1 and lengthHistogram[l] is increased by
+ * the number of cycles of length l.
+ */
+long int countCycles(struct Graph* g, long int* lengthHistogram, long int maxCycles, double timeLimit, char* truncated) {
+	struct JohnsonRun run = {0};
+	run.maxCycles = maxCycles;
+	run.timeLimit = timeLimit;
+	run.lengthHistogram = lengthHistogram;
+	enumerateCycles(g, &run);
+	if (truncated) {
+		*truncated = run.truncated;
+	}
+	return run.nCycles;
+}
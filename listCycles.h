@@ -7,6 +7,9 @@ char findPath(struct Vertex* v, struct Vertex* parent, struct Vertex* target, in
 struct ShallowGraph* listCycles(struct Graph *g, struct ShallowGraphPool *sgp);
 struct ShallowGraph* listCyclesOfLength(struct Graph *g, int cycleLength, struct ShallowGraphPool *sgp);
 
+struct ShallowGraph* listCyclesOnce(struct Graph* g, long int maxCycles, double timeLimit, char* truncated, struct ShallowGraphPool* sgp);
+long int countCycles(struct Graph* g, long int* lengthHistogram, long int maxCycles, double timeLimit, char* truncated);
+
 int getNumberOfSimpleCycles(struct Graph* g, struct ShallowGraphPool* sgp, struct GraphPool* gp);
 int getNumberOfNonIsoCycles(struct Graph* g, struct ShallowGraphPool* sgp, struct GraphPool* gp);
 
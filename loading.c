@@ -3,7 +3,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <sys/types.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "loading.h"
 
@@ -150,6 +158,22 @@ void createStdinIterator(struct GraphPool* p) {
 	initCache();
 }
 
+/**
+Check whether the stream of the file iterator is exhausted.
+Blocks until at least one more character is available or the stream is closed.
+*/
+char fileIteratorAtEnd() {
+	if (!FI_DATABASE) {
+		return 1;
+	}
+	int c = fgetc(FI_DATABASE);
+	if (c == EOF) {
+		return 1;
+	}
+	ungetc(c, FI_DATABASE);
+	return 0;
+}
+
 /** close the datastream */
 void destroyFileIterator() {
 	fclose(FI_DATABASE);
@@ -222,8 +246,6 @@ static inline int fastAtoi( const char ** pos )
 	}
 }
 
-static int AGNOSTIC_ERROR = 1;
-
 /**
 Parse an integer from the string starting at *pos.
 Move *pos to the first position in the string where there is no number.
@@ -231,9 +253,9 @@ Skip any number of initial white spaces, then terminate at first position that i
 
 Cornercase: Interprets '-' as 0.
 
-Set local variable AGNOSTIC_ERROR to 1 if nothing was read due to invalid input.
+Set *error to 1 if nothing was read due to invalid input, and to 0 otherwise.
 */
-static inline int fastAtoiAgnostic( const char ** pos )
+static inline int fastAtoiAgnostic( const char ** pos, int* error )
 {
    const char *p = *pos;
 
@@ -260,27 +282,28 @@ static inline int fastAtoiAgnostic( const char ** pos )
    if (start != p) {
 	   // move pointer
 	   *pos = p;
-	   AGNOSTIC_ERROR = 0;
+	   *error = 0;
 	   return x*n;
    } else {
 	   // return error code
-	   AGNOSTIC_ERROR = 1;
+	   *error = 1;
 	   return 0;
    }
 
 }
 
 
-static inline int parseHeader(int* id, int* activity, int* n, int* m) { 
-	const char *current = *HEAD_PTR + 1;
-	if ((*HEAD_PTR)[0] != '#') { 
+static inline int parseHeader(const char* header, int* id, int* activity, int* n, int* m) { 
+	const char *current = header + 1;
+	if (header[0] != '#') { 
 		return -1; 
 	}
 
-	*id = fastAtoiAgnostic(&current);
-	int agnostic_errors = AGNOSTIC_ERROR;
-	*activity = fastAtoiAgnostic(&current);
-	agnostic_errors += AGNOSTIC_ERROR;
+	int agnostic_errors;
+	int error;
+	*id = fastAtoiAgnostic(&current, &agnostic_errors);
+	*activity = fastAtoiAgnostic(&current, &error);
+	agnostic_errors += error;
 	*n = fastAtoi(&current);
 	*m = fastAtoi(&current);
 	/* return number of correctly read items.
@@ -289,155 +312,303 @@ static inline int parseHeader(int* id, int* activity, int* n, int* m) {
 }
 
 
-static inline void fastLabelLength(const char* pos, size_t* offset, size_t* labelSize) {
-	*offset = 0;
-	*labelSize = 0;
+/***********************************************************************************
+ ******************** Tokenizing of Vertex and Edge Lines **************************
+ ***********************************************************************************/
 
-    // skip whitespaces
-    for ( ; isspace(*pos); pos++) {
-    	++(*offset);
-    }
+/* labels are scanned in blocks of TOKENIZER_BLOCK characters. Line buffers have TOKENIZER_BLOCK characters
+of slack after the terminating zero, such that a block load starting within the line is always valid. */
+#define TOKENIZER_BLOCK 32
 
-    // get labelSize
-    for ( ; !isspace(*pos); pos++) {
-		++(*labelSize);
-    }
-}
 
-static inline int grabLabel(const char** currentPosition, char** label) {
-	size_t offset;
-	size_t labelSize;
-	*label = NULL;
-	fastLabelLength(*currentPosition, &offset, &labelSize);
-	if (labelSize != 0) {
-		if ((*label = malloc((labelSize + 1) * sizeof(char)))) {
-			memcpy(*label, *currentPosition + offset, labelSize);
-			(*label)[labelSize] = '\0';
-			*currentPosition += offset + labelSize;	
-			return labelSize;
+/**
+Return a bit mask that has bit i set iff p[i] is a white space character in the sense of isspace() in the
+C locale or the terminating zero, for 0 <= i < TOKENIZER_BLOCK. Uses AVX2 or SSE2, if available.
+*/
+static inline uint32_t separatorMask(const char* p) {
+#if defined(__AVX2__)
+	__m256i c = _mm256_loadu_si256((const __m256i*)p);
+	__m256i shifted = _mm256_sub_epi8(c, _mm256_set1_epi8('\t'));
+	__m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+	__m256i space = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(' '));
+	__m256i zero = _mm256_cmpeq_epi8(c, _mm256_setzero_si256());
+	return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(control, space), zero));
+#elif defined(__SSE2__)
+	uint32_t mask = 0;
+	for (int half=0; half<2; ++half) {
+		__m128i c = _mm_loadu_si128((const __m128i*)(p + 16 * half));
+		__m128i shifted = _mm_sub_epi8(c, _mm_set1_epi8('\t'));
+		__m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+		__m128i space = _mm_cmpeq_epi8(c, _mm_set1_epi8(' '));
+		__m128i zero = _mm_cmpeq_epi8(c, _mm_setzero_si128());
+		mask |= (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(control, space), zero)) << (16 * half);
+	}
+	return mask;
+#else
+	uint32_t mask = 0;
+	for (int i=0; i<TOKENIZER_BLOCK; ++i) {
+		unsigned char c = p[i];
+		if ((c == ' ') || (c == '\0') || ((unsigned char)(c - '\t') <= '\r' - '\t')) {
+			mask |= (uint32_t)1 << i;
 		}
-	} 
-	return 0;
+	}
+	return mask;
+#endif
 }
 
 
-static inline int parseEdgeNew(const char** currentPosition, int* v, int* w, char** label) {
-	*v = fastAtoi(currentPosition);
-	*w = fastAtoi(currentPosition);
-	grabLabel(currentPosition, label);
-	return (*v != -1) + (*w != -1) + (*label != NULL);
-}
+/* character classes for the scalar parts of the tokenizer */
+#define WHITESPACE 1
+#define SEPARATOR 2 // white space or terminating zero
 
+static const unsigned char CHARACTER_CLASS[256] = {
+	['\0'] = SEPARATOR,
+	['\t'] = WHITESPACE | SEPARATOR, ['\n'] = WHITESPACE | SEPARATOR, ['\v'] = WHITESPACE | SEPARATOR,
+	['\f'] = WHITESPACE | SEPARATOR, ['\r'] = WHITESPACE | SEPARATOR, [' '] = WHITESPACE | SEPARATOR
+};
 
-/* stream a graph from a database file of the format described in the documentation */
-struct Graph* iterateFile() {
-	int i;
-	struct Graph* g = getGraph(FI_GP);
-	const char* currentPosition;
 
-	if (!FI_DATABASE) {
-		fprintf(stderr, "Could not access input stream.\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
+/**
+Make sure that the line buffer has TOKENIZER_BLOCK characters of slack after the line of length length.
+*/
+static inline void padLineBuffer(char** line, size_t* size, ssize_t length) {
+	if ((size_t)length + 1 + TOKENIZER_BLOCK > *size) {
+		*size = length + 1 + TOKENIZER_BLOCK;
+		*line = realloc(*line, *size);
 	}
+}
 
-	/* copy header line to local variable
-	dependent on GNU C */
-	if (getline(HEAD_PTR, HEAD_SIZE, FI_DATABASE) == -1) {
-		fprintf(stderr, "Could not read graph header from input stream.\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
+
+/**
+Skip white space starting at *pos and return the length of the following token.
+Separators are usually single spaces and most labels are short. Tokens that are longer than eight characters
+are scanned block wise.
+*/
+static inline int nextToken(const char** pos) {
+	const char* p = *pos;
+	while (CHARACTER_CLASS[(unsigned char)*p] & WHITESPACE) {
+		++p;
 	}
-			
-	/* parse header */	
-	if (parseHeader(&(g->number), &(g->activity), &(g->n), &(g->m)) != 4) {
-		/* if reading of header does not work anymore, check if we have reached the correct end of the stream */
-		if (**HEAD_PTR != '$') {
-			fprintf(stderr, "Invalid Graph header: %s\nparsing result: %i %i %i %i\n", *HEAD_PTR, g->number, g->activity, g->n, g->m);
+	*pos = p;
+
+	const char* end = p;
+	while (!(CHARACTER_CLASS[(unsigned char)*end] & SEPARATOR)) {
+		++end;
+		if (end - p == 8) {
+			uint32_t mask;
+			while ((mask = separatorMask(end)) == 0) {
+				end += TOKENIZER_BLOCK;
+			}
+			return end - p + __builtin_ctz(mask);
 		}
-		dumpGraph(FI_GP, g);
-		return NULL;
 	}
+	return end - p;
+}
 
-	/* read vertices */
-	if ((g->vertices = malloc(g->n * sizeof(struct Vertex*))) == NULL) {
-		fprintf(stderr, "Error allocating vertices\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
-	}
 
-	/* copy vertex line to local variable
-	dependent on GNU C */
-	if (getline(VERTEX_PTR, VERTEX_SIZE, FI_DATABASE) == -1) {
-		fprintf(stderr, "Could not read vertex line from input stream.\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
+/**
+Parse the positive integer starting at *pos after skipping white space, as fastAtoi() does.
+Return -1 if there is no digit.
+*/
+static inline int nextIntegerToken(const char** pos) {
+	const char* p = *pos;
+	unsigned int n = 0;
+	unsigned int d;
+
+	while (CHARACTER_CLASS[(unsigned char)*p] & WHITESPACE) {
+		++p;
+	}
+	const char* start = p;
+	--p;
+	while ((d = digitValue(*++p)) <= 9) {
+		n = n * 10 + d;
 	}
+	*pos = p;
+	return (p != start) ? (int)n : -1;
+}
 
-	/* parse vertex info */
-	currentPosition = *VERTEX_PTR;
-	for (i=0; i<g->n; ++i) {
-		char* label;
-		if (grabLabel(&currentPosition, &label) != -1) {
-			g->vertices[i] = getVertex(FI_GP->vertexPool);
-			g->vertices[i]->label = label;
-			g->vertices[i]->number = i;
-			g->vertices[i]->isStringMaster = 1;
-		} else {
-			fprintf(stderr, "Error while parsing vertices\n");
-			dumpGraph(FI_GP, g);
-			return NULL;
+
+static inline char* copyToken(const char* p, int length) {
+	char* label = malloc((length + 1) * sizeof(char));
+	memcpy(label, p, length);
+	label[length] = '\0';
+	return label;
+}
+
+
+/**
+Create the vertices of g from the vertex line in a single pass.
+Return 0 if the line does not contain g->n labels and 1 otherwise. In this case, no vertices are created.
+*/
+static int parseVertexLine(struct Graph* g, const char* line, struct GraphPool* gp) {
+	const char* p = line;
+	for (int i=0; i<g->n; ++i) {
+		int length = nextToken(&p);
+		if (length == 0) {
+			for (int j=0; j<i; ++j) {
+				dumpVertex(gp->vertexPool, g->vertices[j]);
+			}
+			return 0;
 		}
+		g->vertices[i] = getVertex(gp->vertexPool);
+		g->vertices[i]->label = copyToken(p, length);
+		g->vertices[i]->number = i;
+		g->vertices[i]->isStringMaster = 1;
+		p += length;
 	}
-					
-	/* copy edge line to local variable
-	dependent on GNU C */
-	if (getline(EDGE_PTR, EDGE_SIZE, FI_DATABASE) == -1) {
-		fprintf(stderr, "Could not read edge line from input stream.\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
-	}
+	return 1;
+}
 
-	/* parse edge info */
-	currentPosition = *EDGE_PTR;
-	for (i=0; i<g->m; ++i) {
-		char* label;
-		int v,w;
 
-		if (parseEdgeNew(&currentPosition, &v, &w, &label) == 3) {
-			
-			struct VertexList* e = getVertexList(FI_GP->listPool);
-			struct VertexList* f = getVertexList(FI_GP->listPool);
+/**
+Add the edges in the edge line to g in a single pass. If directed is 0, the reverse edges are added, as well.
+Return 0 if the line does not contain g->m valid edges and 1 otherwise.
+*/
+static int parseEdgeLine(struct Graph* g, const char* line, char directed, struct GraphPool* gp) {
+	const char* p = line;
+	for (int i=0; i<g->m; ++i) {
+		int v = nextIntegerToken(&p);
+		int w = nextIntegerToken(&p);
+		int length = nextToken(&p);
+		if ((v < 1) || (v > g->n) || (w < 1) || (w > g->n) || (length == 0)) {
+			return 0;
+		}
+
+		struct VertexList* e = getVertexList(gp->listPool);
 
-			/* edge */
-			e->startPoint = g->vertices[v-1];
-			e->endPoint = g->vertices[w-1];
-			e->label = label;
-			e->isStringMaster = 1;
+		/* edge */
+		e->startPoint = g->vertices[v-1];
+		e->endPoint = g->vertices[w-1];
+		e->label = copyToken(p, length);
+		e->isStringMaster = 1;
+		p += length;
 
-			addEdge(e->startPoint, e);
+		addEdge(e->startPoint, e);
 
-			/* reverse edge*/
-			f->startPoint = g->vertices[w-1];
-			f->endPoint = g->vertices[v-1];
+		/* reverse edge*/
+		if (!directed) {
+			struct VertexList* f = getVertexList(gp->listPool);
+			f->startPoint = e->endPoint;
+			f->endPoint = e->startPoint;
 			f->label = e->label;
 
 			addEdge(f->startPoint, f);
-		} else {
-			fprintf(stderr, "Error while parsing edges\n");
-			dumpGraph(FI_GP, g);
-			return NULL;
 		}
 	}
-	return g;
+	return 1;
 }
 
 
-/* stream a directed graph from a database file of the format described in the documentation */
-struct Graph* iterateFileDirected() {
-	int i;
+/* errors that can occur while reading a graph, see reportLoadingError() */
+typedef enum {
+	loadingOk,
+	noHeader,
+	invalidHeader,
+	vertexAllocationFailed,
+	noVertexLine,
+	invalidVertexLine,
+	noEdgeLine,
+	invalidEdgeLine
+} LoadingError;
+
+
+/**
+Print the message for error to stderr. header is the header line of the graph that caused the error.
+*/
+static void reportLoadingError(LoadingError error, const char* header) {
+	int number = 0;
+	int activity = 0;
+	int n = 0;
+	int m = 0;
+
+	switch (error) {
+	case loadingOk:
+		break;
+	case noHeader:
+		fprintf(stderr, "Could not read graph header from input stream.\n");
+		break;
+	case invalidHeader:
+		/* if reading of header does not work anymore, check if we have reached the correct end of the stream */
+		if (header[0] != '$') {
+			parseHeader(header, &number, &activity, &n, &m);
+			fprintf(stderr, "Invalid Graph header: %s\nparsing result: %i %i %i %i\n", header, number, activity, n, m);
+		}
+		break;
+	case vertexAllocationFailed:
+		fprintf(stderr, "Error allocating vertices\n");
+		break;
+	case noVertexLine:
+		fprintf(stderr, "Could not read vertex line from input stream.\n");
+		break;
+	case invalidVertexLine:
+		fprintf(stderr, "Error while parsing vertices\n");
+		break;
+	case noEdgeLine:
+		fprintf(stderr, "Could not read edge line from input stream.\n");
+		break;
+	case invalidEdgeLine:
+		fprintf(stderr, "Error while parsing edges\n");
+		break;
+	}
+}
+
+
+static LoadingError parseGraphHeader(struct Graph* g, const char* header) {
+	if (parseHeader(header, &(g->number), &(g->activity), &(g->n), &(g->m)) != 4) {
+		return invalidHeader;
+	}
+	return loadingOk;
+}
+
+
+/* line is NULL if the vertex line is missing */
+static LoadingError parseGraphVertices(struct Graph* g, const char* line, struct GraphPool* gp) {
+	if (line == NULL) {
+		return noVertexLine;
+	}
+	if ((g->vertices = malloc(g->n * sizeof(struct Vertex*))) == NULL) {
+		return vertexAllocationFailed;
+	}
+	if (!parseVertexLine(g, line, gp)) {
+		free(g->vertices);
+		g->vertices = NULL;
+		return invalidVertexLine;
+	}
+	return loadingOk;
+}
+
+
+/* line is NULL if the edge line is missing */
+static LoadingError parseGraphEdges(struct Graph* g, const char* line, char directed, struct GraphPool* gp) {
+	if (line == NULL) {
+		return noEdgeLine;
+	}
+	if (!parseEdgeLine(g, line, directed, gp)) {
+		return invalidEdgeLine;
+	}
+	return loadingOk;
+}
+
+
+/* state of the last call to iterateFileInternal(), see fileIteratorFailed() and skipToRequestEnd() */
+static char FI_FAILED = 0;
+static char FI_AT_TERMINATOR = 0;
+
+/* a line starting with '$' terminates a database or a request in server mode */
+static inline char isTerminatorLine(const char* line, ssize_t length) {
+	return (length > 0) && (line[0] == '$');
+}
+
+
+/* stream a graph from a database file of the format described in the documentation. 
+If directed is 0, the reverse of each edge is added to the graph, too. */
+static struct Graph* iterateFileInternal(char directed) {
 	struct Graph* g = getGraph(FI_GP);
-	const char* currentPosition;
+	LoadingError error = loadingOk;
+	ssize_t length;
+
+	FI_FAILED = 0;
+	FI_AT_TERMINATOR = 0;
 
 	if (!FI_DATABASE) {
 		fprintf(stderr, "Could not access input stream.\n");
@@ -445,94 +616,326 @@ struct Graph* iterateFileDirected() {
 		return NULL;
 	}
 
-	/* copy header line to local variable
-	dependent on GNU C */
-	if (getline(HEAD_PTR, HEAD_SIZE, FI_DATABASE) == -1) {
-		fprintf(stderr, "Could not read graph header from input stream.\n");
+	/* copy lines to local variables, dependent on GNU C.
+	the next line is only read if the previous ones were valid */
+	length = getline(HEAD_PTR, HEAD_SIZE, FI_DATABASE);
+	if (length == -1) {
+		error = noHeader;
+	} else if (isTerminatorLine(*HEAD_PTR, length)) {
+		/* regular end of the database or of a request */
+		FI_AT_TERMINATOR = 1;
 		dumpGraph(FI_GP, g);
 		return NULL;
 	}
-
-	/* parse header */
-	if (parseHeader(&(g->number), &(g->activity), &(g->n), &(g->m)) != 4) {
-		/* if reading of header does not work anymore, check if we have reached the correct end of the stream */
-		if (**HEAD_PTR != '$') {
-			fprintf(stderr, "Invalid Graph header: %s\nparsing result: %i %i %i %i\n", *HEAD_PTR, g->number, g->activity, g->n, g->m);
+	if (error == loadingOk) {
+		error = parseGraphHeader(g, *HEAD_PTR);
+	}
+	if (error == loadingOk) {
+		length = getline(VERTEX_PTR, VERTEX_SIZE, FI_DATABASE);
+		if (length != -1) {
+			FI_AT_TERMINATOR = isTerminatorLine(*VERTEX_PTR, length);
+			padLineBuffer(VERTEX_PTR, VERTEX_SIZE, length);
 		}
-		dumpGraph(FI_GP, g);
-		return NULL;
+		error = parseGraphVertices(g, (length != -1) ? *VERTEX_PTR : NULL, FI_GP);
 	}
-
-	/* read vertices */
-	if ((g->vertices = malloc(g->n * sizeof(struct Vertex*))) == NULL) {
-		fprintf(stderr, "Error allocating vertices\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
+	if (error == loadingOk) {
+		length = getline(EDGE_PTR, EDGE_SIZE, FI_DATABASE);
+		if (length != -1) {
+			FI_AT_TERMINATOR = isTerminatorLine(*EDGE_PTR, length);
+			padLineBuffer(EDGE_PTR, EDGE_SIZE, length);
+		}
+		error = parseGraphEdges(g, (length != -1) ? *EDGE_PTR : NULL, directed, FI_GP);
 	}
 
-	/* copy vertex line to local variable
-	dependent on GNU C */
-	if (getline(VERTEX_PTR, VERTEX_SIZE, FI_DATABASE) == -1) {
-		fprintf(stderr, "Could not read vertex line from input stream.\n");
+	if (error != loadingOk) {
+		reportLoadingError(error, *HEAD_PTR);
+		/* running out of input at a graph boundary is not a malformed graph */
+		FI_FAILED = (error != noHeader);
 		dumpGraph(FI_GP, g);
 		return NULL;
 	}
+	return g;
+}
 
-	/* parse vertex info */
-	currentPosition = *VERTEX_PTR;
-	for (i=0; i<g->n; ++i) {
-		char* label;
-		if (grabLabel(&currentPosition, &label) != -1) {
-			g->vertices[i] = getVertex(FI_GP->vertexPool);
-			g->vertices[i]->label = label;
-			g->vertices[i]->number = i;
-			g->vertices[i]->isStringMaster = 1;
-		} else {
-			fprintf(stderr, "Error while parsing vertices\n");
-			dumpGraph(FI_GP, g);
-			return NULL;
+
+/**
+Return 1 if the last call to iterateFile() returned NULL because the graph it read was malformed,
+and 0 if it returned a graph or reached a line starting with '$' or the end of the input.
+*/
+char fileIteratorFailed() {
+	return FI_FAILED;
+}
+
+
+/**
+Consume the input up to and including the next line that starts with '$', unless the last call to
+iterateFile() has already read such a line. In server mode, this skips the rest of a request that
+contains a malformed graph. Returns 0 if the input ends before such a line is found.
+*/
+char skipToRequestEnd() {
+	if (FI_AT_TERMINATOR) {
+		FI_AT_TERMINATOR = 0;
+		return 1;
+	}
+	ssize_t length;
+	while ((length = getline(HEAD_PTR, HEAD_SIZE, FI_DATABASE)) != -1) {
+		if (isTerminatorLine(*HEAD_PTR, length)) {
+			return 1;
 		}
 	}
+	return 0;
+}
 
-	/* copy edge line to local variable
-	dependent on GNU C */
-	if (getline(EDGE_PTR, EDGE_SIZE, FI_DATABASE) == -1) {
-		fprintf(stderr, "Could not read edge line from input stream.\n");
-		dumpGraph(FI_GP, g);
-		return NULL;
+
+/* stream a graph from a database file of the format described in the documentation */
+struct Graph* iterateFile() {
+	return iterateFileInternal(0);
+}
+
+
+/* stream a directed graph from a database file of the format described in the documentation */
+struct Graph* iterateFileDirected() {
+	return iterateFileInternal(1);
+}
+
+
+/***********************************************************************************
+ ******************** Parallel Loading of a Whole Database *************************
+ ***********************************************************************************/
+
+/* the input is read in batches of at least this many bytes */
+#define LOADING_BATCH_SIZE (64 << 20)
+
+/* number of threads used by readGraphDatabase(), 0 for the number of online processors */
+static int LOADING_THREADS = 1;
+
+
+/**
+Set the number of threads that readGraphDatabase() uses to parse graphs (default 1). If nThreads is 0 or
+negative, the number of online processors is used.
+*/
+void setLoadingThreads(int nThreads) {
+	LOADING_THREADS = nThreads;
+}
+
+
+/* a thread that parses the graphs first, ..., last - 1 of a batch into its own pools */
+struct LoadingWorker {
+	pthread_t thread;
+	struct GraphPool* gp;
+	char directed;
+	char** lines;            // header, vertex line, and edge line of each graph of the batch; NULL if missing
+	struct Graph** graphs;   // output, NULL for graphs that could not be parsed
+	LoadingError* errors;
+	int first;
+	int last;
+};
+
+
+static void* loadingWorker(void* arg) {
+	struct LoadingWorker* w = arg;
+	for (int i=w->first; i<w->last; ++i) {
+		struct Graph* g = getGraph(w->gp);
+		LoadingError error = parseGraphHeader(g, w->lines[3 * i]);
+		if (error == loadingOk) {
+			error = parseGraphVertices(g, w->lines[3 * i + 1], w->gp);
+		}
+		if (error == loadingOk) {
+			error = parseGraphEdges(g, w->lines[3 * i + 2], w->directed, w->gp);
+		}
+		if (error != loadingOk) {
+			dumpGraph(w->gp, g);
+			g = NULL;
+		}
+		w->graphs[i] = g;
+		w->errors[i] = error;
 	}
+	return NULL;
+}
 
-	/* parse edge info */
-	currentPosition = *EDGE_PTR;
-	for (i=0; i<g->m; ++i) {
-		char* label;
-		int v,w;
 
-		if (parseEdgeNew(&currentPosition, &v, &w, &label) == 3) {
+/**
+Return the end of the line starting at p, that is the position of the next '\n' before end, or NULL if there is none.
+*/
+static inline char* lineEnd(char* p, char* end) {
+	return memchr(p, '\n', end - p);
+}
 
-			struct VertexList* e = getVertexList(FI_GP->listPool);
 
-			/* edge */
-			e->startPoint = g->vertices[v-1];
-			e->endPoint = g->vertices[w-1];
-			e->label = label;
-			e->isStringMaster = 1;
+/**
+Read all remaining graphs from the file iterator into *db, which is realloc'ed as needed, and return their number.
+If directed is 0, the reverse of each edge is added to the graphs, as iterateFile() does. Otherwise, the graphs are
+loaded as iterateFileDirected() does.
+
+The input is split into batches of graphs that are parsed in parallel, see setLoadingThreads(). Each thread
+uses its own pools, which are merged into the pools of the file iterator afterwards. The graphs are stored in
+the order of the input and the same messages are printed as if they were read by iterateFile().
+Reading stops at the first graph that cannot be parsed, but in contrast to iterateFile(), the input stream may
+have been read further than that graph.
+*/
+int readGraphDatabase(struct Graph*** db, char directed) {
+	if (!FI_DATABASE) {
+		fprintf(stderr, "Could not access input stream.\n");
+		return 0;
+	}
+
+	int nThreads = (LOADING_THREADS > 0) ? LOADING_THREADS : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThreads < 1) {
+		nThreads = 1;
+	}
+	struct LoadingWorker* workers = malloc(nThreads * sizeof(struct LoadingWorker));
+	for (int t=0; t<nThreads; ++t) {
+		/* pools of size one, such that their elements can be freed individually when they are dumped into FI_GP */
+		workers[t].gp = createGraphPool(1, createVertexPool(1), createListPool(1));
+		workers[t].directed = directed;
+	}
 
-			addEdge(e->startPoint, e);
+	size_t capacity = LOADING_BATCH_SIZE;
+	size_t size = 0;
+	char* buffer = malloc(capacity + TOKENIZER_BLOCK + 1);
+	char** lines = NULL;
+	LoadingError* errors = NULL;
+	int linesCapacity = 0;
+	int dbSize = 0;
+	int nGraphs = 0;
+	char done = 0;
+
+	while (!done) {
+		size += fread(buffer + size, 1, capacity - size, FI_DATABASE);
+		char atEnd = (size < capacity);
+		buffer[size] = '\0';
+
+		/* find the lines of the graphs in the buffer. An incomplete graph at the end is kept for the next batch */
+		char* p = buffer;
+		char* end = buffer + size;
+		int nBatch = 0;
+		LoadingError endError = loadingOk;
+		while (1) {
+			char* graphLines[3] = {NULL, NULL, NULL};
+			char* lineEnds[3] = {NULL, NULL, NULL};
+			char* q = p;
+			int nLines = 0;
+			int neededLines = 3;
+
+			if (p == end) {
+				if (atEnd) {
+					endError = noHeader;
+					done = 1;
+				}
+				break;
+			}
+			/* iterateFile() does not read further than an invalid header */
+			if (*p != '#') {
+				neededLines = 1;
+			}
+			while ((nLines < neededLines) && (q < end)) {
+				graphLines[nLines] = q;
+				lineEnds[nLines] = lineEnd(q, end);
+				q = lineEnds[nLines] ? lineEnds[nLines] + 1 : end;
+				++nLines;
+			}
+			if ((nLines < neededLines || lineEnds[nLines - 1] == NULL) && !atEnd) {
+				break;
+			}
 
-			/* reverse edge is not added! */
+			if (3 * (nBatch + 1) > linesCapacity) {
+				linesCapacity = linesCapacity ? 2 * linesCapacity : 3 * 1024;
+				lines = realloc(lines, linesCapacity * sizeof(char*));
+				errors = realloc(errors, linesCapacity / 3 * sizeof(LoadingError));
+			}
+			for (int l=0; l<3; ++l) {
+				if (lineEnds[l]) {
+					*lineEnds[l] = '\0';
+				}
+				lines[3 * nBatch + l] = graphLines[l];
+			}
+			++nBatch;
+			p = q;
+			if ((neededLines < 3) || (nLines < 3) || ((p == end) && atEnd)) {
+				/* the next header would be missing */
+				done = 1;
+				if ((neededLines == 3) && (nLines == 3)) {
+					endError = noHeader;
+				}
+				break;
+			}
+		}
 
+		/* parse the graphs of the batch */
+		if (nGraphs + nBatch > dbSize) {
+			dbSize = (nGraphs + nBatch > 2 * dbSize) ? nGraphs + nBatch : 2 * dbSize;
+			*db = realloc(*db, dbSize * sizeof(struct Graph*));
+		}
+		for (int t=0; t<nThreads; ++t) {
+			workers[t].lines = lines;
+			workers[t].graphs = *db + nGraphs;
+			workers[t].errors = errors;
+			workers[t].first = (int)((long)nBatch * t / nThreads);
+			workers[t].last = (int)((long)nBatch * (t + 1) / nThreads);
+		}
+		if (nThreads == 1) {
+			loadingWorker(&workers[0]);
 		} else {
-			fprintf(stderr, "Error while parsing edges\n");
-			dumpGraph(FI_GP, g);
-			return NULL;
+			for (int t=0; t<nThreads; ++t) {
+				pthread_create(&workers[t].thread, NULL, &loadingWorker, &workers[t]);
+			}
+			for (int t=0; t<nThreads; ++t) {
+				pthread_join(workers[t].thread, NULL);
+			}
+		}
+
+		/* keep the graphs up to the first error */
+		for (int i=0; i<nBatch; ++i) {
+			if (errors[i] != loadingOk) {
+				/* print the header as iterateFile() does, including its line break */
+				char* header = lines[3 * i];
+				size_t headerLength = strlen(header);
+				char* printedHeader = malloc(headerLength + 2);
+				memcpy(printedHeader, header, headerLength);
+				strcpy(printedHeader + headerLength, (header + headerLength < end) ? "\n" : "");
+				reportLoadingError(errors[i], printedHeader);
+				free(printedHeader);
+
+				for (int j=i+1; j<nBatch; ++j) {
+					if ((*db)[nGraphs + j]) {
+						dumpGraph(FI_GP, (*db)[nGraphs + j]);
+					}
+				}
+				nBatch = i;
+				done = 1;
+				endError = loadingOk;
+				break;
+			}
+		}
+		nGraphs += nBatch;
+
+		if (endError != loadingOk) {
+			reportLoadingError(endError, NULL);
+		}
+
+		/* move the incomplete graph to the front of the buffer */
+		size = end - p;
+		memmove(buffer, p, size);
+		if (!done && (size == capacity)) {
+			capacity *= 2;
+			buffer = realloc(buffer, capacity + TOKENIZER_BLOCK + 1);
 		}
 	}
-	return g;
+
+	for (int t=0; t<nThreads; ++t) {
+		absorbGraphPool(FI_GP, workers[t].gp);
+	}
+	free(workers);
+	free(buffer);
+	free(lines);
+	free(errors);
+	return nGraphs;
 }
 
 
 
+
+
 /* return the base 10 string representation of label in a correctly sized newly allocated buffer */
 char* intLabel(const unsigned int label) {
 	int bufferSize;
@@ -12,9 +12,14 @@ char* aids99EdgeLabel(const unsigned int label);
 char* intLabel(const unsigned int label);
 struct Graph* iterateFile();
 struct Graph* iterateFileDirected();
+void setLoadingThreads(int nThreads);
+int readGraphDatabase(struct Graph*** db, char directed);
 void createFileIterator(char* filename, struct GraphPool* p);
 void createStdinIterator(struct GraphPool* p);
 void destroyFileIterator();
+char fileIteratorAtEnd();
+char fileIteratorFailed();
+char skipToRequestEnd();
 void writeCurrentGraph(FILE* out);
 
 
@@ -66,7 +66,7 @@ return -1
 int getMaxLocalEasiness(struct Graph* g, long int maxBound, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 
 	long int max = -1;
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
+	struct ShallowGraph* biconnectedComponents = getBlocksAsShallowGraphs(getBlockDecomposition(g), sgp);
 	long int* easiness = computeLocalEasinessExactly(biconnectedComponents, g->n, maxBound, gp, sgp);
 	dumpShallowGraphCycle(sgp, biconnectedComponents);
 	for (int v=0; v<g->n; ++v) {
@@ -90,7 +90,7 @@ If the minimum is larger than INT_MAX, or the value could not been computed for
 */
 int getMinLocalEasiness(struct Graph* g, long int maxBound, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	long int min = -1;
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
+	struct ShallowGraph* biconnectedComponents = getBlocksAsShallowGraphs(getBlockDecomposition(g), sgp);
 	long int* easiness = computeLocalEasinessExactly(biconnectedComponents, g->n, maxBound, gp, sgp);
 	dumpShallowGraphCycle(sgp, biconnectedComponents);
 	for (int v=0; v<g->n; ++v) {
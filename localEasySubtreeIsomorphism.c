@@ -51,7 +51,7 @@ static int lowPointComparator(const void* a, const void* b) {
 
 struct BlockTree getBlockTreeT(struct Graph* g, struct ShallowGraphPool* sgp) {
 
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
+	struct ShallowGraph* biconnectedComponents = getBlocksAsShallowGraphs(getBlockDecomposition(g), sgp);
 
 	for (int v=0; v<g->n; ++v) {
 		g->vertices[v]->visited = -1; // isRoot
@@ -250,12 +250,106 @@ struct Graph* spanningTreeConverter(struct ShallowGraph* localTrees, struct Grap
 }
 
 
-// init characteristics array
-void initCharacteristicsArrayForLocalEasy(struct SpanningtreeTree* sptTree) {
-	sptTree->characteristics = malloc(sptTree->nRoots * sizeof(struct SupportSet*));
-	for (int v=0; v<sptTree->nRoots; ++v) {
-		sptTree->characteristics[v] = getSupportSet();
+/**
+ * Move the local spanning trees of all roots into one block of memory, see struct SpanningtreeTree,
+ * compute their postorders, and initialize the characteristics.
+ * localSpanningTrees[v] is the list of local spanning trees of root v. These graphs are dumped.
+ */
+static void packSpanningtreeTree(struct SpanningtreeTree* sptTree, struct Graph** localSpanningTrees, struct GraphPool* gp) {
+	int nRoots = sptTree->nRoots;
+	int nTrees = 0;
+	int nVertices = 0;
+	int nEdges = 0;
+	for (int v=0; v<nRoots; ++v) {
+		for (struct Graph* tree=localSpanningTrees[v]; tree!=NULL; tree=tree->next) {
+			++nTrees;
+			nVertices += tree->n;
+			nEdges += 2 * tree->m;
+		}
 	}
+
+	/* all structs below contain pointers, hence their sizes are multiples of the alignment of pointers
+	 * and each array starts at a properly aligned position. The ints come last. */
+	size_t graphBytes = nTrees * sizeof(struct Graph);
+	size_t vertexPointerBytes = nVertices * sizeof(struct Vertex*);
+	size_t vertexBytes = nVertices * sizeof(struct Vertex);
+	size_t edgeBytes = nEdges * sizeof(struct VertexList);
+	size_t setBytes = nRoots * sizeof(struct SupportSet);
+	size_t elementBytes = nTrees * sizeof(struct SupportSetElement);
+	size_t postorderPointerBytes = nTrees * sizeof(int*);
+	size_t intBytes = (nRoots + 1 + nVertices) * sizeof(int);
+	char* block = malloc(graphBytes + vertexPointerBytes + vertexBytes + edgeBytes + setBytes + elementBytes + postorderPointerBytes + intBytes);
+
+	sptTree->nLocalTrees = nTrees;
+	sptTree->nLocalVertices = nVertices;
+	sptTree->localTrees = (struct Graph*)block;
+	block += graphBytes;
+	struct Vertex** nextVertexPointer = (struct Vertex**)block;
+	block += vertexPointerBytes;
+	struct Vertex* nextVertex = (struct Vertex*)block;
+	block += vertexBytes;
+	struct VertexList* nextEdge = (struct VertexList*)block;
+	block += edgeBytes;
+	sptTree->characteristics = (struct SupportSet*)block;
+	block += setBytes;
+	sptTree->characteristicElements = (struct SupportSetElement*)block;
+	block += elementBytes;
+	sptTree->localPostorders = (int**)block;
+	block += postorderPointerBytes;
+	sptTree->firstLocalTree = (int*)block;
+	int* nextPostorder = sptTree->firstLocalTree + nRoots + 1;
+
+	int t = 0;
+	for (int v=0; v<nRoots; ++v) {
+		sptTree->firstLocalTree[v] = t;
+		for (struct Graph* tree=localSpanningTrees[v]; tree!=NULL; tree=tree->next, ++t) {
+			// sets ->visited and ->lowPoint of the vertices of tree, which are copied below
+			int* postorder = getPostorder(tree, 0);
+			memcpy(nextPostorder, postorder, tree->n * sizeof(int));
+			free(postorder);
+			sptTree->localPostorders[t] = nextPostorder;
+			nextPostorder += tree->n;
+
+			struct Graph* copy = &(sptTree->localTrees[t]);
+			*copy = *tree;
+			copy->next = NULL;
+			copy->blocks = NULL;
+			copy->vertices = nextVertexPointer;
+			nextVertexPointer += tree->n;
+			for (int i=0; i<tree->n; ++i) {
+				copy->vertices[i] = nextVertex++;
+			}
+			for (int i=0; i<tree->n; ++i) {
+				struct Vertex* w = copy->vertices[i];
+				*w = *(tree->vertices[i]);
+				w->next = NULL;
+				w->isStringMaster = 0;
+				w->neighborhood = NULL;
+				struct VertexList* last = NULL;
+				for (struct VertexList* e=tree->vertices[i]->neighborhood; e!=NULL; e=e->next) {
+					struct VertexList* f = nextEdge++;
+					*f = *e;
+					f->startPoint = w;
+					f->endPoint = copy->vertices[e->endPoint->number];
+					f->next = NULL;
+					f->isStringMaster = 0;
+					if (last != NULL) {
+						last->next = f;
+					} else {
+						w->neighborhood = f;
+					}
+					last = f;
+				}
+			}
+		}
+		dumpGraphList(gp, localSpanningTrees[v]);
+	}
+	sptTree->firstLocalTree[nRoots] = t;
+
+	memset(sptTree->characteristics, 0, setBytes);
+	memset(sptTree->characteristicElements, 0, elementBytes);
+	sptTree->cubes = NULL;
+	sptTree->cubesSize = 0;
 }
 
 
@@ -508,74 +602,75 @@ struct ShallowGraph* filterDuplicateSpanningTrees(struct ShallowGraph* sptrees,
 }
 
 
-static struct PostorderList* __getPOL() {
-	struct PostorderList* result = malloc(sizeof(struct PostorderList));
-	result->postorder = NULL;
-	result->next = NULL;
-	return result;
-}
-
 /**
  * blockTree is consumed
  * spanningTreesPerBlock must be >= 1
  */
-struct SpanningtreeTree getSampledSpanningtreeTree(struct BlockTree blockTree, int spanningTreesPerBlock, char removeDuplicates, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	struct SpanningtreeTree sptTree = {0,0,0,0,0,0,0};
+struct SpanningtreeTree getSampledSpanningtreeTree(struct BlockTree blockTree, int spanningTreesPerBlock, char removeDuplicates, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	return getCachedSampledSpanningtreeTree(blockTree, spanningTreesPerBlock, removeDuplicates, NULL, rng, gp, sgp);
+}
+
+
+/**
+ * Like getSampledSpanningtreeTree(), but v-rooted components that are isomorphic to a component in cache
+ * get the cached local spanning trees instead of new samples. The trees that are sampled for the other components
+ * are added to cache. cache may be NULL.
+ *
+ * Hence, the local spanning trees of each component are still a uniform sample, but isomorphic components
+ * (in this and in other graphs that share cache) get the same sample.
+ */
+struct SpanningtreeTree getCachedSampledSpanningtreeTree(struct BlockTree blockTree, int spanningTreesPerBlock, char removeDuplicates, struct LocalSpanningTreeCache* cache, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	struct SpanningtreeTree sptTree = {0};
 	sptTree.g = blockTree.g;
 	sptTree.nRoots = blockTree.nRoots;
 	sptTree.roots = blockTree.roots;
 	sptTree.parents = blockTree.parents;
-	sptTree.localSpanningTrees = malloc(sptTree.nRoots * sizeof(struct Graph*));
-	sptTree.localPostorders = malloc(sptTree.nRoots * sizeof(struct PostorderList*));
+	struct Graph** localSpanningTrees = malloc(sptTree.nRoots * sizeof(struct Graph*));
 
 	for (int v=0; v<sptTree.nRoots; ++v) {
 		struct ShallowGraph* mergedEdges = mergeShallowGraphs(blockTree.vRootedBlocks[v], sgp);
 		struct Graph* mergedGraph = blockConverter(mergedEdges, gp);
 
 		struct ShallowGraph* shallowSpanningtrees = NULL;
-		if (mergedGraph->m != mergedGraph->n-1) {
-			// sample spanning trees according to parameter
-			for (int i=0; i<spanningTreesPerBlock; ++i) {
-				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, sgp);
-				spt->next = shallowSpanningtrees;
-				shallowSpanningtrees = spt;
-			}
-
-			/* Duplicate spanning trees are filtered here.
-			 * In contrast to normal spanning tree sampling, here we can only filter identical trees (seen as edge sets)
-			 * and not trees up to isomorphism, as two isomorphic but different local spanning trees might result in different
-			 * (and hence possibly nonisomorphic) global spanning trees, when combined. */
-			if (removeDuplicates) {
-				shallowSpanningtrees = filterDuplicateSpanningTrees(shallowSpanningtrees, sgp);
-			}
-		} else {
+		if (mergedGraph->m == mergedGraph->n-1) {
 			// if the mergedGraph is a tree, we use it directly
 			shallowSpanningtrees = getGraphEdges(mergedGraph, sgp);
-		}
-		sptTree.localSpanningTrees[v] = spanningTreeConverter(shallowSpanningtrees, mergedGraph, gp, sgp);
-
-		sptTree.localPostorders[v] = NULL;
-		struct PostorderList* tail = NULL;
-		for (struct Graph* localSpanningTree=sptTree.localSpanningTrees[v]; localSpanningTree!=NULL; localSpanningTree=localSpanningTree->next) {
-			struct PostorderList* tmp = __getPOL();
-			tmp->postorder = getPostorder(localSpanningTree, 0);
-			if (sptTree.localPostorders[v] == NULL) {
-				sptTree.localPostorders[v] = tail = tmp;
-			} else {
-				// append at the end of the list
-				tail->next = tmp;
-				tail = tmp;
+		} else {
+			if (cache != NULL) {
+				// NULL, if there is no isomorphic component in the cache
+				shallowSpanningtrees = getCachedLocalSpanningTrees(cache, mergedGraph, sgp);
+			}
+			if (shallowSpanningtrees == NULL) {
+				// sample spanning trees according to parameter
+				for (int i=0; i<spanningTreesPerBlock; ++i) {
+					struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, rng, sgp);
+					spt->next = shallowSpanningtrees;
+					shallowSpanningtrees = spt;
+				}
+
+				/* Duplicate spanning trees are filtered here.
+				 * In contrast to normal spanning tree sampling, here we can only filter identical trees (seen as edge sets)
+				 * and not trees up to isomorphism, as two isomorphic but different local spanning trees might result in different
+				 * (and hence possibly nonisomorphic) global spanning trees, when combined. */
+				if (removeDuplicates) {
+					shallowSpanningtrees = filterDuplicateSpanningTrees(shallowSpanningtrees, sgp);
+				}
+				if (cache != NULL) {
+					addLocalSpanningTreesToCache(cache, mergedGraph, shallowSpanningtrees);
+				}
 			}
 		}
+		localSpanningTrees[v] = spanningTreeConverter(shallowSpanningtrees, mergedGraph, gp, sgp);
 
 		// garbage collection
 		dumpShallowGraph(sgp, mergedEdges);
 		dumpGraph(gp, mergedGraph);
 	}
 
-	initCharacteristicsArrayForLocalEasy(&sptTree);
+	packSpanningtreeTree(&sptTree, localSpanningTrees, gp);
 
 	//garbage collection
+	free(localSpanningTrees);
 	free(blockTree.vRootedBlocks);
 
 	return sptTree;
@@ -587,101 +682,76 @@ struct SpanningtreeTree getSampledSpanningtreeTree(struct BlockTree blockTree, i
  * spanningTreesPerBlock must be >= 1
  */
 struct SpanningtreeTree getFullSpanningtreeTree(struct BlockTree blockTree, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	struct SpanningtreeTree sptTree = {0,0,0,0,0,0,0};
+	return getCachedFullSpanningtreeTree(blockTree, NULL, gp, sgp);
+}
+
+
+/**
+ * Like getFullSpanningtreeTree(), but the spanning trees of v-rooted components that are isomorphic to a
+ * component in cache are mapped from the cache instead of being listed again. cache may be NULL.
+ */
+struct SpanningtreeTree getCachedFullSpanningtreeTree(struct BlockTree blockTree, struct LocalSpanningTreeCache* cache, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	struct SpanningtreeTree sptTree = {0};
 	sptTree.g = blockTree.g;
 	sptTree.nRoots = blockTree.nRoots;
 	sptTree.roots = blockTree.roots;
 	sptTree.parents = blockTree.parents;
-	sptTree.localSpanningTrees = malloc(sptTree.nRoots * sizeof(struct Graph*));
-	sptTree.localPostorders = malloc(sptTree.nRoots * sizeof(struct PostorderList*));
+	struct Graph** localSpanningTrees = malloc(sptTree.nRoots * sizeof(struct Graph*));
 
 	for (int v=0; v<sptTree.nRoots; ++v) {
 		struct ShallowGraph* mergedEdges = mergeShallowGraphs(blockTree.vRootedBlocks[v], sgp);
 		// TODO make destructive. shallowGraphs are not used afterwards.
 		struct Graph* mergedGraph = blockConverter(mergedEdges, gp);
 
-		struct ShallowGraph* shallowSpanningtrees = listSpanningTrees(mergedGraph, sgp, gp);
-		sptTree.localSpanningTrees[v] = spanningTreeConverter(shallowSpanningtrees, mergedGraph, gp, sgp);
-
-		sptTree.localPostorders[v] = NULL;
-		struct PostorderList* tail = NULL;
-		for (struct Graph* localSpanningTree=sptTree.localSpanningTrees[v]; localSpanningTree!=NULL; localSpanningTree=localSpanningTree->next) {
-			struct PostorderList* tmp = __getPOL();
-			tmp->postorder = getPostorder(localSpanningTree, 0);
-			if (sptTree.localPostorders[v] == NULL) {
-				sptTree.localPostorders[v] = tail = tmp;
-			} else {
-				// append at the end of the list
-				tail->next = tmp;
-				tail = tmp;
+		struct ShallowGraph* shallowSpanningtrees = NULL;
+		if ((mergedGraph->m == mergedGraph->n-1) || (cache == NULL)) {
+			shallowSpanningtrees = listSpanningTrees(mergedGraph, sgp, gp);
+		} else {
+			shallowSpanningtrees = getCachedLocalSpanningTrees(cache, mergedGraph, sgp);
+			if (shallowSpanningtrees == NULL) {
+				shallowSpanningtrees = listSpanningTrees(mergedGraph, sgp, gp);
+				addLocalSpanningTreesToCache(cache, mergedGraph, shallowSpanningtrees);
 			}
 		}
+		localSpanningTrees[v] = spanningTreeConverter(shallowSpanningtrees, mergedGraph, gp, sgp);
 
 		// garbage collection
 		dumpShallowGraph(sgp, mergedEdges);
 		dumpGraph(gp, mergedGraph);
 	}
 
-	initCharacteristicsArrayForLocalEasy(&sptTree);
+	packSpanningtreeTree(&sptTree, localSpanningTrees, gp);
 
 	//garbage collection
+	free(localSpanningTrees);
 	free(blockTree.vRootedBlocks);
 
 	return sptTree;
 }
 
 
+/**
+ * Empty the characteristics of all roots. Their memory is reused by the next subtree check.
+ * subtreeCheckForSpanningtreeTree() empties the characteristics of each root before it computes them, anyway.
+ */
 void wipeCharacteristicsForLocalEasy(struct SpanningtreeTree sptTree) {
-	if (sptTree.characteristics) {
-		for (int v=0; v<sptTree.nRoots; ++v) {
-			struct SupportSet* list = sptTree.characteristics[v];
-			if (list) {
-				struct SupportSetElement* tmp;
-				for (struct SupportSetElement* e=list->first; e!=NULL; e=tmp) {
-					tmp = e->next;
-					dumpNewCube(e->data.S, e->data.g->n);
-					free(e);
-				}
-				list->size = 0;
-				list->first = list->last = NULL;
-				list->next = NULL;
-			}
-		}
+	for (int v=0; v<sptTree.nRoots; ++v) {
+		struct SupportSet* list = &(sptTree.characteristics[v]);
+		list->size = 0;
+		list->first = list->last = NULL;
+		list->next = NULL;
 	}
 }
 
 
 void dumpSpanningtreeTree(struct SpanningtreeTree sptTree, struct GraphPool* gp) {
-	for (int v=0; v<sptTree.nRoots; ++v) {
-		dumpGraphList(gp, sptTree.localSpanningTrees[v]);
-		if (sptTree.characteristics) {
-			if (sptTree.characteristics[v]) {
-				struct SupportSetElement* tmp;
-				for (struct SupportSetElement* e=sptTree.characteristics[v]->first; e!=NULL; e=tmp) {
-					tmp = e->next;
-					dumpNewCube(e->data.S, e->data.g->n);
-					free(e);
-				}
-			}
-			free(sptTree.characteristics[v]);
-		}
-		if (sptTree.localPostorders) {
-			if (sptTree.localPostorders[v]) {
-				struct PostorderList* tmp = NULL;
-				for (struct PostorderList* l=sptTree.localPostorders[v]; l!=NULL; l=tmp) {
-					tmp = l->next;
-					free(l->postorder);
-					free(l);
-				}
-			}
-		}
-	}
+	(void)gp; // unused
 	free(sptTree.parents);
 	free(sptTree.roots);
-	free(sptTree.localSpanningTrees);
-	free(sptTree.localPostorders);
-	if (sptTree.characteristics) {
-		free(sptTree.characteristics);
+	free(sptTree.localTrees);
+	free(sptTree.cubes);
+	if (sptTree.bipartite) {
+		dumpCachedGraph(sptTree.bipartite);
 	}
 }
 
@@ -689,7 +759,7 @@ void dumpSpanningtreeTree(struct SpanningtreeTree sptTree, struct GraphPool* gp)
 static int countNontrivialRoots(struct SpanningtreeTree sptTree) {
 	int count = 0;
 	for (int i=0; i<sptTree.nRoots; ++i) {
-		if (sptTree.localSpanningTrees[i]->next) {
+		if (sptTree.firstLocalTree[i+1] - sptTree.firstLocalTree[i] > 1) {
 			++count;
 		}
 	}
@@ -707,14 +777,16 @@ void printSptTree(struct SpanningtreeTree sptTree) {
 	printf("local spanning trees:\n");
 	for (int v=0; v<sptTree.nRoots; ++v) {
 		printf("root %i (-> %i): lps (%i %i) \n", sptTree.roots[v]->number, sptTree.parents[v]->number, sptTree.roots[v]->lowPoint, sptTree.parents[v]->lowPoint);
-		printGraph(sptTree.localSpanningTrees[v]);
+		for (int t=sptTree.firstLocalTree[v]; t<sptTree.firstLocalTree[v+1]; ++t) {
+			printGraph(&(sptTree.localTrees[t]));
+		}
 	}
 
 	printf("Characteristics:\n");
 	for (int v=0; v<sptTree.nRoots; ++v) {
 		printf("root %i (-> %i):\n", sptTree.roots[v]->number, sptTree.parents[v]->number);
-		if (sptTree.characteristics && sptTree.characteristics[v]) {
-			for (struct SupportSetElement* e=sptTree.characteristics[v]->first; e!=NULL; e=e->next) {
+		if (sptTree.characteristics[v].first != NULL) {
+			for (struct SupportSetElement* e=sptTree.characteristics[v].first; e!=NULL; e=e->next) {
 				printNewCubeCondensed(e->data.S, e->data.g->n, e->data.h->n, stdout);
 			}
 		} else {
@@ -832,6 +904,21 @@ void computeCharacteristics(struct SubtreeIsoDataStore* current, struct SubtreeI
 }
 
 
+/* the cube of local tree t starts at byte (number of vertices in the trees before t) * h->n^2 / 8 + t,
+ * which leaves enough space for the cubes of the trees before t */
+static size_t getCubeOffset(struct SpanningtreeTree* sptTree, int t, size_t cubeBits) {
+	return (size_t)(sptTree->localPostorders[t] - sptTree->localPostorders[0]) * cubeBits / 8 + t;
+}
+
+
+/**
+ * Return the number of bytes that the cubes of all local spanning trees of sptTree take for a pattern with hn vertices.
+ */
+size_t getCubesSizeForSpanningtreeTree(struct SpanningtreeTree* sptTree, int hn) {
+	return (size_t)sptTree->nLocalVertices * hn * hn / 8 + sptTree->nLocalTrees + 1;
+}
+
+
 /**
 Labeled Subtree Isomorphism Check for a single local spanning tree of some v-rooted blocks.
  */
@@ -839,9 +926,7 @@ static void subtreeCheckForOneBlockSpanningTree(struct SubtreeIsoDataStore* curr
 
 	struct Graph* g = current->g;
 	struct Graph* h = current->h;
-
-
-	struct CachedGraph* cachedB = initCachedGraph(gp, h->n);
+	struct CachedGraph* cachedB = sptTree->bipartite;
 
 	current->foundIso = 0;
 	// we can skip the computation if w = v, unless v is the global root of the graph
@@ -860,28 +945,25 @@ static void subtreeCheckForOneBlockSpanningTree(struct SubtreeIsoDataStore* curr
 			if ((w->d == -1) || (w->number == 0)) {
 				computeCharacteristics(current, NULL, cachedB, u, w, NULL, gp);
 				if (current->foundIso) {
-					dumpCachedGraph(cachedB);
 					return;
 				}
 
 			} else {
 				// if w is a root unequal v
 				// loop over the spanning trees of the w-rooted components
-				for (struct SupportSetElement* e=sptTree->characteristics[w->d]->first; e!=NULL; e=e->next) {
+				for (struct SupportSetElement* e=sptTree->characteristics[w->d].first; e!=NULL; e=e->next) {
 //					if (e->next) {
 //						fprintf(stderr, "processing multiple children at v=%i for w=%i\n", g->vertices[0]->d, w->d);
 //					}
 					struct Vertex* wBelow = e->data.g->vertices[0];
 					computeCharacteristics(current, &(e->data), cachedB, u, w, wBelow, gp);
 					if (current->foundIso) {
-						dumpCachedGraph(cachedB);
 						return;
 					}
 				}
 			}
 		}
 	}
-	dumpCachedGraph(cachedB);
 }
 
 
@@ -895,36 +977,313 @@ static void subtreeCheckForOneBlockSpanningTree(struct SubtreeIsoDataStore* curr
  */
 char subtreeCheckForSpanningtreeTree(struct SpanningtreeTree* sptTree, struct Graph* h, struct GraphPool* gp) {
 
+	size_t cubeBits = (size_t)h->n * h->n;
+	size_t cubesSize = getCubesSizeForSpanningtreeTree(sptTree, h->n);
+	if (cubesSize > sptTree->cubesSize) {
+		free(sptTree->cubes);
+		sptTree->cubes = malloc(cubesSize);
+		sptTree->cubesSize = cubesSize;
+	}
+	if (sptTree->bipartite == NULL) {
+		sptTree->bipartite = initCachedGraph(gp, h->n);
+	}
+
 	// for each root, process each spanning tree of the v rooted components and compute characteristics
 	for (int v=sptTree->nRoots-1; v>=0; --v) {
 		// we need to compute characteristics for the global root, which is a special case.
 		int blockDoesNotContainGlobalRoot = v==0 ? 0 : 1;
+		struct SupportSet* characteristics = &(sptTree->characteristics[v]);
+		characteristics->first = characteristics->last = NULL;
+		characteristics->size = 0;
+
+		for (int t=sptTree->firstLocalTree[v]; t<sptTree->firstLocalTree[v+1]; ++t) {
+			struct SupportSetElement* e = &(sptTree->characteristicElements[t]);
+			struct Graph* localTree = &(sptTree->localTrees[t]);
+			size_t size = (localTree->n * cubeBits + 7) / 8;
+
+			e->data.g = localTree;
+			e->data.h = h;
+			e->data.postorder = sptTree->localPostorders[t];
+			e->data.S = sptTree->cubes + getCubeOffset(sptTree, t, cubeBits);
+			e->data.foundIso = 0;
+			e->next = NULL;
+			memset(e->data.S, 0, size);
+
+			subtreeCheckForOneBlockSpanningTree(&(e->data), sptTree, blockDoesNotContainGlobalRoot, gp);
+			appendSupportSetElement(characteristics, e);
+
+			if (e->data.foundIso) {
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+/*
+ * Compute all characteristics for one $\theta \in \Theta_{vw}(\tau)$, including (u, u, w) and all (x, u, w) for neighbors x of u
+ * if there is an isomorphism. Return 1 in this case and 0 otherwise.
+ */
+static char computeAllCharacteristics(struct SubtreeIsoDataStore* current, struct SubtreeIsoDataStore* wCharacteristics, struct CachedGraph* cachedB, struct Vertex* u, struct Vertex* w, struct Vertex* wBelow, struct GraphPool* gp) {
+
+	struct Graph* B = makeBipartiteInstanceFromVerticesForLocalEasyCached(*current, wCharacteristics, cachedB, u, w, wBelow, gp);
+	int sizeofMatching = bipartiteMatchingEvenMoreDirty(B);
+	int nNeighbors = B->number;
+	char foundIso = sizeofMatching == nNeighbors;
+
+	if (foundIso) {
+		addCharacteristic(current, u, u, w);
+		for (struct VertexList* e=u->neighborhood; e!=NULL; e=e->next) {
+			addCharacteristic(current, e->endPoint, u, w);
+		}
+		current->foundIso = 1;
+	} else if (sizeofMatching == nNeighbors - 1) {
+		addNoncriticalVertexCharacteristics(current, B, u, w);
+	}
 
-		struct Graph* localTree = NULL;
-		struct PostorderList* localPostorder = NULL;
-		for (localTree=sptTree->localSpanningTrees[v], localPostorder=sptTree->localPostorders[v];
-				localTree!=NULL;
-				localTree=localTree->next, localPostorder=localPostorder->next) {
+	returnCachedGraph(cachedB);
+	return foundIso;
+}
 
-			struct SubtreeIsoDataStore info = {0,0,0,0,0};
-			info.g = localTree;
-			info.h = h;
-//			info.postorder = getPostorder(localTree, 0); // 0 is the root v of localTree
-			info.postorder = localPostorder->postorder;
-			info.S = createNewCube(info.g->n, info.h->n);
 
-			subtreeCheckForOneBlockSpanningTree(&info, sptTree, blockDoesNotContainGlobalRoot, gp);
-			appendSupportSetData(sptTree->characteristics[v], info);
+/*
+ * Compute the characteristics (a, b, w) and (b, b, w) for the last vertex b of h, which is a leaf with neighbor a.
+ * This is what computeAllCharacteristics() does, without building a bipartite graph: H^a_b is the single vertex b and
+ * H^b_b is h rooted at b, which maps to w if H^b_a maps to a child of w along an edge with the label of {a, b}.
+ */
+static void computeLeafCharacteristics(struct SubtreeIsoDataStore* current, struct SpanningtreeTree* sptTree, struct Vertex* b, struct Vertex* w) {
+	struct Vertex* a = b->neighborhood->endPoint;
+	char* edgeLabel = b->neighborhood->label;
+
+	addCharacteristic(current, a, b, w);
 
-//			free(info.postorder);
-//			info.postorder = NULL;
+	for (struct VertexList* e=w->neighborhood; e!=NULL; e=e->next) {
+		/* y has to be a child of w */
+		if ((e->endPoint->visited < w->visited) && (labelCmp(e->label, edgeLabel) == 0) && containsCharacteristic(*current, b, a, e->endPoint)) {
+			addCharacteristic(current, b, b, w);
+			current->foundIso = 1;
+			return;
+		}
+	}
+	if ((w->d != -1) && (w->number != 0)) {
+		for (struct SupportSetElement* c=sptTree->characteristics[w->d].first; c!=NULL; c=c->next) {
+			for (struct VertexList* e=c->data.g->vertices[0]->neighborhood; e!=NULL; e=e->next) {
+				if ((labelCmp(e->label, edgeLabel) == 0) && containsCharacteristic(c->data, b, a, e->endPoint)) {
+					addCharacteristic(current, b, b, w);
+					current->foundIso = 1;
+					return;
+				}
+			}
+		}
+	}
+}
+
+
+/*
+ * Let b be the last vertex of h and a its neighbor. The characteristics (x, u, w) of h differ from those of h - b only if
+ * a is contained in the subtree H^x_u, i.e. if x is not the parent of u in h rooted at a. These can only hold in h if they
+ * hold in h - b.
+ */
+static char mayHaveNewCharacteristics(uint8_t* base, int baseN, struct Vertex* u, struct Vertex* w, int* parents) {
+	size_t offset = ((size_t)w->number * baseN + u->number) * baseN;
+	if (getBit(base, offset + u->number)) {
+		return 1;
+	}
+	for (struct VertexList* e=u->neighborhood; e!=NULL; e=e->next) {
+		int x = e->endPoint->number;
+		if ((x < baseN) && (x != parents[u->number]) && getBit(base, offset + x)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+/*
+ * The bipartite graph that decides the characteristics (x, u, w) has an edge between a neighbor x of u and a child y of w if
+ * (u, x, y) holds. For u != a, this changes from h - b to h only for the parent p of u in h rooted at a. Return 1 if these
+ * edges are the same for h and h - b. Then, the characteristics (x, u, w) of h are those of h - b.
+ */
+static char hasSameBipartiteGraph(struct SubtreeIsoDataStore* current, uint8_t* baseCubes, size_t baseCubeBits, int t, struct SpanningtreeTree* sptTree, struct Vertex* u, struct Vertex* p, char* edgeLabel, struct Vertex* w) {
+	int baseN = current->h->n - 1;
+	uint8_t* base = baseCubes + getCubeOffset(sptTree, t, baseCubeBits);
+
+	for (struct VertexList* e=w->neighborhood; e!=NULL; e=e->next) {
+		struct Vertex* y = e->endPoint;
+		/* y has to be a child of w */
+		if ((y->visited < w->visited) && (labelCmp(e->label, edgeLabel) == 0)) {
+			if (containsCharacteristic(*current, u, p, y) != getBit(base, ((size_t)y->number * baseN + p->number) * baseN + u->number)) {
+				return 0;
+			}
+		}
+	}
+	if ((w->d != -1) && (w->number != 0)) {
+		for (struct SupportSetElement* c=sptTree->characteristics[w->d].first; c!=NULL; c=c->next) {
+			base = baseCubes + getCubeOffset(sptTree, (int)(c - sptTree->characteristicElements), baseCubeBits);
+			for (struct VertexList* e=c->data.g->vertices[0]->neighborhood; e!=NULL; e=e->next) {
+				struct Vertex* y = e->endPoint;
+				if (labelCmp(e->label, edgeLabel) == 0) {
+					if (containsCharacteristic(c->data, u, p, y) != getBit(base, ((size_t)y->number * baseN + p->number) * baseN + u->number)) {
+						return 0;
+					}
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+
+/**
+ * Compute all characteristics of h for the local spanning tree t of some v-rooted blocks.
+ *
+ * If baseCubes is NULL, all characteristics are computed from scratch. Otherwise, baseCubes must contain the characteristics
+ * of h - b, where b is the last vertex of h, and parents must contain the parents of the vertices of h rooted at the neighbor
+ * of b. Then, only those characteristics are recomputed that may change by adding b.
+ */
+static void iterativeSubtreeCheckForOneBlockSpanningTree(struct SubtreeIsoDataStore* current, uint8_t* baseCubes, int* parents, int t, struct SpanningtreeTree* sptTree, int blockDoesNotContainGlobalRoot, struct GraphPool* gp) {
+
+	struct Graph* g = current->g;
+	struct Graph* h = current->h;
+	struct CachedGraph* cachedB = sptTree->bipartite;
+	int baseN = h->n - 1;
+	size_t baseCubeBits = (size_t)baseN * baseN;
+	uint8_t* base = baseCubes ? baseCubes + getCubeOffset(sptTree, t, baseCubeBits) : NULL;
 
-			if (info.foundIso) {
+	current->foundIso = 0;
+	for (int wi=0; wi<g->n-blockDoesNotContainGlobalRoot; ++wi) {
+		struct Vertex* w = g->vertices[current->postorder[wi]];
+
+		for (int ui=0; ui<h->n; ++ui) {
+			struct Vertex* u = h->vertices[ui];
+
+			// check if vertex labels match
+			if (labelCmp(u->label, w->label) != 0) { continue; }
+
+			if (base != NULL) {
+				if (ui == baseN) {
+					computeLeafCharacteristics(current, sptTree, u, w);
+					continue;
+				}
+
+				size_t offset = ((size_t)w->number * baseN + ui) * baseN;
+				int p = parents[ui];
+
+				// characteristics that do not contain the new vertex are copied from base
+				if (!mayHaveNewCharacteristics(base, baseN, u, w, parents)) {
+					if ((p != -1) && getBit(base, offset + p)) {
+						addCharacteristicRaw(current, p, ui, w->number);
+					}
+					continue;
+				}
+
+				// all characteristics are copied from base if the bipartite graph did not change
+				if (p != -1) {
+					struct VertexList* up = u->neighborhood;
+					while (up->endPoint->number != p) {
+						up = up->next;
+					}
+					if (hasSameBipartiteGraph(current, baseCubes, baseCubeBits, t, sptTree, u, up->endPoint, up->label, w)) {
+						for (int x=0; x<baseN; ++x) {
+							if (getBit(base, offset + x)) {
+								addCharacteristicRaw(current, x, ui, w->number);
+							}
+						}
+						if (getBit(base, offset + ui)) {
+							current->foundIso = 1;
+						}
+						continue;
+					}
+				}
+			}
+
+			if ((w->d == -1) || (w->number == 0)) {
+				computeAllCharacteristics(current, NULL, cachedB, u, w, NULL, gp);
+			} else {
+				for (struct SupportSetElement* e=sptTree->characteristics[w->d].first; e!=NULL; e=e->next) {
+					struct Vertex* wBelow = e->data.g->vertices[0];
+					if (computeAllCharacteristics(current, &(e->data), cachedB, u, w, wBelow, gp)) {
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+
+/**
+ * Return the number of bytes that iterativeSubtreeCheckForSpanningtreeTree() needs for a pattern with hn vertices.
+ */
+size_t getIterativeCubesSizeForSpanningtreeTree(struct SpanningtreeTree* sptTree, int hn) {
+	return sizeof(int) + getCubesSizeForSpanningtreeTree(sptTree, hn);
+}
+
+
+/**
+ * Iterative variant of subtreeCheckForSpanningtreeTree() that stores the characteristics of h in cubes, which must have
+ * getIterativeCubesSizeForSpanningtreeTree(sptTree, h->n) bytes.
+ *
+ * If baseCubes is not NULL, it must contain the characteristics of h - b that this function computed before, where b is the
+ * last vertex of h and a leaf. Then, only the characteristics that are affected by b are recomputed, similar to
+ * iterativeSubtreeCheck() for forests. If baseCubes is NULL, all characteristics are computed from scratch.
+ *
+ * Like subtreeCheckForSpanningtreeTree(), the computation stops once an isomorphism is found, but only after the current
+ * local spanning tree is complete. The first int of cubes stores the number of local spanning trees that are complete (in
+ * the order in which they are processed). The characteristics of the remaining ones are computed from scratch when cubes is
+ * the base of an extension of h.
+ */
+char iterativeSubtreeCheckForSpanningtreeTree(struct SpanningtreeTree* sptTree, struct Graph* h, uint8_t* baseCubes, uint8_t* cubes, struct GraphPool* gp) {
+
+	size_t cubeBits = (size_t)h->n * h->n;
+	memset(cubes, 0, getIterativeCubesSizeForSpanningtreeTree(sptTree, h->n));
+	if (sptTree->bipartite == NULL) {
+		sptTree->bipartite = initCachedGraph(gp, h->n);
+	}
+
+	int nBaseTrees = 0;
+	int* parents = NULL;
+	if (baseCubes != NULL) {
+		struct Vertex* b = h->vertices[h->n - 1];
+		nBaseTrees = ((int*)baseCubes)[0];
+		parents = getParents(h, b->neighborhood->endPoint->number);
+	}
+
+	int nTrees = 0;
+	for (int v=sptTree->nRoots-1; v>=0; --v) {
+		int blockDoesNotContainGlobalRoot = v==0 ? 0 : 1;
+		struct SupportSet* characteristics = &(sptTree->characteristics[v]);
+		characteristics->first = characteristics->last = NULL;
+		characteristics->size = 0;
+
+		for (int t=sptTree->firstLocalTree[v]; t<sptTree->firstLocalTree[v+1]; ++t) {
+			struct SupportSetElement* e = &(sptTree->characteristicElements[t]);
+
+			e->data.g = &(sptTree->localTrees[t]);
+			e->data.h = h;
+			e->data.postorder = sptTree->localPostorders[t];
+			e->data.S = cubes + sizeof(int) + getCubeOffset(sptTree, t, cubeBits);
+			e->data.foundIso = 0;
+			e->next = NULL;
+
+			/* the trees that are processed before a complete tree are complete, too */
+			uint8_t* base = nTrees < nBaseTrees ? baseCubes + sizeof(int) : NULL;
+			iterativeSubtreeCheckForOneBlockSpanningTree(&(e->data), base, parents, t, sptTree, blockDoesNotContainGlobalRoot, gp);
+			appendSupportSetElement(characteristics, e);
+			++nTrees;
+
+			if (e->data.foundIso) {
+				((int*)cubes)[0] = nTrees;
+				free(parents);
 				return 1;
 			}
 		}
 	}
 
+	((int*)cubes)[0] = nTrees;
+	free(parents);
 	return 0;
 }
 
@@ -941,7 +1300,7 @@ char subtreeCheckForSpanningtreeTree(struct SpanningtreeTree* sptTree, struct Gr
  */
 char isProbabilisticLocalSampleSubtree(struct Graph* g, struct Graph* h, int nLocalTrees, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
-	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(blockTree, nLocalTrees, 1, gp, sgp);
+	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(blockTree, nLocalTrees, 1, threadRandomNumberGenerator(), gp, sgp);
 
 	char result = subtreeCheckForSpanningtreeTree(&sptTree, h, gp);
 
@@ -1078,7 +1437,7 @@ static struct ShallowGraph* xcanonicalStringOfTree(struct Graph* g, int k, long
 /**
  *
  */
-int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
 	int numberOfNonisomorphicSpanningForestComponents = 0;
@@ -1093,7 +1452,7 @@ int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(struct Grap
 		if (mergedGraph->m != mergedGraph->n-1) {
 			// sample spanning trees according to parameter
 			for (int i=0; i<k; ++i) {
-				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, sgp);
+				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, rng, sgp);
 				spt->next = shallowSpanningtrees;
 				shallowSpanningtrees = spt;
 			}
@@ -1149,7 +1508,7 @@ int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(struct Grap
 /**
  *
  */
-int getNumberOfSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+int getNumberOfSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
 	int numberOfConsideredSpanningTrees = 1;
@@ -1164,7 +1523,7 @@ int getNumberOfSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k,
 		if (mergedGraph->m != mergedGraph->n-1) {
 			// sample spanning trees according to parameter
 			for (int i=0; i<k; ++i) {
-				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, sgp);
+				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, rng, sgp);
 				spt->next = shallowSpanningtrees;
 				shallowSpanningtrees = spt;
 			}
@@ -1219,7 +1578,7 @@ int getNumberOfSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k,
 }
 
 
-int getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+int getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
 	int numberOfConsideredSpanningTrees = 1;
@@ -1234,7 +1593,7 @@ int getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Grap
 		if (mergedGraph->m != mergedGraph->n-1) {
 			// sample spanning trees according to parameter
 			for (int i=0; i<k; ++i) {
-				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, sgp);
+				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, rng, sgp);
 				spt->next = shallowSpanningtrees;
 				shallowSpanningtrees = spt;
 			}
@@ -1292,7 +1651,7 @@ int getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Grap
 /**
  *
  */
-int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
 	int numberOfNonisomorphicSpanningForestComponents = 0;
@@ -1307,7 +1666,7 @@ int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFilterin
 		if (mergedGraph->m != mergedGraph->n-1) {
 			// sample spanning trees according to parameter
 			for (int i=0; i<k; ++i) {
-				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, sgp);
+				struct ShallowGraph* spt = randomSpanningTreeAsShallowGraph(mergedGraph, rng, sgp);
 				spt->next = shallowSpanningtrees;
 				shallowSpanningtrees = spt;
 			}
@@ -2,11 +2,9 @@
 #define LOCAL_EASY_SUBTREE_ISO
 
 #include "supportSet.h"
-
-struct PostorderList{
-	int* postorder;
-	struct PostorderList* next;
-};
+#include "randomNumberGenerator.h"
+#include "localSpanningTreeCache.h"
+#include "cachedGraph.h"
 
 /*
  want a tree on roots.
@@ -24,38 +22,60 @@ struct BlockTree{
 
 /*
  *  [x] each vertex should store spanning trees of the v-rooted components
- *  each vertex should store the set of characteristics
+ *  [x] each vertex should store the set of characteristics
  *  and maybe some pruning info?...
+ *
+ * The local spanning trees of root v are localTrees[firstLocalTree[v]], ..., localTrees[firstLocalTree[v+1]-1].
+ * The postorder of localTrees[t] is localPostorders[t] and the characteristics that a subtree check computes
+ * for it are characteristicElements[t], which is appended to characteristics[v].
+ *
+ * All of this is stored in one block of memory that starts at localTrees: the graphs, their vertices, and their
+ * edges (the edges of each vertex are consecutive), followed by the characteristics and the postorders.
+ * The characteristic cubes of a subtree check are stored in cubes, which grows with the size of the pattern.
+ * Likewise, bipartite holds the bipartite matching instances of all subtree checks. Hence, repeated subtree checks
+ * allocate no memory once they have seen the largest pattern.
  */
 struct SpanningtreeTree{
 	struct Graph* g;
 	struct Vertex** roots;
 	struct Vertex** parents;
-	struct Graph** localSpanningTrees;
-	struct SupportSet** characteristics;
-	struct PostorderList** localPostorders;
 	int nRoots;
+	int nLocalTrees;
+	int nLocalVertices;
+
+	struct Graph* localTrees;
+	int* firstLocalTree;
+	int** localPostorders;
+	struct SupportSet* characteristics;
+	struct SupportSetElement* characteristicElements;
+	uint8_t* cubes;
+	size_t cubesSize;
+	struct CachedGraph* bipartite;
 };
 
 
 struct BlockTree getBlockTreeT(struct Graph* g, struct ShallowGraphPool* sgp);
 struct Graph* blockConverter(struct ShallowGraph* edgeList, struct GraphPool* gp);
 struct Graph* spanningTreeConverter(struct ShallowGraph* localTrees, struct Graph* component, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct SpanningtreeTree getSampledSpanningtreeTree(struct BlockTree blockTree, int spanningTreesPerBlock, char removeDuplicates, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct SpanningtreeTree getSampledSpanningtreeTree(struct BlockTree blockTree, int spanningTreesPerBlock, char removeDuplicates, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 struct SpanningtreeTree getFullSpanningtreeTree(struct BlockTree blockTree, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct SpanningtreeTree getCachedSampledSpanningtreeTree(struct BlockTree blockTree, int spanningTreesPerBlock, char removeDuplicates, struct LocalSpanningTreeCache* cache, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct SpanningtreeTree getCachedFullSpanningtreeTree(struct BlockTree blockTree, struct LocalSpanningTreeCache* cache, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 void dumpSpanningtreeTree(struct SpanningtreeTree sptTree, struct GraphPool* gp);
 
-void initCharacteristicsArrayForLocalEasy(struct SpanningtreeTree* sptTree);
 void wipeCharacteristicsForLocalEasy(struct SpanningtreeTree sptTree);
 
 char subtreeCheckForSpanningtreeTree(struct SpanningtreeTree* sptTree, struct Graph* h, struct GraphPool* gp);
+size_t getCubesSizeForSpanningtreeTree(struct SpanningtreeTree* sptTree, int hn);
+size_t getIterativeCubesSizeForSpanningtreeTree(struct SpanningtreeTree* sptTree, int hn);
+char iterativeSubtreeCheckForSpanningtreeTree(struct SpanningtreeTree* sptTree, struct Graph* h, uint8_t* baseCubes, uint8_t* cubes, struct GraphPool* gp);
 char isProbabilisticLocalSampleSubtree(struct Graph* g, struct Graph* h, int nLocalTrees, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 char isLocalEasySubtree(struct Graph* g, struct Graph* h, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 
-int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-int getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-int getNumberOfSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+int getNumberOfNonisomorphicSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+int getNumberOfSpanningTreesObtainedByLocalEasySamplingWithFiltering(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+int getNumberOfSpanningTreesObtainedByLocalEasySampling(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 
 int getNumberOfDifferentSpanningForestComponentsForKSamples(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 #endif
@@ -0,0 +1,449 @@
+/**
+ * Cache of local spanning trees for isomorphic blocks, see struct LocalSpanningTreeCache.
+ *
+ * Blocks are compared by color refinement (1-dimensional Weisfeiler-Lehman): each vertex starts with the hash
+ * of its label and is repeatedly recolored by the hash of its color and the colors and edge labels of its
+ * neighbors, until the number of colors does not increase anymore. Isomorphic blocks get the same multiset
+ * of colors. The isomorphism that is found for a cache hit maps the cached trees onto the new block.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph.h"
+#include "memoryManagement.h"
+#include "localSpanningTreeCache.h"
+
+/* number of candidate vertices that an isomorphism search may try per vertex of the block */
+#define MATCHING_STEPS_PER_VERTEX 256
+
+
+static inline unsigned int mixHash(unsigned int h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+
+/* FNV-1a hash of label. NULL labels hash to 0 */
+static unsigned int hashLabel(const char* label) {
+	if (label == NULL) {
+		return 0;
+	}
+	unsigned int h = 2166136261u;
+	for (const char* c=label; *c!='\0'; ++c) {
+		h ^= (unsigned char)*c;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+
+/* NULL labels are equal to each other and smaller than any string */
+static int compareLabels(const char* a, const char* b) {
+	if ((a == NULL) || (b == NULL)) {
+		return (a != NULL) - (b != NULL);
+	}
+	return strcmp(a, b);
+}
+
+
+static int compareColors(const void* a, const void* b) {
+	unsigned int x = *(const unsigned int*)a;
+	unsigned int y = *(const unsigned int*)b;
+	return (x > y) - (x < y);
+}
+
+
+static int countColors(const unsigned int* colors, int n, unsigned int* sorted) {
+	memcpy(sorted, colors, n * sizeof(unsigned int));
+	qsort(sorted, n, sizeof(unsigned int), &compareColors);
+	int nColors = (n > 0) ? 1 : 0;
+	for (int i=1; i<n; ++i) {
+		if (sorted[i] != sorted[i-1]) {
+			++nColors;
+		}
+	}
+	return nColors;
+}
+
+
+struct LocalSpanningTreeCache* createLocalSpanningTreeCache() {
+	struct LocalSpanningTreeCache* cache = malloc(sizeof(struct LocalSpanningTreeCache));
+	cache->tableSize = 1024;
+	cache->table = calloc(cache->tableSize, sizeof(struct CachedBlock*));
+	cache->nBlocks = 0;
+	cache->hits = 0;
+	cache->misses = 0;
+
+	cache->block = NULL;
+	cache->vertexCapacity = 0;
+	cache->slotCapacity = 0;
+	memset(&(cache->current), 0, sizeof(struct CachedBlock));
+	cache->newColors = NULL;
+	cache->sortedColors = NULL;
+	cache->edgeLabelHashes = NULL;
+	cache->mapping = NULL;
+	cache->used = NULL;
+	cache->candidates = NULL;
+	return cache;
+}
+
+
+static void freeCachedBlock(struct CachedBlock* b) {
+	for (int v=0; v<b->n; ++v) {
+		free(b->vertexLabels[v]);
+	}
+	for (int i=0; i<2*b->m; ++i) {
+		free(b->edgeLabels[i]);
+	}
+	free(b->colors);
+	free(b->vertexLabels);
+	free(b->offsets);
+	free(b->targets);
+	free(b->edgeLabels);
+	free(b->order);
+	free(b->bfsParent);
+	free(b->treeEdges);
+	free(b);
+}
+
+
+void freeLocalSpanningTreeCache(struct LocalSpanningTreeCache* cache) {
+	for (int i=0; i<cache->tableSize; ++i) {
+		struct CachedBlock* next;
+		for (struct CachedBlock* b=cache->table[i]; b!=NULL; b=next) {
+			next = b->next;
+			freeCachedBlock(b);
+		}
+	}
+	free(cache->table);
+
+	free(cache->current.colors);
+	free(cache->current.vertexLabels);
+	free(cache->current.offsets);
+	free(cache->current.targets);
+	free(cache->current.edgeLabels);
+	free(cache->newColors);
+	free(cache->sortedColors);
+	free(cache->edgeLabelHashes);
+	free(cache->mapping);
+	free(cache->used);
+	free(cache->candidates);
+	free(cache);
+}
+
+
+static void reserveScratchSpace(struct LocalSpanningTreeCache* cache, int n, int nSlots) {
+	if (n > cache->vertexCapacity) {
+		cache->vertexCapacity = 2 * n;
+		int c = cache->vertexCapacity;
+		cache->current.colors = realloc(cache->current.colors, c * sizeof(unsigned int));
+		cache->current.vertexLabels = realloc(cache->current.vertexLabels, c * sizeof(char*));
+		cache->current.offsets = realloc(cache->current.offsets, (c + 1) * sizeof(int));
+		cache->newColors = realloc(cache->newColors, c * sizeof(unsigned int));
+		cache->sortedColors = realloc(cache->sortedColors, c * sizeof(unsigned int));
+		cache->mapping = realloc(cache->mapping, c * sizeof(int));
+		cache->used = realloc(cache->used, c * sizeof(char));
+		cache->candidates = realloc(cache->candidates, c * sizeof(int));
+	}
+	if (nSlots > cache->slotCapacity) {
+		cache->slotCapacity = 2 * nSlots;
+		int c = cache->slotCapacity;
+		cache->current.targets = realloc(cache->current.targets, c * sizeof(int));
+		cache->current.edgeLabels = realloc(cache->current.edgeLabels, c * sizeof(char*));
+		cache->edgeLabelHashes = realloc(cache->edgeLabelHashes, c * sizeof(unsigned int));
+	}
+}
+
+
+/**
+ * Store block in cache->current and compute its colors and its hash.
+ */
+static void loadBlock(struct LocalSpanningTreeCache* cache, struct Graph* block) {
+	struct CachedBlock* b = &(cache->current);
+	int n = block->n;
+	reserveScratchSpace(cache, n, 2 * block->m);
+	cache->block = block;
+	b->n = n;
+	b->m = block->m;
+
+	b->offsets[0] = 0;
+	for (int v=0; v<n; ++v) {
+		int i = b->offsets[v];
+		for (struct VertexList* e=block->vertices[v]->neighborhood; e!=NULL; e=e->next, ++i) {
+			b->targets[i] = e->endPoint->number;
+			b->edgeLabels[i] = e->label;
+			cache->edgeLabelHashes[i] = hashLabel(e->label);
+		}
+		b->offsets[v+1] = i;
+		b->vertexLabels[v] = block->vertices[v]->label;
+		b->colors[v] = hashLabel(block->vertices[v]->label);
+	}
+
+	// color refinement
+	int nColors = countColors(b->colors, n, cache->sortedColors);
+	for (int round=0; round<n; ++round) {
+		for (int v=0; v<n; ++v) {
+			unsigned int neighbors = 0;
+			for (int i=b->offsets[v]; i<b->offsets[v+1]; ++i) {
+				neighbors += mixHash(b->colors[b->targets[i]] * 0x9e3779b1u + cache->edgeLabelHashes[i]);
+			}
+			cache->newColors[v] = mixHash(b->colors[v] * 31u + neighbors);
+		}
+		unsigned int* tmp = b->colors;
+		b->colors = cache->newColors;
+		cache->newColors = tmp;
+
+		int nNewColors = countColors(b->colors, n, cache->sortedColors);
+		if (nNewColors <= nColors) {
+			break;
+		}
+		nColors = nNewColors;
+	}
+
+	// countColors left the sorted colors in cache->sortedColors
+	unsigned int h = mixHash(n * 31u + b->m);
+	for (int v=0; v<n; ++v) {
+		h = mixHash(h * 31u + cache->sortedColors[v]);
+	}
+	b->hash = h;
+}
+
+
+/* check if the edges between u and the already mapped neighbors of u in r exist in g with the same labels */
+static char isConsistent(struct CachedBlock* r, struct CachedBlock* g, int* mapping, int u, int x) {
+	if ((r->offsets[u+1] - r->offsets[u] != g->offsets[x+1] - g->offsets[x])
+			|| (compareLabels(r->vertexLabels[u], g->vertexLabels[x]) != 0)) {
+		return 0;
+	}
+	for (int i=r->offsets[u]; i<r->offsets[u+1]; ++i) {
+		int y = mapping[r->targets[i]];
+		if (y == -1) {
+			continue;
+		}
+		char found = 0;
+		for (int j=g->offsets[x]; j<g->offsets[x+1]; ++j) {
+			if ((g->targets[j] == y) && (compareLabels(r->edgeLabels[i], g->edgeLabels[j]) == 0)) {
+				found = 1;
+				break;
+			}
+		}
+		if (!found) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+/**
+ * Search an isomorphism from the cached block r to the current block of cache. On success, cache->mapping[v]
+ * is the image of vertex v of r. Vertices are mapped in the breadth first order of r, hence the candidates for
+ * each vertex but the first are the neighbors of the image of its parent.
+ */
+static char findIsomorphism(struct LocalSpanningTreeCache* cache, struct CachedBlock* r) {
+	struct CachedBlock* g = &(cache->current);
+	int n = r->n;
+	int* mapping = cache->mapping;
+	char* used = cache->used;
+	int* candidates = cache->candidates;
+	long budget = (long)MATCHING_STEPS_PER_VERTEX * n;
+
+	for (int v=0; v<n; ++v) {
+		mapping[v] = -1;
+		used[v] = 0;
+	}
+
+	int d = 0;
+	candidates[0] = 0;
+	while (d >= 0) {
+		int u = r->order[d];
+		if (mapping[u] != -1) {
+			used[mapping[u]] = 0;
+			mapping[u] = -1;
+		}
+
+		int end = (d == 0) ? n : g->offsets[mapping[r->bfsParent[u]] + 1];
+		int x = -1;
+		while (candidates[d] < end) {
+			int y = (d == 0) ? candidates[d] : g->targets[candidates[d]];
+			++candidates[d];
+			if (--budget < 0) {
+				return 0;
+			}
+			if (!used[y] && (g->colors[y] == r->colors[u]) && isConsistent(r, g, mapping, u, y)) {
+				x = y;
+				break;
+			}
+		}
+
+		if (x == -1) {
+			--d;
+			continue;
+		}
+		mapping[u] = x;
+		used[x] = 1;
+		if (d == n - 1) {
+			return 1;
+		}
+		++d;
+		candidates[d] = g->offsets[mapping[r->bfsParent[r->order[d]]]];
+	}
+	return 0;
+}
+
+
+/* return the trees of r, mapped to the current block of cache */
+static struct ShallowGraph* mapTrees(struct LocalSpanningTreeCache* cache, struct CachedBlock* r, struct ShallowGraphPool* sgp) {
+	struct Graph* block = cache->block;
+	struct ShallowGraph* trees = NULL;
+	for (int t=r->nTrees-1; t>=0; --t) {
+		struct ShallowGraph* tree = getShallowGraph(sgp);
+		int* edges = r->treeEdges + 2 * t * (r->n - 1);
+		for (int i=0; i<r->n-1; ++i) {
+			struct Vertex* v = block->vertices[cache->mapping[edges[2*i]]];
+			int w = cache->mapping[edges[2*i+1]];
+			for (struct VertexList* e=v->neighborhood; e!=NULL; e=e->next) {
+				if (e->endPoint->number == w) {
+					appendEdge(tree, shallowCopyEdge(e, sgp->listPool));
+					break;
+				}
+			}
+		}
+		tree->next = trees;
+		trees = tree;
+	}
+	return trees;
+}
+
+
+/**
+ * Return the local spanning trees of a block that is isomorphic to the connected graph block, mapped onto block,
+ * or NULL if there is no such block in the cache. In the latter case, the trees of block can be added by
+ * addLocalSpanningTreesToCache().
+ */
+struct ShallowGraph* getCachedLocalSpanningTrees(struct LocalSpanningTreeCache* cache, struct Graph* block, struct ShallowGraphPool* sgp) {
+	loadBlock(cache, block);
+	struct CachedBlock* g = &(cache->current);
+	for (struct CachedBlock* r=cache->table[g->hash & (cache->tableSize - 1)]; r!=NULL; r=r->next) {
+		if ((r->hash == g->hash) && (r->n == g->n) && (r->m == g->m) && findIsomorphism(cache, r)) {
+			++cache->hits;
+			return mapTrees(cache, r, sgp);
+		}
+	}
+	++cache->misses;
+	return NULL;
+}
+
+
+static char* copyLabel(char* label) {
+	return (label != NULL) ? copyString(label) : NULL;
+}
+
+
+static void rehashCache(struct LocalSpanningTreeCache* cache) {
+	int tableSize = 2 * cache->tableSize;
+	struct CachedBlock** table = calloc(tableSize, sizeof(struct CachedBlock*));
+	for (int i=0; i<cache->tableSize; ++i) {
+		struct CachedBlock* next;
+		for (struct CachedBlock* b=cache->table[i]; b!=NULL; b=next) {
+			next = b->next;
+			b->next = table[b->hash & (tableSize - 1)];
+			table[b->hash & (tableSize - 1)] = b;
+		}
+	}
+	free(cache->table);
+	cache->table = table;
+	cache->tableSize = tableSize;
+}
+
+
+/**
+ * Add the spanning trees of block to the cache. block has to be the graph of the last call of
+ * getCachedLocalSpanningTrees(), which returned NULL. trees is not changed.
+ */
+void addLocalSpanningTreesToCache(struct LocalSpanningTreeCache* cache, struct Graph* block, struct ShallowGraph* trees) {
+	struct CachedBlock* g = &(cache->current);
+	int n = g->n;
+	int nSlots = 2 * g->m;
+	if (cache->block != block) {
+		return;
+	}
+	// only spanning trees of connected blocks are cached
+	int nTrees = 0;
+	for (struct ShallowGraph* tree=trees; tree!=NULL; tree=tree->next) {
+		if (tree->m != n - 1) {
+			return;
+		}
+		++nTrees;
+	}
+
+	struct CachedBlock* b = malloc(sizeof(struct CachedBlock));
+	b->hash = g->hash;
+	b->n = n;
+	b->m = g->m;
+	b->colors = malloc(n * sizeof(unsigned int));
+	memcpy(b->colors, g->colors, n * sizeof(unsigned int));
+	b->offsets = malloc((n + 1) * sizeof(int));
+	memcpy(b->offsets, g->offsets, (n + 1) * sizeof(int));
+	b->targets = malloc(nSlots * sizeof(int));
+	memcpy(b->targets, g->targets, nSlots * sizeof(int));
+	b->vertexLabels = malloc(n * sizeof(char*));
+	for (int v=0; v<n; ++v) {
+		b->vertexLabels[v] = copyLabel(g->vertexLabels[v]);
+	}
+	b->edgeLabels = malloc(nSlots * sizeof(char*));
+	for (int i=0; i<nSlots; ++i) {
+		b->edgeLabels[i] = copyLabel(g->edgeLabels[i]);
+	}
+
+	// breadth first order, the queue is the order
+	b->order = malloc(n * sizeof(int));
+	b->bfsParent = malloc(n * sizeof(int));
+	char* visited = cache->used;
+	for (int v=0; v<n; ++v) {
+		visited[v] = 0;
+	}
+	b->order[0] = 0;
+	b->bfsParent[0] = -1;
+	visited[0] = 1;
+	int tail = 1;
+	for (int head=0; head<tail; ++head) {
+		int v = b->order[head];
+		for (int i=b->offsets[v]; i<b->offsets[v+1]; ++i) {
+			int w = b->targets[i];
+			if (!visited[w]) {
+				visited[w] = 1;
+				b->bfsParent[w] = v;
+				b->order[tail++] = w;
+			}
+		}
+	}
+
+	if (tail < n) {
+		b->treeEdges = NULL;
+		freeCachedBlock(b);
+		return;
+	}
+
+	b->nTrees = nTrees;
+	b->treeEdges = malloc(2 * b->nTrees * (n - 1) * sizeof(int));
+	int* edges = b->treeEdges;
+	for (struct ShallowGraph* tree=trees; tree!=NULL; tree=tree->next) {
+		for (struct VertexList* e=tree->edges; e!=NULL; e=e->next) {
+			*(edges++) = e->startPoint->number;
+			*(edges++) = e->endPoint->number;
+		}
+	}
+
+	b->next = cache->table[b->hash & (cache->tableSize - 1)];
+	cache->table[b->hash & (cache->tableSize - 1)] = b;
+	++cache->nBlocks;
+	if (cache->nBlocks > cache->tableSize) {
+		rehashCache(cache);
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef LOCAL_SPANNING_TREE_CACHE_H_
+#define LOCAL_SPANNING_TREE_CACHE_H_
+
+#include "graph.h"
+
+/**
+ * A connected block together with its local spanning trees.
+ *
+ * The block is stored in compressed sparse row format: the neighbors of v are targets[offsets[v]], ...,
+ * targets[offsets[v+1]-1] and edgeLabels[i] is the label of the edge to targets[i]. colors are the vertex
+ * colors after color refinement, see getCachedLocalSpanningTrees(). order is a breadth first order of the
+ * vertices that starts at vertex 0, bfsParent[v] is the parent of v in this order.
+ *
+ * treeEdges stores nTrees spanning trees with n-1 edges each, as pairs of vertex numbers.
+ */
+struct CachedBlock {
+	unsigned int hash;
+	int n;
+	int m;
+	unsigned int* colors;
+	char** vertexLabels;
+	int* offsets;
+	int* targets;
+	char** edgeLabels;
+	int* order;
+	int* bfsParent;
+	int nTrees;
+	int* treeEdges;
+	struct CachedBlock* next;
+};
+
+/**
+ * Stores the local spanning trees of blocks once for all blocks that are isomorphic (respecting vertex and
+ * edge labels) to each other, e.g. for the benzene rings in a database of molecules.
+ *
+ * The cached blocks are kept in a hash table, keyed by the multiset of their vertex colors. Blocks with equal
+ * keys are tested for isomorphism by a backtracking search along the breadth first order of the cached block.
+ * The search gives up after a number of steps that is linear in the size of the block, in which case the
+ * blocks are treated as being different.
+ *
+ * A cache must only be used for one kind of local spanning trees, e.g. for a fixed number of sampled trees
+ * per block. Cached blocks own copies of their labels, hence the cache does not depend on the graphs whose
+ * blocks it contains.
+ */
+struct LocalSpanningTreeCache {
+	struct CachedBlock** table;
+	int tableSize;
+	int nBlocks;
+	long hits;
+	long misses;
+
+	// the block of the last lookup. Its labels are not copied.
+	struct Graph* block;
+	struct CachedBlock current;
+	int vertexCapacity;
+	int slotCapacity;
+
+	// scratch space for color refinement and isomorphism search
+	unsigned int* newColors;
+	unsigned int* sortedColors;
+	unsigned int* edgeLabelHashes;
+	int* mapping;
+	char* used;
+	int* candidates;
+};
+
+struct LocalSpanningTreeCache* createLocalSpanningTreeCache();
+void freeLocalSpanningTreeCache(struct LocalSpanningTreeCache* cache);
+struct ShallowGraph* getCachedLocalSpanningTrees(struct LocalSpanningTreeCache* cache, struct Graph* block, struct ShallowGraphPool* sgp);
+void addLocalSpanningTreesToCache(struct LocalSpanningTreeCache* cache, struct Graph* block, struct ShallowGraph* trees);
+
+#endif
@@ -15,6 +15,7 @@
 #include "importantSubtrees.h"
 #include "localEasySubtreeIsomorphism.h"
 #include "subtreeIsomorphismSampling.h"
+#include "pathSubgraphIsomorphism.h"
 
 #include "lwm_embeddingOperators.h"
 
@@ -106,6 +107,40 @@ struct SubtreeIsoDataStore localEasyOperator(struct SubtreeIsoDataStore data, st
 }
 
 
+static size_t localEasyCubesLimit = 1 << 20;
+
+void setLocalEasyCubesLimit(size_t bytes) {
+	localEasyCubesLimit = bytes;
+}
+
+/**
+ * Iterative version of localEasyOperator(). See there for (in)exactness.
+ *
+ * The characteristics of h are stored in the result and the characteristics of the parent pattern of h, if stored
+ * in data, are reused. If the characteristics of h would take more than localEasyCubesLimit bytes for this graph,
+ * h is checked by localEasyOperator(), instead, and its extensions will be checked from scratch.
+ */
+struct SubtreeIsoDataStore iterativeLocalEasyOperator(struct SubtreeIsoDataStore data, struct Graph* h, double importance, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	struct SpanningtreeTree* sptTree = (struct SpanningtreeTree*)data.postorder;
+	size_t cubesSize = getIterativeCubesSizeForSpanningtreeTree(sptTree, h->n);
+	if (cubesSize > localEasyCubesLimit) {
+		return localEasyOperator(data, h, importance, gp, sgp);
+	}
+
+	struct SubtreeIsoDataStore result = data;
+	result.h = h;
+	result.S = malloc(cubesSize);
+	uint8_t* baseCubes = (data.S != NULL) && (data.h->n == h->n - 1) ? data.S : NULL;
+
+	result.foundIso = iterativeSubtreeCheckForSpanningtreeTree(sptTree, h, baseCubes, result.S, gp);
+
+	// clean up the spanning tree tree, it points to result.S
+	wipeCharacteristicsForLocalEasy(*sptTree);
+
+	return result;
+}
+
+
 /**
  * Non-standard embedding operator for
  * tree pattern h
@@ -146,6 +181,25 @@ struct SubtreeIsoDataStore subtreeAbsimpOperator(struct SubtreeIsoDataStore data
 }
 
 
+/**
+ * Exact embedding operator for
+ * path pattern h
+ * arbitrary graph transaction data
+ *
+ * Requires that only paths are mined, see setMinePathsOnly().
+ */
+struct SubtreeIsoDataStore pathOperator(struct SubtreeIsoDataStore data, struct Graph* h, double importance, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	(void)importance; // unused
+	(void)sgp; // unused
+	(void)gp; // unused
+	struct SubtreeIsoDataStore result = {0};
+	result.g = data.g;
+	result.h = h;
+	result.foundIso = isPathSubgraph(data.g, h);
+	return result;
+}
+
+
 /**
  * Embedding operator for
  * any object h
@@ -185,7 +239,7 @@ struct SubtreeIsoDataStore hopsSimpleOperator(struct SubtreeIsoDataStore data, s
 	result.h = h;
 
 	for (int i=0; i<importance; ++i) {
-		result.foundIso = subtreeIsomorphismSampler(data.g, h);
+		result.foundIso = subtreeIsomorphismSampler(data.g, h, threadRandomNumberGenerator());
 		if (result.foundIso) {
 			break;
 		}
@@ -216,7 +270,7 @@ struct SubtreeIsoDataStore hopsSimplerandomOperator(struct SubtreeIsoDataStore d
 	result.h = h;
 
 	for (int i=0; i<importance; ++i) {
-		result.foundIso = subtreeIsomorphismSamplerWithImageShuffling(data.g, h);
+		result.foundIso = subtreeIsomorphismSamplerWithImageShuffling(data.g, h, threadRandomNumberGenerator());
 		if (result.foundIso) {
 			break;
 		}
@@ -247,7 +301,7 @@ struct SubtreeIsoDataStore hopsSimplematchingOperator(struct SubtreeIsoDataStore
 	result.h = h;
 
 	for (int i=0; i<importance; ++i) {
-		result.foundIso = subtreeIsomorphismSamplerWithProperMatching(data.g, h, gp);
+		result.foundIso = subtreeIsomorphismSamplerWithProperMatching(data.g, h, threadRandomNumberGenerator(), gp);
 		if (result.foundIso) {
 			break;
 		}
@@ -279,7 +333,7 @@ struct SubtreeIsoDataStore hopsOperator(struct SubtreeIsoDataStore data, struct
 	result.h = h;
 
 	for (int i=0; i<importance; ++i) {
-		result.foundIso = subtreeIsomorphismSamplerWithSampledMaximumMatching(data.g, h, gp, 0);
+		result.foundIso = subtreeIsomorphismSamplerWithSampledMaximumMatching(data.g, h, threadRandomNumberGenerator(), gp, 0);
 		if (result.foundIso) {
 			break;
 		}
@@ -321,7 +375,7 @@ struct SubtreeIsoDataStore hopsOperatorEstimate(struct SubtreeIsoDataStore data,
 	int estimate = 0;
 
 	for (int i=0; i<importance; ++i) {
-		estimate += subtreeIsomorphismSamplerWithSampledMaximumMatching(data.g, h, gp, 1);
+		estimate += subtreeIsomorphismSamplerWithSampledMaximumMatching(data.g, h, threadRandomNumberGenerator(), gp, 1);
 		if (estimate < 0) {
 			// int overflow
 			result.foundIso = INT_MAX;
@@ -46,21 +46,7 @@ static void hardCopyGraphLabels(struct Graph* g) {
 
 
 int getDB(struct Graph*** db) {
-	struct Graph* g = NULL;
-	int dbSize = 0;
-	int i = 0;
-
-	while ((g = iterateFile())) {
-		/* make space for storing graphs in array */
-		if (dbSize <= i) {
-			dbSize = dbSize == 0 ? 128 : dbSize * 2;
-			*db = realloc(*db, dbSize * sizeof (struct Graph*));
-		}
-		/* store graph */
-		(*db)[i] = g;
-		++i;
-	}
-	return i;
+	return readGraphDatabase(db, 0);
 }
 
 
@@ -165,7 +151,7 @@ static int getNonisomorphicSpanningTreeSamplesOfDB(struct Graph*** db, int k, st
 			addToSearchTree(searchTree, canonicalStringOfTree(g, sgp), gp, sgp);
 		} else {
 			// sample k spanning trees, canonicalize them and add them in a search tree (to avoid duplicates, i.e. isomorphic spanning trees)
-			sample = runForEachConnectedComponent(&xsampleSpanningTreesUsingWilson, g, k, k, 1, gp, sgp);
+			sample = runForEachConnectedComponent(&xsampleNonisomorphicSpanningTreesUsingWilson, g, k, k, 1, gp, sgp);
 			for (struct ShallowGraph* tree=sample; tree!=NULL; tree=tree->next) {
 				if (tree->m != 0) {
 					struct Graph* tmp = shallowGraphToGraph(tree, gp);
@@ -624,7 +610,7 @@ size_t initFrequentTreeMiningForForestDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -649,7 +635,7 @@ size_t initFrequentTreeMiningForForestDB(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = createSingletonPatternSupportSetsForForestDB(db, postorders, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForForestsDataStructures* x = malloc(sizeof(struct IterativeBfsForForestsDataStructures));
@@ -682,7 +668,7 @@ size_t initGlobalTreeEnumerationForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -705,7 +691,7 @@ size_t initGlobalTreeEnumerationForGraphDB(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = createSingletonPatternSupportSetsForForestDB(db, postorders, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForForestsDataStructures* x = malloc(sizeof(struct IterativeBfsForForestsDataStructures));
@@ -734,7 +720,7 @@ size_t initProbabilisticTreeMiningForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -757,7 +743,7 @@ size_t initProbabilisticTreeMiningForGraphDB(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = createSingletonPatternSupportSetsForForestDB(db, postorders, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForForestsDataStructures* x = malloc(sizeof(struct IterativeBfsForForestsDataStructures));
@@ -794,7 +780,7 @@ size_t initExactLocalEasyForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -806,10 +792,12 @@ size_t initExactLocalEasyForGraphDB(// input
 	struct Graph** db = NULL;
 	size_t nGraphs = getDB(&db);
 	struct SpanningtreeTree* sptTrees = malloc(nGraphs * sizeof(struct SpanningtreeTree));
+	struct LocalSpanningTreeCache* cache = createLocalSpanningTreeCache();
 	for (size_t i=0; i<nGraphs; ++i) {
 		struct BlockTree blockTree = getBlockTreeT(db[i], sgp);
-		sptTrees[i] = getFullSpanningtreeTree(blockTree, gp, sgp);
+		sptTrees[i] = getCachedFullSpanningtreeTree(blockTree, cache, gp, sgp);
 	}
+	freeLocalSpanningTreeCache(cache);
 
 	struct Vertex* frequentVertices;
 	struct Vertex* frequentEdges;
@@ -824,7 +812,7 @@ size_t initExactLocalEasyForGraphDB(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = createSingletonPatternSupportSetsForLocalEasyDB(sptTrees, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForLocalEasyDataStructures* x = malloc(sizeof(struct IterativeBfsForLocalEasyDataStructures));
@@ -843,6 +831,19 @@ size_t initExactLocalEasyForGraphDB(// input
 }
 
 
+static char SHARE_SAMPLED_SPANNING_TREES = 0;
+
+/**
+If shareSampledSpanningTrees is nonzero, initSampledLocalEasyForGraphDB() samples the local spanning trees
+of isomorphic sets of v-rooted components only once for all transaction graphs, if more than one
+local spanning tree is sampled per component. Otherwise, each set of v-rooted components is sampled
+independently.
+*/
+void setShareSampledSpanningTrees(char shareSampledSpanningTrees) {
+	SHARE_SAMPLED_SPANNING_TREES = shareSampledSpanningTrees;
+}
+
+
 /**
  * In this method, we remove duplicate sampled local spanning trees.
  */
@@ -855,7 +856,7 @@ size_t initSampledLocalEasyForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -865,9 +866,16 @@ size_t initSampledLocalEasyForGraphDB(// input
 	struct Graph** db = NULL;
 	size_t nGraphs = getDB(&db);
 	struct SpanningtreeTree* sptTrees = malloc(nGraphs * sizeof(struct SpanningtreeTree));
+	struct RandomNumberGenerator* rng = threadRandomNumberGenerator();
+	/* if requested, isomorphic v-rooted components share their sampled local spanning trees.
+	 * A single local spanning tree is cheaper to sample than to look up. */
+	struct LocalSpanningTreeCache* cache = (!SHARE_SAMPLED_SPANNING_TREES || (int)importance <= 1) ? NULL : createLocalSpanningTreeCache();
 	for (size_t i=0; i<nGraphs; ++i) {
 		struct BlockTree blockTree = getBlockTreeT(db[i], sgp);
-		sptTrees[i] = getSampledSpanningtreeTree(blockTree, (int)importance, 1, gp, sgp);
+		sptTrees[i] = getCachedSampledSpanningtreeTree(blockTree, (int)importance, 1, cache, rng, gp, sgp);
+	}
+	if (cache != NULL) {
+		freeLocalSpanningTreeCache(cache);
 	}
 
 	struct Vertex* frequentVertices;
@@ -883,7 +891,7 @@ size_t initSampledLocalEasyForGraphDB(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = createSingletonPatternSupportSetsForLocalEasyDB(sptTrees, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForLocalEasyDataStructures* x = malloc(sizeof(struct IterativeBfsForLocalEasyDataStructures));
@@ -997,7 +1005,7 @@ size_t initPatternEnumeration(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -1021,7 +1029,7 @@ size_t initPatternEnumeration(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = getSupportSetsOfVerticesForPatternEnumeration(db, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForForestsDataStructures* x = malloc(sizeof(struct IterativeBfsForForestsDataStructures));
@@ -1041,6 +1049,114 @@ size_t initPatternEnumeration(// input
 
 
 
+static struct SupportSet* initPathMiningForVertices(struct Graph** db, size_t nGraphs, struct Graph* h, int patternId) {
+	struct SupportSet* actualSupport = getSupportSet();
+	h->number = patternId;
+	for (size_t i=0; i<nGraphs; ++i) {
+		for (int v=0; v<db[i]->n; ++v) {
+			if (strcmp(db[i]->vertices[v]->label, h->vertices[0]->label) == 0) {
+				struct SubtreeIsoDataStore data = {0};
+				data.g = db[i];
+				data.h = h;
+				data.postorder = NULL;
+				data.foundIso = 1;
+				appendSupportSetData(actualSupport, data);
+				break;
+			}
+		}
+	}
+	return actualSupport;
+}
+
+
+/**
+ * create data structures for levelwise mining of paths for all frequent vertices in the db.
+ * In contrast to getSupportSetsOfVerticesForPatternEnumeration(), the support set of a vertex
+ * contains only the graphs that contain a vertex with its label.
+ */
+static struct SupportSet* getSupportSetsOfVerticesForPathMining(struct Graph** db, int nGraphs, struct Vertex* frequentVertices, struct GraphPool* gp) {
+	// data structures for iterative levelwise search
+	struct SupportSet* vertexSupportSets = NULL;
+	struct SupportSet* vertexSupportSetsTail = NULL;
+
+	int id = 1;
+	for (struct VertexList* e=frequentVertices->neighborhood; e!=NULL; e=e->next) {
+
+		struct Graph* candidate = createGraph(1, gp);
+		candidate->vertices[0]->label = e->label;
+		e->endPoint->lowPoint = id;
+
+		struct SupportSet* vertexSupport = initPathMiningForVertices(db, nGraphs, candidate, id);
+
+		if (vertexSupportSetsTail != NULL) {
+			vertexSupportSetsTail->next = vertexSupport;
+			vertexSupportSetsTail = vertexSupport;
+		} else {
+			vertexSupportSets = vertexSupport;
+			vertexSupportSetsTail = vertexSupport;
+		}
+		++id;
+	}
+	return vertexSupportSets;
+}
+
+
+/**
+ * Initialization for mining frequent paths in arbitrary graph databases. The garbage collector is
+ * garbageCollectPatternEnumeration().
+ */
+size_t initPathMining(// input
+		size_t threshold,
+		double importance,
+		// output
+		struct Vertex** initialFrequentPatterns,
+		struct SupportSet** supportSets,
+		struct ShallowGraph** extensionEdgeList,
+		void** dataStructures,
+		// printing
+		struct SparseFeatureWriter* featureStream,
+		FILE* patternStream,
+		FILE* logStream,
+		// pools
+		struct GraphPool* gp,
+		struct ShallowGraphPool* sgp) {
+
+	(void)importance; // unused
+
+	struct Graph** db = NULL;
+	int nGraphs = getDB(&db);
+
+	struct Vertex* frequentVertices;
+	struct Vertex* frequentEdges;
+	getFrequentVerticesAndEdges(db, nGraphs, threshold, &frequentVertices, &frequentEdges, logStream, gp);
+
+	/* convert frequentEdges to ShallowGraph of extension edges */
+	struct Graph* extensionEdgesVertexStore = NULL;
+	struct ShallowGraph* extensionEdges = edgeSearchTree2ShallowGraph(frequentEdges, &extensionEdgesVertexStore, gp, sgp);
+	dumpSearchTree(gp, frequentEdges);
+
+	// levelwise search for patterns with one vertex:
+	struct SupportSet* frequentVerticesSupportSets = getSupportSetsOfVerticesForPathMining(db, nGraphs, frequentVertices, gp);
+	printStringsInSearchTree(frequentVertices, patternStream, sgp);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+
+	// store pointers for final garbage collection
+	struct IterativeBfsForForestsDataStructures* x = malloc(sizeof(struct IterativeBfsForForestsDataStructures));
+	x->db = db;
+	x->nGraphs = nGraphs;
+	x->extensionEdges = extensionEdges;
+	x->extensionEdgesVertexStore = extensionEdgesVertexStore;
+	x->initialFrequentPatterns = frequentVertices;
+
+	// 'return'
+	*initialFrequentPatterns = frequentVertices;
+	*supportSets = frequentVerticesSupportSets;
+	*extensionEdgeList = extensionEdges;
+	*dataStructures = x;
+	return 1; // returned patterns have 1 vertex
+}
+
+
 void garbageCollectPatternEnumeration(void** y, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	struct IterativeBfsForForestsDataStructures* dataStructures = (struct IterativeBfsForForestsDataStructures*)y;
 
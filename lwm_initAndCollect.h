@@ -41,7 +41,7 @@ size_t initFrequentTreeMiningForForestDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -57,7 +57,7 @@ size_t initProbabilisticTreeMiningForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -73,7 +73,7 @@ size_t initGlobalTreeEnumerationForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -89,13 +89,14 @@ size_t initExactLocalEasyForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
 		struct GraphPool* gp,
 		struct ShallowGraphPool* sgp);
 
+void setShareSampledSpanningTrees(char shareSampledSpanningTrees);
 size_t initSampledLocalEasyForGraphDB(// input
 		size_t threshold,
 		double importance,
@@ -105,7 +106,7 @@ size_t initSampledLocalEasyForGraphDB(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -121,7 +122,23 @@ size_t initPatternEnumeration(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
+		FILE* patternStream,
+		FILE* logStream,
+		// pools
+		struct GraphPool* gp,
+		struct ShallowGraphPool* sgp);
+
+size_t initPathMining(// input
+		size_t threshold,
+		double importance,
+		// output
+		struct Vertex** initialFrequentPatterns,
+		struct SupportSet** supportSets,
+		struct ShallowGraph** extensionEdgeList,
+		void** dataStructures,
+		// printing
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
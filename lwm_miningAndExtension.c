@@ -53,6 +53,17 @@ struct SupportSet* getCandidateSupportSuperSet(struct IntSet* parentIds, struct
 }
 
 
+static char MINE_PATHS_ONLY = 0;
+
+/**
+If minePathsOnly is nonzero, BFSStrategy() extends patterns only on their ends. Hence, it
+outputs only the frequent paths, starting from the frequent vertices.
+*/
+void setMinePathsOnly(char minePathsOnly) {
+	MINE_PATHS_ONLY = minePathsOnly;
+}
+
+
 static void _extendPreviousLevel(// input
 		struct SupportSet* previousLevelSupportLists,
 		struct Vertex* previousLevelSearchTree,
@@ -89,10 +100,12 @@ static void _extendPreviousLevel(// input
 	for (struct SupportSet* frequentPatternSupportList=previousLevelSupportLists; frequentPatternSupportList!=NULL; frequentPatternSupportList=frequentPatternSupportList->next) {
 		struct Graph* frequentPattern = frequentPatternSupportList->first->data.h;
 
-		// extend frequent pattern
-		struct Graph* listOfExtensions = extendPatternOnOuterShells(frequentPattern, extensionEdges, gp, sgp);
+		// extend frequent pattern once per orbit of its automorphism group (isomorphic extensions may remain)
+		struct Graph* listOfExtensions = MINE_PATHS_ONLY ?
+				extendPathOnEnds(frequentPattern, extensionEdges, gp, sgp) :
+				extendPatternOnOrbitRepresentatives(frequentPattern, extensionEdges, gp, sgp);
+//		struct Graph* listOfExtensions = extendPatternOnOuterShells(frequentPattern, extensionEdges, gp, sgp);
 //		struct Graph* listOfExtensions = extendPatternOnLeaves(frequentPattern, extensionEdges, gp);
-//		struct Graph* listOfExtensions = extendPatternByLargerEdgesTMP(frequentPattern, extensionEdges, gp);
 
 		for (struct Graph* extension=popGraph(&listOfExtensions); extension!=NULL; extension=popGraph(&listOfExtensions)) {
 			// count number of generated extensions
@@ -261,7 +274,7 @@ void BFSStrategy(size_t startPatternSize,
 					  // embedding operator function pointer,
 					  struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*),
 					  double importance,
-					  FILE* featureStream,
+					  struct SparseFeatureWriter* featureStream,
 					  FILE* patternStream,
 					  FILE* logStream,
 					  struct GraphPool* gp,
@@ -282,8 +295,8 @@ void BFSStrategy(size_t startPatternSize,
 
 		printStringsInSearchTree(currentLevelSearchTree, patternStream, sgp);
 		fflush(patternStream);
-		printSupportSetsSparse(currentLevelSupportSets, featureStream);
-		fflush(featureStream);
+		writeSupportSetsSparse(currentLevelSupportSets, featureStream);
+		flushSparseFeatureWriter(featureStream);
 
 		// garbage collection:
 		// what is now all previousLevel... data structures will not be used at all in the next iteration
@@ -6,6 +6,8 @@
 #include "intSet.h"
 #include "supportSet.h"
 
+void setMinePathsOnly(char minePathsOnly);
+
 struct SupportSet* getCandidateSupportSuperSet(struct IntSet* parentIds, struct SupportSet* previousLevelSupportLists, int parentIdToKeep);
 
 void BFSStrategy(size_t startPatternSize,
@@ -17,7 +19,7 @@ void BFSStrategy(size_t startPatternSize,
 					  // embedding operator function pointer,
 					  struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*),
 					  double importance,
-					  FILE* featureStream,
+					  struct SparseFeatureWriter* featureStream,
 					  FILE* patternStream,
 					  FILE* logStream,
 					  struct GraphPool* gp,
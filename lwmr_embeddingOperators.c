@@ -45,6 +45,21 @@ struct SubtreeIsoDataStore rootedSubtreeComputationOperator(struct SubtreeIsoDat
 
 
 
+/**
+ * Exact embedding Operator for
+ * tree pattern h
+ * forest transaction data
+ *
+ * The algorithm extends the rooted embeddings of a direct predecessor of h, if data contains them.
+ */
+struct SubtreeIsoDataStore rootedSubtreeIterativeOperator(struct SubtreeIsoDataStore data, struct Graph* h, double importance, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	(void)sgp; // unused
+	(void)importance; // unused
+	return iterativeRootedSubtreeCheck(data, h, gp);
+}
+
+
+
 /**
  * Randomized embedding operator for
  * tree pattern h
@@ -67,7 +82,7 @@ struct SubtreeIsoDataStore rootedHopsOperator(struct SubtreeIsoDataStore data, s
 	result.h = h;
 
 	for (int i=0; i<importance; ++i) {
-		result.foundIso = subtreeIsomorphismSamplerWithSampledMaximumMatching(data.g, h, gp, 0);
+		result.foundIso = subtreeIsomorphismSamplerWithSampledMaximumMatching(data.g, h, threadRandomNumberGenerator(), gp, 0);
 		if (result.foundIso) {
 			break;
 		}
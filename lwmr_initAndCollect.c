@@ -28,21 +28,7 @@
  * Load the graph database as directed graphs!
  */
 int getDirectedDB(struct Graph*** db) {
-	struct Graph* g = NULL;
-	int dbSize = 0;
-	int i = 0;
-
-	while ((g = iterateFileDirected())) {
-		/* make space for storing graphs in array */
-		if (dbSize <= i) {
-			dbSize = dbSize == 0 ? 128 : dbSize * 2;
-			*db = realloc(*db, dbSize * sizeof (struct Graph*));
-		}
-		/* store graph */
-		(*db)[i] = g;
-		++i;
-	}
-	return i;
+	return readGraphDatabase(db, 1);
 }
 
 
@@ -217,7 +203,7 @@ size_t initDirectedPatternEnumeration(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -241,7 +227,7 @@ size_t initDirectedPatternEnumeration(// input
 	// levelwise search for patterns with one vertex:
 	struct SupportSet* frequentVerticesSupportSets = getSupportSetsOfVerticesForPatternEnumeration(db, nGraphs, frequentVertices, gp, sgp);
 	printStringsInSearchTree(frequentVertices, patternStream, sgp);
-	printSupportSetsSparse(frequentVerticesSupportSets, featureStream);
+	writeSupportSetsSparse(frequentVerticesSupportSets, featureStream);
 
 	// store pointers for final garbage collection
 	struct IterativeBfsForForestsDataStructures* x = malloc(sizeof(struct IterativeBfsForForestsDataStructures));
@@ -22,7 +22,7 @@ size_t initDirectedPatternEnumeration(// input
 		struct ShallowGraph** extensionEdgeList,
 		void** dataStructures,
 		// printing
-		FILE* featureStream,
+		struct SparseFeatureWriter* featureStream,
 		FILE* patternStream,
 		FILE* logStream,
 		// pools
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <limits.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "graph.h"
 #include "searchTree.h"
@@ -236,15 +237,12 @@ static struct SupportSet* _getNextLevelRooted(// input
 		}
 		fflush(stdout);
 	} else {
-		// all candidates share the same candidate support set. dump it and free the headers.
-		if (currentLevelCandidateSupportSets) {
-			candidateSupport = currentLevelCandidateSupportSets->next;
-			dumpSupportSetCopy(currentLevelCandidateSupportSets);
-			while(candidateSupport) {
-				struct SupportSet* tmp = candidateSupport->next;
-				free(candidateSupport);
-				candidateSupport = tmp;
-			}
+		// all candidates share the support set of their parent, which belongs to the caller. free the headers.
+		candidateSupport = currentLevelCandidateSupportSets;
+		while(candidateSupport) {
+			struct SupportSet* tmp = candidateSupport->next;
+			free(candidateSupport);
+			candidateSupport = tmp;
 		}
 	}
 
@@ -282,7 +280,7 @@ void BFSStrategyRooted(size_t startPatternSize,
 					  // embedding operator function pointer,
 					  struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*),
 					  double importance,
-					  FILE* featureStream,
+					  struct SparseFeatureWriter* featureStream,
 					  FILE* patternStream,
 					  FILE* logStream,
 					  struct GraphPool* gp,
@@ -305,8 +303,8 @@ void BFSStrategyRooted(size_t startPatternSize,
 
 		printStringsInSearchTree(currentLevelSearchTree, patternStream, sgp);
 		fflush(patternStream);
-		printSupportSetsSparse(currentLevelSupportSets, featureStream);
-		fflush(featureStream);
+		writeSupportSetsSparse(currentLevelSupportSets, featureStream);
+		flushSparseFeatureWriter(featureStream);
 
 		// garbage collection:
 		// what is now all previousLevel... data structures will not be used at all in the next iteration
@@ -335,37 +333,166 @@ void BFSStrategyRooted(size_t startPatternSize,
 }
 
 
-void DFSStrategyRooted(size_t startPatternSize,
-					  size_t maxPatternSize,
-		              size_t threshold,
-					  struct Vertex* initialFrequentPatterns,
-					  struct SupportSet* supportSets,
-					  struct ShallowGraph* extensionEdges,
-					  // embedding operator function pointer,
-					  struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*),
-					  double importance,
-					  FILE* featureStream,
-					  FILE* patternStream,
-					  FILE* logStream,
-					  struct GraphPool* gp,
-					  struct ShallowGraphPool* sgp) {
+static int ROOTED_DFS_THREADS = 1;
+
+/**
+Set the number of threads that DFSStrategyRooted() uses. Each thread processes whole subtrees of the
+enumeration tree below the patterns that the mining starts with.
+*/
+void setRootedMiningThreads(int nThreads) {
+	ROOTED_DFS_THREADS = nThreads;
+}
+
+
+struct RootedDFSParameters {
+	size_t startPatternSize;
+	size_t maxPatternSize;
+	size_t threshold;
+	struct ShallowGraph* extensionEdges;
+	struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*);
+	double importance;
+};
+
+/**
+ * The output of the extension of one pattern. Ids of patterns that are larger than startPatternSize are
+ * local to the task, i.e. they start at 1 for each task. features stores, for each frequent extension,
+ * its id, the size of its support set, and the numbers of the graphs in its support set.
+ */
+struct RootedDFSStep {
+	int patternId;
+	size_t patternSize;
+	struct Vertex* frequentPatterns;
+	int* features;
+	size_t nFeatures;
+	char* log;
+	size_t logLength;
+};
+
+/**
+ * The subtree of the enumeration tree below one pattern of startPatternSize. As extensions never change
+ * the root of a pattern, these subtrees are disjoint and can be mined independently of each other.
+ * The search trees of the steps belong to gp.
+ */
+struct RootedDFSTask {
+	struct SupportSet* supportSet;
+	int nPatterns;
+	struct RootedDFSStep* steps;
+	int nSteps;
+	int stepCapacity;
+	struct GraphPool* gp;
+	struct ShallowGraphPool* sgp;
+};
+
+struct RootedDFSWorker {
+	struct ListPool* lp;
+	struct VertexPool* vp;
+	struct ShallowGraphPool* sgp;
+	struct GraphPool* gp;
+
+	struct RootedDFSParameters* parameters;
+	struct RootedDFSTask* tasks;
+	int nTasks;
+	int* next;
+	pthread_mutex_t* lock;
+};
+
+/**
+ * Where to write the steps of a task. idOffset is the number of patterns that were output before the task.
+ */
+struct RootedDFSOutput {
+	int idOffset;
+	struct SparseFeatureWriter* featureStream;
+	FILE* patternStream;
+	FILE* logStream;
+};
+
+
+static void addRootedDFSStep(struct RootedDFSTask* task, struct Graph* pattern, struct Vertex* frequentPatterns, struct SupportSet* supportSets, char* log, size_t logLength) {
+	if (task->nSteps == task->stepCapacity) {
+		task->stepCapacity = (task->stepCapacity == 0) ? 16 : 2 * task->stepCapacity;
+		task->steps = realloc(task->steps, task->stepCapacity * sizeof(struct RootedDFSStep));
+	}
+	struct RootedDFSStep* step = &task->steps[task->nSteps];
+	++task->nSteps;
+
+	step->patternId = pattern->number;
+	step->patternSize = pattern->n;
+	step->frequentPatterns = frequentPatterns;
+	step->log = log;
+	step->logLength = logLength;
+
+	step->nFeatures = 0;
+	for (struct SupportSet* l=supportSets; l!=NULL; l=l->next) {
+		step->nFeatures += 2 + l->size;
+	}
+	step->features = malloc(step->nFeatures * sizeof(int));
+	size_t i = 0;
+	for (struct SupportSet* l=supportSets; l!=NULL; l=l->next) {
+		step->features[i++] = l->first->data.h->number;
+		step->features[i++] = l->size;
+		for (struct SupportSetElement* e=l->first; e!=NULL; e=e->next) {
+			step->features[i++] = e->data.g->number;
+		}
+	}
+}
+
+
+/**
+ * Write the steps of task to out, in the same way as a sequential depth first search would have, and dump them.
+ */
+static void writeRootedDFSSteps(struct RootedDFSTask* task, size_t startPatternSize, struct RootedDFSOutput* out) {
+	for (int s=0; s<task->nSteps; ++s) {
+		struct RootedDFSStep* step = &task->steps[s];
+		int patternId = (step->patternSize > startPatternSize) ? step->patternId + out->idOffset : step->patternId;
+
+		fprintf(out->logStream, "Processing pattern %i with %zu vertices:\n", patternId, step->patternSize);
+		fwrite(step->log, 1, step->logLength, out->logStream);
+		fflush(out->logStream);
+		free(step->log);
+
+		offsetSearchTreeIds(step->frequentPatterns, out->idOffset);
+		printStringsInSearchTree(step->frequentPatterns, out->patternStream, task->sgp);
+		fflush(out->patternStream);
+		dumpSearchTree(task->gp, step->frequentPatterns);
+
+		for (size_t i=0; i<step->nFeatures; i+=2+step->features[i+1]) {
+			beginSparseRow(out->featureStream, step->features[i] + out->idOffset);
+			for (int j=0; j<step->features[i+1]; ++j) {
+				addSparseEntry(out->featureStream, step->features[i+2+j], 1);
+			}
+			endSparseRow(out->featureStream);
+		}
+		flushSparseFeatureWriter(out->featureStream);
+		free(step->features);
+	}
+	task->nSteps = 0;
+}
+
 
+/**
+ * Mine the subtree of the enumeration tree below the pattern of task depth first. The embedding data of
+ * the patterns on the current path of the enumeration tree and of their siblings is kept on a stack, such
+ * that embedding operators can extend the embeddings of the parent of a pattern.
+ *
+ * If out is not NULL, each step is written to out immediately. Otherwise, the steps are kept in task.
+ * The support set and pattern of task are not dumped, as they belong to the caller.
+ */
+static void mineRootedSubtree(struct RootedDFSTask* task, struct RootedDFSParameters* parameters, struct RootedDFSOutput* out, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	const char dontUseApriori = 0;
+	const size_t maxPatternSize = parameters->maxPatternSize;
 
-	// init an array of searchtrees, one for each level
-	// this should speed up the alg but will increase memory consumption in the long run
+	task->gp = gp;
+	task->sgp = sgp;
+	task->nPatterns = 0;
+
+	// init an array of searchtrees, one for each level, to filter patterns that were already enumerated
 	struct Vertex** levelSearchTrees = malloc(maxPatternSize * sizeof(struct Vertex*));
 	for (size_t i=0; i<maxPatternSize; ++i) {
-		if (i != startPatternSize - 1) {
-			levelSearchTrees[i] = getVertex(gp->vertexPool);
-		} else {
-			levelSearchTrees[i] = initialFrequentPatterns;
-		}
+		levelSearchTrees[i] = getVertex(gp->vertexPool);
 	}
 
 	// the frontier of candidate patterns
-	struct SupportSet* candidateSupportSetStack = supportSets;
-	size_t patternID = initialFrequentPatterns->lowPoint;
+	struct SupportSet* candidateSupportSetStack = task->supportSet;
 
 	while (candidateSupportSetStack) {
 
@@ -376,51 +503,168 @@ void DFSStrategyRooted(size_t startPatternSize,
 
 		// we extend all patterns that have at most maxPatternSize - 1 vertices
 		if (currentPatternSize < maxPatternSize) {
-
-			// logging
-			fprintf(logStream, "Processing pattern %i with %zu vertices:\n", currentPattern->number, currentPatternSize);
-			fflush(logStream);
+			char* log = NULL;
+			size_t logLength = 0;
+			FILE* logStream = open_memstream(&log, &logLength);
 
 			// extend current pattern and check frequencies
 			struct Vertex* newFrequentPatternSearchTree = getVertex(gp->vertexPool);
-			offsetSearchTreeIds(newFrequentPatternSearchTree, patternID);
-			// TODO add infrequent patterns to some other search tree and output.
-			struct SupportSet *newSupportSets = _getNextLevelRooted(currentPatternSupport, levelSearchTrees[currentPatternSize - 1], levelSearchTrees[currentPatternSize], threshold, extensionEdges, embeddingOperator, importance, dontUseApriori, &newFrequentPatternSearchTree, logStream, gp, sgp);
-			patternID = newFrequentPatternSearchTree->lowPoint;
-
-			// print frequent patterns
-			printStringsInSearchTree(newFrequentPatternSearchTree, patternStream, sgp);
-			fflush(patternStream);
-			printSupportSetsSparse(newSupportSets, featureStream);
-			fflush(featureStream);
+			offsetSearchTreeIds(newFrequentPatternSearchTree, task->nPatterns);
+			struct SupportSet *newSupportSets = _getNextLevelRooted(currentPatternSupport, levelSearchTrees[currentPatternSize - 1], levelSearchTrees[currentPatternSize], parameters->threshold, parameters->extensionEdges, parameters->embeddingOperator, parameters->importance, dontUseApriori, &newFrequentPatternSearchTree, logStream, gp, sgp);
+			task->nPatterns = newFrequentPatternSearchTree->lowPoint;
+			fclose(logStream);
 
 			// add patterns to frequent pattern list and support sets to frontier
-			mergeSearchTrees(levelSearchTrees[currentPatternSize], 
-							 newFrequentPatternSearchTree, 
-							 1, 
-							 NULL, // &searchTreeHelper, don't need results here 
+			mergeSearchTrees(levelSearchTrees[currentPatternSize],
+							 newFrequentPatternSearchTree,
+							 1,
+							 NULL, // &searchTreeHelper, don't need results here
 							 0, // &searchTreePosition, don't need results here
-							 levelSearchTrees[currentPatternSize], 
-							 0, 
+							 levelSearchTrees[currentPatternSize],
+							 0,
 							 gp);
-			dumpSearchTree(gp, newFrequentPatternSearchTree);
+			addRootedDFSStep(task, currentPattern, newFrequentPatternSearchTree, newSupportSets, log, logLength);
+			if (out) {
+				writeRootedDFSSteps(task, parameters->startPatternSize, out);
+			}
 			candidateSupportSetStack = appendSupportSets(newSupportSets, candidateSupportSetStack);
-		} else {
-			// dump support of the pattern, as this is not done by the extension
-			dumpSupportSetCopy(currentPatternSupport);
-			dumpGraph(gp, currentPattern);
 		}
-		if (currentPatternSize == 1) {
-			// dumpSupportSet(currentPatternSupport);
-			dumpGraph(gp, currentPattern);
+
+		// the extensions have their own embedding data, hence we do not need the data of the current pattern any more
+		if (currentPatternSize > parameters->startPatternSize) {
+			dumpSupportSetWithPattern(currentPatternSupport, gp);
 		}
 	}
 
-	// garbage collection: TODO
-	for (size_t i = 0; i < maxPatternSize; ++i) {
-		if (i != startPatternSize - 1) {
-			dumpSearchTree(gp, levelSearchTrees[i]);
-		}
+	for (size_t i=0; i<maxPatternSize; ++i) {
+		dumpSearchTree(gp, levelSearchTrees[i]);
 	}
 	free(levelSearchTrees);
 }
+
+
+/**
+ * Mine the tasks that were not processed by another worker yet, until all tasks are processed.
+ */
+static void* rootedDFSWorkerRun(void* arg) {
+	struct RootedDFSWorker* w = arg;
+	while (1) {
+		pthread_mutex_lock(w->lock);
+		int i = *w->next;
+		++*w->next;
+		pthread_mutex_unlock(w->lock);
+
+		if (i >= w->nTasks) {
+			break;
+		}
+		mineRootedSubtree(&w->tasks[i], w->parameters, NULL, w->gp, w->sgp);
+	}
+	return NULL;
+}
+
+
+/**
+ * Mine the tasks with nThreads threads, each with its own object pools, and write their results in order.
+ * Hence, ids and output do not depend on the number of threads.
+ */
+static void mineRootedSubtreesInParallel(struct RootedDFSTask* tasks, int nTasks, int nThreads, struct RootedDFSParameters* parameters, struct RootedDFSOutput* out) {
+	struct RootedDFSWorker* workers = malloc(nThreads * sizeof(struct RootedDFSWorker));
+	pthread_t* threads = malloc(nThreads * sizeof(pthread_t));
+	char* started = malloc(nThreads * sizeof(char));
+	pthread_mutex_t lock;
+	pthread_mutex_init(&lock, NULL);
+	int next = 0;
+
+	for (int t=0; t<nThreads; ++t) {
+		workers[t].lp = createListPool(10000);
+		workers[t].vp = createVertexPool(10000);
+		workers[t].sgp = createShallowGraphPool(1000, workers[t].lp);
+		workers[t].gp = createGraphPool(100, workers[t].vp, workers[t].lp);
+		workers[t].parameters = parameters;
+		workers[t].tasks = tasks;
+		workers[t].nTasks = nTasks;
+		workers[t].next = &next;
+		workers[t].lock = &lock;
+	}
+
+	for (int t=0; t<nThreads; ++t) {
+		started[t] = pthread_create(&threads[t], NULL, &rootedDFSWorkerRun, &workers[t]) == 0;
+	}
+	for (int t=0; t<nThreads; ++t) {
+		if (started[t]) {
+			pthread_join(threads[t], NULL);
+		}
+	}
+	/* if no thread could be started, process the remaining tasks in the current thread */
+	rootedDFSWorkerRun(&workers[0]);
+
+	for (int i=0; i<nTasks; ++i) {
+		writeRootedDFSSteps(&tasks[i], parameters->startPatternSize, out);
+		out->idOffset += tasks[i].nPatterns;
+	}
+
+	for (int t=0; t<nThreads; ++t) {
+		freeGraphPool(workers[t].gp);
+		freeShallowGraphPool(workers[t].sgp);
+		freeListPool(workers[t].lp);
+		freeVertexPool(workers[t].vp);
+	}
+	pthread_mutex_destroy(&lock);
+	free(started);
+	free(threads);
+	free(workers);
+}
+
+
+/**
+ * Depth first mining of frequent rooted patterns.
+ *
+ * The enumeration tree is split into the subtrees below the patterns in supportSets, which are mined one
+ * after another or, see setRootedMiningThreads(), in parallel.
+ */
+void DFSStrategyRooted(size_t startPatternSize,
+					  size_t maxPatternSize,
+		              size_t threshold,
+					  struct Vertex* initialFrequentPatterns,
+					  struct SupportSet* supportSets,
+					  struct ShallowGraph* extensionEdges,
+					  // embedding operator function pointer,
+					  struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph*, double, struct GraphPool*, struct ShallowGraphPool*),
+					  double importance,
+					  struct SparseFeatureWriter* featureStream,
+					  FILE* patternStream,
+					  FILE* logStream,
+					  struct GraphPool* gp,
+					  struct ShallowGraphPool* sgp) {
+
+	struct RootedDFSParameters parameters = { startPatternSize, maxPatternSize, threshold, extensionEdges, embeddingOperator, importance };
+	struct RootedDFSOutput out = { initialFrequentPatterns->lowPoint, featureStream, patternStream, logStream };
+
+	int nTasks = 0;
+	for (struct SupportSet* s=supportSets; s!=NULL; s=s->next) {
+		++nTasks;
+	}
+	struct RootedDFSTask* tasks = calloc(nTasks, sizeof(struct RootedDFSTask));
+	int i = 0;
+	while (supportSets) {
+		tasks[i].supportSet = popSupportSet(&supportSets);
+		++i;
+	}
+
+	int nThreads = (ROOTED_DFS_THREADS < nTasks) ? ROOTED_DFS_THREADS : nTasks;
+	if (nThreads > 1) {
+		mineRootedSubtreesInParallel(tasks, nTasks, nThreads, &parameters, &out);
+	} else {
+		for (i=0; i<nTasks; ++i) {
+			mineRootedSubtree(&tasks[i], &parameters, &out, gp, sgp);
+			out.idOffset += tasks[i].nPatterns;
+		}
+	}
+
+	// garbage collection
+	for (i=0; i<nTasks; ++i) {
+		dumpSupportSetWithPattern(tasks[i].supportSet, gp);
+		free(tasks[i].steps);
+	}
+	free(tasks);
+}
@@ -7,6 +7,8 @@
 #include "intSet.h"
 #include "supportSet.h"
 
+void setRootedMiningThreads(int nThreads);
+
 void BFSStrategyRooted(size_t startPatternSize,
 					   size_t maxPatternSize,
 					   size_t threshold,
@@ -16,7 +18,7 @@ void BFSStrategyRooted(size_t startPatternSize,
 					   // embedding operator function pointer,
 					   struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph *, double, struct GraphPool *, struct ShallowGraphPool *),
 					   double importance,
-					   FILE *featureStream,
+					   struct SparseFeatureWriter* featureStream,
 					   FILE *patternStream,
 					   FILE *logStream,
 					   struct GraphPool *gp,
@@ -31,7 +33,7 @@ void BFSStrategyRooted(size_t startPatternSize,
 						   // embedding operator function pointer,
 						   struct SubtreeIsoDataStore (*embeddingOperator)(struct SubtreeIsoDataStore, struct Graph *, double, struct GraphPool *, struct ShallowGraphPool *),
 						   double importance,
-						   FILE *featureStream,
+						   struct SparseFeatureWriter* featureStream,
 						   FILE *patternStream,
 						   FILE *logStream,
 						   struct GraphPool *gp,
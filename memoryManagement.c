@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include "graph.h"
 #include "memoryManagement.h"
+#include "listComponents.h"
 
 const int MEM_DEBUG = 0;
 
@@ -340,6 +341,48 @@ void freeGraphPool(struct GraphPool *p) {
 }
 
 
+/* append the unused elements of src to the unused list of dst and free the struct src, see absorbGraphPool() */
+static void absorbListPool(struct ListPool* dst, struct ListPool* src) {
+	if (src->unused) {
+		for (src->tmp=src->unused; src->tmp->next; src->tmp=src->tmp->next);
+		src->tmp->next = dst->unused;
+		dst->unused = src->unused;
+	}
+	free(src);
+}
+
+
+/* append the unused elements of src to the unused list of dst and free the struct src, see absorbGraphPool() */
+static void absorbVertexPool(struct VertexPool* dst, struct VertexPool* src) {
+	if (src->unused) {
+		for (src->tmp=src->unused; src->tmp->next; src->tmp=src->tmp->next);
+		src->tmp->next = dst->unused;
+		dst->unused = src->unused;
+	}
+	free(src);
+}
+
+
+/**
+Move all unused elements of src and of its vertex and list pools to the respective pools of dst and
+free src, its vertex pool, and its list pool. Elements of src that are currently in use can be dumped
+into dst afterwards.
+
+This only works if the pools of src were created with initNumberOfElements = 1, as then each element
+is freed individually by the free functions of dst.
+*/
+void absorbGraphPool(struct GraphPool* dst, struct GraphPool* src) {
+	absorbListPool(dst->listPool, src->listPool);
+	absorbVertexPool(dst->vertexPool, src->vertexPool);
+	if (src->unused) {
+		for (src->tmp=src->unused; src->tmp->next; src->tmp=src->tmp->next);
+		src->tmp->next = dst->unused;
+		dst->unused = src->unused;
+	}
+	free(src);
+}
+
+
 /**
  * Get a graph from the specified GraphPool
  */
@@ -374,6 +417,7 @@ void wipeGraph(struct Graph* g) {
 	g->activity = 0;
 	g->vertices = NULL;
 	g->next = NULL;
+	g->blocks = NULL;
 }
 
 
@@ -384,6 +428,7 @@ vertices array of g and g itself
 void dumpGraph(struct GraphPool* p, struct Graph *g) {
 	struct VertexList *tmp;
 	int i;
+	invalidateBlockDecomposition(g);
 	/* dump content */
 	if (g->vertices) {
 		for (i=0; i<g->n; ++i) {
@@ -27,6 +27,7 @@ void dumpShallowGraphCycle(struct ShallowGraphPool *p, struct ShallowGraph* g);
 
 struct GraphPool* createGraphPool(unsigned int initNumberOfElements, struct VertexPool* vp, struct ListPool* lp);
 void freeGraphPool(struct GraphPool* p);
+void absorbGraphPool(struct GraphPool* dst, struct GraphPool* src);
 struct Graph* getGraph(struct GraphPool* p);
 void wipeGraph(struct Graph* g);
 void dumpGraph(struct GraphPool* p, struct Graph *g);
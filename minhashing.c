@@ -25,10 +25,10 @@
  * Implementing Fisher–Yates shuffle
  * from http://stackoverflow.com/questions/1519736/random-shuffling-of-an-array
  */
-static void shuffleArray(int* array, int arraySize) {
+static void shuffleArray(int* array, int arraySize, struct RandomNumberGenerator* rng) {
 	for (int i = arraySize - 1; i > 0; i--)
 	{
-		int index = rand() % (i + 1);
+		int index = randomIntBelow(rng, i + 1);
 		// Simple swap
 		int a = array[index];
 		array[index] = array[i];
@@ -36,14 +36,14 @@ static void shuffleArray(int* array, int arraySize) {
 	}
 }
 
-/** Return a random permutation of the numbers from 1 to n */
-int* getRandomPermutation(int n) {
+/** Return a random permutation of the numbers from 1 to n, drawn from rng */
+int* getRandomPermutation(int n, struct RandomNumberGenerator* rng) {
 	int* permutation = malloc(n * sizeof(int));
 	if (permutation) {
 		for (int i=0; i<n; ++i) {
 			permutation[i] = i+1;
 		}
-		shuffleArray(permutation, n);
+		shuffleArray(permutation, n, rng);
 	} else {
 		fprintf(stderr, "Error allocating memory for permutation\n");
 	}
@@ -631,7 +631,7 @@ struct IntSet* bfsEmbeddingForLocalEasy(struct Graph* g, struct EvaluationPlan p
 		e->endPoint->d = 1;
 	}
 
-	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(getBlockTreeT(g, sgp), nLocalTrees, 1, gp, sgp);
+	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(getBlockTreeT(g, sgp), nLocalTrees, 1, threadRandomNumberGenerator(), gp, sgp);
 
 	for (struct Vertex* v=popFromVertexQueue(border, sgp); v!=NULL; v=popFromVertexQueue(border, sgp)) {
 		v->d = 0;
@@ -811,7 +811,7 @@ int* fullEmbeddingProjectionApproximationLocalEasy(struct Graph* g, struct Evalu
 	cleanEvaluationPlan(p);
 
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
-	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(blockTree, nLocalTrees, 1, gp, sgp);
+	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(blockTree, nLocalTrees, 1, threadRandomNumberGenerator(), gp, sgp);
 
 	for (int i=0; i<projectionSize; ++i) {
 		// if we don't know the value we need to compute it.
@@ -909,7 +909,7 @@ int* randomProjectionEmbeddingLocalEasy(struct Graph* g, struct EvaluationPlan p
 	cleanEvaluationPlan(p);
 
 	struct BlockTree blockTree = getBlockTreeT(g, sgp);
-	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(blockTree, nLocalTrees, 1, gp, sgp);
+	struct SpanningtreeTree sptTree = getSampledSpanningtreeTree(blockTree, nLocalTrees, 1, threadRandomNumberGenerator(), gp, sgp);
 
 	// alloc output array
 	int* approximateEmbedding = malloc((p.poset->n - 1) * sizeof(int));
@@ -10,6 +10,7 @@
 
 
 #include "graph.h"
+#include "randomNumberGenerator.h"
 
 struct PosPair {
 	size_t level;
@@ -26,7 +27,7 @@ struct EvaluationPlan {
 };
 
 // PERMUTATIONS
-int* getRandomPermutation(int n);
+int* getRandomPermutation(int n, struct RandomNumberGenerator* rng);
 int posetPermutationMark(int* permutation, size_t n, struct Graph* F);
 int* posetPermutationShrink(int* permutation, size_t n, size_t shrunkSize);
 
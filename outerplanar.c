@@ -44,16 +44,7 @@ char isCactus(struct Graph* g, struct ShallowGraphPool* sgp) {
 	}
 
 	if (isConnected(g)) {
-		struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-		struct ShallowGraph* comp;
-		int compNumber = 0;
-		for (comp = biconnectedComponents; comp!=NULL; comp=comp->next) {
-			if (comp->m > 1) {
-				++compNumber;
-			}			
-		}
-		/* cleanup */
-		dumpShallowGraphCycle(sgp, biconnectedComponents);
+		int compNumber = getNumberOfBlocks(g, sgp);
 		return g->m - compNumber == g->n - 1 ? 1 : 0;
 	} else {
 		return 0;
@@ -69,19 +60,21 @@ An outerplanar graph is a graph that can be drawn in the plane such that
 A graph is outerplanar if and only if each of its biconnected components is outerplanar.
 */ 
 char isOuterplanarGraph(struct Graph* g, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
-	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
-	struct ShallowGraph* comp;
+	(void)sgp; // unused
+	(void)gp; // unused
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	struct OuterplanarBlockTest* t = createOuterplanarBlockTest();
 	char isOp = 1;
-	for (comp = biconnectedComponents; comp!=NULL; comp=comp->next) {
-		if (comp->m > 1) {
-			isOp = isOuterplanarBlockShallow(comp, sgp, gp);
+	for (int b=0; b<d->nBlocks; ++b) {
+		int m = d->blockStart[b+1] - d->blockStart[b];
+		if (m > 1) {
+			isOp = getOuterplanarBlockStructure(t, d->edges + d->blockStart[b], m);
 			if (isOp == 0) {
 				break;
 			}
-		}			
+		}
 	}
-	/* cleanup */
-	dumpShallowGraphCycle(sgp, biconnectedComponents);
+	freeOuterplanarBlockTest(t);
 	return isOp;
 }
 
@@ -352,13 +345,359 @@ char isOuterplanarBlock(struct Graph* g, struct ShallowGraphPool* sgp) {
  * Does not change original.
  */
 char isOuterplanarBlockShallow(struct ShallowGraph* original, struct ShallowGraphPool* sgp, struct GraphPool* gp) {
-	struct Graph* g = shallowGraphToGraph(original, gp);
-	char isOP = isOuterplanarBlock(g, sgp);
-	dumpGraph(gp, g);
+	(void)sgp; // unused
+	(void)gp; // unused
+	struct OuterplanarBlockTest* t = createOuterplanarBlockTest();
+	char isOP = getOuterplanarBlockStructureShallow(t, original);
+	freeOuterplanarBlockTest(t);
 	return isOP;
 }
 
 
+/******************************* array based outerplanarity test *********************************************/
+
+
+/**
+ * Create an empty workspace for getOuterplanarBlockStructure(). The arrays grow on demand
+ * and are reused by subsequent calls.
+ */
+struct OuterplanarBlockTest* createOuterplanarBlockTest() {
+	return calloc(1, sizeof(struct OuterplanarBlockTest));
+}
+
+
+void freeOuterplanarBlockTest(struct OuterplanarBlockTest* t) {
+	if (t) {
+		free(t->vertices);
+		free(t->cycle);
+		free(t->cycleEdges);
+		free(t->diagonals);
+		free(t->diagonalEdges);
+		free(t->input);
+		free(t->head);
+		free(t->degree);
+		free(t->queue);
+		free(t->queued);
+		free(t->mark);
+		free(t->cycleNeighbors);
+		free(t->arcNext);
+		free(t->arcPrev);
+		free(t->arcTarget);
+		free(t->pairCount);
+		free(t->removedAt);
+		free(t->pairedAt);
+		free(t);
+	}
+}
+
+
+static void reserveOuterplanarBlockTest(struct OuterplanarBlockTest* t, int n, int m) {
+	if (n > t->vertexCapacity) {
+		t->vertexCapacity = 2 * n;
+		t->vertices = realloc(t->vertices, t->vertexCapacity * sizeof(struct Vertex*));
+		t->cycle = realloc(t->cycle, t->vertexCapacity * sizeof(int));
+		t->cycleEdges = realloc(t->cycleEdges, t->vertexCapacity * sizeof(struct VertexList*));
+		t->head = realloc(t->head, t->vertexCapacity * sizeof(int));
+		t->degree = realloc(t->degree, t->vertexCapacity * sizeof(int));
+		t->queue = realloc(t->queue, t->vertexCapacity * sizeof(int));
+		t->queued = realloc(t->queued, t->vertexCapacity * sizeof(char));
+		t->mark = realloc(t->mark, t->vertexCapacity * sizeof(int));
+		t->cycleNeighbors = realloc(t->cycleNeighbors, 2 * t->vertexCapacity * sizeof(int));
+	}
+	/* original edges and at most n triangulation edges */
+	if (m + n > t->edgeCapacity) {
+		t->edgeCapacity = 2 * (m + n);
+		t->input = realloc(t->input, t->edgeCapacity * sizeof(struct VertexList*));
+		t->diagonals = realloc(t->diagonals, 2 * t->edgeCapacity * sizeof(int));
+		t->diagonalEdges = realloc(t->diagonalEdges, t->edgeCapacity * sizeof(struct VertexList*));
+		t->arcNext = realloc(t->arcNext, 2 * t->edgeCapacity * sizeof(int));
+		t->arcPrev = realloc(t->arcPrev, 2 * t->edgeCapacity * sizeof(int));
+		t->arcTarget = realloc(t->arcTarget, 2 * t->edgeCapacity * sizeof(int));
+		t->pairCount = realloc(t->pairCount, t->edgeCapacity * sizeof(int));
+		t->removedAt = realloc(t->removedAt, t->edgeCapacity * sizeof(int));
+		t->pairedAt = realloc(t->pairedAt, t->edgeCapacity * sizeof(int));
+	}
+}
+
+
+/* add the arcs 2e (v, w) and 2e+1 (w, v) at the heads of the adjacency lists of v and w */
+static void addArcs(struct OuterplanarBlockTest* t, int e, int v, int w) {
+	int a = 2 * e;
+	t->arcTarget[a] = w;
+	t->arcPrev[a] = -1;
+	t->arcNext[a] = t->head[v];
+	if (t->head[v] != -1) {
+		t->arcPrev[t->head[v]] = a;
+	}
+	t->head[v] = a;
+	++t->degree[v];
+
+	a = 2 * e + 1;
+	t->arcTarget[a] = v;
+	t->arcPrev[a] = -1;
+	t->arcNext[a] = t->head[w];
+	if (t->head[w] != -1) {
+		t->arcPrev[t->head[w]] = a;
+	}
+	t->head[w] = a;
+	++t->degree[w];
+}
+
+
+/* remove arc a from the adjacency list of its source v */
+static void removeArc(struct OuterplanarBlockTest* t, int v, int a) {
+	if (t->arcPrev[a] != -1) {
+		t->arcNext[t->arcPrev[a]] = t->arcNext[a];
+	} else {
+		t->head[v] = t->arcNext[a];
+	}
+	if (t->arcNext[a] != -1) {
+		t->arcPrev[t->arcNext[a]] = t->arcPrev[a];
+	}
+	--t->degree[v];
+}
+
+
+/* return the edge between v and w or -1 if there is none. Scans the shorter adjacency list. */
+static int findEdge(struct OuterplanarBlockTest* t, int v, int w) {
+	if (t->degree[w] < t->degree[v]) {
+		int tmp = v;
+		v = w;
+		w = tmp;
+	}
+	for (int a=t->head[v]; a!=-1; a=t->arcNext[a]) {
+		if (t->arcTarget[a] == w) {
+			return a / 2;
+		}
+	}
+	return -1;
+}
+
+
+static int commonNeighbors(struct OuterplanarBlockTest* t, int v, int w, int stamp) {
+	int count = 0;
+	for (int a=t->head[v]; a!=-1; a=t->arcNext[a]) {
+		t->mark[t->arcTarget[a]] = stamp;
+	}
+	for (int a=t->head[w]; a!=-1; a=t->arcNext[a]) {
+		if (t->mark[t->arcTarget[a]] == stamp) {
+			++count;
+		}
+	}
+	return count;
+}
+
+
+/**
+ * Check if the block given by the m edges in edges is outerplanar using the algorithm of Sarah Mitchell
+ * on arrays instead of a copy of the block. The degree two vertices are processed in the same order as
+ * in isOuterplanarBlock() and __getCycleAndDiagonals(), but instead of sorting the list of pairs, each
+ * edge counts how often it was a pair.
+ *
+ * If the block is outerplanar, t->vertices[0..t->n-1] contains its vertices (numbered in the order of their
+ * first occurrence in edges), t->cycle its hamiltonian cycle as sequence of local vertex ids starting at 0
+ * and t->cycleEdges[i] the edge between t->cycle[i] and t->cycle[(i+1) % n]. The i-th of the t->nDiagonals
+ * diagonals connects t->diagonals[2i] and t->diagonals[2i+1] and is t->diagonalEdges[i].
+ *
+ * The edges are not changed, but ->lowPoint of their endpoints is.
+ *
+ * Mitchell, S. [1979]: Linear Algorithms to Recognize Outerplanar and
+ * Maximal Outerplanar Graphs, Information Processing Letters Volume 9,
+ * number 5, 16.12.1979
+ */
+char getOuterplanarBlockStructure(struct OuterplanarBlockTest* t, struct VertexList** edges, int m) {
+	int n = 0;
+	int queueEnd = 0;
+	int nEdges = m;
+	int removed = 0;
+	int near = -1;
+	int next = -1;
+	int lastEdge = -1;
+	int i;
+
+	/* number the vertices in order of their first occurrence */
+	for (i=0; i<m; ++i) {
+		edges[i]->startPoint->lowPoint = -1;
+		edges[i]->endPoint->lowPoint = -1;
+	}
+	reserveOuterplanarBlockTest(t, 2 * m, m);
+	for (i=0; i<m; ++i) {
+		if (edges[i]->startPoint->lowPoint == -1) {
+			edges[i]->startPoint->lowPoint = n;
+			t->vertices[n++] = edges[i]->startPoint;
+		}
+		if (edges[i]->endPoint->lowPoint == -1) {
+			edges[i]->endPoint->lowPoint = n;
+			t->vertices[n++] = edges[i]->endPoint;
+		}
+	}
+	t->n = n;
+	t->nDiagonals = 0;
+
+	/* first check. number of edges ok ? */
+	if (m > 2 * n - 3) {
+		return 0;
+	}
+
+	for (i=0; i<n; ++i) {
+		t->head[i] = -1;
+		t->degree[i] = 0;
+		t->queued[i] = 0;
+		t->mark[i] = -1;
+	}
+	for (i=0; i<m; ++i) {
+		addArcs(t, i, edges[i]->startPoint->lowPoint, edges[i]->endPoint->lowPoint);
+		t->pairCount[i] = 0;
+		t->removedAt[i] = -1;
+	}
+
+	/* second check: enough vertices of degree 2? The initial queue is in decreasing order of ids */
+	for (i=n-1; i>=0; --i) {
+		if (t->degree[i] == 2) {
+			t->queue[queueEnd++] = i;
+			t->queued[i] = 1;
+		}
+	}
+	if (queueEnd < 2) {
+		return 0;
+	}
+
+	/* successively remove vertices of degree 2 */
+	for (i=1; i<=n-2; ++i) {
+		int v = t->queue[i-1];
+		int a1 = t->head[v];
+		int a2 = (a1 != -1) ? t->arcNext[a1] : -1;
+		int e;
+
+		if ((a2 == -1) || (t->arcNext[a2] != -1)) {
+			return 0;
+		}
+
+		near = t->arcTarget[a1];
+		next = t->arcTarget[a2];
+		t->removedAt[a1 / 2] = removed++;
+		t->removedAt[a2 / 2] = removed++;
+
+		/* record the pair (near, next), add a triangulation edge, if necessary */
+		e = findEdge(t, near, next);
+		if (e == -1) {
+			e = nEdges++;
+			t->pairCount[e] = 0;
+			t->removedAt[e] = -1;
+			addArcs(t, e, near, next);
+		}
+		if (t->pairCount[e]++ == 0) {
+			t->pairedAt[e] = i;
+		}
+		lastEdge = e;
+
+		/* remove v and enqueue neighbors that become degree two vertices */
+		removeArc(t, near, a1 ^ 1);
+		if ((t->degree[near] == 2) && !t->queued[near]) {
+			t->queue[queueEnd++] = near;
+			t->queued[near] = 1;
+		}
+		removeArc(t, next, a2 ^ 1);
+		if ((t->degree[next] == 2) && !t->queued[next]) {
+			t->queue[queueEnd++] = next;
+			t->queued[next] = 1;
+		}
+		t->head[v] = -1;
+		t->degree[v] = 0;
+
+		/* the new edge may not lie on more than two triangles */
+		if (commonNeighbors(t, near, next, i) > 1) {
+			return 0;
+		}
+		if (queueEnd - i < 2) {
+			return 0;
+		}
+	}
+	if (near == -1) {
+		return 0;
+	}
+
+	/* each pair has to be an edge that is used at most once as a pair, except for the last edge which may
+	 * additionally be the last pair if it is an original edge */
+	for (i=0; i<nEdges; ++i) {
+		int allowed = ((i == lastEdge) && (i < m)) ? 2 : 1;
+		if (t->pairCount[i] > allowed) {
+			return 0;
+		}
+	}
+
+	/* edges that were never a pair form the hamiltonian cycle. So does the last edge, if it was only
+	 * the last pair. The diagonals are sorted by the step in which they became a pair first (using mark). */
+	for (i=0; i<n; ++i) {
+		t->degree[i] = 0;
+		t->mark[i] = -1;
+	}
+	for (i=0; i<m; ++i) {
+		if ((t->pairCount[i] == 0) || ((i == lastEdge) && (t->pairCount[i] == 1))) {
+			int v = edges[i]->startPoint->lowPoint;
+			int w = edges[i]->endPoint->lowPoint;
+			if ((t->degree[v] == 2) || (t->degree[w] == 2)) {
+				return 0;
+			}
+			t->cycleNeighbors[2 * v + t->degree[v]++] = i;
+			t->cycleNeighbors[2 * w + t->degree[w]++] = i;
+		} else {
+			t->mark[t->pairedAt[i]] = i;
+		}
+	}
+	for (i=1; i<=n-2; ++i) {
+		int e = t->mark[i];
+		if (e != -1) {
+			t->diagonals[2 * t->nDiagonals] = edges[e]->startPoint->lowPoint;
+			t->diagonals[2 * t->nDiagonals + 1] = edges[e]->endPoint->lowPoint;
+			t->diagonalEdges[t->nDiagonals] = edges[e];
+			++t->nDiagonals;
+		}
+	}
+
+	/* walk along the cycle, starting at 0 in the direction of the edge that was removed last */
+	if (t->degree[0] != 2) {
+		return 0;
+	} else {
+		int v = 0;
+		int e = t->cycleNeighbors[0];
+		if (t->removedAt[t->cycleNeighbors[1]] > t->removedAt[e]) {
+			e = t->cycleNeighbors[1];
+		}
+		for (i=0; i<n; ++i) {
+			int w;
+			if (t->degree[v] != 2) {
+				return 0;
+			}
+			t->cycle[i] = v;
+			t->cycleEdges[i] = edges[e];
+			w = (edges[e]->startPoint->lowPoint == v) ? edges[e]->endPoint->lowPoint : edges[e]->startPoint->lowPoint;
+			e = (t->cycleNeighbors[2 * w] == e) ? t->cycleNeighbors[2 * w + 1] : t->cycleNeighbors[2 * w];
+			v = w;
+		}
+		if (v != 0) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+/**
+ * Convenience wrapper of getOuterplanarBlockStructure() for a block given as ShallowGraph.
+ */
+char getOuterplanarBlockStructureShallow(struct OuterplanarBlockTest* t, struct ShallowGraph* block) {
+	struct VertexList* e;
+	int i;
+	reserveOuterplanarBlockTest(t, 2 * block->m, block->m);
+	for (e=block->edges, i=0; e; e=e->next, ++i) {
+		t->input[i] = e;
+	}
+	return getOuterplanarBlockStructure(t, t->input, block->m);
+}
+
+
 /**
  * Create a Block and Bridge Tree struct from given input.
  * For constant time access, the list of blocks is converted to an array.
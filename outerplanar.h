@@ -27,6 +27,42 @@ struct BBTree{
 	int* originalIDs;
 };
 
+/**
+ * Workspace and result of getOuterplanarBlockStructure(). The hamiltonian cycle and the diagonals of
+ * an outerplanar block are given by local vertex ids, i.e. indices into vertices.
+ */
+struct OuterplanarBlockTest {
+	int n;
+	int nDiagonals;
+	struct Vertex** vertices;
+	int* cycle;
+	struct VertexList** cycleEdges;
+	int* diagonals;
+	struct VertexList** diagonalEdges;
+
+	/* scratch space */
+	int vertexCapacity;
+	int edgeCapacity;
+	struct VertexList** input;
+	int* head;
+	int* degree;
+	int* queue;
+	char* queued;
+	int* mark;
+	int* cycleNeighbors;
+	int* arcNext;
+	int* arcPrev;
+	int* arcTarget;
+	int* pairCount;
+	int* removedAt;
+	int* pairedAt;
+};
+
+struct OuterplanarBlockTest* createOuterplanarBlockTest();
+void freeOuterplanarBlockTest(struct OuterplanarBlockTest* t);
+char getOuterplanarBlockStructure(struct OuterplanarBlockTest* t, struct VertexList** edges, int m);
+char getOuterplanarBlockStructureShallow(struct OuterplanarBlockTest* t, struct ShallowGraph* block);
+
 char isOuterplanarBlock(struct Graph* g, struct ShallowGraphPool* sgp);
 char isOuterplanarBlockShallow(struct ShallowGraph* original, struct ShallowGraphPool* sgp, struct GraphPool* gp);
 
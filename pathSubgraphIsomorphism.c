@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+#include "subtreeIsoUtils.h"
+#include "pathSubgraphIsomorphism.h"
+
+
+/**
+ * Store the vertices of path in the order in which they appear on the path, starting at one of its ends.
+ * Returns 0 if path is not a path.
+ */
+static char getPathOrder(struct Graph* path, struct Vertex** order, char** edgeLabels) {
+	struct Vertex* start = path->vertices[0];
+	for (int v=0; v<path->n; ++v) {
+		int deg = degree(path->vertices[v]);
+		if (deg > 2) {
+			return 0;
+		}
+		if (deg < 2) {
+			start = path->vertices[v];
+		}
+	}
+
+	struct Vertex* previous = NULL;
+	struct Vertex* current = start;
+	order[0] = start;
+	for (int i=1; i<path->n; ++i) {
+		struct VertexList* e = current->neighborhood;
+		if ((e != NULL) && (e->endPoint == previous)) {
+			e = e->next;
+		}
+		if (e == NULL) {
+			return 0;
+		}
+		edgeLabels[i-1] = e->label;
+		order[i] = e->endPoint;
+		previous = current;
+		current = e->endPoint;
+	}
+	return 1;
+}
+
+
+/**
+ * Try to map order[i+1], ..., order[k-1] to a simple path in g that starts at a neighbor of v, which is the image of order[i].
+ */
+static char embedPathSuffix(struct Vertex* v, int i, int k, char** edgeLabels, char* feasible, char* used, int n) {
+	if (i == k - 1) {
+		return 1;
+	}
+	used[v->number] = 1;
+	for (struct VertexList* e=v->neighborhood; e!=NULL; e=e->next) {
+		struct Vertex* w = e->endPoint;
+		if (!used[w->number] && feasible[(i+1) * n + w->number] && (labelCmp(e->label, edgeLabels[i]) == 0)) {
+			if (embedPathSuffix(w, i+1, k, edgeLabels, feasible, used, n)) {
+				return 1;
+			}
+		}
+	}
+	used[v->number] = 0;
+	return 0;
+}
+
+
+/**
+ * Decide if the path pattern path is subgraph isomorphic to g, respecting vertex and edge labels.
+ *
+ * feasible[i*n+v] is 1 iff there is a walk in g that starts at v and matches the labels of the i-th to the last
+ * vertex of path. These sets are computed by dynamic programming from the last vertex of path backwards in
+ * O(k * m) time. A walk that matches path is not necessarily a simple path, hence a backtracking search for a
+ * simple path follows, which only visits feasible vertices. It returns on the first embedding it finds, but
+ * it might take exponential time in the length of path in the worst case.
+ *
+ * No bipartite matchings are required as the vertices of a path have at most two neighbors.
+ */
+char isPathSubgraph(struct Graph* g, struct Graph* path) {
+	int n = g->n;
+	int k = path->n;
+
+	struct Vertex** order = malloc(k * sizeof(struct Vertex*));
+	char** edgeLabels = malloc(k * sizeof(char*));
+	if (!getPathOrder(path, order, edgeLabels)) {
+		fprintf(stderr, "isPathSubgraph: pattern is not a path\n");
+		free(order);
+		free(edgeLabels);
+		return 0;
+	}
+
+	char* feasible = malloc(k * n * sizeof(char));
+	char foundIso = 1;
+	for (int i=k-1; (i>=0) && foundIso; --i) {
+		foundIso = 0;
+		for (int v=0; v<n; ++v) {
+			struct Vertex* w = g->vertices[v];
+			char isFeasible = (labelCmp(w->label, order[i]->label) == 0);
+			if (isFeasible && (i < k - 1)) {
+				isFeasible = 0;
+				for (struct VertexList* e=w->neighborhood; e!=NULL; e=e->next) {
+					if (feasible[(i+1) * n + e->endPoint->number] && (labelCmp(e->label, edgeLabels[i]) == 0)) {
+						isFeasible = 1;
+						break;
+					}
+				}
+			}
+			feasible[i * n + v] = isFeasible;
+			foundIso |= isFeasible;
+		}
+	}
+
+	if (foundIso) {
+		foundIso = 0;
+		char* used = calloc(n, sizeof(char));
+		for (int v=0; (v<n) && !foundIso; ++v) {
+			if (feasible[v]) {
+				foundIso = embedPathSuffix(g->vertices[v], 0, k, edgeLabels, feasible, used, n);
+			}
+		}
+		free(used);
+	}
+
+	free(feasible);
+	free(order);
+	free(edgeLabels);
+	return foundIso;
+}
@@ -0,0 +1,8 @@
+#ifndef PATH_SUBGRAPH_ISOMORPHISM_H_
+#define PATH_SUBGRAPH_ISOMORPHISM_H_
+
+#include "graph.h"
+
+char isPathSubgraph(struct Graph* g, struct Graph* path);
+
+#endif
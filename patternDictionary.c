@@ -0,0 +1,443 @@
+/**
+ * Persistent pattern dictionary that maps canonical strings to stable feature ids across runs.
+ *
+ * The dictionary file is a text log with one line "id\tstring\n" for each pattern, where id is the line
+ * number starting at 1. Lines are only ever appended, hence ids never change and feature vectors computed
+ * by different runs on different data are compatible.
+ *
+ * Several processes may use the same file at the same time. Reading the log is done under a shared lock,
+ * appending under an exclusive lock. Before a process appends new patterns, it reads the lines that others
+ * appended since its last read, so a string that was added concurrently gets the id that is already in the
+ * log. A line that is not terminated by a newline can only be the remainder of a crashed writer and is
+ * removed by the next writer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+#include "searchTree.h"
+#include "patternDictionary.h"
+
+
+/******* In memory hash index *****************************************/
+
+static uint32_t stringHash(const char* s) {
+	uint32_t hash = 2166136261u;
+	for (; *s!='\0'; ++s) {
+		hash ^= (unsigned char)*s;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Return the slot of string in the index of d, or the empty slot where it should be inserted.
+ */
+static size_t findSlot(struct PatternDictionary* d, const char* string) {
+	size_t slot = stringHash(string) & (d->nSlots - 1);
+	while (d->slots[slot] != 0) {
+		if (strcmp(d->strings + d->slots[slot] - 1, string) == 0) {
+			break;
+		}
+		slot = (slot + 1) & (d->nSlots - 1);
+	}
+	return slot;
+}
+
+static void growIndex(struct PatternDictionary* d) {
+	size_t oldSlots = d->nSlots;
+	size_t* oldOffsets = d->slots;
+	int* oldIds = d->ids;
+
+	d->nSlots *= 2;
+	d->slots = calloc(d->nSlots, sizeof(size_t));
+	d->ids = malloc(d->nSlots * sizeof(int));
+	for (size_t i=0; i<oldSlots; ++i) {
+		if (oldOffsets[i] != 0) {
+			size_t slot = findSlot(d, d->strings + oldOffsets[i] - 1);
+			d->slots[slot] = oldOffsets[i];
+			d->ids[slot] = oldIds[i];
+		}
+	}
+	free(oldOffsets);
+	free(oldIds);
+}
+
+/**
+ * Add string with the next id to the index. string must not be contained in the index.
+ */
+static int addToIndex(struct PatternDictionary* d, const char* string, size_t length) {
+	if (2 * (d->nPatterns + 1) > (int)d->nSlots) {
+		growIndex(d);
+	}
+	while (d->stringsSize + length + 1 > d->stringsCapacity) {
+		d->stringsCapacity *= 2;
+		d->strings = realloc(d->strings, d->stringsCapacity);
+	}
+	memcpy(d->strings + d->stringsSize, string, length);
+	d->strings[d->stringsSize + length] = '\0';
+
+	size_t slot = findSlot(d, d->strings + d->stringsSize);
+	d->slots[slot] = d->stringsSize + 1;
+	d->ids[slot] = ++d->nPatterns;
+	d->stringsSize += length + 1;
+	return d->nPatterns;
+}
+
+static int lookupInIndex(struct PatternDictionary* d, const char* string) {
+	size_t slot = findSlot(d, string);
+	return d->slots[slot] ? d->ids[slot] : 0;
+}
+
+/**
+ * Remove all strings with id larger than nPatterns from the index. The strings are stored in the order of
+ * their ids, hence the index is rebuilt from the first nPatterns strings.
+ */
+static void truncateIndex(struct PatternDictionary* d, int nPatterns) {
+	size_t offset = 0;
+	memset(d->slots, 0, d->nSlots * sizeof(size_t));
+	for (int id=1; id<=nPatterns; ++id) {
+		size_t slot = findSlot(d, d->strings + offset);
+		d->slots[slot] = offset + 1;
+		d->ids[slot] = id;
+		offset += strlen(d->strings + offset) + 1;
+	}
+	d->stringsSize = offset;
+	d->nPatterns = nPatterns;
+}
+
+
+/******* Log file *****************************************************/
+
+/**
+ * Add all complete lines of the log after d->loadedSize to the index. The caller has to hold a lock on the file.
+ * If truncate is set, an incomplete last line is removed from the file, which requires an exclusive lock.
+ * Returns 0 on success and -1 if the file cannot be read or is corrupt.
+ */
+static int catchUp(struct PatternDictionary* d, char truncate) {
+	struct stat info;
+	if (fstat(d->fd, &info) != 0) {
+		perror("Error: cannot access pattern dictionary");
+		return -1;
+	}
+	if (info.st_size <= d->loadedSize) {
+		return 0;
+	}
+
+	size_t size = info.st_size - d->loadedSize;
+	char* buffer = malloc(size + 1);
+	size_t done = 0;
+	while (done < size) {
+		ssize_t r = pread(d->fd, buffer + done, size - done, d->loadedSize + done);
+		if (r <= 0) {
+			perror("Error: cannot read pattern dictionary");
+			free(buffer);
+			return -1;
+		}
+		done += r;
+	}
+	buffer[size] = '\0';
+
+	char* line = buffer;
+	char* end;
+	while ((end = memchr(line, '\n', buffer + size - line)) != NULL) {
+		int id;
+		int offset;
+		*end = '\0';
+		if ((sscanf(line, "%i\t%n", &id, &offset) != 1) || (id != d->nPatterns + 1)) {
+			fprintf(stderr, "Error: corrupt line %i in pattern dictionary: %s\n", d->nPatterns + 1, line);
+			free(buffer);
+			return -1;
+		}
+		addToIndex(d, line + offset, end - line - offset);
+		line = end + 1;
+	}
+	d->loadedSize += line - buffer;
+	free(buffer);
+
+	if (truncate && (d->loadedSize < info.st_size)) {
+		fprintf(stderr, "Warning: removing incomplete last line of pattern dictionary\n");
+		if (ftruncate(d->fd, d->loadedSize) != 0) {
+			perror("Error: cannot truncate pattern dictionary");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Lock or unlock the log with operation as in flock(). Returns 0 on success and -1 otherwise.
+ */
+static int lockDictionary(struct PatternDictionary* d, int operation) {
+	if (flock(d->fd, operation) != 0) {
+		perror(operation == LOCK_UN ? "Error: cannot unlock pattern dictionary" : "Error: cannot lock pattern dictionary");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Read the lines appended by other processes.
+ */
+static int refresh(struct PatternDictionary* d) {
+	if (d->fd == -1) {
+		return 0;
+	}
+	if (lockDictionary(d, LOCK_SH) != 0) {
+		return -1;
+	}
+	int status = catchUp(d, 0);
+	if (lockDictionary(d, LOCK_UN) != 0) {
+		status = -1;
+	}
+	return status;
+}
+
+/**
+ * Assign ids to the n strings, adding those to the log that are not yet contained in it.
+ * ids[i] must be 0 for the strings that need an id and is left unchanged otherwise.
+ * If the new lines cannot be written, the strings of this call are removed from the index again and -1 is
+ * returned. Complete lines that were written nevertheless are read back by the next catchUp().
+ */
+static int appendPatterns(struct PatternDictionary* d, char** strings, int* ids, int n) {
+	char* buffer = NULL;
+	size_t size = 0;
+	size_t capacity = 0;
+	int status = 0;
+
+	if (d->fd != -1) {
+		if (lockDictionary(d, LOCK_EX) != 0) {
+			return -1;
+		}
+		status = catchUp(d, 1);
+	}
+	int knownPatterns = d->nPatterns;
+
+	for (int i=0; (i<n) && (status==0); ++i) {
+		if (ids[i] != 0) {
+			continue;
+		}
+		/* the string may have been added by another process or earlier in strings */
+		ids[i] = lookupInIndex(d, strings[i]);
+		if (ids[i] == 0) {
+			size_t length = strlen(strings[i]);
+			ids[i] = addToIndex(d, strings[i], length);
+			if (d->fd != -1) {
+				while (size + length + 16 > capacity) {
+					capacity = capacity ? 2 * capacity : 4096;
+					buffer = realloc(buffer, capacity);
+				}
+				size += sprintf(buffer + size, "%i\t%s\n", ids[i], strings[i]);
+			}
+		}
+	}
+
+	if (d->fd != -1) {
+		size_t done = 0;
+		while ((status == 0) && (done < size)) {
+			ssize_t w = pwrite(d->fd, buffer + done, size - done, d->loadedSize + done);
+			if (w <= 0) {
+				perror("Error: cannot write pattern dictionary");
+				status = -1;
+			} else {
+				done += w;
+			}
+		}
+		if (status == 0) {
+			d->loadedSize += done;
+		} else {
+			truncateIndex(d, knownPatterns);
+		}
+		if (lockDictionary(d, LOCK_UN) != 0) {
+			status = -1;
+		}
+	}
+	free(buffer);
+	return status;
+}
+
+
+/******* Public interface *********************************************/
+
+/**
+ * Open the pattern dictionary stored in filename, creating the file if it does not exist.
+ * If filename is NULL, the dictionary is kept in memory only.
+ * Returns NULL if the file cannot be opened.
+ */
+struct PatternDictionary* openPatternDictionary(const char* filename) {
+	int fd = -1;
+	if (filename != NULL) {
+		fd = open(filename, O_RDWR | O_CREAT, 0644);
+		if (fd == -1) {
+			fprintf(stderr, "Error: cannot open pattern dictionary %s: ", filename);
+			perror(NULL);
+			return NULL;
+		}
+	}
+
+	struct PatternDictionary* d = malloc(sizeof(struct PatternDictionary));
+	d->fd = fd;
+	d->loadedSize = 0;
+	d->stringsSize = 0;
+	d->stringsCapacity = 4096;
+	d->strings = malloc(d->stringsCapacity);
+	d->nSlots = 1024;
+	d->slots = calloc(d->nSlots, sizeof(size_t));
+	d->ids = malloc(d->nSlots * sizeof(int));
+	d->nPatterns = 0;
+	return d;
+}
+
+void closePatternDictionary(struct PatternDictionary* d) {
+	if (d->fd != -1) {
+		close(d->fd);
+	}
+	free(d->strings);
+	free(d->slots);
+	free(d->ids);
+	free(d);
+}
+
+/**
+ * Return the id of string, adding it to the dictionary if necessary.
+ * string consists of the labels of a canonical string, separated by single spaces.
+ * Returns -1 on errors.
+ */
+int getPatternId(struct PatternDictionary* d, const char* string) {
+	int id = lookupInIndex(d, string);
+	if ((id == 0) && (refresh(d) == 0)) {
+		id = lookupInIndex(d, string);
+	}
+	if (id == 0) {
+		char* s = (char*)string;
+		if (appendPatterns(d, &s, &id, 1) != 0) {
+			return -1;
+		}
+	}
+	return id;
+}
+
+
+struct PatternCollector {
+	char* buffer;
+	size_t capacity;
+	char** strings;
+	int* counts;
+	int* depths;
+	int n;
+	int size;
+};
+
+/**
+ * Collect the strings in the search tree below v in the order of mergeSearchTrees(). The labels of the current
+ * path are stored in c->buffer up to position length.
+ */
+static void collectPatterns(struct Vertex* v, struct PatternCollector* c, size_t length, int depth) {
+	if ((depth > 0) && (v->visited != 0)) {
+		if (c->n == c->size) {
+			c->size = c->size ? 2 * c->size : 64;
+			c->strings = realloc(c->strings, c->size * sizeof(char*));
+			c->counts = realloc(c->counts, c->size * sizeof(int));
+			c->depths = realloc(c->depths, c->size * sizeof(int));
+		}
+		c->strings[c->n] = malloc(length);
+		memcpy(c->strings[c->n], c->buffer, length - 1);
+		c->strings[c->n][length - 1] = '\0';
+		c->counts[c->n] = v->visited;
+		c->depths[c->n] = depth;
+		++c->n;
+	}
+
+	for (struct VertexList* e=v->neighborhood; e!=NULL; e=e->next) {
+		size_t labelLength = strlen(e->label);
+		while (length + labelLength + 1 > c->capacity) {
+			c->capacity *= 2;
+			c->buffer = realloc(c->buffer, c->capacity);
+		}
+		memcpy(c->buffer + length, e->label, labelLength);
+		c->buffer[length + labelLength] = ' ';
+		collectPatterns(e->endPoint, c, length + labelLength + 1, depth + 1);
+	}
+}
+
+/**
+ * Store (id, count, depth) of each string in searchTree in results, starting at position *pos, and increase
+ * *pos accordingly. This is a replacement of mergeSearchTrees() with a global search tree whose ids are
+ * persistent. As in mergeSearchTrees(), new strings get ids in the order of a depth first traversal of
+ * searchTree. results needs space for searchTree->number entries.
+ * Returns -1 if the dictionary file cannot be read or written, and 0 otherwise.
+ */
+int getPatternIds(struct PatternDictionary* d, struct Vertex* searchTree, struct compInfo* results, int* pos) {
+	struct PatternCollector c = {malloc(256), 256, NULL, NULL, NULL, 0, 0};
+	int* ids;
+	int nUnknown = 0;
+	int status = 0;
+
+	collectPatterns(searchTree, &c, 0, 0);
+	ids = malloc(c.n * sizeof(int));
+	for (int i=0; i<c.n; ++i) {
+		ids[i] = lookupInIndex(d, c.strings[i]);
+		if (ids[i] == 0) {
+			++nUnknown;
+		}
+	}
+	/* read what other processes added before appending the remaining strings ourselves */
+	if (nUnknown > 0) {
+		status = refresh(d);
+		nUnknown = 0;
+		for (int i=0; (i<c.n) && (status==0); ++i) {
+			if (ids[i] == 0) {
+				ids[i] = lookupInIndex(d, c.strings[i]);
+				nUnknown += ids[i] == 0;
+			}
+		}
+	}
+	if ((nUnknown > 0) && (status == 0)) {
+		status = appendPatterns(d, c.strings, ids, c.n);
+	}
+
+	for (int i=0; i<c.n; ++i) {
+		if (status == 0) {
+			results[*pos].id = ids[i];
+			results[*pos].count = c.counts[i];
+			results[*pos].depth = c.depths[i];
+			++*pos;
+		}
+		free(c.strings[i]);
+	}
+	free(ids);
+	free(c.strings);
+	free(c.counts);
+	free(c.depths);
+	free(c.buffer);
+	return status;
+}
+
+
+/**
+ * Write the strings in searchTree as feature vector "label id:count id:count ..." with increasing ids
+ * taken from d. Returns -1 if the dictionary file cannot be read or written, and 0 otherwise.
+ */
+int writePatternFeatures(struct PatternDictionary* d, struct Vertex* searchTree, int label, struct SparseFeatureWriter* out) {
+	struct compInfo* results = getResultVector(searchTree->number);
+	int pos = 0;
+	int status = getPatternIds(d, searchTree, results, &pos);
+
+	if (status == 0) {
+		qsort(results, pos, sizeof(struct compInfo), &compInfoComparison);
+		beginSparseRow(out, label);
+		for (int i=0; i<pos; ++i) {
+			addSparseEntry(out, results[i].id, results[i].count);
+		}
+		endSparseRow(out);
+	}
+	free(results);
+	return status;
+}
@@ -0,0 +1,39 @@
+#ifndef PATTERN_DICTIONARY_H_
+#define PATTERN_DICTIONARY_H_
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "graph.h"
+#include "searchTree.h"
+#include "sparseFeatureWriter.h"
+
+/**
+ * Persistent mapping of canonical strings to feature ids.
+ *
+ * The file is an append-only log with one line "id\tstring\n" per pattern. The ids are 1, 2, 3, ... in
+ * the order of the lines. The hash index over the log is kept in memory. It is built lazily on the first
+ * lookup, and later lookups only read the lines that other processes appended in the meantime.
+ */
+struct PatternDictionary {
+	int fd;               // -1 if the dictionary is not backed by a file
+	off_t loadedSize;     // number of bytes of the log that are contained in the index
+
+	char* strings;        // all strings of the index, zero terminated
+	size_t stringsSize;
+	size_t stringsCapacity;
+
+	size_t* slots;        // offset + 1 of the string in strings, 0 for empty slots
+	int* ids;
+	size_t nSlots;
+	int nPatterns;
+};
+
+struct PatternDictionary* openPatternDictionary(const char* filename);
+void closePatternDictionary(struct PatternDictionary* d);
+
+int getPatternId(struct PatternDictionary* d, const char* string);
+int getPatternIds(struct PatternDictionary* d, struct Vertex* searchTree, struct compInfo* results, int* pos);
+int writePatternFeatures(struct PatternDictionary* d, struct Vertex* searchTree, int label, struct SparseFeatureWriter* out);
+
+#endif /* PATTERN_DICTIONARY_H_ */
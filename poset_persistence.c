@@ -0,0 +1,701 @@
+/**
+ * Binary serialization of pattern posets and the evaluation plans that gpe builds on top of them.
+ *
+ * Building the poset (buildTreePosetFromGraphDB) requires canonical strings of all patterns and their
+ * subtrees, and path covers require a max flow computation. Both are done once and written to a plan file.
+ * Later runs mmap that file and rebuild the pooled graph structures directly from flat arrays.
+ *
+ * The file consists of a header followed by int32 sections and a string table:
+ *
+ *   patternInfo     [nPatterns][4]    number, activity, n, m of each pattern (pattern i is poset vertex i+1)
+ *   vertexInfo      [nPatternVertices][2]   label offset and degree of each pattern vertex
+ *   adjacency       [nAdjacencies][2] end point and label offset of each directed pattern edge
+ *   posetDegrees    [posetSize]       out degree of each poset vertex
+ *   posetEdges      [nPosetEdges]     end points of poset edges
+ *   topologicalOrder[posetSize]
+ *   pathLengths     [nPaths]          number of ints stored for each permutation or path
+ *   pathData        [pathDataLength]
+ *   order           [orderLength][2]  level and permutation of the minhash evaluation order
+ *   projection      [projectionSize]
+ *   strings         [stringTableSize] zero terminated labels
+ *
+ * Adjacency lists are stored in list order and rebuilt by pushing in reverse, hence a loaded plan
+ * traverses the poset exactly like the one that was written. Label offsets of -1 denote NULL labels.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+#include "minhashing.h"
+#include "poset_persistence.h"
+
+#define PLAN_MAGIC "GMTPLAN"
+#define PLAN_VERSION 1
+
+struct PlanFileHeader {
+	char magic[8];
+	int32_t version;
+	int32_t type;
+	int32_t posetSize;
+	int32_t nPosetEdges;
+	int32_t nPatternVertices;
+	int32_t nAdjacencies;
+	int32_t nPaths;
+	int32_t pathDataLength;
+	int32_t orderLength;
+	int32_t projectionSize;
+	int32_t stringTableSize;
+	int32_t reserved;
+};
+
+
+/******* String table with hash based deduplication *******************/
+
+struct StringTable {
+	char* data;
+	size_t size;
+	size_t capacity;
+	const char** keys;
+	int32_t* offsets;
+	size_t nSlots;
+	size_t nKeys;
+};
+
+static uint32_t stringHash(const char* s) {
+	uint32_t hash = 2166136261u;
+	for (; *s!='\0'; ++s) {
+		hash ^= (unsigned char)*s;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void initStringTable(struct StringTable* t) {
+	t->size = 0;
+	t->capacity = 1024;
+	t->data = malloc(t->capacity);
+	t->nKeys = 0;
+	t->nSlots = 1024;
+	t->keys = calloc(t->nSlots, sizeof(const char*));
+	t->offsets = malloc(t->nSlots * sizeof(int32_t));
+}
+
+static void freeStringTable(struct StringTable* t) {
+	free(t->data);
+	free(t->keys);
+	free(t->offsets);
+}
+
+static void growStringTableIndex(struct StringTable* t) {
+	size_t oldSlots = t->nSlots;
+	const char** oldKeys = t->keys;
+	int32_t* oldOffsets = t->offsets;
+
+	t->nSlots *= 2;
+	t->keys = calloc(t->nSlots, sizeof(const char*));
+	t->offsets = malloc(t->nSlots * sizeof(int32_t));
+	for (size_t i=0; i<oldSlots; ++i) {
+		if (oldKeys[i] != NULL) {
+			size_t slot = stringHash(oldKeys[i]) & (t->nSlots - 1);
+			while (t->keys[slot] != NULL) {
+				slot = (slot + 1) & (t->nSlots - 1);
+			}
+			t->keys[slot] = oldKeys[i];
+			t->offsets[slot] = oldOffsets[i];
+		}
+	}
+	free(oldKeys);
+	free(oldOffsets);
+}
+
+/**
+ * Return the offset of label in the string table, adding it if it is not yet present.
+ * The key pointers are only valid as long as the graphs that are written are alive.
+ */
+static int32_t internString(struct StringTable* t, const char* label) {
+	if (label == NULL) {
+		return -1;
+	}
+	if (2 * (t->nKeys + 1) > t->nSlots) {
+		growStringTableIndex(t);
+	}
+	size_t slot = stringHash(label) & (t->nSlots - 1);
+	while (t->keys[slot] != NULL) {
+		if (strcmp(t->keys[slot], label) == 0) {
+			return t->offsets[slot];
+		}
+		slot = (slot + 1) & (t->nSlots - 1);
+	}
+
+	size_t length = strlen(label) + 1;
+	while (t->size + length > t->capacity) {
+		t->capacity *= 2;
+		t->data = realloc(t->data, t->capacity);
+	}
+	memcpy(t->data + t->size, label, length);
+	t->keys[slot] = label;
+	t->offsets[slot] = (int32_t)t->size;
+	t->size += length;
+	++t->nKeys;
+	return t->offsets[slot];
+}
+
+
+/******* Writing ****************************************************/
+
+/**
+ * Compute a topological order of the poset using Kahn's algorithm.
+ * Returns NULL if the poset contains a cycle.
+ */
+static int32_t* topologicalOrderOfPoset(struct Graph* poset) {
+	int32_t* order = malloc(poset->n * sizeof(int32_t));
+	int* inDegree = calloc(poset->n, sizeof(int));
+	for (int v=0; v<poset->n; ++v) {
+		for (struct VertexList* e=poset->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+			++inDegree[e->endPoint->number];
+		}
+	}
+	int head = 0;
+	int tail = 0;
+	for (int v=0; v<poset->n; ++v) {
+		if (inDegree[v] == 0) {
+			order[tail++] = v;
+		}
+	}
+	while (head < tail) {
+		struct Vertex* v = poset->vertices[order[head++]];
+		for (struct VertexList* e=v->neighborhood; e!=NULL; e=e->next) {
+			if (--inDegree[e->endPoint->number] == 0) {
+				order[tail++] = e->endPoint->number;
+			}
+		}
+	}
+	free(inDegree);
+	if (tail != poset->n) {
+		free(order);
+		return NULL;
+	}
+	return order;
+}
+
+/**
+ * Minhash permutations do not store their length, but each position of each permutation appears exactly
+ * once in the evaluation order. Path covers store their length in the first entry.
+ */
+static int32_t* getPathLengths(PlanType type, struct EvaluationPlan p) {
+	int32_t* lengths = calloc(p.sketchSize, sizeof(int32_t));
+	if (type == MINHASH_PLAN) {
+		for (size_t i=0; i<p.orderLength; ++i) {
+			if ((int32_t)p.order[i].level + 1 > lengths[p.order[i].permutation]) {
+				lengths[p.order[i].permutation] = (int32_t)p.order[i].level + 1;
+			}
+		}
+	} else {
+		for (size_t i=0; i<p.sketchSize; ++i) {
+			lengths[i] = p.shrunkPermutations[i][0];
+		}
+	}
+	return lengths;
+}
+
+static int writeInts(const int32_t* data, size_t n, FILE* out) {
+	return fwrite(data, sizeof(int32_t), n, out) == n;
+}
+
+/**
+ * Write the pattern poset of p, together with the additional information specified by type, to filename.
+ * Returns 1 on success and 0 on failure. Error messages are printed to stderr.
+ */
+int writeEvaluationPlan(char* filename, PlanType type, struct EvaluationPlan p, int* projection, size_t projectionSize) {
+	struct Graph* poset = p.poset;
+	struct PlanFileHeader header;
+	memset(&header, 0, sizeof(struct PlanFileHeader));
+	strcpy(header.magic, PLAN_MAGIC);
+	header.version = PLAN_VERSION;
+	header.type = type;
+	header.posetSize = poset->n;
+
+	int32_t* topologicalOrder = topologicalOrderOfPoset(poset);
+	if (topologicalOrder == NULL) {
+		fprintf(stderr, "Pattern poset contains a cycle. Evaluation plan was not written.\n");
+		return 0;
+	}
+
+	// count sizes of sections
+	for (int v=0; v<poset->n; ++v) {
+		header.nPosetEdges += degree(poset->vertices[v]);
+	}
+	for (int i=1; i<poset->n; ++i) {
+		struct Graph* pattern = (struct Graph*)poset->vertices[i]->label;
+		header.nPatternVertices += pattern->n;
+		for (int v=0; v<pattern->n; ++v) {
+			header.nAdjacencies += degree(pattern->vertices[v]);
+		}
+	}
+
+	int32_t* pathLengths = NULL;
+	if ((type == MINHASH_PLAN) || (type == PATHCOVER_PLAN)) {
+		header.nPaths = (int32_t)p.sketchSize;
+		pathLengths = getPathLengths(type, p);
+		for (int32_t i=0; i<header.nPaths; ++i) {
+			header.pathDataLength += pathLengths[i];
+		}
+	}
+	if (type == MINHASH_PLAN) {
+		header.orderLength = (int32_t)p.orderLength;
+	}
+	if (type == PROJECTION_PLAN) {
+		header.projectionSize = (int32_t)projectionSize;
+	}
+
+	// flatten graphs
+	struct StringTable strings;
+	initStringTable(&strings);
+
+	int32_t* patternInfo = malloc(4 * (poset->n - 1) * sizeof(int32_t));
+	int32_t* vertexInfo = malloc(2 * header.nPatternVertices * sizeof(int32_t));
+	int32_t* adjacency = malloc(2 * header.nAdjacencies * sizeof(int32_t));
+	size_t vPos = 0;
+	size_t aPos = 0;
+	for (int i=1; i<poset->n; ++i) {
+		struct Graph* pattern = (struct Graph*)poset->vertices[i]->label;
+		patternInfo[4 * (i-1)] = pattern->number;
+		patternInfo[4 * (i-1) + 1] = pattern->activity;
+		patternInfo[4 * (i-1) + 2] = pattern->n;
+		patternInfo[4 * (i-1) + 3] = pattern->m;
+		for (int v=0; v<pattern->n; ++v) {
+			vertexInfo[vPos++] = internString(&strings, pattern->vertices[v]->label);
+			vertexInfo[vPos++] = degree(pattern->vertices[v]);
+			for (struct VertexList* e=pattern->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+				adjacency[aPos++] = e->endPoint->number;
+				adjacency[aPos++] = internString(&strings, e->label);
+			}
+		}
+	}
+
+	int32_t* posetDegrees = malloc(poset->n * sizeof(int32_t));
+	int32_t* posetEdges = malloc(header.nPosetEdges * sizeof(int32_t));
+	size_t ePos = 0;
+	for (int v=0; v<poset->n; ++v) {
+		posetDegrees[v] = degree(poset->vertices[v]);
+		for (struct VertexList* e=poset->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+			posetEdges[ePos++] = e->endPoint->number;
+		}
+	}
+
+	int32_t* order = malloc(2 * header.orderLength * sizeof(int32_t));
+	for (int32_t i=0; i<header.orderLength; ++i) {
+		order[2 * i] = (int32_t)p.order[i].level;
+		order[2 * i + 1] = (int32_t)p.order[i].permutation;
+	}
+
+	header.stringTableSize = (int32_t)strings.size;
+
+	// write everything
+	int success = 0;
+	FILE* out = fopen(filename, "wb");
+	if (out) {
+		success = fwrite(&header, sizeof(struct PlanFileHeader), 1, out) == 1;
+		success = success && writeInts(patternInfo, 4 * (poset->n - 1), out);
+		success = success && writeInts(vertexInfo, 2 * header.nPatternVertices, out);
+		success = success && writeInts(adjacency, 2 * header.nAdjacencies, out);
+		success = success && writeInts(posetDegrees, poset->n, out);
+		success = success && writeInts(posetEdges, header.nPosetEdges, out);
+		success = success && writeInts(topologicalOrder, poset->n, out);
+		success = success && writeInts(pathLengths, header.nPaths, out);
+		for (int32_t i=0; i<header.nPaths; ++i) {
+			success = success && writeInts(p.shrunkPermutations[i], pathLengths[i], out);
+		}
+		success = success && writeInts(order, 2 * header.orderLength, out);
+		success = success && writeInts(projection, header.projectionSize, out);
+		success = success && (fwrite(strings.data, 1, strings.size, out) == strings.size);
+		success = (fclose(out) == 0) && success;
+	}
+	if (!success) {
+		fprintf(stderr, "Could not write evaluation plan to %s\n", filename);
+	}
+
+	free(patternInfo);
+	free(vertexInfo);
+	free(adjacency);
+	free(posetDegrees);
+	free(posetEdges);
+	free(topologicalOrder);
+	free(pathLengths);
+	free(order);
+	freeStringTable(&strings);
+	return success;
+}
+
+
+/******* Loading ****************************************************/
+
+static char* labelAt(char* strings, int32_t offset) {
+	return offset == -1 ? NULL : strings + offset;
+}
+
+static int isValidLabelOffset(struct PlanFileHeader* header, int32_t offset) {
+	return (offset == -1) || ((offset >= 0) && (offset < header->stringTableSize));
+}
+
+/**
+ * Check that the sections announced in the header are nonnegative and fit into the file.
+ */
+static int checkPlanFile(struct PlanFileHeader* header, size_t fileSize) {
+	if ((fileSize < sizeof(struct PlanFileHeader))
+			|| (strncmp(header->magic, PLAN_MAGIC, 8) != 0)
+			|| (header->version != PLAN_VERSION)
+			|| (header->type < POSET_PLAN)
+			|| (header->type > PROJECTION_PLAN)
+			|| (header->posetSize < 1)
+			|| (header->nPosetEdges < 0)
+			|| (header->nPatternVertices < 0)
+			|| (header->nAdjacencies < 0)
+			|| (header->nPaths < 0)
+			|| (header->pathDataLength < 0)
+			|| (header->orderLength < 0)
+			|| (header->projectionSize < 0)
+			|| (header->stringTableSize < 0)) {
+		return 0;
+	}
+	size_t nInts = 4 * (size_t)(header->posetSize - 1)
+			+ 2 * (size_t)header->nPatternVertices
+			+ 2 * (size_t)header->nAdjacencies
+			+ 2 * (size_t)header->posetSize
+			+ (size_t)header->nPosetEdges
+			+ (size_t)header->nPaths
+			+ (size_t)header->pathDataLength
+			+ 2 * (size_t)header->orderLength
+			+ (size_t)header->projectionSize;
+	return sizeof(struct PlanFileHeader) + nInts * sizeof(int32_t) + (size_t)header->stringTableSize == fileSize;
+}
+
+static int32_t findComponent(int32_t* component, int32_t v) {
+	while (component[v] != v) {
+		component[v] = component[component[v]];
+		v = component[v];
+	}
+	return v;
+}
+
+/**
+ * Check that the n pattern vertices in vertexInfo, whose adjacencies start at adjacency, form a tree with m edges
+ * that stores each edge in both directions with the same label. The embedding operators rely on this.
+ * The end points of the adjacencies are expected to be checked already.
+ */
+static int isStoredTree(int32_t n, int32_t m, int32_t* vertexInfo, int32_t* adjacency) {
+	if ((n < 1) || (m != n - 1)) {
+		return 0;
+	}
+	int32_t* first = malloc((n + 1) * sizeof(int32_t));
+	int32_t* component = malloc(n * sizeof(int32_t));
+	first[0] = 0;
+	for (int32_t v=0; v<n; ++v) {
+		first[v+1] = first[v] + vertexInfo[2 * v + 1];
+		component[v] = v;
+	}
+
+	int valid = (first[n] == 2 * m);
+	for (int32_t v=0; valid && (v<n); ++v) {
+		for (int32_t j=first[v]; valid && (j<first[v+1]); ++j) {
+			int32_t w = adjacency[2 * j];
+			int reverseFound = 0;
+			for (int32_t k=first[w]; k<first[w+1]; ++k) {
+				if ((adjacency[2 * k] == v) && (adjacency[2 * k + 1] == adjacency[2 * j + 1])) {
+					reverseFound = 1;
+					break;
+				}
+			}
+			valid = (w != v) && reverseFound;
+			component[findComponent(component, v)] = findComponent(component, w);
+		}
+	}
+	// n - 1 edges connect all vertices iff there is no cycle and no duplicate edge
+	for (int32_t v=1; valid && (v<n); ++v) {
+		valid = (findComponent(component, v) == findComponent(component, 0));
+	}
+
+	free(first);
+	free(component);
+	return valid;
+}
+
+/**
+ * Check that all counts stored in the sections add up to the header, that all indices point into
+ * the pattern, poset, path, or string table they refer to, that all patterns are trees, and that
+ * topologicalOrder is a permutation of the poset vertices. On success, position[v] is set to the index of v in topologicalOrder.
+ */
+static int checkPlanSections(struct PlanFileHeader* header, int32_t* patternInfo, int32_t* vertexInfo, int32_t* adjacency,
+		int32_t* posetDegrees, int32_t* posetEdges, int32_t* topologicalOrder, int32_t* pathLengths, int32_t* pathData,
+		int32_t* order, int32_t* storedProjection, char* strings, int* position) {
+
+	// labels are zero terminated inside the string table
+	if ((header->stringTableSize > 0) && (strings[header->stringTableSize - 1] != '\0')) {
+		return 0;
+	}
+
+	// patterns
+	int64_t nVertices = 0;
+	int64_t nAdjacencies = 0;
+	int32_t* currentVertex = vertexInfo;
+	int32_t* currentAdjacency = adjacency;
+	for (int32_t i=1; i<header->posetSize; ++i) {
+		int32_t* info = patternInfo + 4 * (i-1);
+		if ((info[2] < 0) || (info[3] < 0) || (nVertices + info[2] > header->nPatternVertices)) {
+			return 0;
+		}
+		nVertices += info[2];
+		int32_t* patternVertices = currentVertex;
+		int32_t* patternAdjacency = currentAdjacency;
+		for (int32_t v=0; v<info[2]; ++v, currentVertex+=2) {
+			if (!isValidLabelOffset(header, currentVertex[0])
+					|| (currentVertex[1] < 0)
+					|| (nAdjacencies + currentVertex[1] > header->nAdjacencies)) {
+				return 0;
+			}
+			nAdjacencies += currentVertex[1];
+			for (int32_t j=0; j<currentVertex[1]; ++j, currentAdjacency+=2) {
+				if ((currentAdjacency[0] < 0) || (currentAdjacency[0] >= info[2]) || !isValidLabelOffset(header, currentAdjacency[1])) {
+					return 0;
+				}
+			}
+		}
+		if (!isStoredTree(info[2], info[3], patternVertices, patternAdjacency)) {
+			return 0;
+		}
+	}
+	if ((nVertices != header->nPatternVertices) || (nAdjacencies != header->nAdjacencies)) {
+		return 0;
+	}
+
+	// poset
+	int64_t nPosetEdges = 0;
+	for (int32_t v=0; v<header->posetSize; ++v) {
+		if ((posetDegrees[v] < 0) || (nPosetEdges + posetDegrees[v] > header->nPosetEdges)) {
+			return 0;
+		}
+		nPosetEdges += posetDegrees[v];
+	}
+	if (nPosetEdges != header->nPosetEdges) {
+		return 0;
+	}
+	for (int32_t i=0; i<header->nPosetEdges; ++i) {
+		if ((posetEdges[i] < 0) || (posetEdges[i] >= header->posetSize)) {
+			return 0;
+		}
+	}
+	for (int32_t v=0; v<header->posetSize; ++v) {
+		position[v] = -1;
+	}
+	for (int32_t i=0; i<header->posetSize; ++i) {
+		int32_t v = topologicalOrder[i];
+		if ((v < 0) || (v >= header->posetSize) || (position[v] != -1)) {
+			return 0;
+		}
+		position[v] = i;
+	}
+
+	// paths and projections store patterns, i.e. poset vertices other than the root 0.
+	// path covers additionally store their length in the first entry
+	int64_t pathDataLength = 0;
+	for (int32_t i=0; i<header->nPaths; ++i) {
+		if ((pathLengths[i] < 0) || (pathDataLength + pathLengths[i] > header->pathDataLength)) {
+			return 0;
+		}
+		int32_t* path = pathData + pathDataLength;
+		int32_t first = 0;
+		if (header->type == PATHCOVER_PLAN) {
+			if ((pathLengths[i] < 1) || (path[0] != pathLengths[i])) {
+				return 0;
+			}
+			first = 1;
+		}
+		for (int32_t j=first; j<pathLengths[i]; ++j) {
+			if ((path[j] < 1) || (path[j] >= header->posetSize)) {
+				return 0;
+			}
+		}
+		pathDataLength += pathLengths[i];
+	}
+	if (pathDataLength != header->pathDataLength) {
+		return 0;
+	}
+	for (int32_t i=0; i<header->orderLength; ++i) {
+		int32_t level = order[2 * i];
+		int32_t permutation = order[2 * i + 1];
+		if ((permutation < 0) || (permutation >= header->nPaths) || (level < 0) || (level >= pathLengths[permutation])) {
+			return 0;
+		}
+	}
+	for (int32_t i=0; i<header->projectionSize; ++i) {
+		if ((storedProjection[i] < 1) || (storedProjection[i] >= header->posetSize)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * Map filename into memory and rebuild the evaluation plan stored in it.
+ *
+ * p receives poset, reverse poset, and (depending on the type of the plan) shrunk permutations or paths
+ * and the minhash evaluation order. If the plan stores a random projection, *projection is set to a
+ * malloc'd copy of it. All of this can be freed as usual by dumpEvaluationPlan() and free().
+ * Afterwards, call releasePlanFile() on the returned handle.
+ *
+ * On error, the returned handle has data == NULL and an error message is printed to stderr.
+ */
+struct PlanFile loadEvaluationPlan(char* filename, struct EvaluationPlan* p, int** projection, size_t* projectionSize, struct GraphPool* gp) {
+	struct PlanFile f = {0};
+
+	int fd = open(filename, O_RDONLY);
+	if (fd == -1) {
+		fprintf(stderr, "Could not open evaluation plan file %s\n", filename);
+		return f;
+	}
+	struct stat fileInfo;
+	if ((fstat(fd, &fileInfo) == -1) || (fileInfo.st_size == 0)) {
+		fprintf(stderr, "Could not read evaluation plan file %s\n", filename);
+		close(fd);
+		return f;
+	}
+	void* data = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		fprintf(stderr, "Could not map evaluation plan file %s\n", filename);
+		return f;
+	}
+
+	struct PlanFileHeader* header = (struct PlanFileHeader*)data;
+	if (!checkPlanFile(header, fileInfo.st_size)) {
+		fprintf(stderr, "%s is not a valid evaluation plan file\n", filename);
+		munmap(data, fileInfo.st_size);
+		return f;
+	}
+
+	int32_t* patternInfo = (int32_t*)(header + 1);
+	int32_t* vertexInfo = patternInfo + 4 * (header->posetSize - 1);
+	int32_t* adjacency = vertexInfo + 2 * header->nPatternVertices;
+	int32_t* posetDegrees = adjacency + 2 * header->nAdjacencies;
+	int32_t* posetEdges = posetDegrees + header->posetSize;
+	int32_t* topologicalOrder = posetEdges + header->nPosetEdges;
+	int32_t* pathLengths = topologicalOrder + header->posetSize;
+	int32_t* pathData = pathLengths + header->nPaths;
+	int32_t* order = pathData + header->pathDataLength;
+	int32_t* storedProjection = order + 2 * header->orderLength;
+	char* strings = (char*)(storedProjection + header->projectionSize);
+
+	int* position = malloc(header->posetSize * sizeof(int));
+	if (!checkPlanSections(header, patternInfo, vertexInfo, adjacency, posetDegrees, posetEdges, topologicalOrder,
+			pathLengths, pathData, order, storedProjection, strings, position)) {
+		fprintf(stderr, "%s is not a valid evaluation plan file\n", filename);
+		free(position);
+		munmap(data, fileInfo.st_size);
+		return f;
+	}
+
+	// check that the poset is consistent with its topological order
+	int32_t* target = posetEdges;
+	for (int32_t v=0; v<header->posetSize; ++v) {
+		for (int32_t j=0; j<posetDegrees[v]; ++j, ++target) {
+			if (position[*target] <= position[v]) {
+				fprintf(stderr, "Pattern poset in %s contradicts its topological order\n", filename);
+				free(position);
+				munmap(data, fileInfo.st_size);
+				return f;
+			}
+		}
+	}
+	free(position);
+
+	// rebuild patterns. their labels point into the mapped file
+	struct Graph* poset = createGraph(header->posetSize, gp);
+	int32_t* currentVertex = vertexInfo;
+	int32_t* currentAdjacency = adjacency;
+	for (int32_t i=1; i<header->posetSize; ++i) {
+		int32_t* info = patternInfo + 4 * (i-1);
+		struct Graph* pattern = createGraph(info[2], gp);
+		pattern->number = info[0];
+		pattern->activity = info[1];
+		pattern->m = info[3];
+		for (int v=0; v<pattern->n; ++v, currentVertex+=2) {
+			struct Vertex* vertex = pattern->vertices[v];
+			vertex->label = labelAt(strings, currentVertex[0]);
+			// push in reverse to reproduce the stored list order
+			for (int j=currentVertex[1]-1; j>=0; --j) {
+				struct VertexList* e = getVertexList(gp->listPool);
+				e->startPoint = vertex;
+				e->endPoint = pattern->vertices[currentAdjacency[2 * j]];
+				e->label = labelAt(strings, currentAdjacency[2 * j + 1]);
+				addEdge(vertex, e);
+			}
+			currentAdjacency += 2 * currentVertex[1];
+		}
+		poset->vertices[i]->label = (char*)pattern; // misuse of char* pointer
+	}
+
+	// rebuild poset
+	target = posetEdges;
+	for (int32_t v=0; v<header->posetSize; ++v) {
+		for (int j=posetDegrees[v]-1; j>=0; --j) {
+			struct VertexList* e = getVertexList(gp->listPool);
+			e->startPoint = poset->vertices[v];
+			e->endPoint = poset->vertices[target[j]];
+			addEdge(e->startPoint, e);
+		}
+		target += posetDegrees[v];
+	}
+	poset->m = header->nPosetEdges;
+
+	p->poset = poset;
+	p->reversePoset = reverseGraph(poset, gp);
+	p->sketchSize = header->nPaths;
+	p->shrunkPermutations = NULL;
+	p->order = NULL;
+	p->orderLength = header->orderLength;
+
+	// copy paths and order, as they are freed by dumpEvaluationPlan
+	if (header->nPaths > 0) {
+		p->shrunkPermutations = malloc(header->nPaths * sizeof(int*));
+		int32_t* path = pathData;
+		for (int32_t i=0; i<header->nPaths; ++i) {
+			p->shrunkPermutations[i] = malloc(pathLengths[i] * sizeof(int));
+			memcpy(p->shrunkPermutations[i], path, pathLengths[i] * sizeof(int));
+			path += pathLengths[i];
+		}
+	}
+	if (header->orderLength > 0) {
+		p->order = malloc(header->orderLength * sizeof(struct PosPair));
+		for (int32_t i=0; i<header->orderLength; ++i) {
+			p->order[i].level = order[2 * i];
+			p->order[i].permutation = order[2 * i + 1];
+		}
+	}
+	*projectionSize = header->projectionSize;
+	if (header->projectionSize > 0) {
+		*projection = malloc(header->projectionSize * sizeof(int));
+		memcpy(*projection, storedProjection, header->projectionSize * sizeof(int));
+	}
+
+	f.data = data;
+	f.size = fileInfo.st_size;
+	f.type = header->type;
+	return f;
+}
+
+
+/**
+ * Unmap a plan file. Call this only after all graphs of the plan have been dumped.
+ */
+void releasePlanFile(struct PlanFile f) {
+	if (f.data != NULL) {
+		munmap(f.data, f.size);
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef POSET_PERSISTENCE_H_
+#define POSET_PERSISTENCE_H_
+
+#include <stddef.h>
+
+#include "graph.h"
+#include "minhashing.h"
+
+/**
+ * What an evaluation plan file contains in addition to the pattern poset.
+ * gpe methods check that a loaded plan was built for them.
+ */
+typedef enum {
+	POSET_PLAN = 0,      // patterns and poset only
+	MINHASH_PLAN = 1,    // shrunk permutations and evaluation order
+	PATHCOVER_PLAN = 2,  // static path cover of the poset
+	PROJECTION_PLAN = 3  // random projection pattern ids
+} PlanType;
+
+/**
+ * Handle to a memory mapped evaluation plan file.
+ * The label strings of all loaded patterns point into the mapped region,
+ * hence it must stay alive until the plan is dumped.
+ */
+struct PlanFile {
+	void* data;
+	size_t size;
+	PlanType type;
+};
+
+int writeEvaluationPlan(char* filename, PlanType type, struct EvaluationPlan p, int* projection, size_t projectionSize);
+struct PlanFile loadEvaluationPlan(char* filename, struct EvaluationPlan* p, int** projection, size_t* projectionSize, struct GraphPool* gp);
+void releasePlanFile(struct PlanFile f);
+
+#endif /* POSET_PERSISTENCE_H_ */
@@ -118,6 +118,80 @@ def load_svmlight_files(files, n_features=None, dtype=None, buffer_mb=40):
     return result
 
 
+_SPARSE_MAGIC = b"GMTCSR\0\0"
+
+
+def load_sparse_features(file_path, n_features=None, dtype=None,
+                         zero_based="auto"):
+    """Load a binary sparse feature file into sparse CSR matrix
+
+    The binary format is written by lwg, lwgr, gpe, and ts with -b and by
+    cpk and tpk with -featureFormat binary (see sparseFeatureWriter.c). The
+    file is read with a few calls to np.fromfile without any parsing.
+
+    The keys of the rows are the class labels of the graphs (cpk, tpk, ts,
+    gpe) or the ids of the patterns (lwg, lwgr). Files without values (lwg,
+    lwgr) result in a binary matrix.
+
+    Parameters
+    ----------
+    file_path: str
+        Path to a file to load.
+
+    n_features: int or None
+        The number of features to use. If None, it will be inferred.
+
+    zero_based: boolean or "auto"
+        Whether column indices in the file are zero-based (True) or
+        one-based (False). If "auto", they are assumed to be one-based
+        if there is no zero column index.
+
+    Returns
+    -------
+    (X, y)
+
+    where X is a scipy.sparse matrix of shape (n_samples, n_features),
+          y is a ndarray of shape (n_samples,) containing the row keys.
+    """
+    with open(file_path, "rb") as f:
+        if f.read(8) != _SPARSE_MAGIC:
+            raise ValueError("%s is not a binary sparse feature file" % file_path)
+        version, has_values = np.fromfile(f, dtype=np.int32, count=2)
+        if version != 1:
+            raise ValueError("unsupported version %i of %s" % (version, file_path))
+
+        f.seek(-24, os.SEEK_END)
+        n_rows, n_entries = np.fromfile(f, dtype=np.int64, count=2)
+        if f.read(8) != _SPARSE_MAGIC:
+            raise ValueError("%s is truncated" % file_path)
+
+        f.seek(16)
+        if has_values:
+            entries = np.fromfile(f, dtype=np.int32, count=2 * n_entries)
+            indices = entries[0::2].copy()
+            data = entries[1::2].astype(dtype or np.float64)
+        else:
+            indices = np.fromfile(f, dtype=np.int32, count=n_entries)
+            data = np.ones(n_entries, dtype=dtype or np.float64)
+        labels = np.fromfile(f, dtype=np.int32, count=n_rows)
+        if n_rows % 2:
+            f.seek(4, os.SEEK_CUR)
+        indptr = np.fromfile(f, dtype=np.int64, count=n_rows + 1)
+
+    if zero_based is False or \
+       (zero_based == "auto" and n_entries > 0 and np.min(indices) > 0):
+        indices -= 1
+
+    if n_features is not None:
+        shape = (n_rows, n_features)
+    else:
+        shape = None    # inferred
+
+    X = sp.csr_matrix((data, indices, indptr), shape)
+
+    return (X, labels.astype(np.float64))
+
+
 def dump_svmlight_file(X, y, f, zero_based=True):
     """Dump the dataset in svmlight / libsvm file format.
 
@@ -5,75 +5,59 @@
  *      Author: pascal
  */
 
-#include <float.h>
 #include <stdlib.h>
 #include <math.h>
 #include <limits.h>
 
 #include "loading.h"
+#include "randomNumberGenerator.h"
 #include "randomGraphGenerators.h"
 
 // Utility Functions
 
 /**
- * Box-Muller Transform to create two normally distributed values.
+ * Create two normally distributed values, see randomGaussianPair().
  * We are happy that two are generated, as we are interested in moving 2-d points
  * in our geometric threshold graphs and return both values right away.
  *
- * Source: https://en.wikipedia.org/wiki/Box%E2%80%93Muller_transform
- *
- * Uses rand() 2 times
+ * Draws one pair from rng
  */
-void generateGaussianNoise(double* z0, double* z1, double mu, double sigma) {
-	static const double epsilon = DBL_EPSILON;
-	static const double two_pi = 2.0*3.14159265358979323846;
-
-	double u1, u2;
-	do {
-		u1 = rand() * (1.0 / RAND_MAX);
-		u2 = rand() * (1.0 / RAND_MAX);
-	} while ( u1 <= epsilon );
-
-	*z0 = sqrt(-2.0 * log(u1)) * cos(two_pi * u2) * sigma + mu;
-	*z1 = sqrt(-2.0 * log(u1)) * sin(two_pi * u2) * sigma + mu;
+void generateGaussianNoise(double* z0, double* z1, double mu, double sigma, struct RandomNumberGenerator* rng) {
+	double n0, n1;
+	randomGaussianPair(rng, &n0, &n1);
+
+	*z0 = n0 * sigma + mu;
+	*z1 = n1 * sigma + mu;
 }
 
 
 /**
- * Box-Muller Transform to create two normally distributed values.
+ * Create two normally distributed values, see randomGaussianPair().
  * We are happy that two are generated, as we are interested in moving 2-d points
  * in our geometric threshold graphs and return both values right away.
  *
  * mu (i.e., the mean is given by the initialized values of the two double in/out variables
  *
- * Source: https://en.wikipedia.org/wiki/Box%E2%80%93Muller_transform
- *
- * Uses rand() 2 times
+ * Draws one pair from rng
  */
-void generateIntegerGaussianNoise(int* z0, int* z1, double sigma) {
-	static const double epsilon = DBL_EPSILON;
-	static const double two_pi = 2.0*3.14159265358979323846;
-
-	double u1, u2;
-	do {
-		u1 = rand() * (1.0 / RAND_MAX);
-		u2 = rand() * (1.0 / RAND_MAX);
-	} while ( u1 <= epsilon );
-
-	*z0 = *z0 + (sqrt(-2.0 * log(u1)) * cos(two_pi * u2) * sigma) * RAND_MAX;
-	*z1 = *z1 + (sqrt(-2.0 * log(u1)) * sin(two_pi * u2) * sigma) * RAND_MAX;
+void generateIntegerGaussianNoise(int* z0, int* z1, double sigma, struct RandomNumberGenerator* rng) {
+	double n0, n1;
+	randomGaussianPair(rng, &n0, &n1);
+
+	*z0 = *z0 + (n0 * sigma) * RAND_MAX;
+	*z1 = *z1 + (n1 * sigma) * RAND_MAX;
 }
 
 
 /**
  * Randomly assign vertex labels from 0 to nVertexLabels-1 to the vertices.
  *
- * Uses rand() g->n times
+ * Uses rng g->n times
  */
-void randomVertexLabels(struct Graph* g, int nVertexLabels) {
+void randomVertexLabels(struct Graph* g, int nVertexLabels, struct RandomNumberGenerator* rng) {
 	int i;
 	for (i=0; i<g->n; ++i) {
-		g->vertices[i]->label = intLabel(rand() % nVertexLabels);
+		g->vertices[i]->label = intLabel(randomIntBelow(rng, nVertexLabels));
 		g->vertices[i]->isStringMaster = 1;
 	}
 }
@@ -101,13 +85,13 @@ void makeMinDegree1(struct Graph* g, struct GraphPool* gp) {
  * The returned graph will have exactly n vertices and the probability of any edge being present is p.
  * Note that vertices and edges have NULL labels.
  *
- * Uses rand() n * (n-1) / 2 times
+ * Uses rng n * (n-1) / 2 times
  */
-struct Graph* erdosRenyi(int n, double p, struct GraphPool* gp) {
+struct Graph* erdosRenyi(int n, double p, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	struct Graph* g = createGraph(n, gp);
 	for (int i=0; i<n; ++i) {
 		for (int j=i+1; j<n; ++j) {
-			double value = rand() / (RAND_MAX + 1.0);
+			double value = randomDouble(rng);
 			if (value < p) {
 				addEdgeBetweenVertices(i, j, NULL, g, gp);
 			}
@@ -121,18 +105,18 @@ struct Graph* erdosRenyi(int n, double p, struct GraphPool* gp) {
 * The returned graph will have exactly n vertices and the probability of any edge being present is p.
 * Vertices and edges have int labels that are in the specified ranges.
 *
-* Uses rand() n * (n-1) / 2 + n + m times
+* Uses rng n * (n-1) / 2 + n + m times
  */
-struct Graph* erdosRenyiWithLabels(int n, double p, int nVertexLabels, int nEdgeLabels, struct GraphPool* gp) {
+struct Graph* erdosRenyiWithLabels(int n, double p, int nVertexLabels, int nEdgeLabels, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	struct Graph* g = createGraph(n, gp);
-	randomVertexLabels(g, nVertexLabels);
+	randomVertexLabels(g, nVertexLabels, rng);
 
 	for (int i=0; i<n; ++i) {
 		for (int j=i+1; j<n; ++j) {
-			double value = rand() / (RAND_MAX + 1.0);
+			double value = randomDouble(rng);
 			if (value < p) {
 				// add a labeled edge and set one of the two resulting vertex lists as string master.
-				addEdgeBetweenVertices(i, j, intLabel(rand() % nEdgeLabels), g, gp);
+				addEdgeBetweenVertices(i, j, intLabel(randomIntBelow(rng, nEdgeLabels)), g, gp);
 				g->vertices[i]->neighborhood->isStringMaster = 1;
 			}
 		}
@@ -155,9 +139,9 @@ struct Graph* erdosRenyiWithLabels(int n, double p, int nVertexLabels, int nEdge
  *
  * If nVertexLabels is smaller than 1, then the vertices will be injectively labeled.
  *
- * Uses rand()
+ * Uses rng
  */
-struct Graph* blockChainGenerator(int nBlocks, int blockSize, int nVertexLabels, int nEdgeLabels, double diagonalProbability, struct GraphPool* gp) {
+struct Graph* blockChainGenerator(int nBlocks, int blockSize, int nVertexLabels, int nEdgeLabels, double diagonalProbability, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 
 	// create empty graph of correct size
 	int nVertices = nBlocks * blockSize - nBlocks + 1;
@@ -170,20 +154,20 @@ struct Graph* blockChainGenerator(int nBlocks, int blockSize, int nVertexLabels,
 			g->vertices[v]->isStringMaster = 1;
 		}
 	} else {
-		randomVertexLabels(g, nVertexLabels);
+		randomVertexLabels(g, nVertexLabels, rng);
 	}
 
 	// add cycle edges
 	for (int blockStart=0; blockStart<nVertices-1; blockStart+=blockSize-1) {
 		for (int v=blockStart; v<blockStart+blockSize; ++v) {
 			for (int w=v+1; w<blockStart+blockSize; ++w) {
-				if ((w - v == 1) || (rand() / ((double)RAND_MAX) <= diagonalProbability)) {
-					addEdgeBetweenVertices(v, w, intLabel(rand() % nEdgeLabels), g, gp);
+				if ((w - v == 1) || (randomInt(rng) / ((double)RAND_MAX) <= diagonalProbability)) {
+					addEdgeBetweenVertices(v, w, intLabel(randomIntBelow(rng, nEdgeLabels)), g, gp);
 				}
 			}
 		}
 		if (!isIncident(g->vertices[blockStart], g->vertices[blockStart+blockSize-1])) {
-			addEdgeBetweenVertices(blockStart, blockStart+blockSize-1, intLabel(rand() % nEdgeLabels), g, gp);
+			addEdgeBetweenVertices(blockStart, blockStart+blockSize-1, intLabel(randomIntBelow(rng, nEdgeLabels)), g, gp);
 		}
 	}
 	return g;
@@ -197,7 +181,7 @@ struct Graph* blockChainGenerator(int nBlocks, int blockSize, int nVertexLabels,
  *
  * The core is consumed.
  */
-struct Graph* barabasiAlpha(int n, int edgesAddedPerVertex, double alpha, struct Graph* core, struct GraphPool* gp) {
+struct Graph* barabasiAlpha(int n, int edgesAddedPerVertex, double alpha, struct Graph* core, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	// min degree of core needs to be 1
 	if ((getMinDegree(core) == 0) || (n < core->n) || (edgesAddedPerVertex > core->n)) {
 		return NULL;
@@ -230,15 +214,15 @@ struct Graph* barabasiAlpha(int n, int edgesAddedPerVertex, double alpha, struct
 	}
 
 	for (int v=core->n; v<n; ++v) {
-		if (rand() <= alpha * RAND_MAX) {
-			int w = rand() % v;
+		if (randomInt(rng) <= alpha * RAND_MAX) {
+			int w = randomIntBelow(rng, v);
 			addEdgeBetweenVertices(v, w, intLabel(1), g, gp);
 			g->vertices[v]->d += 1;
 			g->vertices[w]->d += 1;
 			g->vertices[v]->neighborhood->isStringMaster = 1;
 		} else {
 			for (int i=0; i<edgesAddedPerVertex; ++i) {
-				int randV = rand() % (2 * g->m);
+				int randV = randomIntBelow(rng, 2 * g->m);
 				int find = 0;
 				for (int w=0; w<v; ++w) {
 					find += g->vertices[w]->d;
@@ -259,7 +243,7 @@ struct Graph* barabasiAlpha(int n, int edgesAddedPerVertex, double alpha, struct
 }
 
 // core is consumed
-struct Graph* barabasiAlbert(int n, int edgesAddedPerVertex, struct Graph* core, struct GraphPool* gp) {
+struct Graph* barabasiAlbert(int n, int edgesAddedPerVertex, struct Graph* core, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	// min degree of core needs to be 1
 	if ((getMinDegree(core) == 0) || (n < core->n) || (edgesAddedPerVertex > core->n)) {
 		return NULL;
@@ -293,7 +277,7 @@ struct Graph* barabasiAlbert(int n, int edgesAddedPerVertex, struct Graph* core,
 
 	for (int v=core->n; v<n; ++v) {
 		for (int i=0; i<edgesAddedPerVertex; ++i) {
-			int randV = rand() % (2 * g->m);
+			int randV = randomIntBelow(rng, 2 * g->m);
 			int find = 0;
 			for (int w=0; w<v; ++w) {
 				find += g->vertices[w]->d;
@@ -350,13 +334,13 @@ void printOverlapGraphDotFormat(struct Graph* g, FILE* out) {
 /**
  * Create a graph
  */
-struct Graph* randomOverlapGraph(int n, double d, struct GraphPool* gp) {
+struct Graph* randomOverlapGraph(int n, double d, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	struct Graph* g = createGraph(n, gp);
 
 	// every vertex is a two-dimensional point
 	for (int v=0; v<n; ++v) {
-		g->vertices[v]->d = rand();
-		g->vertices[v]->lowPoint = rand();
+		g->vertices[v]->d = randomInt(rng);
+		g->vertices[v]->lowPoint = randomInt(rng);
 		g->vertices[v]->label = intLabel(1);
 	}
 	// add edge iff distance is smaller than d
@@ -374,14 +358,14 @@ struct Graph* randomOverlapGraph(int n, double d, struct GraphPool* gp) {
 /**
  * Create a graph
  */
-struct Graph* randomOverlapGraphWithLabels(int n, double d, int nVertexLabels, struct GraphPool* gp) {
+struct Graph* randomOverlapGraphWithLabels(int n, double d, int nVertexLabels, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	struct Graph* g = createGraph(n, gp);
 
 	// every vertex is a two-dimensional point
 	for (int v=0; v<n; ++v) {
-		g->vertices[v]->d = rand();
-		g->vertices[v]->lowPoint = rand();
-		g->vertices[v]->label = intLabel(rand() % nVertexLabels);
+		g->vertices[v]->d = randomInt(rng);
+		g->vertices[v]->lowPoint = randomInt(rng);
+		g->vertices[v]->label = intLabel(randomIntBelow(rng, nVertexLabels));
 	}
 	// add edge iff distance is smaller than d
 	for (int v=0; v<n; ++v) {
@@ -395,8 +379,8 @@ struct Graph* randomOverlapGraphWithLabels(int n, double d, int nVertexLabels, s
 }
 
 
-void moveVertexGaussian(struct Vertex* v, double moveParameter) {
-	generateIntegerGaussianNoise(&(v->d), &(v->lowPoint), moveParameter);
+void moveVertexGaussian(struct Vertex* v, double moveParameter, struct RandomNumberGenerator* rng) {
+	generateIntegerGaussianNoise(&(v->d), &(v->lowPoint), moveParameter, rng);
 	// mirror in unit interval
 	// stupid undefined behavior of abs(INT_MIN) requires to do it ourselves:
 	int a = v->d;
@@ -409,7 +393,7 @@ void moveVertexGaussian(struct Vertex* v, double moveParameter) {
 /**
  * Create a graph
  */
-struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nClusters, double mu, struct GraphPool* gp) {
+struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nClusters, double mu, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 
 	if (nClusters > n) {
 		fprintf(stderr, "Number of clusters is larger than number of vertices: %i > %i\n", nClusters, n);
@@ -428,8 +412,8 @@ struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nCluste
 	// every vertex is a two-dimensional point
 	int i=0;
 	for (int v=0; v<nClusters; ++v) {
-		g->vertices[i]->d = rand();
-		g->vertices[i]->lowPoint = rand();
+		g->vertices[i]->d = randomInt(rng);
+		g->vertices[i]->lowPoint = randomInt(rng);
 		g->vertices[i]->label = intLabel(v);
 		g->vertices[i]->isStringMaster = 1;
 		for (int w=1; w<nodesPerCluster; ++w) {
@@ -437,7 +421,7 @@ struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nCluste
 			g->vertices[i+w]->lowPoint = g->vertices[i]->lowPoint;
 			g->vertices[i+w]->label = intLabel(v);
 			g->vertices[i+w]->isStringMaster = 1;
-			moveVertexGaussian(g->vertices[i+w], mu);
+			moveVertexGaussian(g->vertices[i+w], mu, rng);
 		}
 		i += nodesPerCluster;
 	}
@@ -458,11 +442,11 @@ struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nCluste
 
 
 // Due to strangeness in A
-void moveOverlapGraph(struct Graph* g, double moveParameter, double d, struct GraphPool* gp) {
+void moveOverlapGraph(struct Graph* g, double moveParameter, double d, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 
 	// move vertices
 	for (int v=0; v<g->n; ++v) {
-		moveVertexGaussian(g->vertices[v], moveParameter);
+		moveVertexGaussian(g->vertices[v], moveParameter, rng);
 	}
 
 	// dump edges
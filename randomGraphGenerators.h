@@ -9,10 +9,11 @@
 #define RANDOMGRAPHGENERATORS_H_
 
 #include "graph.h"
+#include "randomNumberGenerator.h"
 
-void generateGaussianNoise(double* z0, double* z1, double mu, double sigma);
-void generateIntegerGaussianNoise(int* z0, int* z1, double sigma);
-void randomVertexLabels(struct Graph* g, int nVertexLabels);
+void generateGaussianNoise(double* z0, double* z1, double mu, double sigma, struct RandomNumberGenerator* rng);
+void generateIntegerGaussianNoise(int* z0, int* z1, double sigma, struct RandomNumberGenerator* rng);
+void randomVertexLabels(struct Graph* g, int nVertexLabels, struct RandomNumberGenerator* rng);
 void makeMinDegree1(struct Graph* g, struct GraphPool* gp);
 double euclideanDistanceWrap(const int v, const int w, struct Graph* g);
 double euclideanDistance(const int vx, const int vy, const int wx, const int wy);
@@ -20,18 +21,18 @@ void printOverlapGraphDotFormat(struct Graph* g, FILE* out);
 
 
 
-struct Graph* erdosRenyi(int n, double p, struct GraphPool* gp);
-struct Graph* erdosRenyiWithLabels(int n, double p, int nVertexLabels, int nEdgeLabels, struct GraphPool* gp);
+struct Graph* erdosRenyi(int n, double p, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+struct Graph* erdosRenyiWithLabels(int n, double p, int nVertexLabels, int nEdgeLabels, struct RandomNumberGenerator* rng, struct GraphPool* gp);
 
-struct Graph* barabasiAlbert(int n, int edgesAddedPerVertex, struct Graph* core, struct GraphPool* gp);
-struct Graph* barabasiAlpha(int n, int edgesAddedPerVertex, double alpha, struct Graph* core, struct GraphPool* gp);
+struct Graph* barabasiAlbert(int n, int edgesAddedPerVertex, struct Graph* core, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+struct Graph* barabasiAlpha(int n, int edgesAddedPerVertex, double alpha, struct Graph* core, struct RandomNumberGenerator* rng, struct GraphPool* gp);
 
-struct Graph* blockChainGenerator(int nBlocks, int blockSize, int nVertexLabels, int nEdgeLabels, double diagonalProbability, struct GraphPool* gp);
+struct Graph* blockChainGenerator(int nBlocks, int blockSize, int nVertexLabels, int nEdgeLabels, double diagonalProbability, struct RandomNumberGenerator* rng, struct GraphPool* gp);
 
-struct Graph* randomOverlapGraph(int n, double d, struct GraphPool* gp);
-struct Graph* randomOverlapGraphWithLabels(int n, double d, int nVertexLabels, struct GraphPool* gp);
-struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nClusters, double mu, struct GraphPool* gp);
-void moveOverlapGraph(struct Graph* g, double moveParameter, double d, struct GraphPool* gp);
+struct Graph* randomOverlapGraph(int n, double d, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+struct Graph* randomOverlapGraphWithLabels(int n, double d, int nVertexLabels, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+struct Graph* randomClusteredOverlapGraphWithLabels(int n, double d, int nClusters, double mu, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+void moveOverlapGraph(struct Graph* g, double moveParameter, double d, struct RandomNumberGenerator* rng, struct GraphPool* gp);
 
 
 #endif /* RANDOMGRAPHGENERATORS_H_ */
@@ -0,0 +1,252 @@
+/**
+ * Reentrant pseudo random numbers for the sampling algorithms.
+ *
+ * The generator is xoshiro256** by Blackman and Vigna (http://prng.di.unimi.it/), seeded by splitmix64.
+ * Bounded integers are unbiased, using the multiply and reject method of Lemire ("Fast Random Integer
+ * Generation in an Interval", 2019). Normally distributed values are generated by the polar method.
+ *
+ * Code that cannot pass a generator through its call chain (e.g. functions that are called via function
+ * pointers with a fixed signature) uses threadRandomNumberGenerator(), which returns a generator for the
+ * calling thread. These are independent streams of a master generator that is seeded by
+ * seedRandomNumberGenerators().
+ */
+
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "randomNumberGenerator.h"
+
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+
+static uint64_t splitMix64(uint64_t* x) {
+	uint64_t z = (*x += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+
+/**
+ * Initialize rng with the xoshiro256** state derived from seed.
+ */
+void seedRandomNumberGenerator(struct RandomNumberGenerator* rng, uint64_t seed) {
+	for (int i=0; i<4; ++i) {
+		rng->state[i] = splitMix64(&seed);
+	}
+	rng->legacy = 0;
+	rng->hasGaussian = 0;
+	rng->gaussian = 0.0;
+}
+
+
+/**
+ * Initialize rng as legacy generator, see struct RandomNumberGenerator. This calls srand(seed).
+ */
+void seedLegacyRandomNumberGenerator(struct RandomNumberGenerator* rng, unsigned int seed) {
+	seedRandomNumberGenerator(rng, seed);
+	rng->legacy = 1;
+	srand(seed);
+}
+
+
+/**
+ * Advance rng by 2^128 steps. Hence, 2^128 calls to randomUint64() of the state before the jump
+ * do not overlap with the sequence that starts after the jump.
+ */
+void jumpRandomNumberGenerator(struct RandomNumberGenerator* rng) {
+	static const uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+	uint64_t s[4] = {0, 0, 0, 0};
+
+	for (int i=0; i<4; ++i) {
+		for (int b=0; b<64; ++b) {
+			if (JUMP[i] & ((uint64_t)1 << b)) {
+				for (int j=0; j<4; ++j) {
+					s[j] ^= rng->state[j];
+				}
+			}
+			randomUint64(rng);
+		}
+	}
+	for (int j=0; j<4; ++j) {
+		rng->state[j] = s[j];
+	}
+}
+
+
+/**
+ * Initialize stream with the current state of rng and jump rng ahead. Repeated calls yield
+ * non-overlapping streams, e.g. one for each thread.
+ */
+void splitRandomNumberGenerator(struct RandomNumberGenerator* rng, struct RandomNumberGenerator* stream) {
+	*stream = *rng;
+	stream->hasGaussian = 0;
+	jumpRandomNumberGenerator(rng);
+}
+
+
+/**
+ * Return 64 random bits. Legacy generators return the next value of the xoshiro256** state, too,
+ * as rand() has no 64 bit equivalent.
+ */
+uint64_t randomUint64(struct RandomNumberGenerator* rng) {
+	uint64_t* s = rng->state;
+	const uint64_t result = rotl(s[1] * 5, 7) * 9;
+	const uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+
+	return result;
+}
+
+
+/**
+ * Return a uniformly distributed integer between 0 and RAND_MAX, like rand().
+ */
+int randomInt(struct RandomNumberGenerator* rng) {
+	if (rng->legacy) {
+		return rand();
+	}
+	return (int)(randomUint64(rng) % ((uint64_t)RAND_MAX + 1));
+}
+
+
+/**
+ * Return a uniformly distributed integer between 0 and n-1. n must be positive.
+ * Legacy generators return rand() % n, which is biased towards small numbers.
+ */
+int randomIntBelow(struct RandomNumberGenerator* rng, int n) {
+	if (rng->legacy) {
+		return rand() % n;
+	}
+
+	const uint32_t bound = (uint32_t)n;
+	uint64_t m = (randomUint64(rng) >> 32) * bound;
+	uint32_t low = (uint32_t)m;
+	if (low < bound) {
+		/* reject the 2^32 mod bound smallest values of low */
+		const uint32_t threshold = -bound % bound;
+		while (low < threshold) {
+			m = (randomUint64(rng) >> 32) * bound;
+			low = (uint32_t)m;
+		}
+	}
+	return (int)(m >> 32);
+}
+
+
+/**
+ * Return a uniformly distributed double in [0, 1).
+ */
+double randomDouble(struct RandomNumberGenerator* rng) {
+	if (rng->legacy) {
+		return rand() / (RAND_MAX + 1.0);
+	}
+	return (randomUint64(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/**
+ * Set z0 and z1 to two independent standard normally distributed values.
+ * Legacy generators use the Box-Muller transform that randomGraphGenerators.c used before.
+ */
+void randomGaussianPair(struct RandomNumberGenerator* rng, double* z0, double* z1) {
+	if (rng->legacy) {
+		static const double epsilon = DBL_EPSILON;
+		static const double two_pi = 2.0*3.14159265358979323846;
+
+		double u1, u2;
+		do {
+			u1 = rand() * (1.0 / RAND_MAX);
+			u2 = rand() * (1.0 / RAND_MAX);
+		} while ( u1 <= epsilon );
+
+		*z0 = sqrt(-2.0 * log(u1)) * cos(two_pi * u2);
+		*z1 = sqrt(-2.0 * log(u1)) * sin(two_pi * u2);
+		return;
+	}
+
+	double u, v, s;
+	do {
+		u = 2.0 * randomDouble(rng) - 1.0;
+		v = 2.0 * randomDouble(rng) - 1.0;
+		s = u * u + v * v;
+	} while ((s >= 1.0) || (s == 0.0));
+
+	s = sqrt(-2.0 * log(s) / s);
+	*z0 = u * s;
+	*z1 = v * s;
+}
+
+
+/**
+ * Return a standard normally distributed value. Every second call is answered from the previous one.
+ */
+double randomGaussian(struct RandomNumberGenerator* rng) {
+	if (rng->hasGaussian) {
+		rng->hasGaussian = 0;
+		return rng->gaussian;
+	}
+	double z0;
+	randomGaussianPair(rng, &z0, &(rng->gaussian));
+	rng->hasGaussian = 1;
+	return z0;
+}
+
+
+/* the per thread generators are split from MASTER_RNG. SEED_GENERATION counts the calls to
+seedRandomNumberGenerators() such that threads notice that they need a new stream */
+static struct RandomNumberGenerator MASTER_RNG;
+static int SEED_GENERATION = 0;
+static pthread_mutex_t MASTER_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread struct RandomNumberGenerator THREAD_RNG;
+static __thread int THREAD_SEED_GENERATION = -1;
+
+
+/**
+ * Seed the master generator of threadRandomNumberGenerator(). If legacy is set, all threads use rand(),
+ * seeded by srand(seed).
+ */
+void seedRandomNumberGenerators(unsigned int seed, char legacy) {
+	pthread_mutex_lock(&MASTER_LOCK);
+	if (legacy) {
+		seedLegacyRandomNumberGenerator(&MASTER_RNG, seed);
+	} else {
+		seedRandomNumberGenerator(&MASTER_RNG, seed);
+	}
+	++SEED_GENERATION;
+	pthread_mutex_unlock(&MASTER_LOCK);
+}
+
+
+/**
+ * Return the generator of the calling thread. The first thread that calls this function after
+ * seedRandomNumberGenerators() gets the first stream of the master generator, and so on. The master generator
+ * is seeded with 1 if seedRandomNumberGenerators() was never called, as rand() is.
+ */
+struct RandomNumberGenerator* threadRandomNumberGenerator() {
+	if (THREAD_SEED_GENERATION != SEED_GENERATION) {
+		pthread_mutex_lock(&MASTER_LOCK);
+		if (SEED_GENERATION == 0) {
+			seedRandomNumberGenerator(&MASTER_RNG, 1);
+			SEED_GENERATION = 1;
+		}
+		if (THREAD_SEED_GENERATION != SEED_GENERATION) {
+			splitRandomNumberGenerator(&MASTER_RNG, &THREAD_RNG);
+			THREAD_SEED_GENERATION = SEED_GENERATION;
+		}
+		pthread_mutex_unlock(&MASTER_LOCK);
+	}
+	return &THREAD_RNG;
+}
@@ -0,0 +1,37 @@
+#ifndef RANDOM_NUMBER_GENERATOR_H_
+#define RANDOM_NUMBER_GENERATOR_H_
+
+#include <stdint.h>
+
+/**
+ * State of a xoshiro256** generator. Each thread that samples needs its own generator; independent
+ * streams are obtained by splitRandomNumberGenerator().
+ *
+ * A legacy generator draws all numbers from the libc rand() instead and maps them to the requested
+ * ranges exactly as the sampling code did before it used this module. Hence, seeding a legacy generator
+ * with the seed of an old experiment reproduces its results. Legacy generators share the global state of
+ * rand() and must not be used by more than one thread.
+ */
+struct RandomNumberGenerator {
+	uint64_t state[4];
+	char legacy;
+	char hasGaussian;
+	double gaussian; // second value of the last polar method, if hasGaussian
+};
+
+void seedRandomNumberGenerator(struct RandomNumberGenerator* rng, uint64_t seed);
+void seedLegacyRandomNumberGenerator(struct RandomNumberGenerator* rng, unsigned int seed);
+void jumpRandomNumberGenerator(struct RandomNumberGenerator* rng);
+void splitRandomNumberGenerator(struct RandomNumberGenerator* rng, struct RandomNumberGenerator* stream);
+
+uint64_t randomUint64(struct RandomNumberGenerator* rng);
+int randomInt(struct RandomNumberGenerator* rng);
+int randomIntBelow(struct RandomNumberGenerator* rng, int n);
+double randomDouble(struct RandomNumberGenerator* rng);
+void randomGaussianPair(struct RandomNumberGenerator* rng, double* z0, double* z1);
+double randomGaussian(struct RandomNumberGenerator* rng);
+
+void seedRandomNumberGenerators(unsigned int seed, char legacy);
+struct RandomNumberGenerator* threadRandomNumberGenerator();
+
+#endif /* RANDOM_NUMBER_GENERATOR_H_ */
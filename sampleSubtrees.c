@@ -16,14 +16,14 @@
 /**
 Sample a spanning tree from a cactus graph, given as a list of its biconnected components, uniformly at random.
 To this end, we just need to remove a random edge from each cycle = block of the graph. **/
-struct ShallowGraph* sampleSpanningTreeEdgesFromCactus(struct ShallowGraph* biconnectedComponents, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* sampleSpanningTreeEdgesFromCactus(struct ShallowGraph* biconnectedComponents, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp) {
 	struct ShallowGraph* spanningTree = getShallowGraph(sgp);
 	struct ShallowGraph* idx;
 	for (idx=biconnectedComponents; idx!=NULL; idx=idx->next) {
 		if (idx->m == 1) {
 			appendEdge(spanningTree, shallowCopyEdge(idx->edges, sgp->listPool));
 		} else {
-			int removalEdgeId = rand() % idx->m;
+			int removalEdgeId = randomIntBelow(rng, idx->m);
 			struct VertexList* e;
 			int i = 0;
 			for (e=idx->edges; e!=NULL; e=e->next) {
@@ -41,14 +41,14 @@ struct ShallowGraph* sampleSpanningTreeEdgesFromCactus(struct ShallowGraph* bico
 /**
 Sample a spanning tree from a cactus graph, given as a list of its biconnected components, uniformly at random.
 To this end, we just need to remove a random edge from each cycle = block of the graph. **/
-struct Graph* sampleSpanningTreeFromCactus(struct Graph* original, struct ShallowGraph* biconnectedComponents, struct GraphPool* gp) {
+struct Graph* sampleSpanningTreeFromCactus(struct Graph* original, struct ShallowGraph* biconnectedComponents, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 	struct Graph* spanningTree = emptyGraph(original, gp);
 	struct ShallowGraph* idx;
 	for (idx=biconnectedComponents; idx!=NULL; idx=idx->next) {
 		if (idx->m == 1) {
 			addEdgeBetweenVertices(idx->edges->startPoint->number, idx->edges->endPoint->number, idx->edges->label, spanningTree, gp);
 		} else {
-			int removalEdgeId = rand() % idx->m;
+			int removalEdgeId = randomIntBelow(rng, idx->m);
 			struct VertexList* e;
 			int i = 0;
 			for (e=idx->edges; e!=NULL; e=e->next) {
@@ -65,22 +65,64 @@ struct Graph* sampleSpanningTreeFromCactus(struct Graph* original, struct Shallo
 
 /**
 Take k random spanning trees of g using Wilsons algorithm and return them as a list.
+The adjacency of g and the scratch space are set up once for all k trees, see struct WilsonSampler.
 */
-struct ShallowGraph* sampleSpanningTreesUsingWilson(struct Graph* g, int k, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* sampleSpanningTreesUsingWilson(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp) {
 	struct ShallowGraph* spanningTrees = NULL;
-	int j;
-	for (j=0; j<k; ++j) {
-		struct ShallowGraph* spanningTree = randomSpanningTreeAsShallowGraph(g, sgp);
+	if (g->m == 0) {
+		for (int j=0; j<k; ++j) {
+			struct ShallowGraph* spanningTree = getShallowGraph(sgp);
+			spanningTree->next = spanningTrees;
+			spanningTrees = spanningTree;
+		}
+		return spanningTrees;
+	}
+
+	struct WilsonSampler* sampler = createWilsonSampler(g);
+	for (int j=0; j<k; ++j) {
+		wilsonSampleTree(sampler, rng);
+		struct ShallowGraph* spanningTree = wilsonTreeAsShallowGraph(sampler, sgp);
 		spanningTree->next = spanningTrees;
 		spanningTrees = spanningTree;
 	}
+	freeWilsonSampler(sampler);
+	return spanningTrees;
+}
+
+
+/**
+Take k random spanning trees of g using Wilsons algorithm and return one of each isomorphism class as a list.
+Duplicates are recognized by their canonical ids before they are converted to edge lists.
+*/
+struct ShallowGraph* sampleNonisomorphicSpanningTreesUsingWilson(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp) {
+	if (g->m == 0) {
+		return (k > 0) ? getShallowGraph(sgp) : NULL;
+	}
+
+	struct ShallowGraph* spanningTrees = NULL;
+	struct WilsonSampler* sampler = createWilsonSampler(g);
+	for (int j=0; j<k; ++j) {
+		wilsonSampleTree(sampler, rng);
+		if (wilsonTreeIsNew(sampler)) {
+			struct ShallowGraph* spanningTree = wilsonTreeAsShallowGraph(sampler, sgp);
+			spanningTree->next = spanningTrees;
+			spanningTrees = spanningTree;
+		}
+	}
+	freeWilsonSampler(sampler);
 	return spanningTrees;
 }
 
 struct ShallowGraph* xsampleSpanningTreesUsingWilson(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	(void)threshold;
 	(void)gp;
-	return sampleSpanningTreesUsingWilson(g, k, sgp);
+	return sampleSpanningTreesUsingWilson(g, k, threadRandomNumberGenerator(), sgp);
+}
+
+struct ShallowGraph* xsampleNonisomorphicSpanningTreesUsingWilson(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	(void)threshold;
+	(void)gp;
+	return sampleNonisomorphicSpanningTreesUsingWilson(g, k, threadRandomNumberGenerator(), sgp);
 }
 
 struct ShallowGraph* xlistSpanningTrees(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
@@ -91,9 +133,8 @@ struct ShallowGraph* xlistSpanningTrees(struct Graph* g, int k, long int thresho
 
 
 /** from http://stackoverflow.com/questions/6127503/shuffle-array-in-c, 
-but replaced their use of drand48 by rand
-make sure you randomize properly using srand()! */
-void shuffle(struct VertexList** array, size_t n) {
+but replaced their use of drand48 by rng */
+void shuffle(struct VertexList** array, size_t n, struct RandomNumberGenerator* rng) {
     // struct timeval tv;
     // gettimeofday(&tv, NULL);
     // int usec = tv.tv_usec;
@@ -102,7 +143,7 @@ void shuffle(struct VertexList** array, size_t n) {
     if (n > 1) {
         size_t i;
         for (i = n - 1; i > 0; i--) {
-            size_t j = (unsigned int) (rand() % i);
+            size_t j = (unsigned int) randomIntBelow(rng, i);
             struct VertexList* t = array[j];
             array[j] = array[i];
             array[i] = t;
@@ -111,61 +152,55 @@ void shuffle(struct VertexList** array, size_t n) {
 }
 
 
-struct ShallowGraph* sampleSpanningTreesUsingKruskalOnce(struct Graph* g, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	struct ShallowGraph* spanningTree = NULL;
-	int i;
-
-	// create and shuffle array of edges of g
-	struct ShallowGraph* edges = getGraphEdges(g, sgp);
-	struct VertexList** edgeArray = malloc(g->m * sizeof(struct VertexList*));
-	if (edges->m != 0) {
-		edgeArray[0] = edges->edges;
-	}
-	for (i=1; i < g->m; ++i) {
-		edgeArray[i] = edgeArray[i-1]->next;
-	}
-	shuffle(edgeArray, g->m);
-
-	// do the kruskal
-	spanningTree = kruskalMST(g, edgeArray, gp, sgp);
-
-	// garbage collection
-	dumpShallowGraphCycle(sgp, edges);
-	free(edgeArray);
-
+/**
+Draw one spanning tree of g by running Kruskals algorithm on a random permutation of the edges of g.
+*/
+struct ShallowGraph* sampleSpanningTreesUsingKruskalOnce(struct Graph* g, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	(void)gp;
+	struct KruskalSampler* sampler = createKruskalSampler(g);
+	kruskalSampleTree(sampler, rng);
+	struct ShallowGraph* spanningTree = kruskalTreeAsShallowGraph(sampler, sgp);
+	freeKruskalSampler(sampler);
 	return spanningTree;
 }
 
 struct ShallowGraph* xsampleSpanningTreesUsingKruskalOnce(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	(void)k;
 	(void)threshold;
-	return sampleSpanningTreesUsingKruskalOnce(g, gp, sgp);
+	return sampleSpanningTreesUsingKruskalOnce(g, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
-struct ShallowGraph* sampleSpanningTreesUsingKruskal(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+/**
+Draw k spanning trees of g with Kruskals algorithm. The edges and the union-find forest are set up once
+for all k trees, see struct KruskalSampler.
+*/
+struct ShallowGraph* sampleSpanningTreesUsingKruskal(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+	(void)gp;
 	struct ShallowGraph* spanningTrees = NULL;
-	int i;
+	struct KruskalSampler* sampler = createKruskalSampler(g);
 
-	for (i=0; i<k; ++i) {
-		struct ShallowGraph* tmp = sampleSpanningTreesUsingKruskalOnce(g, gp, sgp);
+	for (int i=0; i<k; ++i) {
+		kruskalSampleTree(sampler, rng);
+		struct ShallowGraph* tmp = kruskalTreeAsShallowGraph(sampler, sgp);
 		tmp->next = spanningTrees;
 		spanningTrees = tmp;
 	}
+	freeKruskalSampler(sampler);
 	return spanningTrees;
 }
 
 
 struct ShallowGraph* xsampleSpanningTreesUsingKruskal(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	(void)threshold;
-	return sampleSpanningTreesUsingKruskal(g, k, gp, sgp);
+	return sampleSpanningTreesUsingKruskal(g, k, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
 /**
 List all spanning trees of g and draw k of them uniformly at random, return these k spanning trees as a list. 
 */
-struct ShallowGraph* sampleSpanningTreesUsingListing(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* sampleSpanningTreesUsingListing(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	struct ShallowGraph* spanningTrees = NULL;
 	struct ShallowGraph* trees = listSpanningTrees(g, sgp, gp);
 	struct ShallowGraph** array;
@@ -186,7 +221,7 @@ struct ShallowGraph* sampleSpanningTreesUsingListing(struct Graph* g, int k, str
 
 	/* sample k trees uniformly at random */
 	for (j=0; j<k; ++j) {
-		int rnd = rand() % nTrees;
+		int rnd = randomIntBelow(rng, nTrees);
 		// can't just use the listed tree itself, as it might get selected more than once
 		struct ShallowGraph* tree = cloneShallowGraph(array[rnd], sgp);
 		tree->next = spanningTrees;
@@ -200,7 +235,7 @@ struct ShallowGraph* sampleSpanningTreesUsingListing(struct Graph* g, int k, str
 
 struct ShallowGraph* xsampleSpanningTreesUsingListing(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	(void)threshold;
-	return sampleSpanningTreesUsingListing(g, k, gp, sgp);
+	return sampleSpanningTreesUsingListing(g, k, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
@@ -208,18 +243,18 @@ struct ShallowGraph* xsampleSpanningTreesUsingListing(struct Graph* g, int k, lo
 If there are expected to be less than threshold spanning trees, sample spanning trees using explicit listing, 
 otherwise use wilsons algorithm.
 */
-struct ShallowGraph* sampleSpanningTreesUsingMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* sampleSpanningTreesUsingMix(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	long upperBound = getGoodEstimate(g, sgp, gp);
 	if ((upperBound < threshold) && (upperBound != -1)) {
-		return sampleSpanningTreesUsingListing(g, k, gp, sgp);
+		return sampleSpanningTreesUsingListing(g, k, rng, gp, sgp);
 	} else {
-		return sampleSpanningTreesUsingWilson(g, k, sgp);
+		return sampleSpanningTreesUsingWilson(g, k, rng, sgp);
 	}
 }
 
 
 struct ShallowGraph* xsampleSpanningTreesUsingMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	return sampleSpanningTreesUsingMix(g, k, threshold, gp, sgp);
+	return sampleSpanningTreesUsingMix(g, k, threshold, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
@@ -227,7 +262,7 @@ struct ShallowGraph* xsampleSpanningTreesUsingMix(struct Graph* g, int k, long i
 If there are expected to be less than threshold spanning trees, sample spanning trees using explicit listing, 
 otherwise use wilsons algorithm.
 */
-struct ShallowGraph* sampleSpanningTreesUsingPartialListingMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* sampleSpanningTreesUsingPartialListingMix(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	long upperBound = getGoodEstimate(g, sgp, gp);
 
 	if (k != 1) {
@@ -235,7 +270,7 @@ struct ShallowGraph* sampleSpanningTreesUsingPartialListingMix(struct Graph* g,
 		k = 1;
 	}
 	if ((upperBound < threshold) && (upperBound != -1)) {
-		int i = rand() % threshold;
+		int i = randomIntBelow(rng, threshold);
 		int storeI = i;
 		struct ShallowGraph* garbage = listKSpanningTrees(g, &i, sgp, gp);
 		if (i == 0) {
@@ -252,13 +287,13 @@ struct ShallowGraph* sampleSpanningTreesUsingPartialListingMix(struct Graph* g,
 			return result;
 		}
 	} else {
-		return sampleSpanningTreesUsingWilson(g, k, sgp);
+		return sampleSpanningTreesUsingWilson(g, k, rng, sgp);
 	}
 }
 
 
 struct ShallowGraph* xsampleSpanningTreesUsingPartialListingMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	return sampleSpanningTreesUsingPartialListingMix(g, k, threshold, gp, sgp);
+	return sampleSpanningTreesUsingPartialListingMix(g, k, threshold, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
@@ -266,7 +301,7 @@ struct ShallowGraph* xsampleSpanningTreesUsingPartialListingMix(struct Graph* g,
 If g is a cactus graph, use a specialized method to sample spanning trees, 
 otherwise use sampleSpanningTreesUsingMix.
 */
-struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	struct ShallowGraph* spanningTrees = NULL;
 	struct ShallowGraph* biconnectedComponents = listBiconnectedComponents(g, sgp);
 	int blockCount = 0;
@@ -280,7 +315,7 @@ struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, l
 	if (g->n - 1 + blockCount == g->m) {
 		int j;
 		for (j=0; j<k; ++j) {	
-			struct ShallowGraph* spanningTree = sampleSpanningTreeEdgesFromCactus(biconnectedComponents, sgp);
+			struct ShallowGraph* spanningTree = sampleSpanningTreeEdgesFromCactus(biconnectedComponents, rng, sgp);
 			spanningTree->next = spanningTrees;
 			spanningTrees = spanningTree;
 		}
@@ -288,9 +323,9 @@ struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, l
 		// for speedup. this is sampleSpanningTreesUsingMix
 		long upperBound = getGoodEstimatePrecomputedBlocks(g, biconnectedComponents, sgp, gp);
 		if ((upperBound < threshold) && (upperBound != -1)) {
-			spanningTrees = sampleSpanningTreesUsingListing(g, k, gp, sgp);
+			spanningTrees = sampleSpanningTreesUsingListing(g, k, rng, gp, sgp);
 		} else {
-			spanningTrees = sampleSpanningTreesUsingWilson(g, k, sgp);
+			spanningTrees = sampleSpanningTreesUsingWilson(g, k, rng, sgp);
 		}
 	}
 	dumpShallowGraphCycle(sgp, biconnectedComponents);
@@ -299,7 +334,7 @@ struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, l
 
 
 struct ShallowGraph* xsampleSpanningTreesUsingCactusMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	return sampleSpanningTreesUsingCactusMix(g, k, threshold, gp, sgp);
+	return sampleSpanningTreesUsingCactusMix(g, k, threshold, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
@@ -334,20 +369,20 @@ struct ShallowGraph* xlistBridgeForest(struct Graph* g, int k, long int threshol
 If there are expected to be less than threshold spanning trees, return a list containing all of them. 
 Otherwise, sample k spanning trees using Wilsons algorithm. 
 */
-struct ShallowGraph* listOrSampleSpanningTrees(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* listOrSampleSpanningTrees(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
 	struct ShallowGraph* spanningTrees = NULL; 
 	long upperBound = getGoodEstimate(g, sgp, gp);
 	if ((upperBound < threshold) && (upperBound != -1)) {
 		spanningTrees = listSpanningTrees(g, sgp, gp);	
 	} else {
-		spanningTrees = sampleSpanningTreesUsingWilson(g, k, sgp);
+		spanningTrees = sampleSpanningTreesUsingWilson(g, k, rng, sgp);
 	}
 	return spanningTrees;
 }
 
 
 struct ShallowGraph* xlistOrSampleSpanningTrees(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
-	return listOrSampleSpanningTrees(g, k, threshold, gp, sgp);
+	return listOrSampleSpanningTrees(g, k, threshold, threadRandomNumberGenerator(), gp, sgp);
 }
 
 
@@ -408,7 +443,7 @@ int getNumberOfNonisomorphicSpanningForestComponentsForKSamples(struct Graph* g,
 	struct Vertex* searchTree = getVertex(gp->vertexPool);
 
 	// sample k spanning trees, canonicalize them and add them in a search tree (to avoid duplicates, i.e. isomorphic spanning trees)
-	struct ShallowGraph* sample = runForEachConnectedComponent(&xsampleSpanningTreesUsingWilson, g, k, k, 1, gp, sgp);
+	struct ShallowGraph* sample = runForEachConnectedComponent(&xsampleNonisomorphicSpanningTreesUsingWilson, g, k, k, 1, gp, sgp);
 	for (struct ShallowGraph* tree=sample; tree!=NULL; tree=tree->next) {
 		if (tree->m != 0) {
 			struct Graph* tmp = shallowGraphToGraph(tree, gp);
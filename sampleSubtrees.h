@@ -1,20 +1,24 @@
 #ifndef SAMPLE_SUBTREES_H_
 #define SAMPLE_SUBTREES_H_ 
 
-struct Graph* sampleSpanningTreeFromCactus(struct Graph* original, struct ShallowGraph* biconnectedComponents, struct GraphPool* gp);
-struct ShallowGraph* sampleSpanningTreeEdgesFromCactus(struct ShallowGraph* biconnectedComponents, struct ShallowGraphPool* sgp);
-
-struct ShallowGraph* sampleSpanningTreesUsingWilson(struct Graph* g, int k, struct ShallowGraphPool* sgp);
-struct ShallowGraph* sampleSpanningTreesUsingKruskalOnce(struct Graph* g, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct ShallowGraph* sampleSpanningTreesUsingKruskal(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct ShallowGraph* sampleSpanningTreesUsingListing(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct ShallowGraph* sampleSpanningTreesUsingMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct ShallowGraph* sampleSpanningTreesUsingPartialListingMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+#include "randomNumberGenerator.h"
+
+struct Graph* sampleSpanningTreeFromCactus(struct Graph* original, struct ShallowGraph* biconnectedComponents, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+struct ShallowGraph* sampleSpanningTreeEdgesFromCactus(struct ShallowGraph* biconnectedComponents, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp);
+
+struct ShallowGraph* sampleSpanningTreesUsingWilson(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleNonisomorphicSpanningTreesUsingWilson(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleSpanningTreesUsingKruskalOnce(struct Graph* g, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleSpanningTreesUsingKruskal(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleSpanningTreesUsingListing(struct Graph* g, int k, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleSpanningTreesUsingMix(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleSpanningTreesUsingPartialListingMix(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* sampleSpanningTreesUsingCactusMix(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 struct ShallowGraph* listBridgeForest(struct Graph* g, struct GraphPool* gp, struct ShallowGraphPool* sgp);
-struct ShallowGraph* listOrSampleSpanningTrees(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* listOrSampleSpanningTrees(struct Graph* g, int k, long int threshold, struct RandomNumberGenerator* rng, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 
 struct ShallowGraph* xsampleSpanningTreesUsingWilson(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
+struct ShallowGraph* xsampleNonisomorphicSpanningTreesUsingWilson(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 struct ShallowGraph* xsampleSpanningTreesUsingKruskalOnce(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 struct ShallowGraph* xsampleSpanningTreesUsingKruskal(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 struct ShallowGraph* xsampleSpanningTreesUsingListing(struct Graph* g, int k, long int threshold, struct GraphPool* gp, struct ShallowGraphPool* sgp);
@@ -31,6 +35,6 @@ struct ShallowGraph* runForEachConnectedComponent(struct ShallowGraph* (*sampler
 
 int getNumberOfNonisomorphicSpanningForestComponentsForKSamples(struct Graph* g, int k, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 
-void shuffle(struct VertexList** array, size_t n);
+void shuffle(struct VertexList** array, size_t n, struct RandomNumberGenerator* rng);
 
 #endif
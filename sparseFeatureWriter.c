@@ -0,0 +1,198 @@
+/**
+ * Buffered output of sparse feature vectors, either as text or as binary CSR matrix.
+ *
+ * The text format is the one that the print functions of intSet.c and supportSet.c produce, but integers
+ * are formatted by hand into a large buffer instead of calling fprintf for each of them.
+ *
+ * The binary format is written sequentially, hence it can be written to pipes. All numbers are in native
+ * byte order:
+ *
+ *   header      char magic[8] = "GMTCSR\0\0", int32 version, int32 hasValues
+ *   entries     [nEntries] int32 column, or [nEntries][2] int32 column, value if hasValues
+ *   keys        [nRows] int32, followed by a zero int32 if nRows is odd
+ *   rowPointers [nRows + 1] int64, the entries of row i are rowPointers[i], ..., rowPointers[i+1] - 1
+ *   footer      int64 nRows, int64 nEntries, char magic[8] = "GMTCSR\0\0"
+ *
+ * A reader finds the sections by reading the footer first. python/svmlight_loader.py contains one.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sparseFeatureWriter.h"
+
+#define SPARSE_MAGIC "GMTCSR\0\0"
+#define SPARSE_VERSION 1
+#define SPARSE_BUFFER_SIZE (1 << 20)
+
+
+/**
+ * Set *format according to name, which may be "text" or "binary". Returns 0 if name is unknown.
+ */
+char parseSparseFeatureFormat(const char* name, SparseFeatureFormat* format) {
+	if (strcmp(name, "text") == 0) {
+		*format = sparseText;
+		return 1;
+	}
+	if (strcmp(name, "binary") == 0) {
+		*format = sparseBinary;
+		return 1;
+	}
+	return 0;
+}
+
+
+static void writeBytes(struct SparseFeatureWriter* w, const void* data, size_t size) {
+	if (w->size + size > w->capacity) {
+		flushSparseFeatureWriter(w);
+	}
+	if (size > w->capacity) {
+		fwrite(data, 1, size, w->out);
+	} else {
+		memcpy(w->buffer + w->size, data, size);
+		w->size += size;
+	}
+}
+
+
+/**
+ * Append the decimal representation of value to the buffer. The buffer needs space for 11 more characters.
+ */
+static void formatInt(struct SparseFeatureWriter* w, int value) {
+	char digits[12];
+	int n = 0;
+	unsigned int u = (value < 0) ? -(unsigned int)value : (unsigned int)value;
+
+	do {
+		digits[n++] = '0' + u % 10;
+		u /= 10;
+	} while (u > 0);
+	if (value < 0) {
+		w->buffer[w->size++] = '-';
+	}
+	while (n > 0) {
+		w->buffer[w->size++] = digits[--n];
+	}
+}
+
+
+/**
+ * Create a writer that writes to out, which has to be closed by the caller after closeSparseFeatureWriter().
+ * Rows of a writer with values are written as "key c:v c:v ...", rows without values as "key: c c ...".
+ */
+struct SparseFeatureWriter* createSparseFeatureWriter(FILE* out, SparseFeatureFormat format, char hasValues) {
+	struct SparseFeatureWriter* w = malloc(sizeof(struct SparseFeatureWriter));
+	w->out = out;
+	w->format = format;
+	w->hasValues = hasValues;
+	w->capacity = SPARSE_BUFFER_SIZE;
+	w->buffer = malloc(w->capacity);
+	w->size = 0;
+	w->keys = NULL;
+	w->rowPointers = NULL;
+	w->nRows = 0;
+	w->rowCapacity = 0;
+	w->nEntries = 0;
+
+	if (format == sparseBinary) {
+		int32_t header[2] = {SPARSE_VERSION, hasValues ? 1 : 0};
+		w->rowCapacity = 1024;
+		w->keys = malloc(w->rowCapacity * sizeof(int32_t));
+		w->rowPointers = malloc((w->rowCapacity + 1) * sizeof(int64_t));
+		w->rowPointers[0] = 0;
+		writeBytes(w, SPARSE_MAGIC, 8);
+		writeBytes(w, header, sizeof(header));
+	}
+	return w;
+}
+
+
+/**
+ * Write the buffer to the output stream and flush it. The binary format is only complete after
+ * closeSparseFeatureWriter().
+ */
+void flushSparseFeatureWriter(struct SparseFeatureWriter* w) {
+	if (w->size > 0) {
+		fwrite(w->buffer, 1, w->size, w->out);
+		w->size = 0;
+	}
+	fflush(w->out);
+}
+
+
+/**
+ * Write the row index of the binary format, flush, and free w. Does not close the output stream.
+ */
+void closeSparseFeatureWriter(struct SparseFeatureWriter* w) {
+	if (w->format == sparseBinary) {
+		int64_t footer[2] = {w->nRows, w->nEntries};
+		int32_t padding = 0;
+		writeBytes(w, w->keys, w->nRows * sizeof(int32_t));
+		if (w->nRows % 2) {
+			writeBytes(w, &padding, sizeof(int32_t));
+		}
+		writeBytes(w, w->rowPointers, (w->nRows + 1) * sizeof(int64_t));
+		writeBytes(w, footer, sizeof(footer));
+		writeBytes(w, SPARSE_MAGIC, 8);
+	}
+	flushSparseFeatureWriter(w);
+	free(w->keys);
+	free(w->rowPointers);
+	free(w->buffer);
+	free(w);
+}
+
+
+void beginSparseRow(struct SparseFeatureWriter* w, int key) {
+	if (w->format == sparseBinary) {
+		if (w->nRows == w->rowCapacity) {
+			w->rowCapacity *= 2;
+			w->keys = realloc(w->keys, w->rowCapacity * sizeof(int32_t));
+			w->rowPointers = realloc(w->rowPointers, (w->rowCapacity + 1) * sizeof(int64_t));
+		}
+		w->keys[w->nRows] = key;
+	} else {
+		if (w->size + 12 > w->capacity) {
+			flushSparseFeatureWriter(w);
+		}
+		formatInt(w, key);
+		if (!w->hasValues) {
+			w->buffer[w->size++] = ':';
+		}
+	}
+}
+
+
+/**
+ * Add an entry to the current row. value is ignored if the writer has no values.
+ */
+void addSparseEntry(struct SparseFeatureWriter* w, int column, int value) {
+	if (w->format == sparseBinary) {
+		int32_t entry[2] = {column, value};
+		writeBytes(w, entry, w->hasValues ? 2 * sizeof(int32_t) : sizeof(int32_t));
+		++w->nEntries;
+	} else {
+		if (w->size + 24 > w->capacity) {
+			flushSparseFeatureWriter(w);
+		}
+		w->buffer[w->size++] = ' ';
+		formatInt(w, column);
+		if (w->hasValues) {
+			w->buffer[w->size++] = ':';
+			formatInt(w, value);
+		}
+	}
+}
+
+
+void endSparseRow(struct SparseFeatureWriter* w) {
+	if (w->format == sparseBinary) {
+		++w->nRows;
+		w->rowPointers[w->nRows] = w->nEntries;
+	} else {
+		if (w->size + 1 > w->capacity) {
+			flushSparseFeatureWriter(w);
+		}
+		w->buffer[w->size++] = '\n';
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef SPARSE_FEATURE_WRITER_H_
+#define SPARSE_FEATURE_WRITER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef enum {
+	sparseText,    // "key c:v c:v ..." if the writer has values, "key: c c ..." otherwise
+	sparseBinary   // CSR matrix, see sparseFeatureWriter.c
+} SparseFeatureFormat;
+
+/**
+ * Buffered writer for sparse feature vectors. Each row consists of a key (the class label of a graph or
+ * the id of a pattern) and a list of column ids, optionally with an integer value for each column.
+ */
+struct SparseFeatureWriter {
+	FILE* out;
+	SparseFeatureFormat format;
+	char hasValues;
+
+	char* buffer;
+	size_t size;
+	size_t capacity;
+
+	/* row index of the binary format */
+	int32_t* keys;
+	int64_t* rowPointers;
+	size_t nRows;
+	size_t rowCapacity;
+	int64_t nEntries;
+};
+
+char parseSparseFeatureFormat(const char* name, SparseFeatureFormat* format);
+
+struct SparseFeatureWriter* createSparseFeatureWriter(FILE* out, SparseFeatureFormat format, char hasValues);
+void closeSparseFeatureWriter(struct SparseFeatureWriter* w);
+void flushSparseFeatureWriter(struct SparseFeatureWriter* w);
+
+void beginSparseRow(struct SparseFeatureWriter* w, int key);
+void addSparseEntry(struct SparseFeatureWriter* w, int column, int value);
+void endSparseRow(struct SparseFeatureWriter* w);
+
+#endif /* SPARSE_FEATURE_WRITER_H_ */
@@ -18,14 +18,14 @@
 /**
  * create a shuffled array of the elements of v->neighbors.
  */
-struct VertexList** shuffleNeighbors(struct Vertex* v, int degV) {
+struct VertexList** shuffleNeighbors(struct Vertex* v, int degV, struct RandomNumberGenerator* rng) {
 	if (degV > 0) {
 		struct VertexList** edgeArray = malloc(degV * sizeof(struct VertexList*));
 		edgeArray[0] = v->neighborhood;
 		for (int i=1; i < degV; ++i) {
 			edgeArray[i] = edgeArray[i-1]->next;
 		}
-		shuffle(edgeArray, degV);
+		shuffle(edgeArray, degV, rng);
 		return edgeArray;
 	}
 	return NULL;
@@ -36,12 +36,12 @@ struct VertexList** shuffleNeighbors(struct Vertex* v, int degV) {
  * mixed bfs/dfs strategy. embed all children of a vertex, then call recursively.
  * similar to gaston dfs strategy in the pattern space, but for a single tree in a fixed graph.
  */
-static char recursiveSubtreeIsomorphismSampler(struct Vertex* parent, struct Graph* g) {
+static char recursiveSubtreeIsomorphismSampler(struct Vertex* parent, struct Graph* g, struct RandomNumberGenerator* rng) {
 
 	struct Vertex* currentImage = g->vertices[parent->visited - 1];
 
 	int nNeighbors = degree(parent);
-	struct VertexList** shuffledNeighbors = shuffleNeighbors(parent, nNeighbors);
+	struct VertexList** shuffledNeighbors = shuffleNeighbors(parent, nNeighbors, rng);
 
 	// TODO need to shuffle the neighbors of the image, as well
 	int unassignedNeighborsOfRoot = 0;
@@ -88,7 +88,7 @@ static char recursiveSubtreeIsomorphismSampler(struct Vertex* parent, struct Gra
 		struct VertexList* child = shuffledNeighbors[i];
 		if (child->flag) {
 			child->flag = 0;
-			embeddingWorked = recursiveSubtreeIsomorphismSampler(child->endPoint, g);
+			embeddingWorked = recursiveSubtreeIsomorphismSampler(child->endPoint, g, rng);
 		}
 		if (!embeddingWorked) {
 			break;
@@ -104,15 +104,15 @@ static char recursiveSubtreeIsomorphismSampler(struct Vertex* parent, struct Gra
  * similar to gaston dfs strategy in the pattern space, but for a single tree pattern
  * in a fixed graph transaction.
  */
-static char recursiveSubtreeIsomorphismSamplerWithShuffledImage(struct Vertex* parent, struct Graph* g) {
+static char recursiveSubtreeIsomorphismSamplerWithShuffledImage(struct Vertex* parent, struct Graph* g, struct RandomNumberGenerator* rng) {
 
 	struct Vertex* currentImage = g->vertices[parent->visited - 1];
 
 	int nNeighbors = degree(parent);
-	struct VertexList** shuffledNeighbors = shuffleNeighbors(parent, nNeighbors);
+	struct VertexList** shuffledNeighbors = shuffleNeighbors(parent, nNeighbors, rng);
 
 	int nImageNeighbors = degree(currentImage);
-	struct VertexList** shuffledImageNeighbors = shuffleNeighbors(currentImage, nImageNeighbors);
+	struct VertexList** shuffledImageNeighbors = shuffleNeighbors(currentImage, nImageNeighbors, rng);
 
 	int unassignedNeighborsOfRoot = 0;
 	int processedNeighborsOfRoot = 0;
@@ -161,7 +161,7 @@ static char recursiveSubtreeIsomorphismSamplerWithShuffledImage(struct Vertex* p
 		struct VertexList* child = shuffledNeighbors[i];
 		if (child->flag) {
 			child->flag = 0;
-			embeddingWorked = recursiveSubtreeIsomorphismSampler(child->endPoint, g);
+			embeddingWorked = recursiveSubtreeIsomorphismSampler(child->endPoint, g, rng);
 		}
 		if (!embeddingWorked) {
 			break;
@@ -177,14 +177,14 @@ static char recursiveSubtreeIsomorphismSamplerWithShuffledImage(struct Vertex* p
  *
  * vertices of g have their ->visited values set to 1 if they are already matched. vertices of the tree h have their ->visited
  * values set to their image->number + 1.  Thus, we can match to all vertices that have ->visited = 0 */
-static struct Graph* makeBipartiteInstanceFromVertices(struct Vertex* parent, struct Vertex* parentImage, struct GraphPool* gp) {
+static struct Graph* makeBipartiteInstanceFromVertices(struct Vertex* parent, struct Vertex* parentImage, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 
 	/* shuffle neighbors of parent and parentImage */
 	int nNeighbors = degree(parent);
-	struct VertexList** shuffledNeighbors = shuffleNeighbors(parent, nNeighbors);
+	struct VertexList** shuffledNeighbors = shuffleNeighbors(parent, nNeighbors, rng);
 
 	int nImageNeighbors = degree(parentImage);
-	struct VertexList** shuffledImageNeighbors = shuffleNeighbors(parentImage, nImageNeighbors);
+	struct VertexList** shuffledImageNeighbors = shuffleNeighbors(parentImage, nImageNeighbors, rng);
 
 	/* construct bipartite graph B(v,u) */
 	struct Graph* B = createGraph(nNeighbors + nImageNeighbors, gp);
@@ -248,13 +248,13 @@ static struct Graph* makeBipartiteInstanceFromVertices(struct Vertex* parent, st
  * similar to gaston dfs strategy in the pattern space, but for a single tree pattern
  * in a fixed graph transaction.
  */
-static char recursiveSubtreeIsomorphismSamplerWithMatching(struct Vertex* parent, struct Graph* g, struct GraphPool* gp) {
+static char recursiveSubtreeIsomorphismSamplerWithMatching(struct Vertex* parent, struct Graph* g, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 
 	// base case: if parent is a leaf and its only neighbor is already assigned to a vertex in g, we are done
 	if (isLeaf(parent) && parent->neighborhood->endPoint->visited) { return 1; }
 
 	struct Vertex* parentImage = g->vertices[parent->visited - 1];
-	struct Graph* B = makeBipartiteInstanceFromVertices(parent, parentImage, gp);
+	struct Graph* B = makeBipartiteInstanceFromVertices(parent, parentImage, rng, gp);
 	int sizeOfMatching = bipartiteMatchingEvenMoreDirty(B);
 	int nNeighbors = B->number;
 
@@ -283,7 +283,7 @@ static char recursiveSubtreeIsomorphismSamplerWithMatching(struct Vertex* parent
 		for (struct VertexList* e=B->vertices[i]->neighborhood; e!=NULL; e=e->next) {
 			if (e->flag == 1) {
 				struct Vertex* newChild = ((struct VertexList*)e->startPoint->label)->endPoint;
-				char embeddingWorked = recursiveSubtreeIsomorphismSamplerWithMatching(newChild, g, gp);
+				char embeddingWorked = recursiveSubtreeIsomorphismSamplerWithMatching(newChild, g, rng, gp);
 				if (embeddingWorked) {
 					// we are done with this neighbor of parent
 					break;
@@ -383,11 +383,11 @@ static inline int* getClassesArray(struct VertexList** neighbors, int deg) {
  * Shuffle the image neighbors; separately in each block (i.e., swap only items that have identical vertex and edge labels)
  * This is where the magic happens to generate maximum matchings uniformly at random for our particular situation.
  */
-static void shuffleInClasses(struct VertexList** imageNeighbors, int* imageNeighborClasses) {
+static void shuffleInClasses(struct VertexList** imageNeighbors, int* imageNeighborClasses, struct RandomNumberGenerator* rng) {
 	int startIdx = 0;
 	for (int i=1; i<imageNeighborClasses[0] + 1; ++i) {
 		int size = imageNeighborClasses[i] - startIdx;
-		shuffle(&(imageNeighbors[startIdx]), size);
+		shuffle(&(imageNeighbors[startIdx]), size, rng);
 		startIdx = imageNeighborClasses[i];
 	}
 }
@@ -420,7 +420,7 @@ return 0;
 
 static const void* EMPTY_MATCHING = ((void*)0x1);
 
-static struct VertexList** uniformBlockMaximumMatching(struct Vertex* parent, struct Vertex* image, int* matchingSize, int* n_matchings, int computeEstimate) {
+static struct VertexList** uniformBlockMaximumMatching(struct Vertex* parent, struct Vertex* image, int* matchingSize, int* n_matchings, int computeEstimate, struct RandomNumberGenerator* rng) {
 	int nUncoveredChildren;
 	int nCandidateImages;
 	struct VertexList** uncoveredChildren = getUncoveredNeighborArray(parent, &nUncoveredChildren);
@@ -450,7 +450,7 @@ static struct VertexList** uniformBlockMaximumMatching(struct Vertex* parent, st
 	qsort(candidateImages, nCandidateImages, sizeof(struct VertexList*), &compareLabeledNeighbors);
 
 	int* candidateImageClasses = getClassesArray(candidateImages, nCandidateImages);
-	shuffleInClasses(candidateImages, candidateImageClasses);
+	shuffleInClasses(candidateImages, candidateImageClasses, rng);
 
 	int currentChild = 0;
 	int currentCandidate = 0;
@@ -507,7 +507,7 @@ static struct VertexList** uniformBlockMaximumMatching(struct Vertex* parent, st
 		*matchingSize = nUncoveredChildren;
 		// shuffle *covered* children to randomize the dfs/bfs strategy in case we hit the same image vertex twice in different 
 		// runs of the embedding algorithm
-		shuffle(uncoveredChildren, nUncoveredChildren);
+		shuffle(uncoveredChildren, nUncoveredChildren, rng);
 		return uncoveredChildren; // which are now covered :)
 	} else {
 		free(uncoveredChildren);
@@ -522,13 +522,13 @@ static struct VertexList** uniformBlockMaximumMatching(struct Vertex* parent, st
  * similar to gaston dfs strategy in the pattern space, but for a single tree pattern
  * in a fixed graph transaction.
  */
-static int recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(struct Vertex* parent, struct Graph* g, struct GraphPool* gp, int computeEstimate) {
+static int recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(struct Vertex* parent, struct Graph* g, struct RandomNumberGenerator* rng, struct GraphPool* gp, int computeEstimate) {
 
 	struct Vertex* parentImage = g->vertices[parent->visited - 1];
 
 	int matchingSize;
 	int n_matchings = 0;
-	struct VertexList** maximumMatching = uniformBlockMaximumMatching(parent, parentImage, &matchingSize, &n_matchings, computeEstimate);
+	struct VertexList** maximumMatching = uniformBlockMaximumMatching(parent, parentImage, &matchingSize, &n_matchings, computeEstimate, rng);
 
 	// base case: if there are no children that need to be matched, although parent is not a leaf, we are happy
 	if (maximumMatching == EMPTY_MATCHING) {
@@ -543,7 +543,7 @@ static int recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(struct V
 
 	// recurse to the matched vertices
 	for (int i=0; i<matchingSize; ++i) {
-		int embeddingWorked = recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(maximumMatching[i]->endPoint, g, gp, computeEstimate);
+		int embeddingWorked = recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(maximumMatching[i]->endPoint, g, rng, gp, computeEstimate);
 		if (!embeddingWorked) {
 			free(maximumMatching);
 			return 0;
@@ -597,18 +597,18 @@ static void cleanupSubtreeIsomorphismSampler(struct Graph* h, struct Graph* g) {
  * - g->vertices[v]->visited = 0 for all v \in V(g).
  * - h to be a tree
  * - e->flag to be initialized to 0 for all edges e in h
- * - rand() to be initialized and working.
+ * - rng to be seeded.
  *
  * The algorithm guarantees
  * - output != 0 iff it has found a subgraph isomorphism from h to g
  * - g->vertices[v]->visited = 0 for all v \in V(g) after termination
  */
-char subtreeIsomorphismSampler(struct Graph* g, struct Graph* h) {
+char subtreeIsomorphismSampler(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng) {
 
 	// we root h at a random vertex
-	struct Vertex* currentRoot = h->vertices[rand() % h->n];
+	struct Vertex* currentRoot = h->vertices[randomIntBelow(rng, h->n)];
 	// and select a random image vertex
-	struct Vertex* rootImage = g->vertices[rand() % g->n];
+	struct Vertex* rootImage = g->vertices[randomIntBelow(rng, g->n)];
 
 	char foundIso = 0;
 	if (labelCmp(currentRoot->label, rootImage->label) == 0) {
@@ -616,7 +616,7 @@ char subtreeIsomorphismSampler(struct Graph* g, struct Graph* h) {
 		currentRoot->visited = rootImage->number + 1;
 		rootImage->visited = 1;
 		// and try to embed the rest of the tree h into g accordingly
-		foundIso = recursiveSubtreeIsomorphismSampler(currentRoot, g);
+		foundIso = recursiveSubtreeIsomorphismSampler(currentRoot, g, rng);
 
 		// cleanup
 		cleanupSubtreeIsomorphismSampler(h, g);
@@ -653,18 +653,18 @@ char subtreeIsomorphismSampler(struct Graph* g, struct Graph* h) {
  * - g->vertices[v]->visited = 0 for all v \in V(g).
  * - h to be a tree
  * - e->flag to be initialized to 0 for all edges e in h
- * - rand() to be initialized and working.
+ * - rng to be seeded.
  *
  * The algorithm guarantees
  * - output != 0 iff it has found a subgraph isomorphism from h to g
  * - g->vertices[v]->visited = 0 for all v \in V(g) after termination
  */
-char subtreeIsomorphismSamplerWithImageShuffling(struct Graph* g, struct Graph* h) {
+char subtreeIsomorphismSamplerWithImageShuffling(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng) {
 
 	// we root h at a random vertex
-	struct Vertex* currentRoot = h->vertices[rand() % h->n];
+	struct Vertex* currentRoot = h->vertices[randomIntBelow(rng, h->n)];
 	// and select a random image vertex
-	struct Vertex* rootImage = g->vertices[rand() % g->n];
+	struct Vertex* rootImage = g->vertices[randomIntBelow(rng, g->n)];
 
 	char foundIso = 0;
 	if (labelCmp(currentRoot->label, rootImage->label) == 0) {
@@ -672,7 +672,7 @@ char subtreeIsomorphismSamplerWithImageShuffling(struct Graph* g, struct Graph*
 		currentRoot->visited = rootImage->number + 1;
 		rootImage->visited = 1;
 		// and try to embed the rest of the tree h into g accordingly
-		foundIso = recursiveSubtreeIsomorphismSamplerWithShuffledImage(currentRoot, g);
+		foundIso = recursiveSubtreeIsomorphismSamplerWithShuffledImage(currentRoot, g, rng);
 
 		// cleanup
 		cleanupSubtreeIsomorphismSampler(h, g);
@@ -701,18 +701,18 @@ char subtreeIsomorphismSamplerWithImageShuffling(struct Graph* g, struct Graph*
  * - g->vertices[v]->visited = 0 for all v \in V(g).
  * - h to be a tree
  * - e->flag to be initialized to 0 for all edges e in h
- * - rand() to be initialized and working.
+ * - rng to be seeded.
  *
  * The algorithm guarantees
  * - output != 0 iff it has found a subgraph isomorphism from h to g
  * - g->vertices[v]->visited = 0 for all v \in V(g) after termination
  */
-char subtreeIsomorphismSamplerWithProperMatching(struct Graph* g, struct Graph* h, struct GraphPool* gp) {
+char subtreeIsomorphismSamplerWithProperMatching(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng, struct GraphPool* gp) {
 
 	// we root h at a random vertex
-	struct Vertex* currentRoot = h->vertices[rand() % h->n];
+	struct Vertex* currentRoot = h->vertices[randomIntBelow(rng, h->n)];
 	// and select a random image vertex
-	struct Vertex* rootImage = g->vertices[rand() % g->n];
+	struct Vertex* rootImage = g->vertices[randomIntBelow(rng, g->n)];
 	//	fprintf(stderr, "\nnew round: %i -> %i\n", currentRoot->number, rootEmbedding->number);
 
 	char foundIso = 0;
@@ -721,7 +721,7 @@ char subtreeIsomorphismSamplerWithProperMatching(struct Graph* g, struct Graph*
 		currentRoot->visited = rootImage->number + 1;
 		rootImage->visited = 1;
 		// and try to embed the rest of the tree h into g accordingly
-		foundIso = recursiveSubtreeIsomorphismSamplerWithMatching(currentRoot, g, gp);
+		foundIso = recursiveSubtreeIsomorphismSamplerWithMatching(currentRoot, g, rng, gp);
 
 		// cleanup
 		cleanupSubtreeIsomorphismSampler(h, g);
@@ -731,7 +731,7 @@ char subtreeIsomorphismSamplerWithProperMatching(struct Graph* g, struct Graph*
 }
 
 
-static struct Vertex* getSuitableImage(struct Vertex* root, struct Graph* g, struct ListPool* lp, int* nCandidates) {
+static struct Vertex* getSuitableImage(struct Vertex* root, struct Graph* g, struct RandomNumberGenerator* rng, struct ListPool* lp, int* nCandidates) {
 	*nCandidates = 0;
 	struct VertexList* candidates = NULL;
 	for (int v=0; v<g->n; ++v) {
@@ -746,7 +746,7 @@ static struct Vertex* getSuitableImage(struct Vertex* root, struct Graph* g, str
 	}
 	struct Vertex* image = NULL;
 	if (*nCandidates > 0) {
-		int index = rand() % (*nCandidates);
+		int index = randomIntBelow(rng, *nCandidates);
 		struct VertexList* e = candidates;
 		for (int i=0; i<index; ++i) {
 			e=e->next;
@@ -779,20 +779,20 @@ static struct Vertex* getSuitableImage(struct Vertex* root, struct Graph* g, str
  * - g->vertices[v]->visited = 0 for all v \in V(g).
  * - h to be a tree
  * - e->flag to be initialized to 0 for all edges e in h
- * - rand() to be initialized and working.
+ * - rng to be seeded.
  *
  * The algorithm guarantees
  * - output != 0 iff it has found a subgraph isomorphism from h to g
  * - g->vertices[v]->visited = 0 for all v \in V(g) after termination
  */
-int subtreeIsomorphismSamplerWithSampledMaximumMatching(struct Graph* g, struct Graph* h, struct GraphPool* gp, int computeEstimate) {
+int subtreeIsomorphismSamplerWithSampledMaximumMatching(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng, struct GraphPool* gp, int computeEstimate) {
 
 	// we root h at a random vertex
-	struct Vertex* currentRoot = h->vertices[rand() % h->n];
+	struct Vertex* currentRoot = h->vertices[randomIntBelow(rng, h->n)];
 	// and select a random image vertex with suitable label (if one exists)
 	int nRootImageCandidates;
-	struct Vertex* rootImage = getSuitableImage(currentRoot, g, gp->listPool, &nRootImageCandidates);
-	//	struct Vertex* rootImage = g->vertices[rand() % g->n];
+	struct Vertex* rootImage = getSuitableImage(currentRoot, g, rng, gp->listPool, &nRootImageCandidates);
+	//	struct Vertex* rootImage = g->vertices[randomIntBelow(rng, g->n)];
 
 
 	int foundIso = 0;
@@ -802,7 +802,7 @@ int subtreeIsomorphismSamplerWithSampledMaximumMatching(struct Graph* g, struct
 		currentRoot->visited = rootImage->number + 1;
 		rootImage->visited = 1;
 		// and try to embed the rest of the tree h into g accordingly
-		foundIso = recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(currentRoot, g, gp, computeEstimate);
+		foundIso = recursiveSubtreeIsomorphismSamplerWithSampledMaximumMatching(currentRoot, g, rng, gp, computeEstimate);
 
 		// cleanup
 		cleanupSubtreeIsomorphismSampler(h, g);
@@ -9,13 +9,14 @@
 #define SUBTREEISOMORPHISMSAMPLING_H_
 
 #include "graph.h"
+#include "randomNumberGenerator.h"
 
-char subtreeIsomorphismSampler(struct Graph* g, struct Graph* h);
-char subtreeIsomorphismSamplerWithImageShuffling(struct Graph* g, struct Graph* h);
-char subtreeIsomorphismSamplerWithProperMatching(struct Graph* g, struct Graph* h, struct GraphPool* gp);
-int subtreeIsomorphismSamplerWithSampledMaximumMatching(struct Graph* g, struct Graph* h, struct GraphPool* gp, int computeEstimate);
+char subtreeIsomorphismSampler(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng);
+char subtreeIsomorphismSamplerWithImageShuffling(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng);
+char subtreeIsomorphismSamplerWithProperMatching(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng, struct GraphPool* gp);
+int subtreeIsomorphismSamplerWithSampledMaximumMatching(struct Graph* g, struct Graph* h, struct RandomNumberGenerator* rng, struct GraphPool* gp, int computeEstimate);
 
-struct VertexList** shuffleNeighbors(struct Vertex* v, int degV);
+struct VertexList** shuffleNeighbors(struct Vertex* v, int degV, struct RandomNumberGenerator* rng);
 
 
 #endif /* SUBTREEISOMORPHISMSAMPLING_H_ */
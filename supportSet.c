@@ -97,6 +97,20 @@ void printSupportSetsSparse(struct SupportSet* lists, FILE* out) {
 	}
 }
 
+/**
+ * Same output as printSupportSetsSparse(), but using a (possibly binary) SparseFeatureWriter.
+ * The writer should be created without values.
+ */
+void writeSupportSetsSparse(struct SupportSet* lists, struct SparseFeatureWriter* out) {
+	for (struct SupportSet* l=lists; l!=NULL; l=l->next) {
+		beginSparseRow(out, l->first->data.h->number);
+		for (struct SupportSetElement* e=l->first; e!=NULL; e=e->next) {
+			addSparseEntry(out, e->data.g->number, 1);
+		}
+		endSparseRow(out);
+	}
+}
+
 struct SupportSet* getSupportSet() {
 	return calloc(1, sizeof(struct SupportSet));
 }
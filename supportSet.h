@@ -11,6 +11,7 @@
 #include "graph.h"
 #include "iterativeSubtreeIsomorphism.h"
 #include "intSet.h"
+#include "sparseFeatureWriter.h"
 
 struct SupportSetElement {
 	struct SubtreeIsoDataStore data;
@@ -37,6 +38,7 @@ struct SubtreeIsoDataStore popSupportSetData(struct SupportSet *s);
 void printSupportSet(struct SupportSet *l, FILE *out);
 void printSupportSetSparse(struct SupportSet* l, FILE* out);
 void printSupportSetsSparse(struct SupportSet* lists, FILE* out);
+void writeSupportSetsSparse(struct SupportSet* lists, struct SparseFeatureWriter* out);
 
 struct SupportSet* getSupportSet();
 
@@ -6,11 +6,34 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include "minunit.h"
 
 #include "../memoryManagement.h"
 #include "../graph.h"
 #include "../randomGraphGenerators.h"
+#include "../randomNumberGenerator.h"
+#include "../listComponents.h"
+#include "../listCycles.h"
+#include "../outerplanar.h"
+#include "../cs_Outerplanar.h"
+#include "../cs_Compare.h"
+#include "../patternDictionary.h"
+#include "../sparseFeatureWriter.h"
+#include "../sampleSubtrees.h"
+#include "../listSpanningTrees.h"
+#include "../localSpanningTreeCache.h"
+#include "../localEasySubtreeIsomorphism.h"
+#include "../iterativeSubtreeIsomorphism.h"
+#include "../searchTree.h"
+#include "../cs_Tree.h"
+#include "../treeEnumeration.h"
+#include "../pathSubgraphIsomorphism.h"
+#include "../loading.h"
+#include "../intSet.h"
 
 int tests_run = 0;
 
@@ -20,14 +43,14 @@ struct GraphPool* gp = NULL;
 struct ShallowGraphPool* sgp = NULL;
 
 static char* test_randomOverlapGraphN(int n) {
-	struct Graph* g = randomOverlapGraph(n, 0.5, gp);
+	struct Graph* g = randomOverlapGraph(n, 0.5, threadRandomNumberGenerator(), gp);
 	mu_assert("error, wrong number of vertices", g->n == n);
 	dumpGraph(gp, g);
 	return 0;
 }
 
 static char* test_randomOverlapGraphM(int n, double p) {
-	struct Graph* g = randomOverlapGraph(n, p, gp);
+	struct Graph* g = randomOverlapGraph(n, p, threadRandomNumberGenerator(), gp);
 
 	for (int v=0; v<g->n; ++v) {
 		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
@@ -39,8 +62,8 @@ static char* test_randomOverlapGraphM(int n, double p) {
 }
 
 static char* test_moveOverlapGraphM(int n, double move, double d) {
-	struct Graph* g = randomOverlapGraph(n, d, gp);
-	moveOverlapGraph(g, move, d, gp);
+	struct Graph* g = randomOverlapGraph(n, d, threadRandomNumberGenerator(), gp);
+	moveOverlapGraph(g, move, d, threadRandomNumberGenerator(), gp);
 
 	for (int v=0; v<g->n; ++v) {
 		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
@@ -51,6 +74,656 @@ static char* test_moveOverlapGraphM(int n, double move, double d) {
 	return 0;
 }
 
+static char* test_biconnectedDecomposition() {
+	/* two triangles sharing vertex 2 and a pendant edge at vertex 4 */
+	struct Graph* g = createGraph(6, gp);
+	addEdgeBetweenVertices(0, 1, NULL, g, gp);
+	addEdgeBetweenVertices(1, 2, NULL, g, gp);
+	addEdgeBetweenVertices(2, 0, NULL, g, gp);
+	addEdgeBetweenVertices(2, 3, NULL, g, gp);
+	addEdgeBetweenVertices(3, 4, NULL, g, gp);
+	addEdgeBetweenVertices(4, 2, NULL, g, gp);
+	addEdgeBetweenVertices(4, 5, NULL, g, gp);
+
+	struct BiconnectedDecomposition* d = computeBiconnectedDecomposition(g);
+	mu_assert("error, wrong number of blocks", d->nBlocks == 3);
+	mu_assert("error, wrong number of articulation points", d->nArticulationPoints == 2);
+	mu_assert("error, wrong articulation points", d->isArticulationPoint[2] && d->isArticulationPoint[4]);
+
+	struct Graph* tree = getBlockCutTree(d, gp);
+	mu_assert("error, block-cut tree has wrong number of vertices", tree->n == 5);
+	mu_assert("error, block-cut tree has wrong number of edges", tree->m == 4);
+
+	dumpGraph(gp, tree);
+	freeBiconnectedDecomposition(d);
+	dumpGraph(gp, g);
+	return 0;
+}
+
+static char* test_biconnectedDecompositionLongPath(int n) {
+	struct Graph* g = createGraph(n, gp);
+	for (int v=1; v<n; ++v) {
+		addEdgeBetweenVertices(v-1, v, NULL, g, gp);
+	}
+	struct BiconnectedDecomposition* d = computeBiconnectedDecomposition(g);
+	mu_assert("error, each edge of a path is a block", d->nBlocks == n - 1);
+	mu_assert("error, inner vertices of a path are articulation points", d->nArticulationPoints == n - 2);
+	freeBiconnectedDecomposition(d);
+	dumpGraph(gp, g);
+	return 0;
+}
+
+static char* test_blockDecompositionCache() {
+	struct Graph* g = createGraph(4, gp);
+	addEdgeBetweenVertices(0, 1, NULL, g, gp);
+	addEdgeBetweenVertices(1, 2, NULL, g, gp);
+	addEdgeBetweenVertices(2, 3, NULL, g, gp);
+
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	mu_assert("error, path should have three bridges", d->nBridges == 3);
+	mu_assert("error, decomposition is not cached", getBlockDecomposition(g) == d);
+
+	addEdgeBetweenVertices(3, 0, NULL, g, gp);
+	mu_assert("error, cache is not invalidated", g->blocks == NULL);
+	d = getBlockDecomposition(g);
+	mu_assert("error, cycle should be a single block", d->nBlocks == 1 && d->nBridges == 0);
+	mu_assert("error, wrong block degrees", getCachedBlockDegrees(g)[0] == 1);
+
+	dumpGraph(gp, g);
+	return 0;
+}
+
+
+static char* test_countCycles() {
+	/* K4 with a pendant edge */
+	struct Graph* g = createGraph(5, gp);
+	long int histogram[6] = {0};
+	char truncated = 0;
+	addEdgeBetweenVertices(0, 1, NULL, g, gp);
+	addEdgeBetweenVertices(0, 2, NULL, g, gp);
+	addEdgeBetweenVertices(0, 3, NULL, g, gp);
+	addEdgeBetweenVertices(1, 2, NULL, g, gp);
+	addEdgeBetweenVertices(1, 3, NULL, g, gp);
+	addEdgeBetweenVertices(2, 3, NULL, g, gp);
+	addEdgeBetweenVertices(3, 4, NULL, g, gp);
+
+	mu_assert("error, K4 should have seven cycles", countCycles(g, histogram, 0, 0, &truncated) == 7);
+	mu_assert("error, wrong cycle lengths", histogram[3] == 4 && histogram[4] == 3);
+	mu_assert("error, enumeration should not be truncated", truncated == 0);
+	mu_assert("error, cycle limit is ignored", countCycles(g, NULL, 2, 0, &truncated) == 2 && truncated == 1);
+
+	dumpGraph(gp, g);
+	return 0;
+}
+
+static char* test_outerplanarBlockStructure() {
+	/* hexagon with two diagonals and K4 */
+	struct Graph* g = createGraph(10, gp);
+	struct OuterplanarBlockTest* t = createOuterplanarBlockTest();
+	for (int v=0; v<6; ++v) {
+		addEdgeBetweenVertices(v, (v + 1) % 6, NULL, g, gp);
+	}
+	addEdgeBetweenVertices(0, 2, NULL, g, gp);
+	addEdgeBetweenVertices(0, 3, NULL, g, gp);
+	for (int v=6; v<10; ++v) {
+		for (int w=v+1; w<10; ++w) {
+			addEdgeBetweenVertices(v, w, NULL, g, gp);
+		}
+	}
+
+	struct BiconnectedDecomposition* d = getBlockDecomposition(g);
+	mu_assert("error, expected two blocks", d->nBlocks == 2);
+	for (int b=0; b<d->nBlocks; ++b) {
+		char isOP = getOuterplanarBlockStructure(t, d->edges + d->blockStart[b], d->blockStart[b+1] - d->blockStart[b]);
+		if (t->n == 6) {
+			mu_assert("error, hexagon should be outerplanar", isOP);
+			mu_assert("error, wrong number of diagonals", t->nDiagonals == 2);
+			for (int i=0; i<6; ++i) {
+				int v = t->vertices[t->cycle[i]]->number;
+				int w = t->vertices[t->cycle[(i + 1) % 6]]->number;
+				mu_assert("error, wrong hamiltonian cycle", (v - w + 6) % 6 == 1 || (w - v + 6) % 6 == 1);
+			}
+		} else {
+			mu_assert("error, K4 is not outerplanar", !isOP);
+		}
+	}
+	mu_assert("error, graph is not outerplanar", !isOuterplanarGraph(g, NULL, gp));
+
+	freeOuterplanarBlockTest(t);
+	dumpGraph(gp, g);
+	return 0;
+}
+
+/* hamiltonian cycle and diagonals of the block of g on vertices 0, ..., n-1, starting at vertex offset */
+static struct ShallowGraph* getBlockParts(struct Graph* g, int n, char** diagonals, int offset, int reverse) {
+	struct ShallowGraph* cycle = getShallowGraph(sgp);
+	struct ShallowGraph* diags = getShallowGraph(sgp);
+	for (int i=0; i<n; ++i) {
+		int v = (offset + (reverse ? n - i : i)) % n;
+		int w = (offset + (reverse ? 2 * n - i - 1 : i + 1)) % n;
+		struct VertexList* e = getVertexList(lp);
+		e->startPoint = g->vertices[v];
+		e->endPoint = g->vertices[w];
+		e->label = ((v + 1) % n == w) ? ((v % 3) ? "x" : "y") : ((w % 3) ? "x" : "y");
+		appendEdge(cycle, e);
+	}
+	for (int i=0; diagonals[i]; i+=2) {
+		struct VertexList* e = getVertexList(lp);
+		e->startPoint = g->vertices[atoi(diagonals[i])];
+		e->endPoint = g->vertices[atoi(diagonals[i+1])];
+		e->label = "d";
+		pushEdge(diags, e);
+	}
+	cycle->next = diags;
+	return cycle;
+}
+
+static char* test_canonicalStringOfOuterplanarBlock() {
+	/* octagon with a symmetric and an asymmetric set of diagonals */
+	char* diagonalSets[2][7] = {{"0", "2", "4", "6", "0", "4", NULL}, {"0", "3", "3", "5", "5", "0", NULL}};
+	for (int d=0; d<2; ++d) {
+		struct ShallowGraph* reference = NULL;
+		for (int reverse=0; reverse<2; ++reverse) {
+			for (int offset=0; offset<8; ++offset) {
+				/* the quadratic version adds the diagonals to the graph, hence it needs an edgeless one each time */
+				struct Graph* g = createGraph(8, gp);
+				for (int v=0; v<8; ++v) {
+					g->vertices[v]->label = (v % 2) ? "a" : "b";
+				}
+				struct ShallowGraph* parts = getBlockParts(g, 8, diagonalSets[d], offset, reverse);
+				struct ShallowGraph* quadratic = canonicalStringOfOuterplanarBlockQuadratic(parts, parts->next, sgp);
+				parts = getBlockParts(g, 8, diagonalSets[d], offset, reverse);
+				struct ShallowGraph* fast = canonicalStringOfOuterplanarBlock(parts, parts->next, sgp);
+				mu_assert("error, canonical strings differ", compareVertexLists(quadratic->edges, fast->edges) == 0);
+				if (reference) {
+					mu_assert("error, canonical string depends on representation", compareVertexLists(reference->edges, fast->edges) == 0);
+					dumpShallowGraph(sgp, fast);
+				} else {
+					reference = fast;
+				}
+				dumpShallowGraph(sgp, quadratic);
+				dumpGraph(gp, g);
+			}
+		}
+		dumpShallowGraph(sgp, reference);
+	}
+	return 0;
+}
+
+static char* test_patternDictionary() {
+	char filename[] = "/tmp/patternDictionaryXXXXXX";
+	int fd = mkstemp(filename);
+	mu_assert("error, cannot create temporary file", fd != -1);
+
+	/* two handles on the same file see the ids assigned by the other one */
+	struct PatternDictionary* d1 = openPatternDictionary(filename);
+	struct PatternDictionary* d2 = openPatternDictionary(filename);
+	mu_assert("error, wrong id of new pattern", getPatternId(d1, "1 ( 2 3 )") == 1);
+	mu_assert("error, wrong id of new pattern", getPatternId(d1, "a") == 2);
+	mu_assert("error, id of existing pattern changed", getPatternId(d1, "1 ( 2 3 )") == 1);
+	mu_assert("error, pattern added by other handle not found", getPatternId(d2, "a") == 2);
+	mu_assert("error, wrong id of new pattern", getPatternId(d2, "b") == 3);
+	mu_assert("error, pattern added by other handle not found", getPatternId(d1, "b") == 3);
+	closePatternDictionary(d1);
+	closePatternDictionary(d2);
+
+	/* the incomplete line of a crashed writer is removed */
+	lseek(fd, 0, SEEK_END);
+	mu_assert("error, cannot write to temporary file", write(fd, "4\tc", 3) == 3);
+	close(fd);
+	d1 = openPatternDictionary(filename);
+	mu_assert("error, ids not persistent", getPatternId(d1, "a") == 2);
+	mu_assert("error, wrong id after incomplete line", getPatternId(d1, "d") == 4);
+	closePatternDictionary(d1);
+	d1 = openPatternDictionary(filename);
+	mu_assert("error, ids not persistent", getPatternId(d1, "d") == 4);
+	mu_assert("error, wrong id of new pattern", getPatternId(d1, "c") == 5);
+	closePatternDictionary(d1);
+
+	/* a pattern that cannot be written does not keep its id */
+	d1 = openPatternDictionary(filename);
+	d2 = openPatternDictionary(filename);
+	int writableFd = d1->fd;
+	d1->fd = open(filename, O_RDONLY);
+	mu_assert("error, write to read only dictionary succeeded", getPatternId(d1, "x") == -1);
+	close(d1->fd);
+	d1->fd = writableFd;
+	mu_assert("error, wrong id of new pattern", getPatternId(d2, "y") == 6);
+	mu_assert("error, unwritten pattern kept its id", getPatternId(d1, "y") == 6);
+	mu_assert("error, wrong id of new pattern", getPatternId(d1, "x") == 7);
+	closePatternDictionary(d1);
+	closePatternDictionary(d2);
+
+	unlink(filename);
+	return 0;
+}
+
+static char* test_sparseFeatureWriter() {
+	char text[64] = {0};
+	int64_t footer[2];
+	FILE* f = tmpfile();
+
+	/* the text format matches printIntSetAsLibSvm and printSupportSetsSparse */
+	struct SparseFeatureWriter* w = createSparseFeatureWriter(f, sparseText, 1);
+	beginSparseRow(w, -1);
+	addSparseEntry(w, 3, 10);
+	addSparseEntry(w, 2147483647, -2147483647 - 1);
+	endSparseRow(w);
+	closeSparseFeatureWriter(w);
+	w = createSparseFeatureWriter(f, sparseText, 0);
+	beginSparseRow(w, 0);
+	endSparseRow(w);
+	closeSparseFeatureWriter(w);
+	rewind(f);
+	mu_assert("error, cannot read text output", fread(text, 1, sizeof(text) - 1, f) > 0);
+	mu_assert("error, wrong text output", strcmp(text, "-1 3:10 2147483647:-2147483648\n0:\n") == 0);
+	fclose(f);
+
+	/* the binary format ends with the row index */
+	f = tmpfile();
+	w = createSparseFeatureWriter(f, sparseBinary, 1);
+	for (int i=0; i<3000; ++i) {
+		beginSparseRow(w, i);
+		for (int j=0; j<i%4; ++j) {
+			addSparseEntry(w, j, i);
+		}
+		endSparseRow(w);
+	}
+	closeSparseFeatureWriter(w);
+	fseek(f, -24, SEEK_END);
+	mu_assert("error, cannot read footer", fread(footer, sizeof(int64_t), 2, f) == 2);
+	mu_assert("error, wrong number of rows", footer[0] == 3000);
+	mu_assert("error, wrong number of entries", footer[1] == 4500);
+	mu_assert("error, wrong file size", ftell(f) + 8 == 16 + 4500 * 8 + 3000 * 4 + 3001 * 8 + 24);
+	fclose(f);
+	return 0;
+}
+
+static char* test_randomNumberGenerator() {
+	struct RandomNumberGenerator a, b, c;
+	seedRandomNumberGenerator(&a, 42);
+	seedRandomNumberGenerator(&b, 42);
+	splitRandomNumberGenerator(&b, &c);
+	mu_assert("error, split stream differs from its origin", randomUint64(&a) == randomUint64(&c));
+	mu_assert("error, jumped generator continues its origin", randomUint64(&b) != randomUint64(&a));
+
+	for (int i=0; i<10000; ++i) {
+		int n = 1 + i % 7;
+		int x = randomIntBelow(&a, n);
+		double d = randomDouble(&a);
+		mu_assert("error, bounded integer out of range", (x >= 0) && (x < n));
+		mu_assert("error, double out of range", (d >= 0.0) && (d < 1.0));
+	}
+	return 0;
+}
+
+static char* test_nonisomorphicSpanningTrees() {
+	/* K4 has twelve spanning paths and four spanning stars */
+	struct Graph* g = createGraph(4, gp);
+	addEdgeBetweenVertices(0, 1, NULL, g, gp);
+	addEdgeBetweenVertices(0, 2, NULL, g, gp);
+	addEdgeBetweenVertices(0, 3, NULL, g, gp);
+	addEdgeBetweenVertices(1, 2, NULL, g, gp);
+	addEdgeBetweenVertices(1, 3, NULL, g, gp);
+	addEdgeBetweenVertices(2, 3, NULL, g, gp);
+
+	struct RandomNumberGenerator rng;
+	seedRandomNumberGenerator(&rng, 3);
+	struct ShallowGraph* trees = sampleNonisomorphicSpanningTreesUsingWilson(g, 200, &rng, sgp);
+	mu_assert("error, K4 should have two nonisomorphic spanning trees", trees != NULL && trees->next != NULL && trees->next->next == NULL);
+	mu_assert("error, wrong number of edges", trees->m == 3 && trees->next->m == 3);
+	dumpShallowGraphCycle(sgp, trees);
+
+	trees = sampleSpanningTreesUsingWilson(g, 10, &rng, sgp);
+	int nTrees = 0;
+	for (struct ShallowGraph* tree=trees; tree!=NULL; tree=tree->next) {
+		mu_assert("error, wrong number of edges", tree->m == 3);
+		++nTrees;
+	}
+	mu_assert("error, wrong number of samples", nTrees == 10);
+	dumpShallowGraphCycle(sgp, trees);
+	dumpGraph(gp, g);
+	return 0;
+}
+
+/* a cycle on four vertices with the chord {shift, shift+2} and vertex labels a, b, a, c starting at shift */
+static struct Graph* createDiamond(int shift, char* chordLabel) {
+	static char* labels[4] = {"a", "b", "a", "c"};
+	struct Graph* g = createGraph(4, gp);
+	for (int v=0; v<4; ++v) {
+		g->vertices[(v + shift) % 4]->label = labels[v];
+		addEdgeBetweenVertices((v + shift) % 4, (v + shift + 1) % 4, "x", g, gp);
+	}
+	addEdgeBetweenVertices(shift, (shift + 2) % 4, chordLabel, g, gp);
+	return g;
+}
+
+static char* test_localSpanningTreeCache() {
+	struct LocalSpanningTreeCache* cache = createLocalSpanningTreeCache();
+	struct Graph* g = createDiamond(0, "y");
+	mu_assert("error, empty cache should not contain g", getCachedLocalSpanningTrees(cache, g, sgp) == NULL);
+	struct ShallowGraph* trees = listSpanningTrees(g, sgp, gp);
+	addLocalSpanningTreesToCache(cache, g, trees);
+	dumpShallowGraphCycle(sgp, trees);
+
+	struct Graph* h = createDiamond(1, "y");
+	trees = getCachedLocalSpanningTrees(cache, h, sgp);
+	int nTrees = 0;
+	for (struct ShallowGraph* tree=trees; tree!=NULL; tree=tree->next) {
+		mu_assert("error, wrong number of edges", tree->m == 3);
+		for (struct VertexList* e=tree->edges; e!=NULL; e=e->next) {
+			mu_assert("error, tree is not mapped to h", (e->startPoint == h->vertices[e->startPoint->number]) && isIncident(e->startPoint, e->endPoint));
+		}
+		++nTrees;
+	}
+	mu_assert("error, the diamond has eight spanning trees", nTrees == 8);
+	dumpShallowGraphCycle(sgp, trees);
+
+	struct Graph* k = createDiamond(1, "z");
+	mu_assert("error, different edge labels should not match", getCachedLocalSpanningTrees(cache, k, sgp) == NULL);
+
+	dumpGraph(gp, g);
+	dumpGraph(gp, h);
+	dumpGraph(gp, k);
+	freeLocalSpanningTreeCache(cache);
+	return 0;
+}
+
+static struct Graph* createStar(int nLeaves) {
+	struct Graph* h = createGraph(nLeaves + 1, gp);
+	for (int v=1; v<=nLeaves; ++v) {
+		addEdgeBetweenVertices(0, v, NULL, h, gp);
+	}
+	return h;
+}
+
+static struct Graph* createPath(int n) {
+	struct Graph* h = createGraph(n, gp);
+	for (int v=0; v<n-1; ++v) {
+		addEdgeBetweenVertices(v, v+1, NULL, h, gp);
+	}
+	return h;
+}
+
+/* two triangles that share vertex 0 and a leaf at vertex 1 */
+static struct Graph* createBowtieWithLeaf() {
+	struct Graph* g = createGraph(6, gp);
+	addEdgeBetweenVertices(0, 1, NULL, g, gp);
+	addEdgeBetweenVertices(1, 2, NULL, g, gp);
+	addEdgeBetweenVertices(2, 0, NULL, g, gp);
+	addEdgeBetweenVertices(0, 3, NULL, g, gp);
+	addEdgeBetweenVertices(3, 4, NULL, g, gp);
+	addEdgeBetweenVertices(4, 0, NULL, g, gp);
+	addEdgeBetweenVertices(1, 5, NULL, g, gp);
+	return g;
+}
+
+static char* test_localEasySubtreeCheck() {
+	struct Graph* g = createBowtieWithLeaf();
+	struct Graph* path = createPath(6);
+	struct Graph* smallStar = createStar(4);
+	struct Graph* largeStar = createStar(5);
+
+	/* the characteristics and bipartite graphs of consecutive checks share their memory */
+	struct SpanningtreeTree sptTree = getFullSpanningtreeTree(getBlockTreeT(g, sgp), gp, sgp);
+	mu_assert("error, wrong number of local spanning trees", sptTree.nLocalTrees == 3 * 3 + 1);
+	mu_assert("error, star with four leaves should be found", subtreeCheckForSpanningtreeTree(&sptTree, smallStar, gp));
+	wipeCharacteristicsForLocalEasy(sptTree);
+	struct CachedGraph* bipartite = sptTree.bipartite;
+	mu_assert("error, path with six vertices should be found", subtreeCheckForSpanningtreeTree(&sptTree, path, gp));
+	wipeCharacteristicsForLocalEasy(sptTree);
+	mu_assert("error, star with five leaves should not be found", !subtreeCheckForSpanningtreeTree(&sptTree, largeStar, gp));
+	/* a check does not depend on wiping the characteristics of the previous one */
+	mu_assert("error, star with four leaves should be found again", subtreeCheckForSpanningtreeTree(&sptTree, smallStar, gp));
+	mu_assert("error, bipartite graphs should be reused", bipartite != NULL && sptTree.bipartite == bipartite);
+	wipeCharacteristicsForLocalEasy(sptTree);
+	dumpSpanningtreeTree(sptTree, gp);
+
+	dumpGraph(gp, g);
+	dumpGraph(gp, path);
+	dumpGraph(gp, smallStar);
+	dumpGraph(gp, largeStar);
+	return 0;
+}
+
+static char* test_iterativeLocalEasySubtreeCheck() {
+	struct Graph* g = createBowtieWithLeaf();
+	struct SpanningtreeTree sptTree = getFullSpanningtreeTree(getBlockTreeT(g, sgp), gp, sgp);
+
+	/* each pattern is its predecessor plus a leaf. The largest path and star do not match */
+	for (int shape=0; shape<2; ++shape) {
+		uint8_t* baseCubes = NULL;
+		for (int n=2; n<=7; ++n) {
+			struct Graph* h = shape == 0 ? createPath(n) : createStar(n - 1);
+			uint8_t* cubes = malloc(getIterativeCubesSizeForSpanningtreeTree(&sptTree, n));
+			char iterativeMatch = iterativeSubtreeCheckForSpanningtreeTree(&sptTree, h, baseCubes, cubes, gp);
+			char match = subtreeCheckForSpanningtreeTree(&sptTree, h, gp);
+			mu_assert("error, iterative and non-iterative local easy check differ", iterativeMatch == match);
+			mu_assert("error, wrong result of iterative local easy check", match == (shape == 0 ? n < 7 : n < 6));
+			free(baseCubes);
+			baseCubes = cubes;
+			dumpGraph(gp, h);
+		}
+		free(baseCubes);
+	}
+
+	wipeCharacteristicsForLocalEasy(sptTree);
+	dumpSpanningtreeTree(sptTree, gp);
+	dumpGraph(gp, g);
+	return 0;
+}
+
+/* a tree with n vertices where vertex v>0 is a child of parents[v] */
+static struct Graph* createRootedTree(int n, char** labels, int* parents) {
+	struct Graph* h = createGraph(n, gp);
+	for (int v=0; v<n; ++v) {
+		h->vertices[v]->label = labels[v];
+		if (v > 0) {
+			addEdgeBetweenVertices(parents[v], v, "e", h, gp);
+		}
+	}
+	return h;
+}
+
+static char* test_iterativeRootedSubtreeCheck() {
+	/* g is rooted at vertex 0 and contains vertex 1 with label b between two vertices with label a */
+	char* gLabels[] = {"a", "b", "a", "c"};
+	int gParents[] = {-1, 0, 1, 0};
+	struct Graph* g = createRootedTree(4, gLabels, gParents);
+	struct SubtreeIsoDataStore data = initG(g);
+
+	/* each pattern is its predecessor plus a leaf. The last one does not match */
+	char* hLabels[] = {"a", "b", "c", "a", "c"};
+	int hParents[] = {-1, 0, 0, 1, 3};
+	struct SubtreeIsoDataStore base = data;
+	for (int n=1; n<=5; ++n) {
+		struct Graph* h = createRootedTree(n, hLabels, hParents);
+		struct SubtreeIsoDataStore current = iterativeRootedSubtreeCheck(base, h, gp);
+		struct Vertex* rootEmbedding = NULL;
+		struct SubtreeIsoDataStore check = noniterativeRootedSubtreeCheck(data, h, &rootEmbedding, gp);
+		mu_assert("error, iterative and non-iterative rooted subtree check differ", current.foundIso == check.foundIso);
+		mu_assert("error, wrong result of iterative rooted subtree check", current.foundIso == (n < 5));
+		if (base.h != NULL) {
+			dumpNewCube(base.S, g->n);
+			dumpGraph(gp, base.h);
+		}
+		base = current;
+	}
+	dumpNewCube(base.S, g->n);
+	dumpGraph(gp, base.h);
+
+	/* the root of a pattern may be mapped below the root of g, but not above its other vertices */
+	char* bLabels[] = {"b", "a"};
+	char* cLabels[] = {"c", "a"};
+	int edgeParents[] = {-1, 0};
+	struct Graph* h = createRootedTree(2, bLabels, edgeParents);
+	struct SubtreeIsoDataStore current = iterativeRootedSubtreeCheck(data, h, gp);
+	mu_assert("error, wrong result of iterative rooted subtree check", current.foundIso);
+	dumpNewCube(current.S, g->n);
+	dumpGraph(gp, h);
+	h = createRootedTree(2, cLabels, edgeParents);
+	current = iterativeRootedSubtreeCheck(data, h, gp);
+	mu_assert("error, wrong result of iterative rooted subtree check", !current.foundIso);
+	dumpNewCube(current.S, g->n);
+	dumpGraph(gp, h);
+
+	free(data.postorder);
+	dumpGraph(gp, g);
+	return 0;
+}
+
+/* extending on orbit representatives results in the same distinct trees, in the same order, as extending on all outer shell vertices */
+static char* test_orbitPrunedTreeExtension() {
+	int nTrees[] = {1, 1, 1, 2, 3, 6, 11, 23, 47};
+
+	struct Graph* patterns = createGraph(1, gp);
+	patterns->vertices[0]->label = "a";
+	struct Vertex* extensionVertex = getVertex(gp->vertexPool);
+	extensionVertex->label = "a";
+	struct ShallowGraph* extensionEdges = getShallowGraph(sgp);
+	struct VertexList* e = getVertexList(sgp->listPool);
+	e->startPoint = extensionVertex;
+	e->endPoint = extensionVertex;
+	e->label = "1";
+	pushEdge(extensionEdges, e);
+
+	for (int n=2; n<=9; ++n) {
+		struct Vertex* allShells = getVertex(gp->vertexPool);
+		struct Vertex* orbits = getVertex(gp->vertexPool);
+		struct Graph* nextPatterns = NULL;
+		int nShellExtensions = 0;
+		int nOrbitExtensions = 0;
+		for (struct Graph* g=patterns; g!=NULL; g=g->next) {
+			struct Graph* shellExtensions = extendPatternOnOuterShells(g, extensionEdges, gp, sgp);
+			for (struct Graph* h=shellExtensions; h!=NULL; h=h->next) {
+				++nShellExtensions;
+			}
+			shellExtensions = basicFilter(shellExtensions, allShells, gp, sgp);
+
+			struct Graph* orbitExtensions = extendPatternOnOrbitRepresentatives(g, extensionEdges, gp, sgp);
+			for (struct Graph* h=orbitExtensions; h!=NULL; h=h->next) {
+				++nOrbitExtensions;
+			}
+			orbitExtensions = basicFilter(orbitExtensions, orbits, gp, sgp);
+
+			// basicFilter keeps the first copy of each tree, in reverse order
+			struct Graph* h = orbitExtensions;
+			for (struct Graph* s=shellExtensions; s!=NULL; s=s->next, h=h->next) {
+				mu_assert("error, orbit pruning lost a tree", h != NULL);
+				struct ShallowGraph* shellString = canonicalStringOfTree(s, sgp);
+				struct ShallowGraph* orbitString = canonicalStringOfTree(h, sgp);
+				mu_assert("error, orbit pruning changed the order of the trees", compareCanonicalStrings(shellString, orbitString) == 0);
+				dumpShallowGraph(sgp, shellString);
+				dumpShallowGraph(sgp, orbitString);
+			}
+			mu_assert("error, orbit pruning added a tree", h == NULL);
+
+			for (struct Graph* s=popGraph(&shellExtensions); s!=NULL; s=popGraph(&shellExtensions)) {
+				dumpGraph(gp, s);
+			}
+			while (orbitExtensions != NULL) {
+				struct Graph* tmp = orbitExtensions->next;
+				orbitExtensions->next = nextPatterns;
+				nextPatterns = orbitExtensions;
+				orbitExtensions = tmp;
+			}
+		}
+		mu_assert("error, wrong number of trees", orbits->d == nTrees[n-1]);
+		mu_assert("error, orbit pruning generated more extensions", nOrbitExtensions <= nShellExtensions);
+
+		for (struct Graph* g=popGraph(&patterns); g!=NULL; g=popGraph(&patterns)) {
+			dumpGraph(gp, g);
+		}
+		dumpSearchTree(gp, allShells);
+		dumpSearchTree(gp, orbits);
+		patterns = nextPatterns;
+	}
+
+	for (struct Graph* g=popGraph(&patterns); g!=NULL; g=popGraph(&patterns)) {
+		dumpGraph(gp, g);
+	}
+	dumpShallowGraph(sgp, extensionEdges);
+	dumpVertex(gp->vertexPool, extensionVertex);
+	return 0;
+}
+
+/* walks that match a path pattern are not necessarily embeddings */
+static char* test_pathSubgraphIsomorphism() {
+	struct Graph* cycle = createPath(5);
+	addEdgeBetweenVertices(4, 0, NULL, cycle, gp);
+	struct Graph* path = createPath(5);
+	struct Graph* longPath = createPath(6);
+	mu_assert("error, path with five vertices should be found in cycle", isPathSubgraph(cycle, path));
+	mu_assert("error, path with six vertices should not be found in cycle", !isPathSubgraph(cycle, longPath));
+
+	struct Graph* g = createPath(3);
+	struct Graph* h = createPath(3);
+	g->vertices[0]->label = "a";
+	g->vertices[1]->label = "b";
+	g->vertices[2]->label = "a";
+	h->vertices[0]->label = "b";
+	h->vertices[1]->label = "a";
+	h->vertices[2]->label = "b";
+	mu_assert("error, path b-a-b should not be found in path a-b-a", !isPathSubgraph(g, h));
+	mu_assert("error, path a-b-a should be found in itself", isPathSubgraph(g, g));
+
+	dumpGraph(gp, cycle);
+	dumpGraph(gp, path);
+	dumpGraph(gp, longPath);
+	dumpGraph(gp, g);
+	dumpGraph(gp, h);
+	return 0;
+}
+
+static char* test_fileIteratorRequests() {
+	char filename[] = "/tmp/testsuiteRequestsXXXXXX";
+	int fd = mkstemp(filename);
+	mu_assert("error, cannot create temporary file", fd != -1);
+	FILE* f = fdopen(fd, "w");
+	/* the second graph of the first request references a vertex that does not exist,
+	the second request is cut off by its '$' line */
+	fputs("# 1 1 2 1\nA B\n1 2 x\n# 2 1 2 1\nA B\n1 5 x\n# 3 1 2 1\nA B\n1 2 x\n$\n", f);
+	fputs("# 4 1 2 1\nA B\n$\n", f);
+	fputs("# 5 1 1 0\nA\n\n$\n", f);
+	fclose(f);
+
+	createFileIterator(filename, gp);
+	struct Graph* g = iterateFile();
+	mu_assert("error, first graph not read", g && g->number == 1);
+	dumpGraph(gp, g);
+	mu_assert("error, malformed graph read", iterateFile() == NULL);
+	mu_assert("error, malformed graph not reported", fileIteratorFailed());
+	mu_assert("error, end of first request not found", skipToRequestEnd());
+	mu_assert("error, premature end of input", !fileIteratorAtEnd());
+
+	mu_assert("error, truncated graph read", iterateFile() == NULL);
+	mu_assert("error, truncated graph not reported", fileIteratorFailed());
+	mu_assert("error, end of second request not found", skipToRequestEnd());
+
+	g = iterateFile();
+	mu_assert("error, graph of third request not read", g && g->number == 5);
+	dumpGraph(gp, g);
+	mu_assert("error, end of request reported as failure", (iterateFile() == NULL) && !fileIteratorFailed());
+	destroyFileIterator();
+	unlink(filename);
+	return 0;
+}
+
+static char* test_fingerprintBuffer() {
+	struct FingerprintBuffer buffer = {0};
+	addFingerprint(&buffer, 0x80000001u);
+	addFingerprint(&buffer, 5);
+	addFingerprint(&buffer, UINT32_MAX);
+	addFingerprint(&buffer, 5);
+	addFingerprint(&buffer, 1);
+	struct IntSet* fingerprints = fingerprintBufferToIntSet(&buffer);
+	mu_assert("error, wrong number of fingerprints", fingerprints->size == 3);
+	mu_assert("error, fingerprints not sorted", isSortedUniqueIntSet(fingerprints));
+	mu_assert("error, negative fingerprint", fingerprints->first->value == 1);
+	mu_assert("error, wrong largest fingerprint", fingerprints->last->value == 2147483647);
+	dumpIntSet(fingerprints);
+	return 0;
+}
 
 static char * all_tests() {
 	mu_run_test(test_randomOverlapGraphN(10));
@@ -60,6 +733,24 @@ static char * all_tests() {
 	mu_run_test(test_moveOverlapGraphM(10, 1, 0.5));
 	mu_run_test(test_moveOverlapGraphM(10, 100, 0.5));
 	mu_run_test(test_moveOverlapGraphM(10, 0.5, 0.5));
+	mu_run_test(test_biconnectedDecomposition());
+	mu_run_test(test_biconnectedDecompositionLongPath(1000000));
+	mu_run_test(test_blockDecompositionCache());
+	mu_run_test(test_countCycles());
+	mu_run_test(test_outerplanarBlockStructure());
+	mu_run_test(test_canonicalStringOfOuterplanarBlock());
+	mu_run_test(test_patternDictionary());
+	mu_run_test(test_sparseFeatureWriter());
+	mu_run_test(test_randomNumberGenerator());
+	mu_run_test(test_nonisomorphicSpanningTrees());
+	mu_run_test(test_localSpanningTreeCache());
+	mu_run_test(test_localEasySubtreeCheck());
+	mu_run_test(test_iterativeLocalEasySubtreeCheck());
+	mu_run_test(test_iterativeRootedSubtreeCheck());
+	mu_run_test(test_orbitPrunedTreeExtension());
+	mu_run_test(test_pathSubgraphIsomorphism());
+	mu_run_test(test_fileIteratorRequests());
+	mu_run_test(test_fingerprintBuffer());
 	return 0;
 }
 
@@ -4,6 +4,7 @@
 
 #include "graph.h"
 #include "cs_Tree.h"
+#include "cs_Compare.h"
 #include "searchTree.h"
 #include "bloomFilter.h"
 #include "subtreeIsoUtils.h"
@@ -179,6 +180,125 @@ struct Graph* extendPatternOnOuterShells(struct Graph* g, struct ShallowGraph* c
 
 
 
+/**
+Among the vertices v of the tree g with v->visited == 1, keep ->visited == 1 only at one vertex in each orbit of the
+automorphism group of g and set it to 0 at the others. The representative of an orbit is its marked vertex with
+largest number.
+
+Two vertices u and w of a tree lie in the same orbit iff g rooted at u and g rooted at w are isomorphic
+as rooted trees, i.e., iff their rooted canonical strings are identical.
+ */
+static void markOrbitRepresentatives(struct Graph* g, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph** rootedStrings = malloc(g->n * sizeof(struct ShallowGraph*));
+
+	for (int v=g->n-1; v>=0; --v) {
+		rootedStrings[v] = NULL;
+		if (g->vertices[v]->visited) {
+			rootedStrings[v] = canonicalStringOfRootedTree(g->vertices[v], g->vertices[v], sgp);
+			for (int w=g->n-1; w>v; --w) {
+				if (g->vertices[w]->visited && (compareCanonicalStrings(rootedStrings[v], rootedStrings[w]) == 0)) {
+					g->vertices[v]->visited = 0;
+					break;
+				}
+			}
+		}
+	}
+
+	for (int v=0; v<g->n; ++v) {
+		if (rootedStrings[v]) {
+			dumpShallowGraph(sgp, rootedStrings[v]);
+		}
+	}
+	free(rootedStrings);
+}
+
+
+/**
+Take a tree and add any edge in the candidate set to the vertices on the outermost two shells, like
+extendPatternOnOuterShells(), but only to one vertex of each orbit of the automorphism group of g.
+Attaching an edge to two vertices in the same orbit results in isomorphic trees, which are not generated.
+
+This does not remove all duplicates: Extensions at different orbits of g may still be isomorphic, and each
+tree is generated from each of its frequent parents. The result is the output of extendPatternOnOuterShells()
+without the isomorphic copies that follow the copy at the orbit vertex with largest number. Hence, the first
+occurrence of each tree in the output, and thus the result of a duplicate filter like basicFilter(), is the same.
+
+candidateEdges is expected to contain edges that have a nonNULL ->startPoint and ->endPoint.
+The label of startPoint determines, which vertex can be used for appending the edge,
+the label of the endpoint defines the label of the new vertex added
+ */
+struct Graph* extendPatternOnOrbitRepresentatives(struct Graph* g, struct ShallowGraph* candidateEdges, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+
+	struct Graph* rho = NULL;
+
+	// if v->lowPoint >= outershell then we extend on v
+	int outerShell = computeDistanceToCenter(g, sgp) - 1;
+	for (int v=0; v<g->n; ++v) {
+		g->vertices[v]->visited = g->vertices[v]->lowPoint >= outerShell;
+	}
+	markOrbitRepresentatives(g, sgp);
+
+	// add refinement edges only at orbit representatives on the outer shells
+	for (int v=0; v<g->n; ++v) {
+		if (g->vertices[v]->visited) {
+			for (struct VertexList* e=candidateEdges->edges; e!=NULL; e=e->next) {
+				/* if the labels are compatible */
+				if (strcmp(g->vertices[v]->label, e->startPoint->label) == 0) {
+					struct Graph* h = refinementGraph(g, v, e, gp);
+					h->next = rho;
+					rho = h;
+				}
+			}
+		}
+	}
+
+	// clean up
+	for (int v=0; v<g->n; ++v) {
+		g->vertices[v]->visited = 0;
+	}
+	return rho;
+}
+
+
+/**
+Take a path and add any edge in the candidate set to one end of the path in each orbit of its automorphism
+group. I.e., both ends are extended, unless the path is symmetric. The resulting extensions are paths.
+
+candidateEdges is expected to contain edges that have a nonNULL ->startPoint and ->endPoint.
+The label of startPoint determines, which vertex can be used for appending the edge,
+the label of the endpoint defines the label of the new vertex added
+ */
+struct Graph* extendPathOnEnds(struct Graph* g, struct ShallowGraph* candidateEdges, struct GraphPool* gp, struct ShallowGraphPool* sgp) {
+
+	struct Graph* rho = NULL;
+
+	for (int v=0; v<g->n; ++v) {
+		g->vertices[v]->visited = degree(g->vertices[v]) <= 1;
+	}
+	markOrbitRepresentatives(g, sgp);
+
+	// add refinement edges only at ends that are orbit representatives
+	for (int v=0; v<g->n; ++v) {
+		if (g->vertices[v]->visited) {
+			for (struct VertexList* e=candidateEdges->edges; e!=NULL; e=e->next) {
+				/* if the labels are compatible */
+				if (strcmp(g->vertices[v]->label, e->startPoint->label) == 0) {
+					struct Graph* h = refinementGraph(g, v, e, gp);
+					h->next = rho;
+					rho = h;
+				}
+			}
+		}
+	}
+
+	// clean up
+	for (int v=0; v<g->n; ++v) {
+		g->vertices[v]->visited = 0;
+	}
+	return rho;
+}
+
+
 /**
 Return the list of all graphs in extension that are not contained in listOfGraphs (given as searchTree).
 extension is consumed. after the call, canonical strings of all elements in extension will be added to listOfGraphs */
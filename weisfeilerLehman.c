@@ -2,6 +2,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "loading.h"
 #include "searchTree.h"
 #include "weisfeilerLehman.h"
@@ -73,3 +74,456 @@ struct Graph* weisfeilerLehmanRelabel(struct Graph* g, struct Vertex* wlLabels,
 	// printStringsInSearchTree(wlLabels, stderr, sgp);
 	return h;
 }
+
+
+/******* Integer label Weisfeiler Lehman **********************************************/
+
+/**
+ * Create an empty compression table. initialSlots is rounded up to a power of two.
+ */
+struct WLCompressionTable* createWLCompressionTable(size_t initialSlots) {
+	struct WLCompressionTable* t = malloc(sizeof(struct WLCompressionTable));
+	t->nSlots = 16;
+	while (t->nSlots < initialSlots) {
+		t->nSlots *= 2;
+	}
+	t->slots = calloc(t->nSlots, sizeof(int));
+	t->hashes = malloc(t->nSlots * sizeof(uint64_t));
+	t->arenaCapacity = 4 * t->nSlots;
+	t->arena = malloc(t->arenaCapacity * sizeof(int));
+	t->arenaSize = 0;
+	t->offsets = malloc(t->nSlots / 2 * sizeof(size_t));
+	t->lengths = malloc(t->nSlots / 2 * sizeof(int));
+	t->nLabels = 0;
+	return t;
+}
+
+void freeWLCompressionTable(struct WLCompressionTable* t) {
+	free(t->slots);
+	free(t->hashes);
+	free(t->arena);
+	free(t->offsets);
+	free(t->lengths);
+	free(t);
+}
+
+/**
+ * Hash a sequence of ints. Each element is mixed into the state with a multiply-xorshift step,
+ * the result is finalized with the splitmix64 finalizer.
+ */
+uint64_t wlSignatureHash(const int* signature, int length) {
+	uint64_t hash = 0x9E3779B97F4A7C15ull ^ (uint64_t)length;
+	for (int i=0; i<length; ++i) {
+		hash ^= (uint32_t)signature[i];
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32;
+	}
+	hash ^= hash >> 30;
+	hash *= 0xBF58476D1CE4E5B9ull;
+	hash ^= hash >> 27;
+	hash *= 0x94D049BB133111EBull;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+static void growWLCompressionTable(struct WLCompressionTable* t) {
+	size_t oldSlots = t->nSlots;
+	int* oldIds = t->slots;
+	uint64_t* oldHashes = t->hashes;
+
+	t->nSlots *= 2;
+	t->slots = calloc(t->nSlots, sizeof(int));
+	t->hashes = malloc(t->nSlots * sizeof(uint64_t));
+	t->offsets = realloc(t->offsets, t->nSlots / 2 * sizeof(size_t));
+	t->lengths = realloc(t->lengths, t->nSlots / 2 * sizeof(int));
+
+	for (size_t i=0; i<oldSlots; ++i) {
+		if (oldIds[i] != 0) {
+			size_t slot = oldHashes[i] & (t->nSlots - 1);
+			while (t->slots[slot] != 0) {
+				slot = (slot + 1) & (t->nSlots - 1);
+			}
+			t->slots[slot] = oldIds[i];
+			t->hashes[slot] = oldHashes[i];
+		}
+	}
+	free(oldIds);
+	free(oldHashes);
+}
+
+/**
+ * Return the compressed label id of signature, assigning the next free id if the signature is new.
+ */
+int wlCompressSignature(struct WLCompressionTable* t, const int* signature, int length) {
+	if (2 * (size_t)(t->nLabels + 1) > t->nSlots) {
+		growWLCompressionTable(t);
+	}
+
+	uint64_t hash = wlSignatureHash(signature, length);
+	size_t slot = hash & (t->nSlots - 1);
+	while (t->slots[slot] != 0) {
+		int id = t->slots[slot];
+		if ((t->hashes[slot] == hash)
+				&& (t->lengths[id - 1] == length)
+				&& (memcmp(t->arena + t->offsets[id - 1], signature, length * sizeof(int)) == 0)) {
+			return id;
+		}
+		slot = (slot + 1) & (t->nSlots - 1);
+	}
+
+	// new signature
+	while (t->arenaSize + length > t->arenaCapacity) {
+		t->arenaCapacity *= 2;
+		t->arena = realloc(t->arena, t->arenaCapacity * sizeof(int));
+	}
+	memcpy(t->arena + t->arenaSize, signature, length * sizeof(int));
+	t->offsets[t->nLabels] = t->arenaSize;
+	t->lengths[t->nLabels] = length;
+	t->arenaSize += length;
+
+	++t->nLabels;
+	t->slots[slot] = t->nLabels;
+	t->hashes[slot] = hash;
+	return t->nLabels;
+}
+
+/**
+ * Return the compressed label id of an original vertex label.
+ * The signature of a label string consists of iteration 0 followed by its characters.
+ */
+int wlCompressString(struct WLCompressionTable* t, const char* label) {
+	int length = strlen(label) + 1;
+	int stackBuffer[64];
+	int* signature = length <= 64 ? stackBuffer : malloc(length * sizeof(int));
+	signature[0] = 0;
+	for (int i=1; i<length; ++i) {
+		signature[i] = (unsigned char)label[i-1];
+	}
+	int id = wlCompressSignature(t, signature, length);
+	if (signature != stackBuffer) {
+		free(signature);
+	}
+	return id;
+}
+
+static int compareInts(const void* a, const void* b) {
+	int x = *(const int*)a;
+	int y = *(const int*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Sort a small array of ints. Vertex degrees are small in our databases,
+ * hence insertion sort is used for short arrays.
+ */
+void sortWLMultiset(int* a, int n) {
+	if (n > 16) {
+		qsort(a, n, sizeof(int), &compareInts);
+		return;
+	}
+	for (int i=1; i<n; ++i) {
+		int x = a[i];
+		int j = i - 1;
+		while ((j >= 0) && (a[j] > x)) {
+			a[j+1] = a[j];
+			--j;
+		}
+		a[j+1] = x;
+	}
+}
+
+/**
+ * Compute h iterations of Weisfeiler-Lehman relabeling of g on integer labels.
+ *
+ * Returns a malloc'd array of (h + 1) * g->n compressed labels, where position i * g->n + v holds
+ * the label of vertex v after i iterations. Iteration 0 holds the compressed original vertex labels.
+ * Compressed labels are unique over all iterations and all graphs that use the same table t.
+ * Edge labels are ignored, as in getWLLabel().
+ */
+int* weisfeilerLehmanIntegerLabels(struct Graph* g, int h, struct WLCompressionTable* t) {
+	int n = g->n;
+	int* labels = malloc((h + 1) * n * sizeof(int));
+	if ((labels == NULL) || (n == 0)) {
+		return labels;
+	}
+
+	for (int v=0; v<n; ++v) {
+		labels[v] = wlCompressString(t, g->vertices[v]->label);
+	}
+
+	int maxDegree = getMaxDegree(g);
+	int* signature = malloc((maxDegree + 2) * sizeof(int));
+	for (int i=1; i<=h; ++i) {
+		int* previous = labels + (i - 1) * n;
+		int* current = labels + i * n;
+		for (int v=0; v<n; ++v) {
+			int length = 2;
+			signature[0] = i;
+			signature[1] = previous[v];
+			for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+				signature[length] = previous[e->endPoint->number];
+				++length;
+			}
+			sortWLMultiset(signature + 2, length - 2);
+			current[v] = wlCompressSignature(t, signature, length);
+		}
+	}
+	free(signature);
+	return labels;
+}
+
+/**
+ * Return a copy of g whose vertex labels are the compressed labels after h iterations.
+ */
+struct Graph* weisfeilerLehmanIntegerRelabel(struct Graph* g, int h, struct WLCompressionTable* t, struct GraphPool* gp) {
+	struct Graph* relabeled = cloneGraph(g, gp);
+	int* labels = weisfeilerLehmanIntegerLabels(g, h, t);
+	for (int v=0; v<g->n; ++v) {
+		relabeled->vertices[v]->label = intLabel(labels[h * g->n + v]);
+		relabeled->vertices[v]->isStringMaster = 1;
+	}
+	free(labels);
+	return relabeled;
+}
+
+/**
+ * Compute the feature vector of the Weisfeiler-Lehman subtree kernel from an array of compressed labels,
+ * i.e., the number of occurrences of each label. labels is sorted in place.
+ *
+ * ids and counts must have space for nLabels elements. Returns the number of distinct labels.
+ */
+int weisfeilerLehmanSubtreeFeatures(int* labels, int nLabels, int* ids, int* counts) {
+	qsort(labels, nLabels, sizeof(int), &compareInts);
+	int nFeatures = 0;
+	for (int i=0; i<nLabels; ++i) {
+		if ((nFeatures > 0) && (ids[nFeatures - 1] == labels[i])) {
+			++counts[nFeatures - 1];
+		} else {
+			ids[nFeatures] = labels[i];
+			counts[nFeatures] = 1;
+			++nFeatures;
+		}
+	}
+	return nFeatures;
+}
+
+/**
+ * Print a feature vector in libsvm format with the given class label.
+ */
+void printWLSubtreeFeatures(int* ids, int* counts, int nFeatures, int label, FILE* out) {
+	fprintf(out, "%i", label);
+	for (int i=0; i<nFeatures; ++i) {
+		fprintf(out, " %i:%i", ids[i], counts[i]);
+	}
+	fputc('\n', out);
+}
+
+
+/******* Parallel deterministic Weisfeiler Lehman **************************************/
+
+/**
+ * A signature in the merge step of the parallel engine. data points into the arena of a worker's compression table.
+ */
+struct WLSignature {
+	int* data;
+	int length;
+};
+
+/**
+ * Work package of one thread: the graphs with index in [first, last) of the database.
+ *
+ * Each worker compresses the signatures of its vertices with a thread local compression table.
+ * The local ids are translated to global ids by the array localToGlobal after the merge step.
+ */
+struct WLWorker {
+	struct Graph** db;
+	int** labels;
+	int first;
+	int last;
+	int iteration;
+	struct WLCompressionTable* local;
+	int* localToGlobal;
+};
+
+static int compareSignatures(const void* a, const void* b) {
+	const struct WLSignature* x = a;
+	const struct WLSignature* y = b;
+	int length = x->length < y->length ? x->length : y->length;
+	for (int i=0; i<length; ++i) {
+		if (x->data[i] != y->data[i]) {
+			return (x->data[i] > y->data[i]) - (x->data[i] < y->data[i]);
+		}
+	}
+	return (x->length > y->length) - (x->length < y->length);
+}
+
+/**
+ * Phase one: compress the signatures of all vertices of the graphs of a worker using its local table.
+ * The local ids are temporarily stored at the position of the current iteration in the label arrays.
+ *
+ * In iteration 0, the signature of a vertex is given by its label string (see wlCompressString()).
+ * Afterwards, it consists of the previous label of the vertex and the sorted previous labels of its neighbors.
+ */
+static void* wlCollectSignatures(void* arg) {
+	struct WLWorker* w = arg;
+	int* signature = NULL;
+	int signatureSize = 0;
+
+	for (int i=w->first; i<w->last; ++i) {
+		struct Graph* g = w->db[i];
+		int* current = w->labels[i] + w->iteration * g->n;
+		if (w->iteration == 0) {
+			for (int v=0; v<g->n; ++v) {
+				current[v] = wlCompressString(w->local, g->vertices[v]->label);
+			}
+			continue;
+		}
+
+		int* previous = current - g->n;
+		for (int v=0; v<g->n; ++v) {
+			int length = 1;
+			int deg = degree(g->vertices[v]);
+			if (deg + 1 > signatureSize) {
+				signatureSize = 2 * (deg + 1);
+				signature = realloc(signature, signatureSize * sizeof(int));
+			}
+			signature[0] = previous[v];
+			for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next) {
+				signature[length] = previous[e->endPoint->number];
+				++length;
+			}
+			sortWLMultiset(signature + 1, length - 1);
+			current[v] = wlCompressSignature(w->local, signature, length);
+		}
+	}
+	free(signature);
+	return NULL;
+}
+
+/**
+ * Phase three: translate the local ids of a worker to global ids.
+ */
+static void* wlRewriteLabels(void* arg) {
+	struct WLWorker* w = arg;
+	for (int i=w->first; i<w->last; ++i) {
+		int* current = w->labels[i] + w->iteration * w->db[i]->n;
+		for (int v=0; v<w->db[i]->n; ++v) {
+			current[v] = w->localToGlobal[current[v]];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Run function on all workers, each in its own thread.
+ */
+static void wlRunWorkers(void* (*function)(void*), struct WLWorker* workers, int nThreads) {
+	pthread_t* threads = malloc(nThreads * sizeof(pthread_t));
+	char* started = malloc(nThreads * sizeof(char));
+	for (int t=0; t<nThreads; ++t) {
+		started[t] = pthread_create(&threads[t], NULL, function, &workers[t]) == 0;
+		if (!started[t]) {
+			// fall back to running the work package in the current thread
+			function(&workers[t]);
+		}
+	}
+	for (int t=0; t<nThreads; ++t) {
+		if (started[t]) {
+			pthread_join(threads[t], NULL);
+		}
+	}
+	free(started);
+	free(threads);
+}
+
+/**
+ * Compute h iterations of Weisfeiler-Lehman relabeling for all graphs in db using nThreads threads.
+ *
+ * Returns an array of nGraphs label arrays in the format of weisfeilerLehmanIntegerLabels().
+ * In contrast to that method, compressed label ids do not depend on the order in which graphs are processed:
+ * In each iteration, the workers first compress the signatures of their vertices into thread local tables.
+ * Then, all distinct signatures of the iteration are sorted and the id of a signature is its rank plus the
+ * number of labels of all previous iterations. Finally, the workers translate their local ids to these ids.
+ * Hence, the output is identical for any number of threads.
+ *
+ * The total number of distinct labels is stored in *nLabels.
+ */
+int** weisfeilerLehmanParallelLabels(struct Graph** db, int nGraphs, int h, int nThreads, int* nLabels) {
+	if (nThreads > nGraphs) {
+		nThreads = nGraphs;
+	}
+	if (nThreads < 1) {
+		nThreads = 1;
+	}
+
+	int** labels = malloc(nGraphs * sizeof(int*));
+	for (int i=0; i<nGraphs; ++i) {
+		labels[i] = malloc((h + 1) * db[i]->n * sizeof(int));
+	}
+
+	struct WLWorker* workers = malloc(nThreads * sizeof(struct WLWorker));
+	for (int t=0; t<nThreads; ++t) {
+		workers[t].db = db;
+		workers[t].labels = labels;
+		workers[t].first = (int)((long)nGraphs * t / nThreads);
+		workers[t].last = (int)((long)nGraphs * (t + 1) / nThreads);
+	}
+
+	int idOffset = 0;
+	for (int iteration=0; iteration<=h; ++iteration) {
+		for (int t=0; t<nThreads; ++t) {
+			workers[t].iteration = iteration;
+			workers[t].local = createWLCompressionTable(1024);
+		}
+		wlRunWorkers(&wlCollectSignatures, workers, nThreads);
+
+		// merge step: sort the distinct signatures of all workers
+		size_t nAll = 0;
+		for (int t=0; t<nThreads; ++t) {
+			nAll += workers[t].local->nLabels;
+		}
+		struct WLSignature* global = malloc(nAll * sizeof(struct WLSignature));
+		size_t pos = 0;
+		for (int t=0; t<nThreads; ++t) {
+			struct WLCompressionTable* local = workers[t].local;
+			for (int id=0; id<local->nLabels; ++id) {
+				global[pos].data = local->arena + local->offsets[id];
+				global[pos].length = local->lengths[id];
+				++pos;
+			}
+		}
+		qsort(global, nAll, sizeof(struct WLSignature), &compareSignatures);
+		size_t nGlobal = 0;
+		for (size_t i=0; i<nAll; ++i) {
+			if ((nGlobal == 0) || (compareSignatures(&global[nGlobal - 1], &global[i]) != 0)) {
+				global[nGlobal] = global[i];
+				++nGlobal;
+			}
+		}
+
+		// translate local ids to ranks in the sorted array
+		for (int t=0; t<nThreads; ++t) {
+			struct WLCompressionTable* local = workers[t].local;
+			workers[t].localToGlobal = malloc((local->nLabels + 1) * sizeof(int));
+			for (int id=0; id<local->nLabels; ++id) {
+				struct WLSignature key;
+				key.data = local->arena + local->offsets[id];
+				key.length = local->lengths[id];
+				struct WLSignature* found = bsearch(&key, global, nGlobal, sizeof(struct WLSignature), &compareSignatures);
+				workers[t].localToGlobal[id + 1] = idOffset + (int)(found - global) + 1;
+			}
+		}
+		wlRunWorkers(&wlRewriteLabels, workers, nThreads);
+		idOffset += nGlobal;
+
+		free(global);
+		for (int t=0; t<nThreads; ++t) {
+			freeWLCompressionTable(workers[t].local);
+			free(workers[t].localToGlobal);
+		}
+	}
+
+	free(workers);
+	*nLabels = idOffset;
+	return labels;
+}
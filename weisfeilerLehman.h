@@ -1,9 +1,45 @@
 #ifndef WEISFEILER_LEHMAN_H_
 #define WEISFEILER_LEHMAN_H_ 
 
+#include <stdio.h>
+#include <stdint.h>
 #include "graph.h"
 
+/**
+ * Compression table of the integer Weisfeiler-Lehman engine.
+ *
+ * Maps signatures, i.e. sequences of ints consisting of the iteration, the label of a vertex and the
+ * sorted multiset of its neighbors' labels, to consecutive compressed label ids starting at 1.
+ * The signatures are stored in a single arena, the index is an open addressing hash table.
+ */
+struct WLCompressionTable {
+	int* arena;
+	size_t arenaSize;
+	size_t arenaCapacity;
+	size_t* offsets;  // offsets[id-1] is the position of the signature of id in arena
+	int* lengths;     // lengths[id-1] is the length of the signature of id
+	int* slots;       // ids, or 0 for empty slots
+	uint64_t* hashes; // hash of the signature stored in each slot
+	size_t nSlots;
+	int nLabels;
+};
+
 char* getWLLabel(struct Vertex* v, struct Vertex* trie, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 struct Graph* weisfeilerLehmanRelabel(struct Graph* g, struct Vertex* wlLabels, struct GraphPool* gp, struct ShallowGraphPool* sgp);
 
+// INTEGER LABEL WEISFEILER LEHMAN
+struct WLCompressionTable* createWLCompressionTable(size_t initialSlots);
+void freeWLCompressionTable(struct WLCompressionTable* t);
+uint64_t wlSignatureHash(const int* signature, int length);
+int wlCompressSignature(struct WLCompressionTable* t, const int* signature, int length);
+int wlCompressString(struct WLCompressionTable* t, const char* label);
+void sortWLMultiset(int* a, int n);
+int* weisfeilerLehmanIntegerLabels(struct Graph* g, int h, struct WLCompressionTable* t);
+struct Graph* weisfeilerLehmanIntegerRelabel(struct Graph* g, int h, struct WLCompressionTable* t, struct GraphPool* gp);
+int weisfeilerLehmanSubtreeFeatures(int* labels, int nLabels, int* ids, int* counts);
+void printWLSubtreeFeatures(int* ids, int* counts, int nFeatures, int label, FILE* out);
+
+// PARALLEL DETERMINISTIC WEISFEILER LEHMAN
+int** weisfeilerLehmanParallelLabels(struct Graph** db, int nGraphs, int h, int nThreads, int* nLabels);
+
 #endif
@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 #include "wilsonsAlgorithm.h"
 #include "graphPrinting.h" 
 
@@ -36,11 +37,11 @@ void ias_free(struct IntegerArrayStack* ias) {
  * Implementing Fisher–Yates shuffle
  * from http://stackoverflow.com/questions/1519736/random-shuffling-of-an-array
  */
-void ias_shuffleArray(struct IntegerArrayStack* ias) {
+void ias_shuffleArray(struct IntegerArrayStack* ias, struct RandomNumberGenerator* rng) {
 	int i;
 	for (i = ias->capacity - 1; i > 0; i--)
 	{
-		int index = rand() % (i + 1);
+		int index = randomIntBelow(rng, i + 1);
 		// Simple swap
 		int a = ias->stackData[index];
 		ias->stackData[index] = ias->stackData[i];
@@ -78,7 +79,7 @@ void al_free(struct ArrayList* al) {
 Return a random spanning tree of g as a list of its edges. 
 Assumes a connected graph g with g->m > 0.
 */
-static struct ShallowGraph* _randomSpanningTreeAsShallowGraph(struct Graph* g, struct ShallowGraphPool* sgp) {
+static struct ShallowGraph* _randomSpanningTreeAsShallowGraph(struct Graph* g, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp) {
 	int i, start;
 	struct VertexList** previous = malloc(g->n * sizeof(struct VertexList*)); // current random walk
 	char* used = malloc(g->n * sizeof(char));
@@ -89,7 +90,7 @@ static struct ShallowGraph* _randomSpanningTreeAsShallowGraph(struct Graph* g, s
 		previous[i] = NULL;
 		used[i] = 0;
 	}
-	ias_shuffleArray(remaining);
+	ias_shuffleArray(remaining, rng);
 
 	// Add a random cell.
 	start = ias_pop(remaining);
@@ -97,7 +98,7 @@ static struct ShallowGraph* _randomSpanningTreeAsShallowGraph(struct Graph* g, s
 
 	// While there are remaining cells,
 	// add a loop-erased random walk to the maze.
-	while (!loopErasedRandomWalk(g, remaining, previous, used, tree, sgp->listPool));
+	while (!loopErasedRandomWalk(g, remaining, previous, used, tree, rng, sgp->listPool));
 
 	ias_free(remaining);
 	free(previous);
@@ -110,11 +111,11 @@ static struct ShallowGraph* _randomSpanningTreeAsShallowGraph(struct Graph* g, s
 /**
 Return a spanning tree of g as a list of edges. Assumes that g is connected.
 */
-struct ShallowGraph* randomSpanningTreeAsShallowGraph(struct Graph* g, struct ShallowGraphPool* sgp) {
+struct ShallowGraph* randomSpanningTreeAsShallowGraph(struct Graph* g, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp) {
 	if (g->m == 0) {
 		return getShallowGraph(sgp);
 	} else {
-		return _randomSpanningTreeAsShallowGraph(g, sgp);
+		return _randomSpanningTreeAsShallowGraph(g, rng, sgp);
 	}
 }
 
@@ -135,7 +136,7 @@ void eraseWalk(int index0, int index1, struct VertexList** previous) {
 
 struct VertexList* ROOT = (struct VertexList*)0x1;
 
-char loopErasedRandomWalk(struct Graph* g, struct IntegerArrayStack* remaining, struct VertexList** previous, char* used, struct ShallowGraph* tree, struct ListPool* lp) {
+char loopErasedRandomWalk(struct Graph* g, struct IntegerArrayStack* remaining, struct VertexList** previous, char* used, struct ShallowGraph* tree, struct RandomNumberGenerator* rng, struct ListPool* lp) {
 
 	int index0 = -1;
 	int index1 = -1;
@@ -151,7 +152,7 @@ char loopErasedRandomWalk(struct Graph* g, struct IntegerArrayStack* remaining,
 	previous[index0] = ROOT; // must be different from NULL, however, must not be a valid pointer.
 	while (1) {
 		struct VertexList* e;
-		int neighborIndex = rand() % degree(g->vertices[index0]);
+		int neighborIndex = randomIntBelow(rng, degree(g->vertices[index0]));
 		int i = 0;
 
 		for (e=g->vertices[index0]->neighborhood; e!=NULL; e=e->next) {
@@ -192,3 +193,414 @@ char loopErasedRandomWalk(struct Graph* g, struct IntegerArrayStack* remaining,
 		}
 	}
 }
+
+
+/* vertex and edge labels are replaced by integers that respect equality of the label strings */
+struct LabelIndex {
+	const char* label;
+	int index;
+};
+
+/* NULL labels are equal to each other and smaller than any string */
+static int compareLabels(const char* a, const char* b) {
+	if ((a == NULL) || (b == NULL)) {
+		return (a != NULL) - (b != NULL);
+	}
+	return strcmp(a, b);
+}
+
+static int compareLabelIndex(const void* a, const void* b) {
+	return compareLabels(((const struct LabelIndex*)a)->label, ((const struct LabelIndex*)b)->label);
+}
+
+static void labelsToIntegers(struct LabelIndex* labels, int n, int* result) {
+	qsort(labels, n, sizeof(struct LabelIndex), &compareLabelIndex);
+	int id = 0;
+	for (int i=0; i<n; ++i) {
+		if ((i > 0) && (compareLabels(labels[i-1].label, labels[i].label) != 0)) {
+			++id;
+		}
+		result[labels[i].index] = id;
+	}
+}
+
+
+/**
+ * Create a sampler for random spanning trees of g. g must be connected and must not be changed or freed
+ * while the sampler is used.
+ */
+struct WilsonSampler* createWilsonSampler(struct Graph* g) {
+	struct WilsonSampler* ws = malloc(sizeof(struct WilsonSampler));
+	int n = g->n;
+	ws->g = g;
+	ws->n = n;
+
+	ws->offsets = malloc((n + 1) * sizeof(int));
+	ws->offsets[0] = 0;
+	for (int v=0; v<n; ++v) {
+		ws->offsets[v+1] = ws->offsets[v] + degree(g->vertices[v]);
+	}
+	int nSlots = ws->offsets[n];
+	ws->targets = malloc(nSlots * sizeof(int));
+	ws->edges = malloc(nSlots * sizeof(struct VertexList*));
+	for (int v=0; v<n; ++v) {
+		int i = ws->offsets[v];
+		for (struct VertexList* e=g->vertices[v]->neighborhood; e!=NULL; e=e->next, ++i) {
+			ws->targets[i] = e->endPoint->number;
+			ws->edges[i] = e;
+		}
+	}
+
+	ws->root = -1;
+	ws->parent = malloc(n * sizeof(int));
+	ws->sequence = malloc(n * sizeof(int));
+	ws->order = malloc(n * sizeof(int));
+	ws->inTree = malloc(n * sizeof(char));
+
+	struct LabelIndex* labels = malloc((n > nSlots ? n : nSlots) * sizeof(struct LabelIndex));
+	ws->vertexLabels = malloc(n * sizeof(int));
+	ws->edgeLabels = malloc(nSlots * sizeof(int));
+	for (int v=0; v<n; ++v) {
+		labels[v].label = g->vertices[v]->label;
+		labels[v].index = v;
+	}
+	labelsToIntegers(labels, n, ws->vertexLabels);
+	for (int i=0; i<nSlots; ++i) {
+		labels[i].label = ws->edges[i]->label;
+		labels[i].index = i;
+	}
+	labelsToIntegers(labels, nSlots, ws->edgeLabels);
+	free(labels);
+
+	ws->treeOffsets = malloc((n + 1) * sizeof(int));
+	ws->treeTargets = malloc(2 * n * sizeof(int));
+	ws->treeEdgeLabels = malloc(2 * n * sizeof(int));
+	ws->queue = malloc(n * sizeof(int));
+	ws->bfsParent = malloc(n * sizeof(int));
+	ws->ids = malloc(n * sizeof(int));
+	ws->pairs = malloc(2 * n * sizeof(int));
+
+	ws->keyCapacity = 1024;
+	ws->keys = malloc(ws->keyCapacity * sizeof(int));
+	ws->nKeys = 0;
+	ws->idCapacity = 256;
+	ws->keyStarts = malloc((ws->idCapacity + 1) * sizeof(size_t));
+	ws->keyStarts[0] = 0;
+	ws->keyHashes = malloc(ws->idCapacity * sizeof(unsigned int));
+	ws->isSampledTree = calloc(ws->idCapacity, sizeof(char));
+	ws->nIds = 0;
+	ws->tableSize = 1024;
+	ws->table = malloc(ws->tableSize * sizeof(int));
+	for (int i=0; i<ws->tableSize; ++i) {
+		ws->table[i] = -1;
+	}
+	return ws;
+}
+
+
+void freeWilsonSampler(struct WilsonSampler* ws) {
+	free(ws->offsets);
+	free(ws->targets);
+	free(ws->edges);
+	free(ws->parent);
+	free(ws->sequence);
+	free(ws->order);
+	free(ws->inTree);
+	free(ws->vertexLabels);
+	free(ws->edgeLabels);
+	free(ws->treeOffsets);
+	free(ws->treeTargets);
+	free(ws->treeEdgeLabels);
+	free(ws->queue);
+	free(ws->bfsParent);
+	free(ws->ids);
+	free(ws->pairs);
+	free(ws->keys);
+	free(ws->keyStarts);
+	free(ws->keyHashes);
+	free(ws->isSampledTree);
+	free(ws->table);
+	free(ws);
+}
+
+
+/**
+ * Draw a uniform random spanning tree of ws->g and store it in ws->parent and ws->sequence.
+ *
+ * The loop erased random walks are implemented by storing the last edge that left each vertex,
+ * which results in the same tree as the explicit erasure of loopErasedRandomWalk(). rng is used
+ * exactly as in randomSpanningTreeAsShallowGraph(), hence both return the same trees for the same seed.
+ */
+void wilsonSampleTree(struct WilsonSampler* ws, struct RandomNumberGenerator* rng) {
+	int n = ws->n;
+	for (int v=0; v<n; ++v) {
+		ws->order[v] = v;
+		ws->parent[v] = -1;
+		ws->inTree[v] = 0;
+	}
+	// same shuffle as ias_shuffleArray()
+	for (int i=n-1; i>0; --i) {
+		int index = randomIntBelow(rng, i + 1);
+		int a = ws->order[index];
+		ws->order[index] = ws->order[i];
+		ws->order[i] = a;
+	}
+
+	int top = n - 1;
+	ws->root = ws->order[top--];
+	ws->inTree[ws->root] = 1;
+
+	int nSequence = 0;
+	while (top >= 0) {
+		int start = ws->order[top--];
+		if (ws->inTree[start]) {
+			continue;
+		}
+
+		// random walk until the tree is hit. loops are erased by overwriting parent
+		for (int v=start; !ws->inTree[v]; ) {
+			int slot = ws->offsets[v] + randomIntBelow(rng, ws->offsets[v+1] - ws->offsets[v]);
+			ws->parent[v] = slot;
+			v = ws->targets[slot];
+		}
+
+		// add the loop erased walk to the tree, the edge next to the tree comes first
+		int first = nSequence;
+		for (int v=start; !ws->inTree[v]; v=ws->targets[ws->parent[v]]) {
+			ws->inTree[v] = 1;
+			ws->sequence[nSequence++] = v;
+		}
+		for (int i=first, j=nSequence-1; i<j; ++i, --j) {
+			int a = ws->sequence[i];
+			ws->sequence[i] = ws->sequence[j];
+			ws->sequence[j] = a;
+		}
+	}
+}
+
+
+/**
+ * Return the last drawn tree as list of edges of ws->g, in the same order as randomSpanningTreeAsShallowGraph().
+ */
+struct ShallowGraph* wilsonTreeAsShallowGraph(struct WilsonSampler* ws, struct ShallowGraphPool* sgp) {
+	struct ShallowGraph* tree = getShallowGraph(sgp);
+	for (int i=0; i<ws->n-1; ++i) {
+		appendEdge(tree, shallowCopyEdge(ws->edges[ws->parent[ws->sequence[i]]], sgp->listPool));
+	}
+	return tree;
+}
+
+
+static unsigned int hashKey(const int* key, int length) {
+	unsigned int hash = 2166136261u;
+	for (int i=0; i<length; ++i) {
+		hash = (hash ^ (unsigned int)key[i]) * 16777619u;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+
+static void rehashKeys(struct WilsonSampler* ws) {
+	ws->tableSize *= 2;
+	ws->table = realloc(ws->table, ws->tableSize * sizeof(int));
+	for (int i=0; i<ws->tableSize; ++i) {
+		ws->table[i] = -1;
+	}
+	for (int id=0; id<ws->nIds; ++id) {
+		int i = ws->keyHashes[id] & (ws->tableSize - 1);
+		while (ws->table[i] != -1) {
+			i = (i + 1) & (ws->tableSize - 1);
+		}
+		ws->table[i] = id;
+	}
+}
+
+
+/**
+ * Return the id of key. Keys that were not seen before get the next free id.
+ */
+static int keyToId(struct WilsonSampler* ws, const int* key, int length) {
+	unsigned int hash = hashKey(key, length);
+	int i = hash & (ws->tableSize - 1);
+	for ( ; ws->table[i] != -1; i = (i + 1) & (ws->tableSize - 1)) {
+		int id = ws->table[i];
+		if ((ws->keyHashes[id] == hash)
+				&& ((size_t)length == ws->keyStarts[id+1] - ws->keyStarts[id])
+				&& (memcmp(ws->keys + ws->keyStarts[id], key, length * sizeof(int)) == 0)) {
+			return id;
+		}
+	}
+
+	int id = ws->nIds++;
+	if (id == ws->idCapacity) {
+		ws->idCapacity *= 2;
+		ws->keyStarts = realloc(ws->keyStarts, (ws->idCapacity + 1) * sizeof(size_t));
+		ws->keyHashes = realloc(ws->keyHashes, ws->idCapacity * sizeof(unsigned int));
+		ws->isSampledTree = realloc(ws->isSampledTree, ws->idCapacity * sizeof(char));
+		memset(ws->isSampledTree + id, 0, ws->idCapacity - id);
+	}
+	if (ws->nKeys + length > ws->keyCapacity) {
+		while (ws->nKeys + length > ws->keyCapacity) {
+			ws->keyCapacity *= 2;
+		}
+		ws->keys = realloc(ws->keys, ws->keyCapacity * sizeof(int));
+	}
+	memcpy(ws->keys + ws->nKeys, key, length * sizeof(int));
+	ws->nKeys += length;
+	ws->keyStarts[id+1] = ws->nKeys;
+	ws->keyHashes[id] = hash;
+	ws->table[i] = id;
+
+	if (2 * ws->nIds > ws->tableSize) {
+		rehashKeys(ws);
+	}
+	return id;
+}
+
+
+static inline int comparePairs(const int* x, const int* y) {
+	if (x[0] != y[0]) {
+		return x[0] < y[0] ? -1 : 1;
+	}
+	if (x[1] != y[1]) {
+		return x[1] < y[1] ? -1 : 1;
+	}
+	return 0;
+}
+
+
+/**
+ * Return the canonical id of the last drawn tree. Two trees drawn by ws have the same id iff they
+ * are isomorphic.
+ *
+ * The tree is rooted at its center. If it has two centers, the id is derived from the ids of both halves.
+ */
+int wilsonTreeCanonicalId(struct WilsonSampler* ws) {
+	int n = ws->n;
+	int* offsets = ws->treeOffsets;
+	int* degrees = ws->ids;
+
+	// store the tree in the same format as the graph
+	for (int v=0; v<=n; ++v) {
+		offsets[v] = 0;
+	}
+	for (int v=0; v<n; ++v) {
+		if (v != ws->root) {
+			++offsets[v+1];
+			++offsets[ws->targets[ws->parent[v]] + 1];
+		}
+	}
+	for (int v=0; v<n; ++v) {
+		offsets[v+1] += offsets[v];
+		degrees[v] = offsets[v];
+	}
+	for (int v=0; v<n; ++v) {
+		if (v != ws->root) {
+			int w = ws->targets[ws->parent[v]];
+			int label = ws->edgeLabels[ws->parent[v]];
+			ws->treeTargets[degrees[v]] = w;
+			ws->treeEdgeLabels[degrees[v]++] = label;
+			ws->treeTargets[degrees[w]] = v;
+			ws->treeEdgeLabels[degrees[w]++] = label;
+		}
+	}
+
+	// find the centers by removing leaves, layer by layer
+	int head = 0;
+	int tail = 0;
+	for (int v=0; v<n; ++v) {
+		degrees[v] = offsets[v+1] - offsets[v];
+		if (degrees[v] <= 1) {
+			ws->queue[tail++] = v;
+		}
+	}
+	for (int remaining=n; remaining>2; ) {
+		int layerEnd = tail;
+		while (head < layerEnd) {
+			int v = ws->queue[head++];
+			degrees[v] = 0;
+			--remaining;
+			for (int i=offsets[v]; i<offsets[v+1]; ++i) {
+				int w = ws->treeTargets[i];
+				if ((degrees[w] > 0) && (--degrees[w] == 1)) {
+					ws->queue[tail++] = w;
+				}
+			}
+		}
+	}
+	int c1 = ws->queue[head];
+	int c2 = (tail - head == 2) ? ws->queue[head + 1] : -1;
+
+	// bfs from the center(s), then compute ids bottom up
+	ws->queue[0] = c1;
+	ws->bfsParent[c1] = c2;
+	tail = 1;
+	if (c2 != -1) {
+		ws->queue[1] = c2;
+		ws->bfsParent[c2] = c1;
+		tail = 2;
+	}
+	for (head=0; head<tail; ++head) {
+		int v = ws->queue[head];
+		for (int i=offsets[v]; i<offsets[v+1]; ++i) {
+			int w = ws->treeTargets[i];
+			if (w != ws->bfsParent[v]) {
+				ws->bfsParent[w] = v;
+				ws->queue[tail++] = w;
+			}
+		}
+	}
+	for (head=tail-1; head>=0; --head) {
+		int v = ws->queue[head];
+		int length = 1;
+		ws->pairs[0] = ws->vertexLabels[v];
+		for (int i=offsets[v]; i<offsets[v+1]; ++i) {
+			int w = ws->treeTargets[i];
+			if (w != ws->bfsParent[v]) {
+				ws->pairs[length++] = ws->treeEdgeLabels[i];
+				ws->pairs[length++] = ws->ids[w];
+			}
+		}
+		// insertion sort, most vertices have few children
+		for (int i=3; i<length; i+=2) {
+			int pair[2] = {ws->pairs[i], ws->pairs[i+1]};
+			int j = i;
+			for ( ; (j > 1) && (comparePairs(ws->pairs + j - 2, pair) > 0); j-=2) {
+				ws->pairs[j] = ws->pairs[j-2];
+				ws->pairs[j+1] = ws->pairs[j-1];
+			}
+			ws->pairs[j] = pair[0];
+			ws->pairs[j+1] = pair[1];
+		}
+		ws->ids[v] = keyToId(ws, ws->pairs, length);
+	}
+
+	if (c2 == -1) {
+		return ws->ids[c1];
+	}
+	int key[4] = {-1, 0, ws->ids[c1], ws->ids[c2]};
+	for (int i=offsets[c1]; i<offsets[c1+1]; ++i) {
+		if (ws->treeTargets[i] == c2) {
+			key[1] = ws->treeEdgeLabels[i];
+		}
+	}
+	if (key[2] > key[3]) {
+		key[2] = ws->ids[c2];
+		key[3] = ws->ids[c1];
+	}
+	return keyToId(ws, key, 4);
+}
+
+
+/**
+ * Return 1 if no tree isomorphic to the last drawn tree was checked by this function before, 0 otherwise.
+ */
+char wilsonTreeIsNew(struct WilsonSampler* ws) {
+	int id = wilsonTreeCanonicalId(ws);
+	if (ws->isSampledTree[id]) {
+		return 0;
+	}
+	ws->isSampledTree[id] = 1;
+	return 1;
+}
@@ -2,6 +2,7 @@
 #define WILSONS_ALGORITHM_H_
 
 #include "graph.h"
+#include "randomNumberGenerator.h"
 
 /**
  * A stack of integer values that uses an array of fixed size. 
@@ -28,6 +29,70 @@ struct ArrayList {
 	int capacity;
 };
 
-struct ShallowGraph* randomSpanningTreeAsShallowGraph(struct Graph* g, struct ShallowGraphPool* sgp);
-char loopErasedRandomWalk(struct Graph* g, struct IntegerArrayStack* remaining, struct VertexList** previous, char* used, struct ShallowGraph* tree, struct ListPool* lp);
+struct ShallowGraph* randomSpanningTreeAsShallowGraph(struct Graph* g, struct RandomNumberGenerator* rng, struct ShallowGraphPool* sgp);
+char loopErasedRandomWalk(struct Graph* g, struct IntegerArrayStack* remaining, struct VertexList** previous, char* used, struct ShallowGraph* tree, struct RandomNumberGenerator* rng, struct ListPool* lp);
+
+/**
+ * Draws many random spanning trees of the same connected graph g with Wilsons algorithm.
+ *
+ * The adjacency of g is stored once in compressed sparse row format: the neighbors of v are
+ * targets[offsets[v]], ..., targets[offsets[v+1]-1] in the order of v's neighborhood and edges[i]
+ * is the edge of g that corresponds to targets[i]. A drawn tree is represented by parent, where
+ * parent[v] is the position i of the edge edges[i] from v to its parent and parent[root] == -1.
+ * sequence lists the n-1 non root vertices in the order in which randomSpanningTreeAsShallowGraph()
+ * would add their edges.
+ *
+ * The sampler also assigns canonical ids to the drawn trees, such that two trees get the same id iff
+ * they are isomorphic (respecting vertex and edge labels). To this end, each rooted subtree is
+ * represented by its root label followed by the sorted (edge label, id) pairs of its children. These keys
+ * are stored in a hash table that assigns consecutive ids.
+ */
+struct WilsonSampler {
+	struct Graph* g;
+	int n;
+	int* offsets;
+	int* targets;
+	struct VertexList** edges;
+
+	// the last drawn tree
+	int root;
+	int* parent;
+	int* sequence;
+
+	// scratch space for drawing
+	int* order;
+	char* inTree;
+
+	// labels as integers, for vertices and for the positions of the adjacency
+	int* vertexLabels;
+	int* edgeLabels;
+
+	// scratch space for canonical ids, the tree is stored in the same format as g
+	int* treeOffsets;
+	int* treeTargets;
+	int* treeEdgeLabels;
+	int* queue;
+	int* bfsParent;
+	int* ids;
+	int* pairs;
+
+	// hash table of the keys of rooted subtrees
+	int* keys;
+	size_t nKeys;
+	size_t keyCapacity;
+	size_t* keyStarts;
+	unsigned int* keyHashes;
+	char* isSampledTree;
+	int nIds;
+	int idCapacity;
+	int* table;
+	int tableSize;
+};
+
+struct WilsonSampler* createWilsonSampler(struct Graph* g);
+void freeWilsonSampler(struct WilsonSampler* ws);
+void wilsonSampleTree(struct WilsonSampler* ws, struct RandomNumberGenerator* rng);
+struct ShallowGraph* wilsonTreeAsShallowGraph(struct WilsonSampler* ws, struct ShallowGraphPool* sgp);
+int wilsonTreeCanonicalId(struct WilsonSampler* ws);
+char wilsonTreeIsNew(struct WilsonSampler* ws);
 #endif